@@ -0,0 +1,201 @@
+/*
+ * Compare lookup and replace performance of light and swiss hash
+ * tables used by memtx HASH index. Values are pointers to keys so
+ * that, like with tuples, every comparison dereferences memory.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <memory>
+#include <vector>
+
+#include <iostream>
+#include <benchmark/benchmark.h>
+
+static inline uint32_t
+perf_hash(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return (uint32_t)key;
+}
+
+#define LIGHT_NAME _perf
+#define LIGHT_DATA_TYPE const uint64_t *
+#define LIGHT_KEY_TYPE uint64_t
+#define LIGHT_CMP_ARG_TYPE int
+#define LIGHT_EQUAL(a, b, arg) (*(a) == *(b))
+#define LIGHT_EQUAL_KEY(a, b, arg) (*(a) == (b))
+#include "salad/light.h"
+
+#define SWISS_NAME _perf
+#define SWISS_DATA_TYPE const uint64_t *
+#define SWISS_KEY_TYPE uint64_t
+#define SWISS_CMP_ARG_TYPE int
+#define SWISS_EQUAL(a, b, arg) (*(a) == *(b))
+#define SWISS_EQUAL_KEY(a, b, arg) (*(a) == (b))
+#include "salad/swiss.h"
+
+static const size_t EXTENT_SIZE = 16 * 1024;
+
+static void *
+extent_alloc(void *ctx)
+{
+	(void)ctx;
+	return malloc(EXTENT_SIZE);
+}
+
+static void
+extent_free(void *ctx, void *extent)
+{
+	(void)ctx;
+	free(extent);
+}
+
+class LightTable {
+public:
+	LightTable()
+	{
+		light_perf_create(&ht, EXTENT_SIZE, extent_alloc, extent_free,
+				  NULL, 0);
+	}
+	~LightTable() { light_perf_destroy(&ht); }
+	void insert(const uint64_t *value)
+	{
+		if (light_perf_insert(&ht, perf_hash(*value),
+				      value) == light_perf_end)
+			abort();
+	}
+	bool get(uint64_t key)
+	{
+		return light_perf_find_key(&ht, perf_hash(key),
+					   key) != light_perf_end;
+	}
+	void replace(const uint64_t *value)
+	{
+		const uint64_t *replaced;
+		if (light_perf_replace(&ht, perf_hash(*value), value,
+				       &replaced) == light_perf_end)
+			abort();
+	}
+private:
+	struct light_perf_core ht;
+};
+
+class SwissTable {
+public:
+	SwissTable()
+	{
+		swiss_perf_create(&ht, EXTENT_SIZE, extent_alloc, extent_free,
+				  NULL, 0);
+	}
+	~SwissTable() { swiss_perf_destroy(&ht); }
+	void insert(const uint64_t *value)
+	{
+		if (swiss_perf_insert(&ht, perf_hash(*value), value) != 0)
+			abort();
+	}
+	bool get(uint64_t key)
+	{
+		return swiss_perf_find_key(&ht, perf_hash(key), key) != NULL;
+	}
+	void replace(const uint64_t *value)
+	{
+		const uint64_t *replaced;
+		if (swiss_perf_replace(&ht, perf_hash(*value), value,
+				       &replaced) != 1)
+			abort();
+	}
+private:
+	struct swiss_perf_core ht;
+};
+
+// Keys and a table filled with them. Built once per table size
+// because filling a table with 500M keys takes a while.
+template<class Table>
+struct Fixture {
+	std::vector<uint64_t> keys;
+	std::unique_ptr<Table> table;
+
+	static Fixture &get(size_t size)
+	{
+		static Fixture fixture;
+		if (fixture.keys.size() != size) {
+			fixture.table.reset();
+			fixture.keys.resize(size);
+			for (size_t i = 0; i < size; i++)
+				fixture.keys[i] = i * 2;
+			fixture.table.reset(new Table());
+			for (size_t i = 0; i < size; i++)
+				fixture.table->insert(&fixture.keys[i]);
+		}
+		return fixture;
+	}
+};
+
+template<class Table>
+static void
+bench_get(benchmark::State& state)
+{
+	Fixture<Table> &f = Fixture<Table>::get(state.range(0));
+	size_t size = f.keys.size();
+	uint64_t rnd = 1;
+	size_t found = 0;
+	for (auto _ : state) {
+		rnd = rnd * 6364136223846793005ULL + 1442695040888963407ULL;
+		// Every other lookup misses.
+		found += f.table->get((rnd >> 16) % (2 * size));
+	}
+	benchmark::DoNotOptimize(found);
+	state.SetItemsProcessed(state.iterations());
+}
+
+template<class Table>
+static void
+bench_replace(benchmark::State& state)
+{
+	Fixture<Table> &f = Fixture<Table>::get(state.range(0));
+	size_t size = f.keys.size();
+	uint64_t rnd = 1;
+	for (auto _ : state) {
+		rnd = rnd * 6364136223846793005ULL + 1442695040888963407ULL;
+		f.table->replace(&f.keys[(rnd >> 16) % size]);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+#define HASH_TABLE_BENCHMARK(func, table)				\
+	BENCHMARK_TEMPLATE(func, table)					\
+		->Arg(10 * 1000 * 1000)					\
+		->Arg(100 * 1000 * 1000)				\
+		->Arg(500 * 1000 * 1000)				\
+		->Unit(benchmark::kNanosecond)
+
+HASH_TABLE_BENCHMARK(bench_get, LightTable);
+HASH_TABLE_BENCHMARK(bench_get, SwissTable);
+HASH_TABLE_BENCHMARK(bench_replace, LightTable);
+HASH_TABLE_BENCHMARK(bench_replace, SwissTable);
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
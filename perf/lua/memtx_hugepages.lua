@@ -0,0 +1,63 @@
+#!/usr/bin/env tarantool
+--
+-- Measure random point lookups in a large memtx space, which are bound
+-- by TLB misses on tree descents and hash probes. Run it twice, with
+-- and without huge pages, and compare the lookup rates. Transparent
+-- huge pages must be enabled in the kernel in the 'madvise' or 'always'
+-- mode, see /sys/kernel/mm/transparent_hugepage/enabled.
+--
+-- Usage: tarantool memtx_hugepages.lua [hugepages] [tuples] [time]
+--
+
+local clock = require('clock')
+local fio = require('fio')
+
+local USE_HUGEPAGES = arg[1] ~= 'false' and arg[1] ~= '0'
+local TUPLES = tonumber(arg[2]) or 10000000
+local DURATION = tonumber(arg[3]) or 10
+
+local work_dir = fio.tempdir()
+box.cfg{
+    work_dir = work_dir,
+    memtx_use_hugepages = USE_HUGEPAGES,
+    memtx_memory = 4 * 1024 * 1024 * 1024,
+    wal_mode = 'none',
+    log_level = 1,
+}
+
+local s = box.schema.space.create('test')
+s:create_index('pk')
+s:create_index('hash', {type = 'hash', parts = {2, 'unsigned'}})
+box.begin()
+for i = 1, TUPLES do
+    s:insert{i, i}
+    if i % 1000 == 0 then
+        box.commit()
+        box.begin()
+    end
+end
+box.commit()
+
+local function bench(index)
+    local count = 0
+    local start = clock.monotonic()
+    local deadline = start + DURATION / 2
+    repeat
+        for _ = 1, 10000 do
+            index:get{math.random(TUPLES)}
+        end
+        count = count + 10000
+    until clock.monotonic() > deadline
+    return count / (clock.monotonic() - start)
+end
+
+print(string.format('hugepages: %s, tuples: %d, arena used: %d MB',
+                    USE_HUGEPAGES, TUPLES,
+                    box.slab.info().arena_used / 1024 / 1024))
+print(string.format('backed by huge pages: %d MB',
+                    box.slab.hugepages_size() / 1024 / 1024))
+print(string.format('tree lookups: %.0f per second', bench(s.index.pk)))
+print(string.format('hash lookups: %.0f per second', bench(s.index.hash)))
+
+fio.rmtree(work_dir)
+os.exit(0)
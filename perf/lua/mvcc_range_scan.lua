@@ -0,0 +1,113 @@
+#!/usr/bin/env tarantool
+--
+-- Measure the MVCC overhead of concurrent range reads and inserts into
+-- the ranges being read. Readers scan ranges of a tree index in
+-- interactive transactions and yield before commit, so writers insert
+-- tuples while the ranges are tracked by the transaction manager.
+--
+-- Usage: tarantool mvcc_range_scan.lua [readers] [writers] [range] [time]
+--
+
+local clock = require('clock')
+local fiber = require('fiber')
+local fio = require('fio')
+
+local READERS = tonumber(arg[1]) or 10
+local WRITERS = tonumber(arg[2]) or 10
+local RANGE = tonumber(arg[3]) or 10000
+local DURATION = tonumber(arg[4]) or 10
+local SPACE_SIZE = 10 * RANGE
+
+local work_dir = fio.tempdir()
+box.cfg{
+    work_dir = work_dir,
+    memtx_use_mvcc_engine = true,
+    memtx_memory = 1024 * 1024 * 1024,
+    wal_mode = 'none',
+    log_level = 1,
+}
+
+local s = box.schema.space.create('test')
+s:create_index('pk')
+box.begin()
+-- Leave holes between keys for writers.
+for i = 1, SPACE_SIZE do
+    s:insert{i * 2}
+    if i % 1000 == 0 then
+        box.commit()
+        box.begin()
+    end
+end
+box.commit()
+
+local stop = false
+local read_count = 0
+local read_tuples = 0
+local write_count = 0
+local conflict_count = 0
+
+local function reader()
+    while not stop do
+        local from = math.random(SPACE_SIZE - RANGE) * 2
+        box.begin()
+        local n = 0
+        for _ in s:pairs({from}, {iterator = 'GE'}) do
+            n = n + 1
+            if n == RANGE then
+                break
+            end
+        end
+        fiber.yield()
+        box.commit()
+        read_count = read_count + 1
+        read_tuples = read_tuples + n
+    end
+end
+
+local function writer()
+    while not stop do
+        local key = math.random(SPACE_SIZE) * 2 + 1
+        local ok = pcall(function()
+            box.begin()
+            s:replace{key}
+            box.commit()
+        end)
+        if not ok then
+            box.rollback()
+            conflict_count = conflict_count + 1
+        end
+        write_count = write_count + 1
+        fiber.yield()
+    end
+end
+
+local fibers = {}
+for _ = 1, READERS do
+    local f = fiber.new(reader)
+    f:set_joinable(true)
+    table.insert(fibers, f)
+end
+for _ = 1, WRITERS do
+    local f = fiber.new(writer)
+    f:set_joinable(true)
+    table.insert(fibers, f)
+end
+
+local start = clock.monotonic()
+fiber.sleep(DURATION)
+stop = true
+for _, f in ipairs(fibers) do
+    f:join()
+end
+local elapsed = clock.monotonic() - start
+
+print(string.format('readers: %d, writers: %d, range: %d, time: %.1f s',
+                    READERS, WRITERS, RANGE, elapsed))
+print(string.format('range reads: %.1f per second (%.0f tuples per second)',
+                    read_count / elapsed, read_tuples / elapsed))
+print(string.format('inserts: %.1f per second, conflicts: %d',
+                    write_count / elapsed, conflict_count))
+print(string.format('tx memory: %d bytes', box.info.memory().tx))
+
+fio.rmtree(work_dir)
+os.exit(0)
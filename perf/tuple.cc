@@ -430,6 +430,232 @@ tuple_tuple_compare_hint(benchmark::State& state)
 
 BENCHMARK(tuple_tuple_compare_hint);
 
+// Set of tuples {tenant_id, "hello", nil, ts, ts} with few distinct
+// tenants, i.e. with a long common prefix of the key {tenant_id, ts}.
+class TenantTuples {
+public:
+	static const size_t NUM_TENANTS = 4;
+	TenantTuples()
+	{
+		format = MemtxEngine::instance().format();
+		tuple_format_ref(format);
+		struct key_part_def kdp[2];
+		memset(kdp, 0, sizeof(kdp));
+		kdp[0].fieldno = 0;
+		kdp[0].type = FIELD_TYPE_UNSIGNED;
+		kdp[1].fieldno = 3;
+		kdp[1].type = FIELD_TYPE_UNSIGNED;
+		kd = key_def_new(kdp, 2, false);
+
+		for (size_t i = 0; i < NUM_TEST_TUPLES; i++) {
+			char buf[64];
+			char *end = buf;
+			uint64_t ts = (uint64_t)rand() * 1024 + rand();
+			end = mp_encode_array(end, 5);
+			end = mp_encode_uint(end, i % NUM_TENANTS);
+			end = mp_encode_str(end, "hello", 5);
+			end = mp_encode_nil(end);
+			end = mp_encode_uint(end, ts);
+			end = mp_encode_uint(end, ts);
+			data[i] = box_tuple_new(format, buf, end);
+			tuple_ref(data[i]);
+			hint[i] = tuple_hint(data[i], kd);
+			wide_hint[i] = tuple_wide_hint(data[i], kd);
+		}
+	}
+	~TenantTuples()
+	{
+		for (size_t i = 0; i < NUM_TEST_TUPLES; i++)
+			tuple_unref(data[i]);
+		key_def_delete(kd);
+		tuple_format_unref(format);
+	}
+	struct tuple *operator[](size_t i) { return data[i]; }
+
+	struct key_def *kd;
+	hint_t hint[NUM_TEST_TUPLES];
+	hint_t wide_hint[NUM_TEST_TUPLES];
+
+private:
+	struct tuple_format *format;
+	struct tuple *data[NUM_TEST_TUPLES];
+};
+
+// benchmark of tuple compare of tenant-prefixed keys with hints
+// stored along with tuples, as in a memtx tree index.
+static void
+tuple_tuple_compare_tenant_hint(benchmark::State& state)
+{
+	TenantTuples tuples;
+	size_t i = 0;
+	size_t j = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		if (j >= NUM_TEST_TUPLES)
+			j -= NUM_TEST_TUPLES;
+		benchmark::DoNotOptimize(tuple_compare(
+			tuples[i], tuples.hint[i], tuples[j], tuples.hint[j],
+			tuples.kd));
+		/* Step by the number of tenants to hit equal hints. */
+		i += 1;
+		j += TenantTuples::NUM_TENANTS + 1;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(tuple_tuple_compare_tenant_hint);
+
+// benchmark of tuple compare of tenant-prefixed keys with wide hints
+// stored along with tuples, as in a memtx tree index with wide_hint.
+static void
+tuple_tuple_compare_tenant_wide_hint(benchmark::State& state)
+{
+	TenantTuples tuples;
+	size_t i = 0;
+	size_t j = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		if (j >= NUM_TEST_TUPLES)
+			j -= NUM_TEST_TUPLES;
+		hint_t h1 = tuples.hint[i], h2 = tuples.hint[j];
+		hint_t w1 = tuples.wide_hint[i], w2 = tuples.wide_hint[j];
+		int rc;
+		if (h1 == h2 && h1 != HINT_NONE && w1 != w2 &&
+		    w1 != HINT_NONE && w2 != HINT_NONE)
+			rc = w1 < w2 ? -1 : 1;
+		else
+			rc = tuple_compare(tuples[i], h1, tuples[j], h2,
+					   tuples.kd);
+		benchmark::DoNotOptimize(rc);
+		i += 1;
+		j += TenantTuples::NUM_TENANTS + 1;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(tuple_tuple_compare_tenant_wide_hint);
+
+// Set of tuples {i, "user:0000000123", nil, i, i} with a short
+// string key sharing a common prefix, as a typical primary key.
+class ShortKeyTuples {
+public:
+	ShortKeyTuples()
+	{
+		format = MemtxEngine::instance().format();
+		tuple_format_ref(format);
+		struct key_part_def kdp;
+		memset(&kdp, 0, sizeof(kdp));
+		kdp.fieldno = 1;
+		kdp.type = FIELD_TYPE_STRING;
+		kd = key_def_new(&kdp, 1, false);
+
+		for (size_t i = 0; i < NUM_TEST_TUPLES; i++) {
+			char buf[64];
+			char key[16];
+			char *end = buf;
+			int len = snprintf(key, sizeof(key), "user:%010zu", i);
+			end = mp_encode_array(end, 5);
+			end = mp_encode_uint(end, i);
+			end = mp_encode_str(end, key, len);
+			end = mp_encode_nil(end);
+			end = mp_encode_uint(end, i);
+			end = mp_encode_uint(end, i);
+			data[i] = box_tuple_new(format, buf, end);
+			tuple_ref(data[i]);
+			hint[i] = tuple_hint(data[i], kd);
+			inline_key_hint[i] = tuple_inline_key_hint(data[i], kd);
+		}
+	}
+	~ShortKeyTuples()
+	{
+		for (size_t i = 0; i < NUM_TEST_TUPLES; i++)
+			tuple_unref(data[i]);
+		key_def_delete(kd);
+		tuple_format_unref(format);
+	}
+	struct tuple *operator[](size_t i) { return data[i]; }
+
+	struct key_def *kd;
+	hint_t hint[NUM_TEST_TUPLES];
+	hint_t inline_key_hint[NUM_TEST_TUPLES];
+
+private:
+	struct tuple_format *format;
+	struct tuple *data[NUM_TEST_TUPLES];
+};
+
+// benchmark of tuple compare of short string keys with hints stored
+// along with tuples. Every other comparison is of equal keys, as in
+// the last steps of a lookup in a memtx tree index.
+static void
+tuple_tuple_compare_short_key_hint(benchmark::State& state)
+{
+	ShortKeyTuples tuples;
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		size_t j = i & ~(size_t)1;
+		benchmark::DoNotOptimize(tuple_compare(
+			tuples[i], tuples.hint[i], tuples[j], tuples.hint[j],
+			tuples.kd));
+		i++;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(tuple_tuple_compare_short_key_hint);
+
+// The same with inline key hints, as in a memtx tree index with
+// inline_key: neither comparison has to look into the tuples.
+static void
+tuple_tuple_compare_short_key_inline(benchmark::State& state)
+{
+	ShortKeyTuples tuples;
+	size_t i = 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		if (i == NUM_TEST_TUPLES) {
+			total_count += i;
+			i = 0;
+		}
+		size_t j = i & ~(size_t)1;
+		hint_t h1 = tuples.hint[i], h2 = tuples.hint[j];
+		hint_t w1 = tuples.inline_key_hint[i];
+		hint_t w2 = tuples.inline_key_hint[j];
+		int rc;
+		if (h1 == h2 && h1 != HINT_NONE && w1 != w2 &&
+		    w1 != HINT_NONE && w2 != HINT_NONE)
+			rc = w1 < w2 ? -1 : 1;
+		else if (h1 == h2 && h1 != HINT_NONE && w1 == w2 &&
+			 inline_key_hint_is_exact(w1))
+			rc = 0;
+		else
+			rc = tuple_compare(tuples[i], h1, tuples[j], h2,
+					   tuples.kd);
+		benchmark::DoNotOptimize(rc);
+		i++;
+	}
+	total_count += i;
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(tuple_tuple_compare_short_key_inline);
+
 BENCHMARK_MAIN();
 
 static void
@@ -0,0 +1,150 @@
+/*
+ * Measure the cost of processing synchronous replication acks with
+ * a deep limbo queue. Transactions are put to the limbo directly and
+ * CONFIRM requests are written to a journal that completes writes
+ * instantly, so only the limbo itself is measured.
+ */
+#include "memory.h"
+#include "fiber.h"
+#include "journal.h"
+#include "memtx_tx.h"
+#include "replication.h"
+#include "txn.h"
+#include "txn_limbo.h"
+
+#include <iostream>
+#include <benchmark/benchmark.h>
+
+// Number of replicas acking transactions, not counting the master.
+const uint32_t NUM_REPLICAS = 4;
+// Replica id of the master owning the limbo.
+const uint32_t MASTER_ID = 1;
+
+// LSN assigned to the last journal entry.
+static int64_t journal_lsn;
+
+static int
+stub_journal_write(struct journal *journal, struct journal_entry *entry)
+{
+	(void)journal;
+	entry->res = ++journal_lsn;
+	journal_queue_on_complete(entry);
+	return 0;
+}
+
+static int
+stub_journal_write_async(struct journal *journal,
+			 struct journal_entry *entry)
+{
+	stub_journal_write(journal, entry);
+	entry->write_async_cb(entry);
+	return 0;
+}
+
+// Class that initializes the limbo owned by this instance.
+class Limbo {
+public:
+	static Limbo &instance()
+	{
+		static Limbo instance;
+		return instance;
+	}
+private:
+	Limbo()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		memtx_tx_manager_init();
+		txn_limbo_init();
+		journal_create(&journal, stub_journal_write_async,
+			       stub_journal_write);
+		journal_set(&journal);
+		instance_id = MASTER_ID;
+		// Skip PROMOTE, it isn't what is measured.
+		txn_limbo.owner_id = MASTER_ID;
+	}
+	~Limbo()
+	{
+		memtx_tx_manager_free();
+		fiber_free();
+		memory_free();
+	}
+
+	struct journal journal;
+};
+
+// Put synchronous transactions to the limbo as if they were written
+// to WAL and acked by the master. Returns the LSN of the first one.
+static int64_t
+limbo_fill(int64_t count)
+{
+	int64_t first_lsn = journal_lsn + 1;
+	for (int64_t i = 0; i < count; i++) {
+		struct txn *txn = txn_begin();
+		if (txn == NULL)
+			abort();
+		txn_set_flags(txn, TXN_WAIT_SYNC | TXN_WAIT_ACK);
+		struct txn_limbo_entry *entry =
+			txn_limbo_append(&txn_limbo, MASTER_ID, txn);
+		if (entry == NULL)
+			abort();
+		fiber_set_txn(fiber(), NULL);
+		txn->signature = ++journal_lsn;
+		txn_limbo_assign_local_lsn(&txn_limbo, entry, txn->signature);
+		txn_limbo_ack(&txn_limbo, MASTER_ID, txn->signature);
+	}
+	return first_lsn;
+}
+
+// Replicas ack every transaction one by one, each in turn, the last
+// ones being a quorum. So the queue stays full until the last replica
+// acks transactions, which confirms them one by one.
+static void
+bench_limbo_ack(benchmark::State& state)
+{
+	Limbo::instance();
+	const int64_t queue_len = state.range(0);
+	replication_synchro_quorum = NUM_REPLICAS + 1;
+	size_t total_count = 0;
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		int64_t first_lsn = limbo_fill(queue_len);
+		state.ResumeTiming();
+		for (uint32_t id = MASTER_ID + 1;
+		     id <= MASTER_ID + NUM_REPLICAS; id++) {
+			for (int64_t i = 0; i < queue_len; i++)
+				txn_limbo_ack(&txn_limbo, id, first_lsn + i);
+		}
+		total_count += queue_len * NUM_REPLICAS;
+		if (!txn_limbo_is_empty(&txn_limbo))
+			abort();
+	}
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(bench_limbo_ack)->Arg(100)->Arg(1000)->Arg(10000);
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
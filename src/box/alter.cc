@@ -213,6 +213,12 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			  "'euclid' or 'manhattan'");
 		return -1;
 	}
+	if (opts->hash_table == hash_index_table_type_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS, "hash_table must be either "
+			 "'light' or 'swiss'");
+		return -1;
+	}
 	if (opts->page_size <= 0 || (opts->range_size > 0 &&
 				     opts->page_size > opts->range_size)) {
 		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
@@ -240,6 +246,12 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->read_ahead < 0) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS,
+			 "read_ahead must be greater than or equal to 0");
+		return -1;
+	}
 	return 0;
 }
 
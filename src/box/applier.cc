@@ -60,6 +60,9 @@
 #include "small/static.h"
 #include "tt_static.h"
 #include "memory.h"
+#include "coio_file.h"
+#include "engine.h"
+#include "memtx_engine.h"
 
 STRS(applier_state, applier_STATE);
 
@@ -203,7 +206,8 @@ applier_thread_writer_f(va_list ap)
 		try {
 			applier->thread.has_acks_to_send = false;
 			struct xrow_header xrow;
-			xrow_encode_vclock(&xrow, &replicaset.vclock);
+			xrow_encode_ack_xc(&xrow, &replicaset.vclock,
+					   applier->thread.leader_tm);
 			xrow.tm = applier->thread.txn_last_tm;
 			coio_write_xrow(&applier->io, &xrow);
 			ERROR_INJECT(ERRINJ_APPLIER_SLOW_ACK, {
@@ -433,6 +437,62 @@ done:
 	applier_set_state(applier, APPLIER_READY);
 }
 
+/**
+ * Receive the master's snapshot file sent on checkpoint initial
+ * join, save it to the snapshot directory and load it.
+ * @param row - the first file chunk; on return, the OK row
+ *        terminating the file.
+ * @retval the number of received file chunks.
+ */
+static uint64_t
+applier_wait_checkpoint(struct applier *applier, struct xrow_header *row)
+{
+	struct iostream *io = &applier->io;
+	struct ibuf *ibuf = &applier->ibuf;
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)engine_by_name("memtx");
+	char filename[PATH_MAX];
+	strlcpy(filename, xdir_format_filename(&memtx->snap_dir,
+					       vclock_sum(&replicaset.vclock),
+					       INPROGRESS), sizeof(filename));
+	int fd = coio_file_open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		tnt_raise(SystemError, "failed to create file '%s'", filename);
+	auto file_guard = make_scoped_guard([&] {
+		if (fd >= 0)
+			coio_file_close(fd);
+		coio_unlink(filename);
+	});
+
+	say_info("receiving the master checkpoint");
+	uint64_t chunk_count = 0;
+	while (row->type != IPROTO_OK) {
+		applier->last_row_time = ev_monotonic_now(loop());
+		if (iproto_type_is_error(row->type)) {
+			xrow_decode_error_xc(row);
+		} else if (row->type != IPROTO_JOIN_FILE) {
+			tnt_raise(ClientError, ER_UNKNOWN_REQUEST_TYPE,
+				  (uint32_t)row->type);
+		}
+		const char *data;
+		uint32_t size;
+		xrow_decode_join_file_xc(row, &data, &size);
+		if (coio_write(fd, data, size) < 0) {
+			tnt_raise(SystemError, "failed to write file '%s'",
+				  filename);
+		}
+		chunk_count++;
+		coio_read_xrow(io, ibuf, row);
+	}
+	int rc = coio_file_close(fd);
+	fd = -1;
+	if (rc < 0)
+		tnt_raise(SystemError, "failed to close file '%s'", filename);
+	if (memtx_engine_recover_join_snapshot(memtx, filename) != 0)
+		diag_raise();
+	return chunk_count;
+}
+
 static uint64_t
 applier_wait_snapshot(struct applier *applier)
 {
@@ -463,6 +523,14 @@ applier_wait_snapshot(struct applier *applier)
 	}
 
 	coio_read_xrow(io, ibuf, &row);
+	if (row.type == IPROTO_JOIN_FILE) {
+		/*
+		 * The master sends its last checkpoint as is. It
+		 * includes the Raft and limbo state, so there's no
+		 * metadata to read.
+		 */
+		return applier_wait_checkpoint(applier, &row);
+	}
 	if (row.type == IPROTO_JOIN_META) {
 		/* Read additional metadata. Empty at the moment. */
 		do {
@@ -570,6 +638,8 @@ struct applier_tx_row {
 			struct raft_request req;
 			struct vclock vclock;
 		} raft;
+		/** Monotonic time of the master sent in a heartbeat. */
+		double leader_tm;
 	} req;
 };
 
@@ -713,7 +783,9 @@ applier_join(struct applier *applier)
 	struct xrow_header row;
 	uint64_t row_count;
 
-	xrow_encode_join_xc(&row, &INSTANCE_UUID);
+	xrow_encode_join_xc(&row, &INSTANCE_UUID,
+			    replication_join_mode ==
+			    REPLICATION_JOIN_MODE_CHECKPOINT);
 	coio_write_xrow(io, &row);
 
 	applier_set_state(applier, APPLIER_INITIAL_JOIN);
@@ -778,7 +850,8 @@ applier_parse_tx_row(struct applier_tx_row *tx_row)
 			diag_raise();
 		}
 	} else if (type == IPROTO_OK) {
-		/* Nothing to do. */
+		if (xrow_decode_heartbeat(row, &tx_row->req.leader_tm) != 0)
+			diag_raise();
 	} else {
 		tnt_raise(ClientError, ER_UNKNOWN_REQUEST_TYPE, type);
 	}
@@ -1029,9 +1102,14 @@ applier_handle_raft_request(struct applier *applier, struct raft_request *req)
 	return box_raft_process(req, applier->instance_id);
 }
 
+/**
+ * Apply rows as a single transaction and submit it to the journal. If
+ * the batch isn't NULL, the transaction may be added to it instead,
+ * see txn_commit_try_async_batch().
+ */
 static int
 apply_plain_tx(uint32_t replica_id, struct stailq *rows,
-	       bool skip_conflict, bool use_triggers)
+	       bool skip_conflict, bool use_triggers, struct txn_batch *batch)
 {
 	/*
 	 * Explicitly begin the transaction so that we can
@@ -1124,7 +1202,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		txn_on_wal_write(txn, on_wal_write);
 	}
 
-	return txn_commit_try_async(txn);
+	return txn_commit_try_async_batch(txn, batch);
 fail:
 	txn_abort(txn);
 	return -1;
@@ -1146,7 +1224,7 @@ apply_final_join_tx(uint32_t replica_id, struct stailq *rows)
 		rc = apply_synchro_req(replica_id, &txr->row,
 				       &txr->req.synchro);
 	} else {
-		rc = apply_plain_tx(replica_id, rows, false, false);
+		rc = apply_plain_tx(replica_id, rows, false, false, NULL);
 	}
 	fiber_gc();
 	return rc;
@@ -1283,11 +1361,19 @@ applier_apply_tx(struct applier *applier, struct stailq *rows)
 		 * each other.
 		 */
 		assert(first_row == last_row);
-		rc = apply_synchro_req(applier->instance_id, &txr->row,
-				       &txr->req.synchro);
+		/*
+		 * The request is written bypassing the batch, so the
+		 * preceding transactions must be submitted first.
+		 */
+		rc = txn_batch_flush(&applier->txn_batch);
+		if (rc == 0) {
+			rc = apply_synchro_req(applier->instance_id, &txr->row,
+					       &txr->req.synchro);
+		}
 	} else {
 		rc = apply_plain_tx(applier->instance_id, rows,
-				    replication_skip_conflict, true);
+				    replication_skip_conflict, true,
+				    &applier->txn_batch);
 	}
 	if (rc != 0)
 		goto finish;
@@ -1316,6 +1402,7 @@ applier_signal_ack(struct applier *applier)
 		struct replica *r = replica_by_id(applier->instance_id);
 		applier->ack_msg.txn_last_tm = (r == NULL ? 0 :
 						r->applier_txn_last_tm);
+		applier->ack_msg.leader_tm = applier->leader_tm;
 		cmsg_init(&applier->ack_msg.base, applier->ack_route);
 		cpipe_push(&applier->applier_thread->thread_pipe,
 			   &applier->ack_msg.base);
@@ -1336,6 +1423,7 @@ applier_thread_signal_ack(struct cmsg *base)
 	fiber_cond_signal(&applier->thread.writer_cond);
 	applier->thread.has_acks_to_send = true;
 	applier->thread.txn_last_tm = msg->txn_last_tm;
+	applier->thread.leader_tm = msg->leader_tm;
 }
 
 /**
@@ -1456,9 +1544,50 @@ applier_handle_raft(struct applier *applier, struct applier_tx_row *txr)
 	return 0;
 }
 
+/**
+ * Submit the transactions applied before a failure to the journal and
+ * raise the error.
+ */
+static void
+applier_flush_and_raise(struct applier *applier)
+{
+	struct error *e = diag_last_error(diag_get());
+	error_ref(e);
+	txn_batch_flush(&applier->txn_batch);
+	diag_set_error(diag_get(), e);
+	error_unref(e);
+	diag_raise();
+}
+
+/**
+ * Remember the monotonic time sent by the master in the last heartbeat while
+ * it is the Raft leader. The time is echoed back in ACKs so the leader knows
+ * when it was heard from the last time by its own clock, which can't be moved
+ * back or forth unlike the wall clock used for row timestamps.
+ *
+ * The time is echoed only if leases are enabled locally: otherwise this
+ * instance doesn't wait for the lease to expire before starting an
+ * election and must not be counted in the leader's lease quorum.
+ */
+static inline void
+applier_update_leader_tm(struct applier *applier,
+			 const struct applier_tx_row *txr)
+{
+	struct raft *raft = box_raft();
+	if (!raft->is_lease_enabled || raft->leader != applier->instance_id)
+		applier->leader_tm = 0;
+	else if (txr->row.type == IPROTO_OK &&
+		 txr->req.leader_tm > applier->leader_tm)
+		applier->leader_tm = txr->req.leader_tm;
+}
+
 /**
  * The tx part of applier-in-thread machinery. Apply all the parsed
  * transactions.
+ *
+ * Consecutive asynchronous transactions are submitted to the journal
+ * as a single entry, which is flushed before any other request is
+ * processed, before the fiber yields and at the end of the message.
  */
 static void
 applier_process_batch(struct cmsg *base)
@@ -1471,13 +1600,15 @@ applier_process_batch(struct cmsg *base)
 			stailq_first_entry(&tx->rows, struct applier_tx_row,
 					    next);
 		raft_process_heartbeat(box_raft(), applier->instance_id);
+		applier_update_leader_tm(applier, txr);
 		if (txr->row.lsn == 0) {
-			if (applier_handle_raft(applier, txr) != 0)
+			if (txn_batch_flush(&applier->txn_batch) != 0 ||
+			    applier_handle_raft(applier, txr) != 0)
 				diag_raise();
 			applier_signal_ack(applier);
 			applier_check_sync(applier);
 		} else if (applier_apply_tx(applier, &tx->rows) != 0) {
-			diag_raise();
+			applier_flush_and_raise(applier);
 		}
 		if (applier->state == APPLIER_FINAL_JOIN &&
 		    instance_id != REPLICA_ID_NIL) {
@@ -1488,6 +1619,9 @@ applier_process_batch(struct cmsg *base)
 		}
 	}
 
+	if (txn_batch_flush(&applier->txn_batch) != 0)
+		diag_raise();
+
 	/* Return the message to applier thread. */
 	cmsg_init(&msg->base.base, return_route);
 	cpipe_push(&applier->applier_thread->thread_pipe, &msg->base.base);
@@ -1817,6 +1951,7 @@ applier_thread_attach_applier(struct cbus_call_msg *base)
 
 	lsregion_create(&applier->thread.lsr, &runtime);
 	fiber_cond_create(&applier->thread.writer_cond);
+	applier->thread.leader_tm = 0;
 	applier_thread_ibuf_init(applier);
 	applier_thread_msgs_init(applier);
 	applier_thread_fiber_init(applier);
@@ -1948,7 +2083,9 @@ applier_subscribe(struct applier *applier)
 	 */
 	uint32_t id_filter = box_is_orphan() ? 0 : 1 << instance_id;
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &vclock, replication_anon, id_filter);
+				 &vclock, replication_anon, id_filter,
+				 replication_space_filter,
+				 replication_space_filter_size);
 	coio_write_xrow(io, &row);
 
 	/* Read SUBSCRIBE response */
@@ -2020,6 +2157,7 @@ applier_subscribe(struct applier *applier)
 	/* Re-enable warnings after successful execution of SUBSCRIBE */
 	applier->last_logged_errcode = 0;
 	applier->lag = TIMEOUT_INFINITY;
+	applier->leader_tm = 0;
 
 	/** Attach the applier to a thread. */
 	struct applier_thread *thread = applier_thread_next();
@@ -2287,6 +2425,7 @@ applier_new(struct uri *uri)
 	rlist_create(&applier->on_state);
 	fiber_cond_create(&applier->resume_cond);
 	diag_create(&applier->diag);
+	txn_batch_create(&applier->txn_batch);
 
 	return applier;
 }
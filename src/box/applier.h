@@ -45,6 +45,7 @@
 #include "uri/uri.h"
 #include "small/lsregion.h"
 #include "cbus.h"
+#include "txn.h"
 
 #include "xrow.h"
 
@@ -120,6 +121,8 @@ struct applier_ack_msg {
 	 * Set to replica::applier_txn_last_tm.
 	 */
 	double txn_last_tm;
+	/** Set to applier::leader_tm. */
+	double leader_tm;
 };
 
 /** The underlying thread behind a number of appliers. */
@@ -145,6 +148,12 @@ struct applier {
 	ev_tstamp last_row_time;
 	/** Number of seconds this replica is behind the remote master */
 	ev_tstamp lag;
+	/**
+	 * Master's monotonic time received in its last heartbeat while it is
+	 * the Raft leader. Sent in ACKs to renew the leader's lease. 0 when
+	 * the master isn't the leader.
+	 */
+	double leader_tm;
 	/** The last box_error_code() logged to avoid log flooding */
 	uint32_t last_logged_errcode;
 	/** Remote instance ID. */
@@ -208,6 +217,12 @@ struct applier {
 	bool is_ack_sent;
 	/** True if ACK was signalled in tx while ack_msg was en route. */
 	bool is_ack_pending;
+	/**
+	 * Replicated transactions applied but not submitted to the journal
+	 * yet, see applier_process_batch(). Also accounts for the number of
+	 * transactions written per journal entry.
+	 */
+	struct txn_batch txn_batch;
 	/** Fields used only by applier thread. */
 	struct {
 		alignas(CACHELINE_SIZE)
@@ -248,6 +263,11 @@ struct applier {
 		 * timestamp. Sent in ACK messages. Updated by applier_ack_msg.
 		 */
 		double txn_last_tm;
+		/**
+		 * Applier thread's view of the leader timestamp. Sent in ACK
+		 * messages. Updated by applier_ack_msg.
+		 */
+		double leader_tm;
 	} thread;
 };
 
@@ -32,6 +32,8 @@
 
 #include "trivia/config.h"
 
+#include <sys/stat.h>
+
 #include "lua/utils.h" /* lua_hash() */
 #include "fiber_pool.h"
 #include <say.h>
@@ -47,6 +49,7 @@
 #include "main.h"
 #include "tuple.h"
 #include "tuple_format.h"
+#include "tuple_compression.h"
 #include "session.h"
 #include "schema.h"
 #include "engine.h"
@@ -263,6 +266,58 @@ box_check_writable_xc(void)
 		diag_raise();
 }
 
+/**
+ * Check that this instance is the Raft leader holding a valid lease and
+ * has claimed the synchronous queue in the current term.
+ */
+static int
+box_check_leader_lease(struct raft *raft)
+{
+	if (raft->state != RAFT_STATE_LEADER) {
+		diag_set(ClientError, ER_NOT_LEADER, raft->leader);
+		return -1;
+	}
+	/*
+	 * A new leader can't serve reads until it claims the synchronous
+	 * queue. Otherwise it could miss transactions confirmed by the
+	 * previous leader.
+	 */
+	if (!raft_has_lease(raft) ||
+	    txn_limbo_replica_term(&txn_limbo, instance_id) != raft->term) {
+		diag_set(ClientError, ER_NO_LEADER_LEASE);
+		return -1;
+	}
+	return 0;
+}
+
+int
+box_check_linearizable_read(struct space *space)
+{
+	if (!current_session()->is_linearizable_read)
+		return 0;
+	if (space_is_temporary(space) || space_group_id(space) == GROUP_LOCAL)
+		return 0;
+	struct raft *raft = box_raft();
+	if (!raft_is_enabled(raft)) {
+		diag_set(ClientError, ER_ELECTION_DISABLED);
+		return -1;
+	}
+	/*
+	 * Synchronous transactions which are still in the limbo may be
+	 * either confirmed or rolled back, and a read served right now
+	 * could see them before they are confirmed or miss them after.
+	 * Wait until the transactions written so far are confirmed. The
+	 * lease is checked after that since it may expire while waiting.
+	 */
+	if (!txn_limbo_is_empty(&txn_limbo)) {
+		if (box_check_leader_lease(raft) != 0)
+			return -1;
+		if (txn_limbo_wait_confirm(&txn_limbo) != 0)
+			return -1;
+	}
+	return box_check_leader_lease(raft);
+}
+
 static void
 box_check_memtx_min_tuple_size(ssize_t memtx_min_tuple_size)
 {
@@ -363,6 +418,55 @@ box_wait_ro(bool ro, double timeout)
 	return 0;
 }
 
+/** Check if the instance vclock has reached the given one. */
+static bool
+box_vclock_is_reached(const struct vclock *vclock)
+{
+	int cmp = vclock_compare_ignore0(box_vclock, vclock);
+	return cmp == 0 || cmp == 1;
+}
+
+static int
+box_wait_vclock_on_wal_write(struct trigger *trigger, void *event)
+{
+	(void)event;
+	fiber_wakeup((struct fiber *)trigger->data);
+	return 0;
+}
+
+int
+box_wait_vclock(const struct vclock *vclock, double timeout)
+{
+	if (box_vclock_is_reached(vclock))
+		return 0;
+	/*
+	 * The vclock can only be advanced by appliers, so there's no need
+	 * to check it until they write something.
+	 */
+	double deadline = ev_monotonic_now(loop()) + timeout;
+	struct trigger on_wal_write;
+	trigger_create(&on_wal_write, box_wait_vclock_on_wal_write,
+		       fiber(), NULL);
+	trigger_add(&replicaset.applier.on_wal_write, &on_wal_write);
+	int rc = 0;
+	while (!box_vclock_is_reached(vclock)) {
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			rc = -1;
+			break;
+		}
+		double now = ev_monotonic_now(loop());
+		if (now >= deadline) {
+			diag_set(ClientError, ER_TIMEOUT);
+			rc = -1;
+			break;
+		}
+		fiber_yield_timeout(deadline - now);
+	}
+	trigger_clear(&on_wal_write);
+	return rc;
+}
+
 void
 box_do_set_orphan(bool orphan)
 {
@@ -811,6 +915,74 @@ box_check_replication_threads(void)
 	return 0;
 }
 
+static enum replication_join_mode
+box_check_replication_join_mode(void)
+{
+	const char *mode = cfg_gets("replication_join_mode");
+	if (mode == NULL)
+		goto error;
+
+	if (strcmp(mode, "read_view") == 0)
+		return REPLICATION_JOIN_MODE_READ_VIEW;
+	else if (strcmp(mode, "checkpoint") == 0)
+		return REPLICATION_JOIN_MODE_CHECKPOINT;
+
+error:
+	diag_set(ClientError, ER_CFG, "replication_join_mode",
+		 "the value must be one of the following strings: "
+		 "'read_view', 'checkpoint'");
+	return REPLICATION_JOIN_MODE_INVALID;
+}
+
+/**
+ * Check box.cfg.replication_space_filter and, if @a filter isn't
+ * NULL, return the space ids in a malloc'ed array.
+ */
+static int
+box_check_replication_space_filter(uint32_t **filter, uint32_t *filter_size)
+{
+	int size = cfg_getarr_size("replication_space_filter");
+	uint32_t *ids = NULL;
+	if (size > 0)
+		ids = (uint32_t *)xcalloc(size, sizeof(*ids));
+	for (int i = 0; i < size; i++) {
+		const char *str = cfg_getarr_elem("replication_space_filter",
+						  i);
+		char *end;
+		errno = 0;
+		unsigned long long id = str != NULL ?
+					strtoull(str, &end, 10) : 0;
+		if (str == NULL || *end != '\0' || errno != 0 ||
+		    id <= BOX_SYSTEM_ID_MAX || id >= BOX_SPACE_MAX) {
+			free(ids);
+			diag_set(ClientError, ER_CFG,
+				 "replication_space_filter",
+				 "the value must be a list of user space ids");
+			return -1;
+		}
+		ids[i] = id;
+	}
+	/*
+	 * A filtering replica doesn't store all rows, so it may
+	 * neither ack them for the synchronous quorum nor pin WAL
+	 * files in the master's GC, which anonymous replicas don't.
+	 */
+	if (size > 0 && cfg_geti("replication_anon") == 0) {
+		free(ids);
+		diag_set(ClientError, ER_CFG, "replication_space_filter",
+			 "the value may be set only when replication_anon "
+			 "is true");
+		return -1;
+	}
+	if (filter == NULL) {
+		free(ids);
+		return 0;
+	}
+	*filter = ids;
+	*filter_size = size;
+	return 0;
+}
+
 static int
 box_check_listen(void)
 {
@@ -1036,6 +1208,11 @@ box_check_replication_anon(void)
 			  "the value may be set to true only when "
 			  "the instance is read-only");
 	}
+	if (!anon && cfg_getarr_size("replication_space_filter") > 0) {
+		tnt_raise(ClientError, ER_CFG, "replication_anon",
+			  "the value may be set to false only when "
+			  "replication_space_filter is empty");
+	}
 	return anon;
 }
 
@@ -1088,6 +1265,59 @@ box_check_wal_cleanup_delay(void)
 	return value;
 }
 
+static int64_t
+box_check_wal_retention_size(void)
+{
+	int64_t size = cfg_geti64("wal_retention_size");
+	if (size < 0) {
+		diag_set(ClientError, ER_CFG, "wal_retention_size",
+			 "value must be >= 0");
+		return -1;
+	}
+	if (size > 0 && cfg_gets("wal_archive_dir") == NULL) {
+		diag_set(ClientError, ER_CFG, "wal_retention_size",
+			 "wal_archive_dir must be set");
+		return -1;
+	}
+	return size;
+}
+
+/**
+ * Create the WAL archive directory unless it exists so that
+ * WAL files can be moved there, see wal_set_retention_size().
+ */
+static int
+box_init_wal_archive_dir(void)
+{
+	const char *dirname = cfg_gets("wal_archive_dir");
+	if (dirname == NULL)
+		return 0;
+	if (*dirname == '\0') {
+		diag_set(ClientError, ER_CFG, "wal_archive_dir",
+			 "must not be empty");
+		return -1;
+	}
+	char path[PATH_MAX];
+	snprintf(path, sizeof(path), "%s/", dirname);
+	if (mkdirpath(path) != 0) {
+		diag_set(SystemError, "failed to create directory '%s'",
+			 dirname);
+		return -1;
+	}
+	struct stat st;
+	if (stat(dirname, &st) != 0) {
+		diag_set(SystemError, "failed to stat directory '%s'",
+			 dirname);
+		return -1;
+	}
+	if (!S_ISDIR(st.st_mode)) {
+		diag_set(ClientError, ER_CFG, "wal_archive_dir",
+			 "not a directory");
+		return -1;
+	}
+	return 0;
+}
+
 static void
 box_check_readahead(int readahead)
 {
@@ -1131,6 +1361,50 @@ box_check_memory_quota(const char *quota_name)
 	return -1;
 }
 
+static int
+box_check_vinyl_max_subcompactions(void)
+{
+	int max_subcompactions = cfg_geti("vinyl_max_subcompactions");
+	if (max_subcompactions < 1) {
+		tnt_raise(ClientError, ER_CFG, "vinyl_max_subcompactions",
+			  "must be greater than or equal to 1");
+	}
+	return max_subcompactions;
+}
+
+static double
+box_check_memtx_defrag_threshold(void)
+{
+	double threshold = cfg_getd("memtx_defrag_threshold");
+	if (threshold < 0 || threshold >= 1) {
+		tnt_raise(ClientError, ER_CFG, "memtx_defrag_threshold",
+			  "must be greater than or equal to 0 and less than 1");
+	}
+	return threshold;
+}
+
+static double
+box_check_memtx_defrag_rate(void)
+{
+	double rate = cfg_getd("memtx_defrag_rate");
+	if (rate <= 0) {
+		tnt_raise(ClientError, ER_CFG, "memtx_defrag_rate",
+			  "must be greater than 0");
+	}
+	return rate;
+}
+
+static int64_t
+box_check_vinyl_bloom_memory(void)
+{
+	int64_t bloom_memory = cfg_geti64("vinyl_bloom_memory");
+	if (bloom_memory < 0) {
+		tnt_raise(ClientError, ER_CFG, "vinyl_bloom_memory",
+			  "must be greater than or equal to 0");
+	}
+	return bloom_memory;
+}
+
 static void
 box_check_vinyl_options(void)
 {
@@ -1144,6 +1418,8 @@ box_check_vinyl_options(void)
 
 	if (box_check_memory_quota("vinyl_memory") < 0)
 		diag_raise();
+	box_check_vinyl_max_subcompactions();
+	box_check_vinyl_bloom_memory();
 
 	if (read_threads < 1) {
 		tnt_raise(ClientError, ER_CFG, "vinyl_read_threads",
@@ -1271,6 +1547,10 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_replication_threads() < 0)
 		diag_raise();
+	if (box_check_replication_join_mode() == REPLICATION_JOIN_MODE_INVALID)
+		diag_raise();
+	if (box_check_replication_space_filter(NULL, NULL) != 0)
+		diag_raise();
 	box_check_replication_sync_timeout();
 	box_check_readahead(cfg_geti("readahead"));
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
@@ -1280,9 +1560,13 @@ box_check_config(void)
 		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
+	if (box_check_wal_retention_size() < 0)
+		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
+	box_check_memtx_defrag_threshold();
+	box_check_memtx_defrag_rate();
 	if (box_check_allocator() != 0)
 		diag_raise();
 	box_check_small_alloc_options();
@@ -1317,6 +1601,12 @@ box_set_election_timeout(void)
 	return 0;
 }
 
+void
+box_set_election_leader_lease(void)
+{
+	raft_cfg_is_lease_enabled(box_raft(), cfg_geti("election_leader_lease"));
+}
+
 /*
  * Sync box.cfg.replication with the cluster registry, but
  * don't start appliers.
@@ -2002,6 +2292,25 @@ box_set_memtx_max_tuple_size(void)
 			cfg_geti("memtx_max_tuple_size"));
 }
 
+void
+box_set_memtx_defrag_threshold(void)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_defrag_threshold(memtx,
+			box_check_memtx_defrag_threshold());
+}
+
+void
+box_set_memtx_defrag_rate(void)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_defrag_rate(memtx, box_check_memtx_defrag_rate());
+}
+
 void
 box_set_too_long_threshold(void)
 {
@@ -2069,6 +2378,16 @@ box_set_wal_cleanup_delay(void)
 	return 0;
 }
 
+int
+box_set_wal_retention_size(void)
+{
+	int64_t size = box_check_wal_retention_size();
+	if (size < 0)
+		return -1;
+	wal_set_retention_size(size);
+	return 0;
+}
+
 void
 box_set_vinyl_memory(void)
 {
@@ -2105,6 +2424,23 @@ box_set_vinyl_timeout(void)
 	vinyl_engine_set_timeout(vinyl,	cfg_getd("vinyl_timeout"));
 }
 
+void
+box_set_vinyl_max_subcompactions(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_max_subcompactions(vinyl,
+			box_check_vinyl_max_subcompactions());
+}
+
+void
+box_set_vinyl_bloom_memory(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_bloom_memory(vinyl, box_check_vinyl_bloom_memory());
+}
+
 void
 box_set_net_msg_max(void)
 {
@@ -2310,6 +2646,9 @@ box_process1(struct request *request, box_tuple_t **result)
 			diag_log();
 			return -1;
 		}
+		if (space->format->is_compressed &&
+		    tuple_compression_check_request(request) != 0)
+			return -1;
 	}
 
 	return box_process_rw(request, space, result);
@@ -2340,6 +2679,8 @@ box_select(uint32_t space_id, uint32_t index_id,
 	struct index *index = index_find(space, index_id);
 	if (index == NULL)
 		return -1;
+	if (box_check_linearizable_read(space) != 0)
+		return -1;
 
 	enum iterator_type type = (enum iterator_type) iterator;
 	uint32_t part_count = key ? mp_decode_array(&key) : 0;
@@ -2519,6 +2860,177 @@ box_truncate(uint32_t space_id)
 	}
 }
 
+/** Number of rows written to WAL in one transaction by a bulk load. */
+enum { BULK_LOAD_WAL_BATCH_SIZE = 1000 };
+
+/**
+ * Write rows inserting the given tuples to WAL, in transactions of
+ * BULK_LOAD_WAL_BATCH_SIZE rows. Returns the number of rows that
+ * were written. If it is less than @a count, diag is set.
+ */
+static uint32_t
+bulk_load_write_wal(struct space *space, const char *data, uint32_t count)
+{
+	struct region *region = &fiber()->gc;
+	uint32_t written = 0;
+	while (written < count) {
+		uint32_t n_rows = MIN(count - written,
+				      (uint32_t)BULK_LOAD_WAL_BATCH_SIZE);
+		size_t region_svp = region_used(region);
+		struct journal_entry *entry = journal_entry_new(
+			n_rows, region, journal_entry_fiber_wakeup_cb, fiber());
+		if (entry == NULL)
+			break;
+		uint32_t i;
+		for (i = 0; i < n_rows; i++) {
+			size_t size;
+			struct xrow_header *row = region_alloc_object(
+				region, struct xrow_header, &size);
+			if (row == NULL) {
+				diag_set(OutOfMemory, size,
+					 "region_alloc_object", "row");
+				break;
+			}
+			struct request request;
+			memset(&request, 0, sizeof(request));
+			request.type = IPROTO_INSERT;
+			request.space_id = space_id(space);
+			request.tuple = data;
+			mp_next(&data);
+			request.tuple_end = data;
+			memset(row, 0, sizeof(*row));
+			row->type = IPROTO_INSERT;
+			row->group_id = space_group_id(space);
+			row->bodycnt = xrow_encode_dml(&request, region,
+						       row->body);
+			if (row->bodycnt < 0)
+				break;
+			entry->rows[i] = row;
+			entry->approx_len += xrow_approx_len(row);
+		}
+		if (i < n_rows)
+			break;
+		/*
+		 * Like an asynchronous transaction, a batch must not
+		 * be written while there are synchronous transactions
+		 * waiting for confirmation. Flush the journal queue
+		 * beforehand so that nothing yields between the check
+		 * and submitting the entry to the journal.
+		 */
+		do {
+			if (txn_limbo_wait_empty(&txn_limbo,
+						 TIMEOUT_INFINITY) != 0)
+				break;
+			journal_queue_flush();
+		} while (!txn_limbo_is_empty(&txn_limbo));
+		if (!txn_limbo_is_empty(&txn_limbo))
+			break;
+		if (journal_write(entry) != 0)
+			break;
+		if (entry->res < 0) {
+			diag_set_journal_res(entry->res);
+			break;
+		}
+		region_truncate(region, region_svp);
+		written += n_rows;
+	}
+	return written;
+}
+
+API_EXPORT int
+box_space_bulk_load(uint32_t space_id, const char *data,
+		    const char *data_end)
+{
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return -1;
+	if (!space_is_temporary(space) &&
+	    space_group_id(space) != GROUP_LOCAL &&
+	    box_check_writable() != 0)
+		return -1;
+	if (access_check_space(space, PRIV_W) != 0)
+		return -1;
+	if (!space_is_memtx(space) || space->def->opts.is_ephemeral) {
+		diag_set(ClientError, ER_UNSUPPORTED, space->engine->name,
+			 "bulk load");
+		return -1;
+	}
+	if (in_txn() != NULL) {
+		diag_set(ClientError, ER_ACTIVE_TRANSACTION);
+		return -1;
+	}
+	/*
+	 * Tuples are inserted directly into indexes, bypassing
+	 * transactions, so everything that hooks into a statement
+	 * must be absent.
+	 */
+	if (space_is_system(space) || space->sequence != NULL ||
+	    space->def->opts.is_sync || !txn_limbo_is_empty(&txn_limbo) ||
+	    !rlist_empty(&space->before_replace) ||
+	    !rlist_empty(&space->on_replace) ||
+	    !rlist_empty(&space->parent_fk_constraint) ||
+	    !rlist_empty(&space->child_fk_constraint)) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memtx",
+			 "bulk load into a system or synchronous space, "
+			 "a space with triggers, constraints or a sequence, "
+			 "or while the limbo is not empty");
+		return -1;
+	}
+	if (memtx_space_is_recovering(space)) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Snapshot recovery",
+			 "bulk load");
+		return -1;
+	}
+	if (mp_typeof(*data) != MP_ARRAY) {
+		diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+		return -1;
+	}
+	uint32_t count = mp_decode_array(&data);
+	size_t size = count * sizeof(struct tuple *);
+	struct tuple **tuples = (struct tuple **)malloc(size);
+	if (tuples == NULL && count > 0) {
+		diag_set(OutOfMemory, size, "malloc", "tuples");
+		return -1;
+	}
+	int rc = -1;
+	uint32_t n_tuples = 0;
+	uint32_t written;
+	const char *tuple = data;
+	for (; n_tuples < count; n_tuples++) {
+		if (tuple == data_end || mp_typeof(*tuple) != MP_ARRAY) {
+			diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+			goto out;
+		}
+		const char *tuple_end = tuple;
+		mp_next(&tuple_end);
+		struct tuple *t = space->format->vtab.tuple_new(
+			space->format, tuple, tuple_end);
+		if (t == NULL)
+			goto out;
+		/* The reference is passed to the space on success. */
+		tuple_ref(t);
+		tuples[n_tuples] = t;
+		tuple = tuple_end;
+	}
+	if (memtx_space_bulk_load_begin(space, tuples, count) != 0)
+		goto out;
+	written = space_is_temporary(space) ? count :
+		  bulk_load_write_wal(space, data, count);
+	/*
+	 * Rows that failed to reach WAL are removed so that the
+	 * space contents match the log.
+	 */
+	memtx_space_bulk_load_end(space, tuples + written, count - written);
+	rc = written == count ? 0 : -1;
+	n_tuples = count - written;
+	memmove(tuples, tuples + written, n_tuples * sizeof(*tuples));
+out:
+	for (uint32_t i = 0; i < n_tuples; i++)
+		tuple_unref(tuples[i]);
+	free(tuples);
+	return rc;
+}
+
 /** Update a record in _sequence_data space. */
 static int
 sequence_data_update(uint32_t seq_id, int64_t value)
@@ -2808,6 +3320,33 @@ box_process_register(struct iostream *io, const struct xrow_header *header)
 	gc_guard.is_active = false;
 }
 
+/** space_foreach() callback that stops at the first vinyl space. */
+static int
+box_find_vinyl_space(struct space *space, void *udata)
+{
+	(void)udata;
+	return space_is_vinyl(space) ? 1 : 0;
+}
+
+/**
+ * Return the checkpoint to send to a replica asking for
+ * checkpoint join or NULL if the master must fall back on
+ * sending rows from a read view.
+ */
+static struct gc_checkpoint *
+box_join_checkpoint(void)
+{
+	/*
+	 * Only the memtx snapshot file is sent, so the data
+	 * stored by vinyl in its own files would be lost.
+	 */
+	if (space_foreach(box_find_vinyl_space, NULL) != 0) {
+		diag_clear(diag_get());
+		return NULL;
+	}
+	return gc_last_checkpoint();
+}
+
 void
 box_process_join(struct iostream *io, const struct xrow_header *header)
 {
@@ -2845,6 +3384,19 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	 * <= OK { VCLOCK: current_vclock } - end of final JOIN stage.
 	 *      - `current_vclock` - master's vclock after final stage.
 	 *
+	 * If the replica sets CHECKPOINT_JOIN in the request, the
+	 * master may send its last checkpoint instead of initial data:
+	 *
+	 * <= OK { VCLOCK: start_vclock } - vclock of the checkpoint.
+	 * <= JOIN_FILE { DATA: chunk }
+	 *    ...
+	 *    Memtx snapshot file split into chunks.
+	 *    ...
+	 * <= JOIN_FILE { DATA: chunk }
+	 *
+	 * The rest of the protocol stays the same: the final stream
+	 * starts at the checkpoint vclock.
+	 *
 	 * All packets must have the same SYNC value as initial JOIN request.
 	 * Master can send ERROR at any time. Replica doesn't confirm rows
 	 * by OKs. Either initial or final stream includes:
@@ -2858,7 +3410,9 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	/* Decode JOIN request */
 	struct tt_uuid instance_uuid;
 	uint32_t replica_version_id;
-	xrow_decode_join_xc(header, &instance_uuid, &replica_version_id);
+	bool checkpoint_join;
+	xrow_decode_join_xc(header, &instance_uuid, &replica_version_id,
+			    &checkpoint_join);
 
 	/* Check that bootstrap has been finished */
 	if (!is_box_configured)
@@ -2890,12 +3444,30 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 			  "wal_mode = 'none'");
 	}
 
+	/*
+	 * Pin the checkpoint sent to the replica so that it isn't
+	 * removed by garbage collection while the file is sent.
+	 */
+	struct gc_checkpoint *checkpoint = NULL;
+	struct gc_checkpoint_ref checkpoint_ref;
+	if (checkpoint_join)
+		checkpoint = box_join_checkpoint();
+	if (checkpoint != NULL) {
+		gc_ref_checkpoint(checkpoint, &checkpoint_ref, "replica %s",
+				  tt_uuid_str(&instance_uuid));
+	}
+	auto checkpoint_guard = make_scoped_guard([&] {
+		if (checkpoint != NULL)
+			gc_unref_checkpoint(&checkpoint_ref);
+	});
+
 	/*
 	 * Register the replica as a WAL consumer so that
 	 * it can resume FINAL JOIN where INITIAL JOIN ends.
 	 */
-	struct gc_consumer *gc = gc_consumer_register(&replicaset.vclock,
-				"replica %s", tt_uuid_str(&instance_uuid));
+	struct gc_consumer *gc = gc_consumer_register(
+		checkpoint != NULL ? &checkpoint->vclock : &replicaset.vclock,
+		"replica %s", tt_uuid_str(&instance_uuid));
 	if (gc == NULL)
 		diag_raise();
 	auto gc_guard = make_scoped_guard([&] { gc_consumer_unregister(gc); });
@@ -2903,12 +3475,30 @@ box_process_join(struct iostream *io, const struct xrow_header *header)
 	say_info("joining replica %s at %s",
 		 tt_uuid_str(&instance_uuid), sio_socketname(io->fd));
 
-	/*
-	 * Initial stream: feed replica with dirty data from engines.
-	 */
 	struct vclock start_vclock;
-	relay_initial_join(io, header->sync, &start_vclock,
-			   replica_version_id);
+	if (checkpoint != NULL) {
+		/*
+		 * Initial stream: feed replica with the last
+		 * checkpoint file.
+		 */
+		vclock_copy(&start_vclock, &checkpoint->vclock);
+		struct memtx_engine *memtx =
+			(struct memtx_engine *)engine_by_name("memtx");
+		char filename[PATH_MAX];
+		strlcpy(filename,
+			xdir_format_filename(&memtx->snap_dir,
+					     vclock_sum(&start_vclock), NONE),
+			sizeof(filename));
+		relay_initial_join_checkpoint(io, header->sync, &start_vclock,
+					      filename);
+	} else {
+		/*
+		 * Initial stream: feed replica with dirty data
+		 * from engines.
+		 */
+		relay_initial_join(io, header->sync, &start_vclock,
+				   replica_version_id);
+	}
 	say_info("initial data sent.");
 
 	/**
@@ -2969,9 +3559,10 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	uint32_t replica_version_id;
 	bool anon;
 	uint32_t id_filter;
+	const char *space_filter;
 	xrow_decode_subscribe_xc(header, &peer_replicaset_uuid, &replica_uuid,
 				 &replica_clock, &replica_version_id, &anon,
-				 &id_filter);
+				 &id_filter, &space_filter);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -2997,6 +3588,19 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 			  "non-anonymous followers.");
 	}
 
+	/*
+	 * A replica that skips rows must not count towards the
+	 * synchronous quorum, so only anonymous ones may filter.
+	 */
+	if (space_filter != NULL && !anon) {
+		const char *data = space_filter;
+		if (mp_decode_array(&data) > 0) {
+			tnt_raise(ClientError, ER_UNSUPPORTED,
+				  "Replication space filter",
+				  "non-anonymous replicas");
+		}
+	}
+
 	/* Check permissions */
 	access_check_universe_xc(PRIV_R);
 
@@ -3113,7 +3717,7 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &replica_clock,
-			replica_version_id, id_filter);
+			replica_version_id, id_filter, space_filter);
 }
 
 void
@@ -3172,6 +3776,7 @@ box_free(void)
 		wal_free();
 		audit_log_free();
 		sql_built_in_functions_cache_free();
+		tuple_compression_free();
 	}
 }
 
@@ -3190,11 +3795,14 @@ engine_init()
 				    cfg_getd("memtx_memory"),
 				    cfg_geti("memtx_min_tuple_size"),
 				    cfg_geti("strip_core"),
+				    cfg_getb("memtx_use_hugepages"),
 				    cfg_geti("slab_alloc_granularity"),
 				    cfg_gets("memtx_allocator"),
 				    cfg_getd("slab_alloc_factor"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
+	box_set_memtx_defrag_threshold();
+	box_set_memtx_defrag_rate();
 
 	struct sysview_engine *sysview = sysview_engine_new_xc();
 	engine_register((struct engine *)sysview);
@@ -3215,6 +3823,8 @@ engine_init()
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
 	box_set_vinyl_timeout();
+	box_set_vinyl_max_subcompactions();
+	box_set_vinyl_bloom_memory();
 }
 
 /**
@@ -3424,8 +4034,8 @@ local_recovery(const struct tt_uuid *instance_uuid,
 
 	struct recovery *recovery;
 	bool is_force_recovery = cfg_geti("force_recovery");
-	recovery = recovery_new(wal_dir(), is_force_recovery,
-				checkpoint_vclock);
+	recovery = recovery_new(wal_dir(), wal_archive_dir(),
+				is_force_recovery, checkpoint_vclock);
 
 	/*
 	 * Make sure we report the actual recovery position
@@ -3628,6 +4238,8 @@ box_init(void)
 
 	if (tuple_init(lua_hash) != 0)
 		diag_raise();
+	if (tuple_compression_init() != 0)
+		diag_raise();
 
 	txn_limbo_init();
 	sequence_init();
@@ -3664,8 +4276,10 @@ box_cfg_xc(void)
 
 	int64_t wal_max_size = box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	enum wal_mode wal_mode = box_check_wal_mode(cfg_gets("wal_mode"));
-	if (wal_init(wal_mode, cfg_gets("wal_dir"), wal_max_size,
-		     &INSTANCE_UUID, on_wal_garbage_collection,
+	if (box_init_wal_archive_dir() != 0)
+		diag_raise();
+	if (wal_init(wal_mode, cfg_gets("wal_dir"), cfg_gets("wal_archive_dir"),
+		     wal_max_size, &INSTANCE_UUID, on_wal_garbage_collection,
 		     on_wal_checkpoint_threshold) != 0) {
 		diag_raise();
 	}
@@ -3692,6 +4306,12 @@ box_cfg_xc(void)
 	box_set_replication_sync_timeout();
 	box_set_replication_skip_conflict();
 	box_set_replication_anon();
+	replication_join_mode = box_check_replication_join_mode();
+	if (replication_join_mode == REPLICATION_JOIN_MODE_INVALID)
+		diag_raise();
+	if (box_check_replication_space_filter(&replication_space_filter,
+					       &replication_space_filter_size) != 0)
+		diag_raise();
 
 	struct gc_checkpoint *checkpoint = gc_last_checkpoint();
 
@@ -3788,6 +4408,7 @@ box_cfg_xc(void)
 
 	if (box_set_election_timeout() != 0)
 		diag_raise();
+	box_set_election_leader_lease();
 	/*
 	 * Election is enabled last. So as all the parameters are installed by
 	 * that time.
@@ -117,6 +117,19 @@ box_is_ro(void);
 bool
 box_is_orphan(void);
 
+/**
+ * Check if a read from the given space can be served by this instance when
+ * the current session requires linearizable reads. It can if the instance is
+ * the Raft leader holding a valid lease. If the limbo isn't empty, the
+ * function waits until the synchronous transactions written so far are
+ * confirmed, so it may yield. Reads from spaces which aren't replicated
+ * are always allowed.
+ * \retval -1 the read is not allowed, the diag is set
+ * \retval 0 success
+ */
+int
+box_check_linearizable_read(struct space *space);
+
 /**
  * Wait until the instance switches to a desired mode.
  * \param ro wait read-only if set or read-write if unset
@@ -127,6 +140,19 @@ box_is_orphan(void);
 int
 box_wait_ro(bool ro, double timeout);
 
+/**
+ * Wait until the instance vclock reaches the given one, not taking
+ * into account the 0th component. Used to serve reads from replicas
+ * with causal consistency: a client passes the vclock returned by
+ * the master on commit, so that it can see its own writes.
+ * \param vclock vclock to wait for
+ * \param timeout max time to wait
+ * \retval -1 timeout or fiber is cancelled
+ * \retval 0 success
+ */
+int
+box_wait_vclock(const struct vclock *vclock, double timeout);
+
 /**
  * Switch this instance from 'orphan' to 'running' state or
  * vice versa depending on the value of the function argument.
@@ -258,14 +284,20 @@ void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
 int box_set_wal_queue_max_size(void);
 int box_set_wal_cleanup_delay(void);
+int box_set_wal_retention_size(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
+void box_set_memtx_defrag_threshold(void);
+void box_set_memtx_defrag_rate(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
 void box_set_vinyl_timeout(void);
+void box_set_vinyl_max_subcompactions(void);
+void box_set_vinyl_bloom_memory(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
+void box_set_election_leader_lease(void);
 void box_set_replication_timeout(void);
 void box_set_replication_connect_timeout(void);
 void box_set_replication_connect_quorum(void);
@@ -474,6 +506,31 @@ box_upsert(uint32_t space_id, uint32_t index_id, const char *tuple,
 API_EXPORT int
 box_truncate(uint32_t space_id);
 
+/**
+ * Load tuples into an empty memtx space.
+ *
+ * Unlike a series of INSERT requests, the tuples are inserted into
+ * indexes at once: tree indexes are built by sorting all keys.
+ * The tuples are written to WAL as INSERT rows in transactions of
+ * up to a thousand rows each. Other writes to the space are
+ * rejected until the function returns.
+ *
+ * The space must not be a system or synchronous one, have
+ * triggers, foreign keys, a sequence or functional indexes.
+ * The function can't be called in a transaction.
+ *
+ * \param space_id space identifier
+ * \param data encoded tuples in MsgPack Array format
+ * ([ [ field1, field2, ...], ... ])
+ * \param data_end end of @a data
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ * \sa \code box.space[space_id]:bulk_load(tuples) \endcode
+ */
+API_EXPORT int
+box_space_bulk_load(uint32_t space_id, const char *data,
+		    const char *data_end);
+
 /**
  * Advance a sequence.
  *
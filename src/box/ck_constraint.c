@@ -200,7 +200,8 @@ ck_constraint_on_replace_trigger(struct trigger *trigger, void *event)
 			 "field_ref");
 		return -1;
 	}
-	vdbe_field_ref_prepare_tuple(field_ref, new_tuple);
+	if (vdbe_field_ref_prepare_tuple(field_ref, new_tuple) != 0)
+		return -1;
 
 	struct ck_constraint *ck_constraint;
 	rlist_foreach_entry(ck_constraint, &space->ck_constraint, link) {
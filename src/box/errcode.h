@@ -286,6 +286,8 @@ struct errcode_record {
 	/*231 */_(ER_TRANSACTION_TIMEOUT,       "Transaction has been aborted by timeout") \
 	/*232 */_(ER_ACTIVE_TIMER,              "Operation is not permitted if timer is already running") \
 	/*233 */_(ER_TUPLE_FIELD_COUNT_LIMIT,	"Tuple field count limit reached: see box.schema.FIELD_MAX") \
+	/*234 */_(ER_NO_LEADER_LEASE,		"The leader doesn't hold a lease to serve linearizable reads") \
+	/*235 */_(ER_TRANSACTION_READ_ONLY,	"Can't modify data in a read-only transaction") \
 
 /*
  * !IMPORTANT! Please follow instructions at start of the file
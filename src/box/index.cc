@@ -39,6 +39,7 @@
 #include "rmean.h"
 #include "info/info.h"
 #include "memtx_tx.h"
+#include "box.h"
 
 /* {{{ Utilities. **********************************************/
 
@@ -175,7 +176,7 @@ check_index(uint32_t space_id, uint32_t index_id,
 	*index = index_find(*space, index_id);
 	if (*index == NULL)
 		return -1;
-	return 0;
+	return box_check_linearizable_read(*space);
 }
 
 /* }}} */
@@ -502,6 +503,7 @@ index_create(struct index *index, struct engine *engine,
 	index->dense_id = UINT32_MAX;
 	rlist_create(&index->nearby_gaps);
 	rlist_create(&index->full_scans);
+	rlist_create(&index->read_ranges);
 	return 0;
 }
 
@@ -520,6 +522,40 @@ index_delete(struct index *index)
 	index_def_delete(def);
 }
 
+int
+index_read_view_create(struct index_read_view *rv,
+		       const struct index_read_view_vtab *vtab,
+		       const struct index_def *def)
+{
+	rv->vtab = vtab;
+	rv->def = index_def_dup(def);
+	if (rv->def == NULL)
+		return -1;
+	return 0;
+}
+
+void
+index_read_view_destroy(struct index_read_view *rv)
+{
+	index_def_delete(rv->def);
+	TRASH(rv);
+}
+
+struct snapshot_iterator *
+index_read_view_create_iterator(struct index_read_view *rv,
+				enum iterator_type type,
+				const char *key, uint32_t part_count)
+{
+	if (type < 0 || type >= iterator_type_MAX) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "Invalid iterator type");
+		return NULL;
+	}
+	if (key_validate(rv->def, type, key, part_count) != 0)
+		return NULL;
+	return rv->vtab->create_iterator(rv, type, key, part_count);
+}
+
 int
 index_build(struct index *index, struct index *pk)
 {
@@ -729,6 +765,13 @@ generic_index_create_snapshot_iterator(struct index *index)
 	return NULL;
 }
 
+struct index_read_view *
+generic_index_create_read_view(struct index *index)
+{
+	diag_set(UnsupportedIndexFeature, index->def, "read view");
+	return NULL;
+}
+
 void
 generic_index_stat(struct index *index, struct info_handler *handler)
 {
@@ -302,6 +302,33 @@ struct snapshot_iterator {
 	void (*free)(struct snapshot_iterator *);
 };
 
+struct index_read_view;
+
+/** Virtual function table of an index read view. */
+struct index_read_view_vtab {
+	/** Destroy the read view. */
+	void (*free)(struct index_read_view *rv);
+	/**
+	 * Create an iterator over the read view. The iterator
+	 * must be destroyed before the read view.
+	 */
+	struct snapshot_iterator *(*create_iterator)(
+		struct index_read_view *rv, enum iterator_type type,
+		const char *key, uint32_t part_count);
+};
+
+/**
+ * Frozen state of an index: further index modifications don't
+ * affect iterators created over it.
+ * \sa index::create_read_view().
+ */
+struct index_read_view {
+	/** Virtual function table. */
+	const struct index_read_view_vtab *vtab;
+	/** Copy of the index definition. */
+	struct index_def *def;
+};
+
 /**
  * Check that the key has correct part count and correct part size
  * for use in an index iterator.
@@ -436,6 +463,13 @@ struct index_vtab {
 	 * Must be destroyed by iterator_delete() after usage.
 	 */
 	struct snapshot_iterator *(*create_snapshot_iterator)(struct index *);
+	/**
+	 * Create a read view of the index. Unlike a snapshot
+	 * iterator, a read view can be iterated any number of times
+	 * and supports iterator types other than ALL. Must be
+	 * destroyed with index_read_view_delete() after usage.
+	 */
+	struct index_read_view *(*create_read_view)(struct index *);
 	/** Introspection (index:stat()) */
 	void (*stat)(struct index *, struct info_handler *);
 	/**
@@ -483,6 +517,11 @@ struct index {
 	struct rlist nearby_gaps;
 	/** List of full scans of the index. @sa struct full_scan_item. */
 	struct rlist full_scans;
+	/**
+	 * List of range_item's describing intervals of the index read
+	 * with iterators. @sa struct range_item.
+	 */
+	struct rlist read_ranges;
 };
 
 /**
@@ -692,6 +731,41 @@ index_create_snapshot_iterator(struct index *index)
 	return index->vtab->create_snapshot_iterator(index);
 }
 
+static inline struct index_read_view *
+index_create_read_view(struct index *index)
+{
+	return index->vtab->create_read_view(index);
+}
+
+/**
+ * Initialize the base part of an index read view.
+ * Returns -1 and sets diag on memory allocation error.
+ */
+int
+index_read_view_create(struct index_read_view *rv,
+		       const struct index_read_view_vtab *vtab,
+		       const struct index_def *def);
+
+/** Destroy the base part of an index read view. */
+void
+index_read_view_destroy(struct index_read_view *rv);
+
+static inline void
+index_read_view_delete(struct index_read_view *rv)
+{
+	rv->vtab->free(rv);
+}
+
+/**
+ * Create an iterator over an index read view. Checks the key
+ * and the iterator type the same way as index_create_iterator()
+ * callers do.
+ */
+struct snapshot_iterator *
+index_read_view_create_iterator(struct index_read_view *rv,
+				enum iterator_type type,
+				const char *key, uint32_t part_count);
+
 static inline void
 index_stat(struct index *index, struct info_handler *handler)
 {
@@ -757,6 +831,7 @@ int generic_index_replace(struct index *, struct tuple *, struct tuple *,
 			  enum dup_replace_mode,
 			  struct tuple **, struct tuple **);
 struct snapshot_iterator *generic_index_create_snapshot_iterator(struct index *);
+struct index_read_view *generic_index_create_read_view(struct index *);
 void generic_index_stat(struct index *, struct info_handler *);
 void generic_index_compact(struct index *);
 void generic_index_reset_stat(struct index *);
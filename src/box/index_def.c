@@ -39,6 +39,8 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *hash_index_table_type_strs[] = { "LIGHT", "SWISS" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -48,10 +50,16 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .read_ahead          = */ 0,
+	/* .compression_level   = */ 3,
+	/* .covering            = */ false,
 	/* .lsn                 = */ 0,
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
 	/* .hint                = */ true,
+	/* .wide_hint           = */ false,
+	/* .inline_key          = */ false,
+	/* .hash_table          = */ HASH_INDEX_TABLE_LIGHT,
 };
 
 const struct opt_def index_opts_reg[] = {
@@ -64,10 +72,18 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF("read_ahead", OPT_INT64, struct index_opts, read_ahead),
+	OPT_DEF("compression_level", OPT_INT64, struct index_opts,
+		compression_level),
+	OPT_DEF("covering", OPT_BOOL, struct index_opts, covering),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
 	OPT_DEF("hint", OPT_BOOL, struct index_opts, hint),
+	OPT_DEF("wide_hint", OPT_BOOL, struct index_opts, wide_hint),
+	OPT_DEF("inline_key", OPT_BOOL, struct index_opts, inline_key),
+	OPT_DEF_ENUM("hash_table", hash_index_table_type, struct index_opts,
+		     hash_table, NULL),
 	OPT_END,
 };
 
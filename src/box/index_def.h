@@ -58,6 +58,15 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+enum hash_index_table_type {
+	/* Chained hash table, see salad/light.h */
+	HASH_INDEX_TABLE_LIGHT,
+	/* Open addressing with SIMD group probing, see salad/swiss.h */
+	HASH_INDEX_TABLE_SWISS,
+	hash_index_table_type_MAX
+};
+extern const char *hash_index_table_type_strs[];
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -153,6 +162,21 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/**
+	 * Max number of pages a range scan may read in advance
+	 * once it detects sequential access. 0 disables read-ahead.
+	 */
+	int64_t read_ahead;
+	/**
+	 * Zstd compression level used for writing compacted runs.
+	 * 0 disables compression.
+	 */
+	int64_t compression_level;
+	/**
+	 * Store full tuples in a vinyl secondary index so that
+	 * reads from it don't need to look up the primary index.
+	 */
+	bool covering;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -169,6 +193,23 @@ struct index_opts {
 	 * Use hint optimization for tree index.
 	 */
 	bool hint;
+	/**
+	 * Store a second comparison hint in each tree element.
+	 * Makes sense only along with hint.
+	 */
+	bool wide_hint;
+	/**
+	 * Store the first key part in tree elements as far as it
+	 * fits in two comparison hints, see tuple_inline_key_hint().
+	 * Equality is decided without looking into tuples only in
+	 * unique non-nullable single-part indexes, others use it
+	 * for ordering. Makes sense only along with hint.
+	 */
+	bool inline_key;
+	/**
+	 * Hash table implementation used by memtx HASH index.
+	 */
+	enum hash_index_table_type hash_table;
 };
 
 extern const struct index_opts index_opts_default;
@@ -213,10 +254,23 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->read_ahead != o2->read_ahead)
+		return o1->read_ahead < o2->read_ahead ? -1 : 1;
+	if (o1->compression_level != o2->compression_level)
+		return o1->compression_level < o2->compression_level ?
+		       -1 : 1;
+	if (o1->covering != o2->covering)
+		return o1->covering < o2->covering ? -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
 		return o1->hint - o2->hint;
+	if (o1->wide_hint != o2->wide_hint)
+		return o1->wide_hint - o2->wide_hint;
+	if (o1->inline_key != o2->inline_key)
+		return o1->inline_key - o2->inline_key;
+	if (o1->hash_table != o2->hash_table)
+		return o1->hash_table < o2->hash_table ? -1 : 1;
 	return 0;
 }
 
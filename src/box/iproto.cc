@@ -329,6 +329,8 @@ struct iproto_msg
 		struct sql_request sql;
 		/* BEGIN request */
 		struct begin_request begin;
+		/* COMMIT request */
+		struct commit_request commit;
 		/** In case of iproto parse error, saved diagnostics. */
 		struct diag diag;
 	};
@@ -1574,6 +1576,8 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		cmsg_init(&msg->base, iproto_thread->begin_route);
 		break;
 	case IPROTO_COMMIT:
+		if (xrow_decode_commit(&msg->header, &msg->commit) != 0)
+			goto error;
 		cmsg_init(&msg->base, iproto_thread->commit_route);
 		break;
 	case IPROTO_ROLLBACK:
@@ -1923,6 +1927,43 @@ tx_inject_delay(void)
 	});
 }
 
+/**
+ * Wait until the instance reaches the vclock passed in a request as
+ * a causal read token, if any.
+ */
+static int
+tx_wait_vclock(const char *wait_vclock, double timeout)
+{
+	if (wait_vclock == NULL)
+		return 0;
+	struct vclock vclock;
+	if (xrow_decode_vclock_token(wait_vclock, &vclock) != 0)
+		return -1;
+	if (timeout == 0)
+		timeout = TIMEOUT_INFINITY;
+	return box_wait_vclock(&vclock, timeout);
+}
+
+/**
+ * Write the select header to a prepared result set, appending the
+ * instance vclock to the reply if the client requested it.
+ */
+static int
+tx_reply_select(struct iproto_msg *msg, struct obuf_svp *svp,
+		uint32_t count, bool return_vclock)
+{
+	struct obuf *out = msg->connection->tx.p_obuf;
+	if (return_vclock) {
+		return iproto_reply_select_with_vclock(out, svp,
+						       msg->header.sync,
+						       ::schema_version,
+						       count, box_vclock);
+	}
+	iproto_reply_select(out, svp, msg->header.sync, ::schema_version,
+			    count);
+	return 0;
+}
+
 static void
 tx_process_begin(struct cmsg *m)
 {
@@ -1965,7 +2006,13 @@ tx_process_commit(struct cmsg *m)
 		goto error;
 
 	out = msg->connection->tx.p_obuf;
-	iproto_reply_ok(out, msg->header.sync, ::schema_version);
+	if (msg->commit.return_vclock) {
+		if (iproto_reply_vclock(out, box_vclock, msg->header.sync,
+					::schema_version) != 0)
+			goto error;
+	} else {
+		iproto_reply_ok(out, msg->header.sync, ::schema_version);
+	}
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg);
 	return;
@@ -2014,8 +2061,11 @@ tx_process1(struct cmsg *m)
 		goto error;
 	if (tuple && tuple_to_obuf(tuple, out))
 		goto error;
-	iproto_reply_select(out, &svp, msg->header.sync, ::schema_version,
-			    tuple != 0);
+	if (tx_reply_select(msg, &svp, tuple != 0,
+			    msg->dml.return_vclock) != 0) {
+		obuf_rollback_to_svp(out, &svp);
+		goto error;
+	}
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg);
 	return;
@@ -2036,6 +2086,8 @@ tx_process_select(struct cmsg *m)
 	struct request *req = &msg->dml;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	if (tx_wait_vclock(req->wait_vclock, req->timeout) != 0)
+		goto error;
 
 	tx_inject_delay();
 	rc = box_select(req->space_id, req->index_id,
@@ -2086,6 +2138,12 @@ tx_process_call(struct cmsg *m)
 	struct iproto_msg *msg = tx_accept_msg(m);
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
+	/*
+	 * Wait before installing the on_yield trigger, because the request
+	 * arguments must stay in the input buffer until the call starts.
+	 */
+	if (tx_wait_vclock(msg->call.wait_vclock, msg->call.timeout) != 0)
+		goto error;
 
 	/*
 	 * CALL/EVAL should copy its arguments so we can discard
@@ -2098,6 +2156,9 @@ tx_process_call(struct cmsg *m)
 
 	int rc;
 	struct port port;
+	/* The request is trashed if the call yields. */
+	bool return_vclock;
+	return_vclock = msg->call.return_vclock;
 
 	switch (msg->header.type) {
 	case IPROTO_CALL:
@@ -2157,8 +2218,10 @@ tx_process_call(struct cmsg *m)
 		goto error;
 	}
 
-	iproto_reply_select(out, &svp, msg->header.sync,
-			    ::schema_version, count);
+	if (tx_reply_select(msg, &svp, count, return_vclock) != 0) {
+		obuf_rollback_to_svp(out, &svp);
+		goto error;
+	}
 	iproto_wpos_create(&msg->wpos, out);
 	tx_end_msg(msg);
 	return;
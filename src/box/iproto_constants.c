@@ -152,6 +152,10 @@ const unsigned char iproto_key_type[IPROTO_KEY_MAX] =
 	/* 0x56 */	MP_DOUBLE, /* IPROTO_TIMEOUT */
 	/* 0x57 */	MP_STR, /* IPROTO_EVENT_KEY */
 	/* 0x58 */	MP_NIL, /* IPROTO_EVENT_DATA (can be any) */
+	/* 0x59 */	MP_BOOL, /* IPROTO_CHECKPOINT_JOIN */
+	/* 0x5a */	MP_ARRAY, /* IPROTO_SPACE_FILTER */
+	/* 0x5b */	MP_DOUBLE, /* IPROTO_LEADER_TM */
+	/* 0x5c */	MP_BOOL, /* IPROTO_RETURN_VCLOCK */
 	/* }}} */
 };
 
@@ -288,6 +292,10 @@ const char *iproto_key_strs[IPROTO_KEY_MAX] = {
 	"timeout",          /* 0x56 */
 	"event key",        /* 0x57 */
 	"event data",       /* 0x58 */
+	"checkpoint join",  /* 0x59 */
+	"space filter",     /* 0x5a */
+	"leader timestamp", /* 0x5b */
+	"return vclock",    /* 0x5c */
 };
 
 const char *vy_page_info_key_strs[VY_PAGE_INFO_KEY_MAX] = {
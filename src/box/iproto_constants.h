@@ -148,6 +148,20 @@ enum iproto_key {
 	/** Key name and data sent to a remote watcher. */
 	IPROTO_EVENT_KEY = 0x57,
 	IPROTO_EVENT_DATA = 0x58,
+	/** Request to join from the last checkpoint of the master. */
+	IPROTO_CHECKPOINT_JOIN = 0x59,
+	/** A list of space ids whose rows should be relayed. */
+	IPROTO_SPACE_FILTER = 0x5a,
+	/**
+	 * Monotonic time of the sender in heartbeats. Replicas echo the
+	 * value received from the Raft leader in ACKs to renew its lease.
+	 */
+	IPROTO_LEADER_TM = 0x5b,
+	/**
+	 * Flag set in a write request to get the instance vclock in the
+	 * reply. Used as a causal read token, see IPROTO_VCLOCK.
+	 */
+	IPROTO_RETURN_VCLOCK = 0x5c,
 	/*
 	 * Be careful to not extend iproto_key values over 0x7f.
 	 * iproto_keys are encoded in msgpack as positive fixnum, which ends at
@@ -282,6 +296,12 @@ enum iproto_type {
 	IPROTO_WATCH = 74,
 	IPROTO_UNWATCH = 75,
 	IPROTO_EVENT = 76,
+	/**
+	 * A chunk of a checkpoint file sent by the master in response to
+	 * JOIN with IPROTO_CHECKPOINT_JOIN set. The chunk is stored in the
+	 * body as IPROTO_DATA.
+	 */
+	IPROTO_JOIN_FILE = 77,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
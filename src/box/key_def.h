@@ -109,7 +109,8 @@ struct key_part {
 	uint64_t format_epoch;
 	/**
 	 * Cached value of the offset slot corresponding to
-	 * the indexed field (tuple_field::offset_slot).
+	 * the indexed field (tuple_field::offset_slot) or
+	 * its static offset (tuple_field::static_offset).
 	 * Valid only if key_part::format_epoch equals the epoch
 	 * of the tuple format. This value is updated in
 	 * tuple_field_raw_by_part to always store the
@@ -177,6 +177,14 @@ lbox_cfg_set_wal_cleanup_delay(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_wal_retention_size(struct lua_State *L)
+{
+	if (box_set_wal_retention_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_read_only(struct lua_State *L)
 {
@@ -210,6 +218,28 @@ lbox_cfg_set_memtx_max_tuple_size(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_memtx_defrag_threshold(struct lua_State *L)
+{
+	try {
+		box_set_memtx_defrag_threshold();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_defrag_rate(struct lua_State *L)
+{
+	try {
+		box_set_memtx_defrag_rate();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_memory(struct lua_State *L)
 {
@@ -254,6 +284,28 @@ lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_max_subcompactions(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_max_subcompactions();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_bloom_memory(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_bloom_memory();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_net_msg_max(struct lua_State *L)
 {
@@ -298,6 +350,14 @@ lbox_cfg_set_election_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_election_leader_lease(struct lua_State *L)
+{
+	(void) L;
+	box_set_election_leader_lease();
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_timeout(struct lua_State *L)
 {
@@ -422,15 +482,23 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
 		{"cfg_set_wal_queue_max_size", lbox_cfg_set_wal_queue_max_size},
 		{"cfg_set_wal_cleanup_delay", lbox_cfg_set_wal_cleanup_delay},
+		{"cfg_set_wal_retention_size", lbox_cfg_set_wal_retention_size},
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
 		{"cfg_set_memtx_memory", lbox_cfg_set_memtx_memory},
 		{"cfg_set_memtx_max_tuple_size", lbox_cfg_set_memtx_max_tuple_size},
+		{"cfg_set_memtx_defrag_threshold",
+			lbox_cfg_set_memtx_defrag_threshold},
+		{"cfg_set_memtx_defrag_rate", lbox_cfg_set_memtx_defrag_rate},
 		{"cfg_set_vinyl_memory", lbox_cfg_set_vinyl_memory},
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
+		{"cfg_set_vinyl_max_subcompactions",
+			lbox_cfg_set_vinyl_max_subcompactions},
+		{"cfg_set_vinyl_bloom_memory", lbox_cfg_set_vinyl_bloom_memory},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
 		{"cfg_set_election_timeout", lbox_cfg_set_election_timeout},
+		{"cfg_set_election_leader_lease", lbox_cfg_set_election_leader_lease},
 		{"cfg_set_replication_timeout", lbox_cfg_set_replication_timeout},
 		{"cfg_set_replication_connect_quorum", lbox_cfg_set_replication_connect_quorum},
 		{"cfg_set_replication_connect_timeout", lbox_cfg_set_replication_connect_timeout},
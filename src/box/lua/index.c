@@ -294,6 +294,22 @@ lbox_truncate(struct lua_State *L)
 	return 0;
 }
 
+/** Load an array of tuples into an empty space. */
+static int
+lbox_space_bulk_load(struct lua_State *L)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1) ||
+	    lua_type(L, 2) != LUA_TTABLE)
+		return luaL_error(L, "Usage space:bulk_load(tuples)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	size_t data_len;
+	const char *data = lbox_encode_tuple_on_gc(L, 2, &data_len);
+	if (box_space_bulk_load(space_id, data, data + data_len) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
 /* }}} */
 
 /* {{{ Introspection */
@@ -363,6 +379,7 @@ box_lua_index_init(struct lua_State *L)
 		{"iterator", lbox_index_iterator},
 		{"iterator_next", lbox_iterator_next},
 		{"truncate", lbox_truncate},
+		{"bulk_load", lbox_space_bulk_load},
 		{"stat", lbox_index_stat},
 		{"compact", lbox_index_compact},
 		{NULL, NULL}
@@ -36,6 +36,7 @@
 #include <lauxlib.h>
 #include <lualib.h>
 
+#include "box/lua/info.h"
 #include "box/applier.h"
 #include "box/relay.h"
 #include "box/iproto.h"
@@ -56,7 +57,7 @@
 #include "fiber.h"
 #include "sio.h"
 
-static void
+void
 lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
 {
 	lua_createtable(L, 0, vclock_size(vclock));
@@ -121,6 +122,17 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 		lua_pushlstring(L, name, total);
 		lua_settable(L, -3);
 
+		/* Transactions written to WAL in batches. */
+		lua_pushstring(L, "wal_batch");
+		lua_newtable(L);
+		lua_pushstring(L, "count");
+		luaL_pushint64(L, applier->txn_batch.write_count);
+		lua_settable(L, -3);
+		lua_pushstring(L, "txns");
+		luaL_pushint64(L, applier->txn_batch.write_txn_count);
+		lua_settable(L, -3);
+		lua_settable(L, -3);
+
 		struct error *e = diag_last_error(&applier->fiber->diag);
 		if (e != NULL)
 			lbox_push_replication_error_message(L, e, -1);
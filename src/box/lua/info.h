@@ -38,10 +38,15 @@ extern "C" {
 
 struct lua_State;
 struct info_handler;
+struct vclock;
 
 void
 box_lua_info_init(struct lua_State *L);
 
+/** Push a vclock to the Lua stack as a table. */
+void
+lbox_pushvclock(struct lua_State *L, const struct vclock *vclock);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -67,6 +67,7 @@
 #include "box/lua/key_def.h"
 #include "box/lua/merger.h"
 #include "box/lua/watcher.h"
+#include "box/lua/read_view.h"
 
 #include "mpstream/mpstream.h"
 
@@ -84,7 +85,8 @@ extern char session_lua[],
 	net_box_lua[],
 	upgrade_lua[],
 	console_lua[],
-	merger_lua[];
+	merger_lua[],
+	read_view_lua[];
 
 static const char *lua_sources[] = {
 	"box/session", session_lua,
@@ -105,6 +107,7 @@ static const char *lua_sources[] = {
 	"box/xlog", xlog_lua,
 	"box/key_def", key_def_lua,
 	"box/merger", merger_lua,
+	"box/read_view", read_view_lua,
 	NULL
 };
 
@@ -480,6 +483,7 @@ box_lua_init(struct lua_State *L)
 	box_lua_xlog_init(L);
 	box_lua_sql_init(L);
 	box_lua_watcher_init(L);
+	box_lua_read_view_init(L);
 	luaopen_net_box(L);
 	lua_pop(L, 1);
 	tarantool_lua_console_init(L);
@@ -46,6 +46,8 @@ local default_cfg = {
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
     memtx_allocator     = "small",
+    memtx_defrag_threshold = 0,
+    memtx_defrag_rate   = 10000,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
@@ -56,12 +58,14 @@ local default_cfg = {
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
+    vinyl_max_subcompactions = 1,
     vinyl_timeout       = 60,
     vinyl_run_count_per_level = 2,
     vinyl_run_size_ratio      = 3.5,
     vinyl_range_size          = nil, -- set automatically
     vinyl_page_size           = 8 * 1024,
     vinyl_bloom_fpr           = 0.05,
+    vinyl_bloom_memory        = 0,
 
     -- logging options are covered by
     -- a separate log module; they are
@@ -79,6 +83,8 @@ local default_cfg = {
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
     wal_cleanup_delay   = 4 * 3600,
+    wal_archive_dir     = nil,
+    wal_retention_size  = 0,
     force_recovery      = false,
     replication         = nil,
     instance_uuid       = nil,
@@ -91,12 +97,14 @@ local default_cfg = {
     read_only           = false,
     hot_standby         = false,
     memtx_use_mvcc_engine = false,
+    memtx_use_hugepages = false,
     checkpoint_interval = 3600,
     checkpoint_wal_threshold = 1e18,
     checkpoint_count    = 2,
     worker_pool_threads = 4,
     election_mode       = 'off',
     election_timeout    = 5,
+    election_leader_lease = false,
     replication_timeout = 1,
     replication_sync_lag = 10,
     replication_sync_timeout = 300,
@@ -107,6 +115,7 @@ local default_cfg = {
     replication_skip_conflict = false,
     replication_anon      = false,
     replication_threads   = 1,
+    replication_join_mode = "read_view",
     feedback_enabled      = true,
     feedback_crashinfo    = true,
     feedback_host         = "https://feedback.tarantool.io",
@@ -157,6 +166,8 @@ local template_cfg = {
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
     memtx_allocator     = 'string',
+    memtx_defrag_threshold = 'number',
+    memtx_defrag_rate   = 'number',
     work_dir            = 'string',
     memtx_dir            = 'string',
     wal_dir             = 'string',
@@ -166,12 +177,14 @@ local template_cfg = {
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
+    vinyl_max_subcompactions  = 'number',
     vinyl_timeout             = 'number',
     vinyl_run_count_per_level = 'number',
     vinyl_run_size_ratio      = 'number',
     vinyl_range_size          = 'number',
     vinyl_page_size           = 'number',
     vinyl_bloom_fpr           = 'number',
+    vinyl_bloom_memory        = 'number',
 
     log                 = 'module',
     log_nonblock        = 'module',
@@ -189,6 +202,8 @@ local template_cfg = {
     wal_max_size        = 'number',
     wal_dir_rescan_delay= 'number',
     wal_cleanup_delay   = 'number',
+    wal_archive_dir     = 'string',
+    wal_retention_size  = 'number',
     force_recovery      = 'boolean',
     replication         = 'string, number, table',
     instance_uuid       = 'string',
@@ -205,9 +220,11 @@ local template_cfg = {
     read_only           = 'boolean',
     hot_standby         = 'boolean',
     memtx_use_mvcc_engine = 'boolean',
+    memtx_use_hugepages = 'boolean',
     worker_pool_threads = 'number',
     election_mode       = 'string',
     election_timeout    = 'number',
+    election_leader_lease = 'boolean',
     replication_timeout = 'number',
     replication_sync_lag = 'number',
     replication_sync_timeout = 'number',
@@ -218,6 +235,8 @@ local template_cfg = {
     replication_skip_conflict = 'boolean',
     replication_anon      = 'boolean',
     replication_threads   = 'number',
+    replication_join_mode = 'string',
+    replication_space_filter = 'table',
     feedback_enabled      = ifdef_feedback('boolean'),
     feedback_crashinfo    = ifdef_feedback('boolean'),
     feedback_host         = ifdef_feedback('string'),
@@ -297,10 +316,14 @@ local dynamic_cfg = {
     read_only               = private.cfg_set_read_only,
     memtx_memory            = private.cfg_set_memtx_memory,
     memtx_max_tuple_size    = private.cfg_set_memtx_max_tuple_size,
+    memtx_defrag_threshold  = private.cfg_set_memtx_defrag_threshold,
+    memtx_defrag_rate       = private.cfg_set_memtx_defrag_rate,
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
+    vinyl_max_subcompactions = private.cfg_set_vinyl_max_subcompactions,
+    vinyl_bloom_memory      = private.cfg_set_vinyl_bloom_memory,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
     checkpoint_wal_threshold = private.cfg_set_checkpoint_wal_threshold,
@@ -313,12 +336,14 @@ local dynamic_cfg = {
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = function() end,
     wal_cleanup_delay       = private.cfg_set_wal_cleanup_delay,
+    wal_retention_size      = private.cfg_set_wal_retention_size,
     custom_proc_title       = function()
         require('title').update(box.cfg.custom_proc_title)
     end,
     force_recovery          = function() end,
     election_mode           = private.cfg_set_election_mode,
     election_timeout        = private.cfg_set_election_timeout,
+    election_leader_lease   = private.cfg_set_election_leader_lease,
     replication_timeout     = private.cfg_set_replication_timeout,
     replication_connect_timeout = private.cfg_set_replication_connect_timeout,
     replication_connect_quorum = private.cfg_set_replication_connect_quorum,
@@ -406,13 +431,18 @@ local dynamic_cfg_skip_at_load = {
     listen                  = true,
     memtx_memory            = true,
     memtx_max_tuple_size    = true,
+    memtx_defrag_threshold  = true,
+    memtx_defrag_rate       = true,
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
     vinyl_timeout           = true,
+    vinyl_max_subcompactions = true,
+    vinyl_bloom_memory      = true,
     too_long_threshold      = true,
     election_mode           = true,
     election_timeout        = true,
+    election_leader_lease   = true,
     replication             = true,
     replication_timeout     = true,
     replication_connect_timeout = true,
@@ -45,6 +45,7 @@
 
 #include "box/tuple.h"       /* tuple_format_runtime,
 				tuple_*(), ... */
+#include "box/tuple_compression.h" /* tuple_data_decompressed() */
 
 #include "lua/error.h"       /* luaT_error() */
 #include "lua/utils.h"       /* luaL_pushcdata(),
@@ -1115,9 +1116,17 @@ encode_result_buffer(struct lua_State *L, struct merge_source *source,
 	while (result_len < limit && (rc =
 	       merge_source_next(source, NULL, &tuple)) == 0 &&
 	       tuple != NULL) {
-		uint32_t bsize = tuple_bsize(tuple);
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		uint32_t bsize;
+		const char *data = tuple_data_decompressed(tuple, &bsize);
+		if (data == NULL) {
+			tuple_unref(tuple);
+			return luaT_error(L);
+		}
 		ibuf_reserve(output_buffer, bsize);
-		memcpy(output_buffer->wpos, tuple_data(tuple), bsize);
+		memcpy(output_buffer->wpos, data, bsize);
+		region_truncate(region, region_svp);
 		output_buffer->wpos += bsize;
 		result_len_offset += bsize;
 		++result_len;
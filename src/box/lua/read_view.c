@@ -0,0 +1,414 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/read_view.h"
+
+#include <assert.h>
+#include <lua.h>
+#include <lauxlib.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "box/index.h"
+#include "box/read_view.h"
+#include "box/space.h"
+#include "box/tuple.h"
+#include "box/lua/info.h"
+#include "box/lua/tuple.h"
+#include "diag.h"
+#include "lua/serializer.h"
+#include "lua/utils.h"
+#include "msgpuck.h"
+#include "small/rlist.h"
+#include "trivia/util.h"
+
+/** Read view opened from Lua. */
+struct lbox_read_view {
+	struct read_view base;
+	/** List of open iterators, linked by lbox_read_view_iterator::link. */
+	struct rlist iterators;
+};
+
+/**
+ * Read view handle pushed as userdata to Lua. Garbage collection
+ * of a handle closes the read view.
+ */
+struct lbox_read_view_handle {
+	/** The read view or NULL if it was closed. */
+	struct lbox_read_view *rv;
+};
+
+/** Read view iterator pushed as userdata to Lua. */
+struct lbox_read_view_iterator {
+	/** The read view or NULL if it was closed. */
+	struct lbox_read_view *rv;
+	/** Link in lbox_read_view::iterators. */
+	struct rlist link;
+	/** Format used for creating tuples. */
+	struct tuple_format *format;
+	/** Underlying index read view iterator. */
+	struct snapshot_iterator *it;
+};
+
+static const char lbox_read_view_typename[] = "box.read_view";
+static const char lbox_read_view_iterator_typename[] =
+	"box.read_view.iterator";
+
+/** Free an iterator and detach it from its read view. */
+static void
+lbox_read_view_iterator_close(struct lbox_read_view_iterator *iterator)
+{
+	if (iterator->rv == NULL)
+		return;
+	iterator->it->free(iterator->it);
+	rlist_del_entry(iterator, link);
+	iterator->rv = NULL;
+	iterator->it = NULL;
+}
+
+static void
+lbox_read_view_close(struct lbox_read_view_handle *handle)
+{
+	struct lbox_read_view *rv = handle->rv;
+	if (rv == NULL)
+		return;
+	struct lbox_read_view_iterator *iterator, *next;
+	rlist_foreach_entry_safe(iterator, &rv->iterators, link, next)
+		lbox_read_view_iterator_close(iterator);
+	read_view_close(&rv->base);
+	free(rv);
+	handle->rv = NULL;
+}
+
+static struct lbox_read_view *
+lbox_check_read_view(struct lua_State *L, int idx)
+{
+	struct lbox_read_view_handle *handle =
+		luaL_checkudata(L, idx, lbox_read_view_typename);
+	if (handle->rv == NULL)
+		luaL_error(L, "Read view is closed");
+	return handle->rv;
+}
+
+/**
+ * Find an index read view by space and index ids.
+ * Raises a Lua error if not found.
+ */
+static struct index_read_view *
+lbox_read_view_check_index(struct lua_State *L, struct lbox_read_view *rv,
+			   uint32_t space_id, uint32_t index_id,
+			   struct space_read_view **space_rv)
+{
+	*space_rv = read_view_space_by_id(&rv->base, space_id);
+	if (*space_rv == NULL)
+		luaL_error(L, "Space %u is not in the read view", space_id);
+	struct index_read_view *index_rv =
+		space_read_view_index(*space_rv, index_id);
+	if (index_rv == NULL)
+		luaL_error(L, "Index %u of space '%s' is not in the read view",
+			   index_id, (*space_rv)->name);
+	return index_rv;
+}
+
+/**
+ * Create an iterator over an index read view. The key is passed
+ * as a MessagePack array encoded by Lua.
+ */
+static struct snapshot_iterator *
+lbox_read_view_create_iterator(struct lua_State *L,
+			       struct index_read_view *index_rv,
+			       uint32_t type, int key_idx)
+{
+	size_t key_len;
+	const char *key = luaL_checklstring(L, key_idx, &key_len);
+	uint32_t part_count = mp_decode_array(&key);
+	struct snapshot_iterator *it = index_read_view_create_iterator(
+		index_rv, (enum iterator_type)type, key, part_count);
+	if (it == NULL)
+		luaT_error(L);
+	return it;
+}
+
+/**
+ * Create a tuple from data returned by a read view iterator and
+ * push it to the Lua stack.
+ */
+static void
+lbox_read_view_push_tuple(struct lua_State *L, struct tuple_format *format,
+			  const char *data, uint32_t size)
+{
+	struct tuple *tuple = tuple_new(format, data, data + size);
+	if (tuple == NULL)
+		luaT_error(L);
+	luaT_pushtuple(L, tuple);
+}
+
+/**
+ * Space filter used by lbox_read_view_open(): checks if the space
+ * id is present in the table passed as the second argument.
+ */
+static bool
+lbox_read_view_filter_space(struct space *space, void *arg)
+{
+	struct lua_State *L = arg;
+	lua_rawgeti(L, 2, space_id(space));
+	bool result = !lua_isnil(L, -1);
+	lua_pop(L, 1);
+	return result;
+}
+
+/**
+ * Open a read view.
+ * Usage: open(name[, space_ids]).
+ * If space_ids is given, only spaces whose ids are keys of the
+ * table are included.
+ */
+static int
+lbox_read_view_open(struct lua_State *L)
+{
+	const char *name = luaL_checkstring(L, 1);
+	struct read_view_opts opts;
+	read_view_opts_create(&opts);
+	opts.name = name;
+	if (!lua_isnoneornil(L, 2)) {
+		luaL_checktype(L, 2, LUA_TTABLE);
+		opts.filter_space = lbox_read_view_filter_space;
+		opts.filter_arg = L;
+	}
+	struct lbox_read_view_handle *handle =
+		lua_newuserdata(L, sizeof(*handle));
+	handle->rv = NULL;
+	luaL_getmetatable(L, lbox_read_view_typename);
+	lua_setmetatable(L, -2);
+	struct lbox_read_view *rv = xmalloc(sizeof(*rv));
+	if (read_view_open(&rv->base, &opts) != 0) {
+		free(rv);
+		return luaT_error(L);
+	}
+	rlist_create(&rv->iterators);
+	handle->rv = rv;
+	return 1;
+}
+
+/** Close a read view. Usage: close(rv). */
+static int
+lbox_read_view_close_f(struct lua_State *L)
+{
+	struct lbox_read_view_handle *handle =
+		luaL_checkudata(L, 1, lbox_read_view_typename);
+	lbox_read_view_close(handle);
+	return 0;
+}
+
+static void
+lbox_read_view_push_info(struct lua_State *L, struct read_view *rv)
+{
+	lua_newtable(L);
+	luaL_pushuint64(L, rv->id);
+	lua_setfield(L, -2, "id");
+	lua_pushstring(L, rv->name);
+	lua_setfield(L, -2, "name");
+	lbox_pushvclock(L, &rv->vclock);
+	lua_setfield(L, -2, "vclock");
+	lua_pushnumber(L, rv->timestamp);
+	lua_setfield(L, -2, "timestamp");
+}
+
+/**
+ * Return information about a read view and its spaces.
+ * Usage: info(rv).
+ */
+static int
+lbox_read_view_info(struct lua_State *L)
+{
+	struct lbox_read_view *rv = lbox_check_read_view(L, 1);
+	lbox_read_view_push_info(L, &rv->base);
+	lua_newtable(L);
+	int i = 1;
+	struct space_read_view *space_rv;
+	rlist_foreach_entry(space_rv, &rv->base.spaces, link) {
+		lua_newtable(L);
+		lua_pushinteger(L, space_rv->id);
+		lua_setfield(L, -2, "id");
+		lua_pushstring(L, space_rv->name);
+		lua_setfield(L, -2, "name");
+		lua_newtable(L);
+		for (uint32_t j = 0; j <= space_rv->index_id_max; j++) {
+			struct index_read_view *index_rv =
+				space_rv->index_map[j];
+			if (index_rv == NULL)
+				continue;
+			lua_newtable(L);
+			lua_pushinteger(L, j);
+			lua_setfield(L, -2, "id");
+			lua_pushstring(L, index_rv->def->name);
+			lua_setfield(L, -2, "name");
+			lua_rawseti(L, -2, j);
+		}
+		lua_setfield(L, -2, "index");
+		lua_rawseti(L, -2, i++);
+	}
+	lua_setfield(L, -2, "spaces");
+	return 1;
+}
+
+/** Return a list of all open read views. Usage: list(). */
+static int
+lbox_read_view_list(struct lua_State *L)
+{
+	lua_newtable(L);
+	int i = 1;
+	struct read_view *rv;
+	read_view_foreach(rv) {
+		lbox_read_view_push_info(L, rv);
+		lua_rawseti(L, -2, i++);
+	}
+	return 1;
+}
+
+/**
+ * Select tuples from a read view.
+ * Usage: select(rv, space_id, index_id, iterator, key, offset, limit).
+ */
+static int
+lbox_read_view_select(struct lua_State *L)
+{
+	struct lbox_read_view *rv = lbox_check_read_view(L, 1);
+	uint32_t space_id = luaL_checkinteger(L, 2);
+	uint32_t index_id = luaL_checkinteger(L, 3);
+	uint32_t type = luaL_checkinteger(L, 4);
+	uint32_t offset = luaL_checkinteger(L, 6);
+	uint32_t limit = luaL_checkinteger(L, 7);
+	struct space_read_view *space_rv;
+	struct index_read_view *index_rv =
+		lbox_read_view_check_index(L, rv, space_id, index_id,
+					   &space_rv);
+	struct snapshot_iterator *it =
+		lbox_read_view_create_iterator(L, index_rv, type, 5);
+	lua_newtable(L);
+	uint32_t found = 0;
+	while (found < limit) {
+		const char *data;
+		uint32_t size;
+		if (it->next(it, &data, &size) != 0) {
+			it->free(it);
+			return luaT_error(L);
+		}
+		if (data == NULL)
+			break;
+		if (offset > 0) {
+			offset--;
+			continue;
+		}
+		struct tuple *tuple = tuple_new(space_rv->format,
+						data, data + size);
+		if (tuple == NULL) {
+			it->free(it);
+			return luaT_error(L);
+		}
+		luaT_pushtuple(L, tuple);
+		lua_rawseti(L, -2, ++found);
+	}
+	it->free(it);
+	return 1;
+}
+
+/**
+ * Create an iterator over a read view.
+ * Usage: iterator(rv, space_id, index_id, iterator, key).
+ */
+static int
+lbox_read_view_iterator(struct lua_State *L)
+{
+	struct lbox_read_view *rv = lbox_check_read_view(L, 1);
+	uint32_t space_id = luaL_checkinteger(L, 2);
+	uint32_t index_id = luaL_checkinteger(L, 3);
+	uint32_t type = luaL_checkinteger(L, 4);
+	struct space_read_view *space_rv;
+	struct index_read_view *index_rv =
+		lbox_read_view_check_index(L, rv, space_id, index_id,
+					   &space_rv);
+	struct lbox_read_view_iterator *iterator =
+		lua_newuserdata(L, sizeof(*iterator));
+	iterator->rv = NULL;
+	luaL_getmetatable(L, lbox_read_view_iterator_typename);
+	lua_setmetatable(L, -2);
+	iterator->it = lbox_read_view_create_iterator(L, index_rv, type, 5);
+	iterator->format = space_rv->format;
+	iterator->rv = rv;
+	rlist_add_entry(&rv->iterators, iterator, link);
+	return 1;
+}
+
+/**
+ * Advance a read view iterator.
+ * Usage: iterator_next(iterator). Returns a tuple or nil on EOF.
+ */
+static int
+lbox_read_view_iterator_next(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *iterator =
+		luaL_checkudata(L, 1, lbox_read_view_iterator_typename);
+	if (iterator->rv == NULL)
+		return luaL_error(L, "Read view is closed");
+	const char *data;
+	uint32_t size;
+	if (iterator->it->next(iterator->it, &data, &size) != 0)
+		return luaT_error(L);
+	if (data == NULL) {
+		lua_pushnil(L);
+		return 1;
+	}
+	lbox_read_view_push_tuple(L, iterator->format, data, size);
+	return 1;
+}
+
+static int
+lbox_read_view_gc(struct lua_State *L)
+{
+	struct lbox_read_view_handle *handle =
+		luaL_checkudata(L, 1, lbox_read_view_typename);
+	lbox_read_view_close(handle);
+	return 0;
+}
+
+static int
+lbox_read_view_iterator_gc(struct lua_State *L)
+{
+	struct lbox_read_view_iterator *iterator =
+		luaL_checkudata(L, 1, lbox_read_view_iterator_typename);
+	lbox_read_view_iterator_close(iterator);
+	return 0;
+}
+
+void
+box_lua_read_view_init(struct lua_State *L)
+{
+	static const struct luaL_Reg lbox_read_view_meta[] = {
+		{"__gc", lbox_read_view_gc},
+		{NULL, NULL},
+	};
+	luaL_register_type(L, lbox_read_view_typename, lbox_read_view_meta);
+
+	static const struct luaL_Reg lbox_read_view_iterator_meta[] = {
+		{"__gc", lbox_read_view_iterator_gc},
+		{NULL, NULL},
+	};
+	luaL_register_type(L, lbox_read_view_iterator_typename,
+			   lbox_read_view_iterator_meta);
+
+	static const struct luaL_Reg lbox_read_view_internal[] = {
+		{"open", lbox_read_view_open},
+		{"close", lbox_read_view_close_f},
+		{"info", lbox_read_view_info},
+		{"list", lbox_read_view_list},
+		{"select", lbox_read_view_select},
+		{"iterator", lbox_read_view_iterator},
+		{"iterator_next", lbox_read_view_iterator_next},
+		{NULL, NULL},
+	};
+	luaL_register(L, "box.internal.read_view", lbox_read_view_internal);
+	lua_pop(L, 1);
+}
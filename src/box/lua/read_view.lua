@@ -0,0 +1,164 @@
+-- read_view.lua (internal file)
+
+local fun = require('fun')
+local msgpack = require('msgpack')
+
+local internal = require('box.internal')
+local read_view_internal = internal.read_view
+local check_iterator_type = internal.check_iterator_type
+local check_select_opts = internal.check_select_opts
+
+local function keify(key)
+    if key == nil then
+        return {}
+    elseif type(key) == "table" or box.tuple.is(key) then
+        return key
+    end
+    return {key}
+end
+
+-- The index is passed as param to keep the read view referenced
+-- while the iterator is in use.
+local function iterator_gen(param, state) -- luacheck: no unused args
+    local tuple = read_view_internal.iterator_next(state)
+    if tuple ~= nil then
+        return state, tuple
+    end
+    return nil
+end
+
+local index_mt = {}
+index_mt.__index = index_mt
+
+function index_mt:select(key, opts)
+    key = keify(key)
+    local iterator, offset, limit = check_select_opts(opts, #key == 0)
+    return read_view_internal.select(self.read_view.handle, self.space_id,
+                                     self.id, iterator, msgpack.encode(key),
+                                     offset, limit)
+end
+
+function index_mt:get(key)
+    return self:select(key, {iterator = 'EQ', limit = 1})[1]
+end
+
+function index_mt:pairs(key, opts)
+    key = keify(key)
+    local iterator = check_iterator_type(opts, #key == 0)
+    local state = read_view_internal.iterator(self.read_view.handle,
+                                              self.space_id, self.id,
+                                              iterator, msgpack.encode(key))
+    return fun.wrap(iterator_gen, self, state)
+end
+
+local space_mt = {}
+space_mt.__index = space_mt
+
+local function space_check_pk(space)
+    local pk = space.index[0]
+    if pk == nil then
+        box.error(box.error.NO_SUCH_INDEX_ID, 0, space.name)
+    end
+    return pk
+end
+
+function space_mt:select(key, opts)
+    return space_check_pk(self):select(key, opts)
+end
+
+function space_mt:get(key)
+    return space_check_pk(self):get(key)
+end
+
+function space_mt:pairs(key, opts)
+    return space_check_pk(self):pairs(key, opts)
+end
+
+local read_view_mt = {}
+read_view_mt.__index = read_view_mt
+
+function read_view_mt:close()
+    read_view_internal.close(self.handle)
+    self.status = 'closed'
+end
+
+local function check_opts(opts)
+    if opts == nil then
+        return {}
+    end
+    if type(opts) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options should be a table")
+    end
+    if opts.name ~= nil and type(opts.name) ~= 'string' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options parameter 'name' should be of type string")
+    end
+    if opts.spaces ~= nil and type(opts.spaces) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options parameter 'spaces' should be of type table")
+    end
+    return opts
+end
+
+-- Opens a read view of memtx spaces. Spaces to include may be
+-- listed by names or ids in opts.spaces, all spaces are included
+-- by default.
+local function open(opts)
+    opts = check_opts(opts)
+    local space_ids
+    if opts.spaces ~= nil then
+        space_ids = {}
+        for _, s in ipairs(opts.spaces) do
+            local space = box.space[s]
+            if space == nil then
+                box.error(box.error.NO_SUCH_SPACE, tostring(s))
+            end
+            space_ids[space.id] = true
+        end
+    end
+    local handle = read_view_internal.open(opts.name or 'unknown', space_ids)
+    local info = read_view_internal.info(handle)
+    local rv = setmetatable({
+        id = info.id,
+        name = info.name,
+        vclock = info.vclock,
+        timestamp = info.timestamp,
+        status = 'open',
+        handle = handle,
+        space = {},
+    }, read_view_mt)
+    for _, s in ipairs(info.spaces) do
+        local space = setmetatable({
+            id = s.id,
+            name = s.name,
+            index = {},
+        }, space_mt)
+        for _, i in pairs(s.index) do
+            local index = setmetatable({
+                id = i.id,
+                name = i.name,
+                space_id = s.id,
+                read_view = rv,
+            }, index_mt)
+            space.index[i.id] = index
+            space.index[i.name] = index
+        end
+        rv.space[s.id] = space
+        rv.space[s.name] = space
+    end
+    return rv
+end
+
+local function list()
+    local result = read_view_internal.list()
+    for _, rv in ipairs(result) do
+        rv.status = 'open'
+    end
+    return result
+end
+
+box.read_view = {
+    open = open,
+    list = list,
+}
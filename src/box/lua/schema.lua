@@ -73,6 +73,8 @@ ffi.cdef[[
     box_txn_begin();
     int
     box_txn_set_timeout(double timeout);
+    int
+    box_txn_make_read_only();
     /** \endcond public */
     /** \cond public */
     int
@@ -332,6 +334,7 @@ end
 
 box.begin = function(options)
     local timeout
+    local read_only
     if options then
         check_param(options, 'options', 'table')
         timeout = options.timeout
@@ -339,6 +342,11 @@ box.begin = function(options)
             box.error(box.error.ILLEGAL_PARAMS,
                       "timeout must be a number greater than 0")
         end
+        read_only = options.read_only
+        if read_only ~= nil and type(read_only) ~= "boolean" then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "read_only must be a boolean")
+        end
     end
     if builtin.box_txn_begin() == -1 then
         box.error()
@@ -346,6 +354,9 @@ box.begin = function(options)
     if timeout then
         assert(builtin.box_txn_set_timeout(timeout) == 0)
     end
+    if read_only then
+        assert(builtin.box_txn_make_read_only() == 0)
+    end
 end
 
 box.is_in_txn = builtin.box_txn
@@ -443,6 +454,7 @@ box.schema.space.create = function(name, options)
         is_local = 'boolean',
         temporary = 'boolean',
         is_sync = 'boolean',
+        compression_threshold = 'number',
     }
     local options_defaults = {
         engine = 'memtx',
@@ -487,7 +499,8 @@ box.schema.space.create = function(name, options)
     local space_options = setmap({
         group_id = options.is_local and 1 or nil,
         temporary = options.temporary and true or nil,
-        is_sync = options.is_sync
+        is_sync = options.is_sync,
+        compression_threshold = options.compression_threshold,
     })
     _space:insert{id, uid, name, options.engine, options.field_count,
         space_options, format}
@@ -580,6 +593,7 @@ local alter_space_template = {
     format = 'table',
     temporary = 'boolean',
     is_sync = 'boolean',
+    compression_threshold = 'number',
     name = 'string',
 }
 
@@ -616,6 +630,10 @@ box.schema.space.alter = function(space_id, options)
         flags.is_sync = options.is_sync
     end
 
+    if options.compression_threshold ~= nil then
+        flags.compression_threshold = options.compression_threshold
+    end
+
     local format
     if options.format ~= nil then
         format = update_format(options.format)
@@ -1085,8 +1103,14 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    read_ahead = 'number',
+    compression_level = 'number',
+    covering = 'boolean',
     func = 'number, string',
     hint = 'boolean',
+    wide_hint = 'boolean',
+    inline_key = 'boolean',
+    hash_table = 'string',
 }
 
 local function jsonpaths_from_idx_parts(parts)
@@ -1194,6 +1218,29 @@ box.schema.index.create = function(space_id, name, options)
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "functional index can't use hints")
     end
+    if options.wide_hint and
+            (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "wide_hint is only reasonable with memtx tree index")
+    end
+    if options.wide_hint and options.hint == false then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "wide_hint can't be used without hint")
+    end
+    if options.inline_key and
+            (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "inline_key is only reasonable with memtx tree index")
+    end
+    if options.inline_key and options.hint == false then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "inline_key can't be used without hint")
+    end
+    if options.hash_table and
+            (options.type ~= 'hash' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "hash_table is only reasonable with memtx hash index")
+    end
 
     local _index = box.space[box.schema.INDEX_ID]
     local _vindex = box.space[box.schema.VINDEX_ID]
@@ -1232,8 +1279,14 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            read_ahead = options.read_ahead,
+            compression_level = options.compression_level,
+            covering = options.covering,
             func = options.func,
             hint = options.hint,
+            wide_hint = options.wide_hint,
+            inline_key = options.inline_key,
+            hash_table = options.hash_table,
     }
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
@@ -1254,6 +1307,14 @@ box.schema.index.create = function(space_id, name, options)
     if parts_can_be_simplified then
         parts = simplify_index_parts(parts)
     end
+    if options.wide_hint and (is_multikey_index(parts) or options.func) then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "multikey and functional indexes can't use wide hints")
+    end
+    if options.inline_key and (is_multikey_index(parts) or options.func) then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "multikey and functional indexes can't use inline keys")
+    end
     if options.hint and is_multikey_index(parts) then
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "multikey index can't use hints")
@@ -1391,6 +1452,34 @@ box.schema.index.alter = function(space_id, index_id, options)
                                           space.name,
                 "functional index can't use hints")
     end
+    if options.wide_hint and
+       (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "wide_hint is only reasonable with memtx tree index")
+    end
+    if index_opts.wide_hint and index_opts.hint == false then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "wide_hint can't be used without hint")
+    end
+    if options.inline_key and
+       (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "inline_key is only reasonable with memtx tree index")
+    end
+    if index_opts.inline_key and index_opts.hint == false then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "inline_key can't be used without hint")
+    end
+    if options.hash_table and
+       (options.type ~= 'hash' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "hash_table is only reasonable with memtx hash index")
+    end
     if options.parts then
         local parts_can_be_simplified
         parts, parts_can_be_simplified =
@@ -1400,6 +1489,16 @@ box.schema.index.alter = function(space_id, index_id, options)
             parts = simplify_index_parts(parts)
         end
     end
+    if options.wide_hint and (is_multikey_index(parts) or options.func) then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "multikey and functional indexes can't use wide hints")
+    end
+    if options.inline_key and (is_multikey_index(parts) or options.func) then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+                "multikey and functional indexes can't use inline keys")
+    end
     if options.hint and is_multikey_index(parts) then
         box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
                                           space.name,
@@ -2076,6 +2175,10 @@ space_mt.bsize = function(space)
     end
     return builtin.space_bsize(s)
 end
+space_mt.stat = function(space)
+    check_space_arg(space, 'stat')
+    return box.internal.space.stat(space.id)
+end
 
 space_mt.get = function(space, key)
     check_space_arg(space, 'get')
@@ -2162,6 +2265,14 @@ space_mt.truncate = function(space)
     check_space_arg(space, 'truncate')
     return internal.truncate(space.id)
 end
+space_mt.bulk_load = function(space, tuples, param, state)
+    check_space_arg(space, 'bulk_load')
+    if type(tuples) ~= 'table' or getmetatable(tuples) ~= nil then
+        -- An iterator, e.g. another space:pairs().
+        tuples = fun.iter(tuples, param, state):totable()
+    end
+    return internal.bulk_load(space.id, tuples)
+end
 space_mt.format = function(space, format)
     check_space_arg(space, 'format')
     return box.schema.space.format(space.id, format)
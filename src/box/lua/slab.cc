@@ -42,9 +42,11 @@
 #include "small/small.h"
 #include "small/quota.h"
 #include "memory.h"
+#include "coio_task.h"
 #include "box/engine.h"
 #include "box/memtx_engine.h"
 #include "box/allocator.h"
+#include "box/tuple.h"
 
 static int
 small_stats_lua_cb(const void *stats, void *cb_ctx)
@@ -120,6 +122,36 @@ lbox_slab_stats(struct lua_State *L)
 	return 1;
 }
 
+static ssize_t
+tuple_arena_hugepages_size_f(va_list ap)
+{
+	struct slab_arena *arena = va_arg(ap, struct slab_arena *);
+	return tuple_arena_hugepages_size(arena);
+}
+
+/**
+ * How much of the arena is backed by huge pages, see
+ * box.cfg.memtx_use_hugepages. Not a part of box.slab.info(),
+ * because it has to parse /proc/self/smaps, which is done in
+ * a coio thread.
+ */
+static int
+lbox_slab_hugepages_size(struct lua_State *L)
+{
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	if (!memtx->use_hugepages) {
+		luaL_pushuint64(L, 0);
+		return 1;
+	}
+	ssize_t size = coio_call(tuple_arena_hugepages_size_f,
+				 &memtx->arena);
+	if (size < 0)
+		return luaT_error(L);
+	luaL_pushuint64(L, size);
+	return 1;
+}
+
 static int
 lbox_slab_info(struct lua_State *L)
 {
@@ -228,6 +260,18 @@ lbox_slab_info(struct lua_State *L)
 	lua_pushstring(L, ratio_buf);
 	lua_settable(L, -3);
 
+	/*
+	 * Number and total size of tuples moved by the background
+	 * defragmentation, see box.cfg.memtx_defrag_threshold.
+	 */
+	lua_pushstring(L, "defrag_tuples_relocated");
+	luaL_pushuint64(L, memtx->defrag_stat.tuples);
+	lua_settable(L, -3);
+
+	lua_pushstring(L, "defrag_bytes_relocated");
+	luaL_pushuint64(L, memtx->defrag_stat.bytes);
+	lua_settable(L, -3);
+
 	return 1;
 }
 
@@ -281,6 +325,10 @@ box_lua_slab_init(struct lua_State *L)
 	lua_pushcfunction(L, lbox_slab_check);
 	lua_settable(L, -3);
 
+	lua_pushstring(L, "hugepages_size");
+	lua_pushcfunction(L, lbox_slab_hugepages_size);
+	lua_settable(L, -3);
+
 	lua_settable(L, -3); /* box.slab */
 
 	lua_pushstring(L, "runtime");
@@ -49,6 +49,7 @@ extern "C" {
 #include "box/schema.h"
 #include "box/user_def.h"
 #include "box/tuple.h"
+#include "box/tuple_compression.h"
 #include "box/txn.h"
 #include "box/sequence.h"
 #include "box/coll_id_cache.h"
@@ -278,6 +279,11 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 	lua_pushboolean(L, space->def->opts.is_sync);
 	lua_settable(L, i);
 
+	/* space.compression_threshold */
+	lua_pushstring(L, "compression_threshold");
+	lua_pushnumber(L, space->def->opts.compression_threshold);
+	lua_settable(L, i);
+
 	lua_pushstring(L, "enabled");
 	lua_pushboolean(L, space_index(space, 0) != 0);
 	lua_settable(L, i);
@@ -370,6 +376,30 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnil(L);
 			lua_setfield(L, -2, "hint");
 		}
+		if (space_is_memtx(space) && index_def->type == TREE &&
+		    index_opts->wide_hint) {
+			lua_pushboolean(L, true);
+			lua_setfield(L, -2, "wide_hint");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "wide_hint");
+		}
+		if (space_is_memtx(space) && index_def->type == TREE &&
+		    index_opts->inline_key) {
+			lua_pushboolean(L, true);
+			lua_setfield(L, -2, "inline_key");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "inline_key");
+		}
+		if (space_is_memtx(space) && index_def->type == HASH &&
+		    index_opts->hash_table != HASH_INDEX_TABLE_LIGHT) {
+			lua_pushstring(L, "swiss");
+			lua_setfield(L, -2, "hash_table");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "hash_table");
+		}
 
 		if (index_opts->func_id > 0) {
 			lua_pushstring(L, "func");
@@ -458,6 +488,22 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnumber(L, index_opts->bloom_fpr);
 			lua_setfield(L, -2, "bloom_fpr");
 
+			if (index_opts->read_ahead > 0) {
+				lua_pushnumber(L, index_opts->read_ahead);
+				lua_setfield(L, -2, "read_ahead");
+			}
+
+			if (index_opts->compression_level !=
+			    index_opts_default.compression_level) {
+				lua_pushnumber(L, index_opts->compression_level);
+				lua_setfield(L, -2, "compression_level");
+			}
+
+			if (index_opts->covering) {
+				lua_pushboolean(L, true);
+				lua_setfield(L, -2, "covering");
+			}
+
 			lua_settable(L, -3);
 		}
 		lua_setfield(L, -2, index_def->name);
@@ -627,6 +673,49 @@ usage_error:
 	return luaL_error(L, "Usage: space:frommap(map, opts)");
 }
 
+/**
+ * Return statistics of a space.
+ * @param Lua space id.
+ * @retval Lua table {compression = {...}}.
+ */
+static int
+lbox_space_stat(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_isnumber(L, 1))
+		return luaL_error(L, "Usage: space:stat()");
+	uint32_t id = lua_tointeger(L, 1);
+	struct space *space = space_cache_find(id);
+	if (space == NULL)
+		return luaT_error(L);
+	struct tuple_compression_stat empty;
+	memset(&empty, 0, sizeof(empty));
+	const struct tuple_compression_stat *stat =
+		tuple_compression_stat(id);
+	if (stat == NULL)
+		stat = &empty;
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushnumber(L, space->def->opts.compression_threshold);
+	lua_setfield(L, -2, "threshold");
+	luaL_pushuint64(L, stat->tuples);
+	lua_setfield(L, -2, "tuples");
+	luaL_pushuint64(L, stat->fields);
+	lua_setfield(L, -2, "fields");
+	luaL_pushuint64(L, stat->raw_size);
+	lua_setfield(L, -2, "raw_size");
+	luaL_pushuint64(L, stat->compressed_size);
+	lua_setfield(L, -2, "compressed_size");
+	lua_pushnumber(L, stat->compressed_size == 0 ? 1 :
+		       (double)stat->raw_size / stat->compressed_size);
+	lua_setfield(L, -2, "ratio");
+	luaL_pushuint64(L, stat->decode_count);
+	lua_setfield(L, -2, "decode_count");
+	lua_pushnumber(L, stat->decode_time);
+	lua_setfield(L, -2, "decode_time");
+	lua_setfield(L, -2, "compression");
+	return 1;
+}
+
 void
 box_lua_space_init(struct lua_State *L)
 {
@@ -726,6 +815,7 @@ box_lua_space_init(struct lua_State *L)
 
 	static const struct luaL_Reg space_internal_lib[] = {
 		{"frommap", lbox_space_frommap},
+		{"stat", lbox_space_stat},
 		{NULL, NULL}
 	};
 	luaL_register(L, "box.internal.space", space_internal_lib);
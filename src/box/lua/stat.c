@@ -42,6 +42,7 @@
 #include "box/iproto.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
+#include "box/memtx_tx.h"
 #include "box/sql.h"
 #include "info/info.h"
 #include "lua/info.h"
@@ -159,6 +160,7 @@ lbox_stat_reset(struct lua_State *L)
 	(void)L;
 	box_reset_stat();
 	iproto_reset_stat();
+	memtx_tx_reset_stat();
 	return 0;
 }
 
@@ -270,6 +272,15 @@ lbox_stat_net_thread_call(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_stat_memtx_tx(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	memtx_tx_stat(&info);
+	return 1;
+}
+
 static int
 lbox_stat_sql(struct lua_State *L)
 {
@@ -332,5 +343,13 @@ box_lua_stat_init(struct lua_State *L)
 	luaL_register(L, NULL, lbox_stat_net_thread_meta);
 	lua_setmetatable(L, -2);
 	lua_pop(L, 1); /* stat net module */
+
+	static const struct luaL_Reg memtxstatlib [] = {
+		{"tx", lbox_stat_memtx_tx},
+		{NULL, NULL}
+	};
+
+	luaL_register_module(L, "box.stat.memtx", memtxstatlib);
+	lua_pop(L, 1); /* stat memtx module */
 }
 
@@ -42,6 +42,7 @@
 
 #include "box/tuple.h"
 #include "box/tuple_convert.h"
+#include "box/tuple_compression.h"
 #include "box/errcode.h"
 #include "json/json.h"
 #include "mpstream/mpstream.h"
@@ -343,6 +344,31 @@ lbox_tuple_gc(struct lua_State *L)
 	return 0;
 }
 
+/**
+ * Decode a top-level tuple field to Lua, decompressing it if it
+ * is stored compressed, see tuple_compression.h.
+ */
+static void
+luamp_decode_tuple_field(struct lua_State *L, const char **field)
+{
+	if (likely(!tuple_field_is_compressed(*field))) {
+		luamp_decode(L, luaL_msgpack_default, field);
+		return;
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t size;
+	const char *raw = tuple_field_decompress(*field, &size);
+	if (raw == NULL) {
+		region_truncate(region, region_svp);
+		luaT_error(L);
+		return;
+	}
+	luamp_decode(L, luaL_msgpack_default, &raw);
+	region_truncate(region, region_svp);
+	mp_next(field);
+}
+
 static int
 lbox_tuple_slice_wrapper(struct lua_State *L)
 {
@@ -356,7 +382,7 @@ lbox_tuple_slice_wrapper(struct lua_State *L)
 	uint32_t field_no = start;
 	field = box_tuple_seek(it, start);
 	while (field && field_no < end) {
-		luamp_decode(L, luaL_msgpack_default, &field);
+		luamp_decode_tuple_field(L, &field);
 		++field_no;
 		field = box_tuple_next(it);
 	}
@@ -465,6 +491,20 @@ luamp_encode_tuple(struct lua_State *L, struct luaL_serializer *cfg,
 void
 tuple_to_mpstream(struct tuple *tuple, struct mpstream *stream)
 {
+	if (unlikely(tuple->has_compressed_fields)) {
+		/*
+		 * The stream may be backed by the fiber region, so
+		 * the decompressed data is freed along with it.
+		 */
+		uint32_t bsize;
+		const char *data = tuple_data_decompressed(tuple, &bsize);
+		if (data == NULL) {
+			stream->error(stream->error_ctx);
+			return;
+		}
+		mpstream_memcpy(stream, data, bsize);
+		return;
+	}
 	size_t bsize = box_tuple_bsize(tuple);
 	char *ptr = mpstream_reserve(stream, bsize);
 	box_tuple_to_buf(tuple, ptr, bsize);
@@ -503,7 +543,7 @@ lbox_tuple_to_map(struct lua_State *L)
 		/* Access by name. */
 		const char *name = format->dict->names[i];
 		lua_pushstring(L, name);
-		luamp_decode(L, luaL_msgpack_default, &pos);
+		luamp_decode_tuple_field(L, &pos);
 		lua_rawset(L, -3);
 		if (names_only)
 			continue;
@@ -520,7 +560,7 @@ lbox_tuple_to_map(struct lua_State *L)
 		return 1;
 	/* Access for not named fields by index. */
 	for (int i = n_named; i < field_count; ++i) {
-		luamp_decode(L, luaL_msgpack_default, &pos);
+		luamp_decode_tuple_field(L, &pos);
 		lua_rawseti(L, -2, i + TUPLE_INDEX_BASE);
 	}
 	return 1;
@@ -606,9 +646,14 @@ lbox_tuple_transform(struct lua_State *L)
 	mpstream_flush(&stream);
 
 	uint32_t new_size = 0, bsize;
-	const char *old_data = tuple_data_range(tuple, &bsize);
 	struct region *region = &fiber()->gc;
 	size_t used = region_used(region);
+	/* Update operations may not be applied to compressed fields. */
+	const char *old_data = tuple_data_decompressed(tuple, &bsize);
+	if (old_data == NULL) {
+		cord_ibuf_put(buf);
+		return luaT_error(L);
+	}
 	struct tuple_format *format = tuple_format(tuple);
 	struct tuple *new_tuple = NULL;
 	/*
@@ -657,15 +702,47 @@ lbox_tuple_field_by_path(struct lua_State *L)
 	const char *field = NULL, *path = lua_tolstring(L, 2, &len);
 	if (len == 0)
 		return 0;
-	field = tuple_field_raw_by_full_path(tuple_format(tuple),
-					     tuple_data(tuple),
-					     tuple_field_map(tuple),
+	struct tuple_format *format = tuple_format(tuple);
+	const char *data = tuple_data(tuple);
+	const uint32_t *field_map = tuple_field_map(tuple);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	if (unlikely(tuple->has_compressed_fields)) {
+		/*
+		 * The path may lead into a compressed field, so look
+		 * it up in the decompressed data, with a field map
+		 * built for it.
+		 */
+		uint32_t size;
+		data = tuple_data_decompressed(tuple, &size);
+		struct field_map_builder builder;
+		if (data == NULL ||
+		    tuple_field_map_create(format, data, false, &builder) != 0)
+			goto error;
+		uint32_t field_map_size = field_map_build_size(&builder);
+		char *buf = region_aligned_alloc(region, field_map_size,
+						 alignof(uint32_t));
+		if (buf == NULL) {
+			diag_set(OutOfMemory, field_map_size,
+				 "region_aligned_alloc", "field_map");
+			goto error;
+		}
+		field_map_build(&builder, buf);
+		field_map = (const uint32_t *)(buf + field_map_size);
+	}
+	field = tuple_field_raw_by_full_path(format, data, field_map,
 					     path, (uint32_t)len,
 					     lua_hashstring(L, 2));
-	if (field == NULL)
+	if (field == NULL) {
+		region_truncate(region, region_svp);
 		return 0;
+	}
 	luamp_decode(L, luaL_msgpack_default, &field);
+	region_truncate(region, region_svp);
 	return 1;
+error:
+	region_truncate(region, region_svp);
+	return luaT_error(L);
 }
 
 static int
@@ -58,6 +58,18 @@ box_tuple_update(box_tuple_t *tuple, const char *expr, const char *expr_end);
 
 box_tuple_t *
 box_tuple_upsert(box_tuple_t *tuple, const char *expr, const char *expr_end);
+
+const char *
+tuple_field_decompress(const char *field, uint32_t *size);
+
+const char *
+tuple_data_decompressed(box_tuple_t *tuple, uint32_t *size);
+
+size_t
+box_region_used(void);
+
+void
+box_region_truncate(size_t size);
 ]]
 
 local builtin = ffi.C
@@ -69,6 +81,45 @@ local is_tuple = function(tuple)
     return tuple ~= nil and type(tuple) == 'cdata' and ffi.istype(const_tuple_ref_t, tuple)
 end
 
+local MP_COMPRESSION = 5
+local data_size = ffi.new('uint32_t[1]')
+
+-- Check if a tuple field is stored compressed, see tuple_compression.h.
+local function field_is_compressed(field)
+    local p = ffi.cast('const uint8_t *', field)
+    local c = p[0]
+    if c >= 0xd4 and c <= 0xd8 then
+        -- fixext
+        return p[1] == MP_COMPRESSION
+    elseif c == 0xc7 then
+        -- ext 8
+        return p[2] == MP_COMPRESSION
+    elseif c == 0xc8 then
+        -- ext 16
+        return p[3] == MP_COMPRESSION
+    elseif c == 0xc9 then
+        -- ext 32
+        return p[5] == MP_COMPRESSION
+    end
+    return false
+end
+
+-- Decode a top-level tuple field, decompressing it if necessary.
+local function decode_field(field)
+    if not field_is_compressed(field) then
+        return (msgpackffi.decode_unchecked(field))
+    end
+    local svp = builtin.box_region_used()
+    local raw = builtin.tuple_field_decompress(field, data_size)
+    if raw == nil then
+        builtin.box_region_truncate(svp)
+        return box.error()
+    end
+    local res = msgpackffi.decode_unchecked(raw)
+    builtin.box_region_truncate(svp)
+    return res
+end
+
 local encode_fix = msgpackffi.internal.encode_fix
 local encode_array = msgpackffi.internal.encode_array
 local encode_r = msgpackffi.internal.encode_r
@@ -156,8 +207,7 @@ local function tuple_iterator_next(it, tuple, pos)
             error("error: invalid key to 'next'")
         end
     end
-    -- () used to shrink the return stack to one value
-    return pos + 1, (msgpackffi.decode_unchecked(field))
+    return pos + 1, decode_field(field)
 end;
 
 -- See http://www.lua.org/manual/5.2/manual.html#pdf-next
@@ -170,7 +220,7 @@ local function tuple_next(tuple, pos)
     if field == nil then
         return nil
     end
-    return pos + 1, (msgpackffi.decode_unchecked(field))
+    return pos + 1, decode_field(field)
 end
 
 -- See http://www.lua.org/manual/5.2/manual.html#pdf-ipairs
@@ -203,7 +253,7 @@ local function tuple_totable(tuple, i, j)
     end
     local ret = {}
     while field ~= nil and i <= j do
-        local val = msgpackffi.decode_unchecked(field)
+        local val = decode_field(field)
         table.insert(ret, val)
         i = i + 1
         field = builtin.box_tuple_next(it)
@@ -269,10 +319,17 @@ end
 -- Set encode hooks for msgpackffi
 local function tuple_to_msgpack(buf, tuple)
     assert(ffi.istype(tuple_t, tuple))
-    local bsize = builtin.box_tuple_bsize(tuple)
+    local svp = builtin.box_region_used()
+    local data = builtin.tuple_data_decompressed(tuple, data_size)
+    if data == nil then
+        builtin.box_region_truncate(svp)
+        return box.error()
+    end
+    local bsize = data_size[0]
     buf:reserve(bsize)
-    builtin.box_tuple_to_buf(tuple, buf.wpos, bsize)
+    ffi.copy(buf.wpos, data, bsize)
     buf.wpos = buf.wpos + bsize
+    builtin.box_region_truncate(svp)
 end
 
 local function tuple_bsize(tuple)
@@ -315,8 +372,7 @@ local tuple_field = function(tuple, field_n)
     if field == nil then
         return nil
     end
-    -- Use () to shrink stack to the first return value
-    return (msgpackffi.decode_unchecked(field))
+    return decode_field(field)
 end
 
 ffi.metatype(tuple_t, {
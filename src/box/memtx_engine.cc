@@ -39,6 +39,7 @@
 #include "errinj.h"
 #include "coio_file.h"
 #include "tuple.h"
+#include "tuple_compression.h"
 #include "txn.h"
 #include "memtx_tx.h"
 #include "memtx_tree.h"
@@ -52,6 +53,7 @@
 #include "raft.h"
 #include "txn_limbo.h"
 #include "memtx_allocator.h"
+#include "assoc.h"
 
 #include <type_traits>
 
@@ -166,6 +168,9 @@ memtx_engine_shutdown(struct engine *engine)
 		checkpoint_cancel(memtx->checkpoint);
 	if (memtx->replica_join_cord != NULL)
 		replica_join_cancel(memtx->replica_join_cord);
+	free(memtx->defrag_key);
+	fiber_cond_destroy(&memtx->bulk_load_cond);
+	mh_i32ptr_delete(memtx->delayed_formats);
 	mempool_destroy(&memtx->iterator_pool);
 	if (mempool_is_initialized(&memtx->rtree_iterator_pool))
 		mempool_destroy(&memtx->rtree_iterator_pool);
@@ -248,6 +253,48 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 	return 0;
 }
 
+int
+memtx_engine_recover_join_snapshot(struct memtx_engine *memtx,
+				   const char *filename)
+{
+	say_info("loading the master checkpoint from `%s'", filename);
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, filename) < 0)
+		return -1;
+
+	int rc;
+	struct xrow_header row;
+	uint64_t row_count = 0;
+	int is_space_system = -1;
+	while ((rc = xlog_cursor_next(&cursor, &row, false)) == 0) {
+		/*
+		 * Data of replica-local spaces is never sent to
+		 * replicas, only their definitions are.
+		 */
+		if (row.group_id == GROUP_LOCAL)
+			continue;
+		rc = memtx_engine_recover_snapshot_row(memtx, &row,
+						       &is_space_system);
+		if (rc < 0)
+			break;
+		if (++row_count % 100000 == 0) {
+			say_info_ratelimited("%.1fM rows processed",
+					     row_count / 1e6);
+			fiber_yield_timeout(0);
+		}
+	}
+	bool is_eof = xlog_cursor_is_eof(&cursor);
+	xlog_cursor_close(&cursor, false);
+	if (rc < 0)
+		return -1;
+	if (!is_eof) {
+		diag_set(XlogError, "snapshot `%s' has no EOF marker",
+			 filename);
+		return -1;
+	}
+	return 0;
+}
+
 static int
 memtx_engine_recover_raft(const struct xrow_header *row)
 {
@@ -606,6 +653,8 @@ checkpoint_write_tuple(struct xlog *l, uint32_t space_id, uint32_t group_id,
 struct checkpoint_entry {
 	uint32_t space_id;
 	uint32_t group_id;
+	/** Tuples may have compressed fields to decompress. */
+	bool decompress;
 	struct snapshot_iterator *iterator;
 	struct rlist link;
 };
@@ -714,6 +763,7 @@ checkpoint_add_space(struct space *sp, void *data)
 
 	entry->space_id = space_id(sp);
 	entry->group_id = space_group_id(sp);
+	entry->decompress = sp->format->is_compressed;
 	entry->iterator = index_create_snapshot_iterator(pk);
 	if (entry->iterator == NULL)
 		return -1;
@@ -775,9 +825,18 @@ checkpoint_f(va_list ap)
 		const char *data;
 		struct snapshot_iterator *it = entry->iterator;
 		while ((rc = it->next(it, &data, &size)) == 0 && data != NULL) {
+			struct region *region = &fiber()->gc;
+			size_t region_svp = region_used(region);
+			if (entry->decompress) {
+				data = tuple_decompress(data, data + size,
+							&size);
+				if (data == NULL)
+					goto fail;
+			}
 			if (checkpoint_write_tuple(&snap, entry->space_id,
 					entry->group_id, data, size) != 0)
 				goto fail;
+			region_truncate(region, region_svp);
 		}
 		if (rc != 0)
 			goto fail;
@@ -797,12 +856,25 @@ fail:
 	return -1;
 }
 
+/**
+ * Wait for all bulk loads to complete. A read view opened during
+ * a bulk load would include tuples whose rows haven't reached WAL
+ * yet and so would follow the read view vclock.
+ */
+static void
+memtx_engine_wait_bulk_load(struct memtx_engine *memtx)
+{
+	while (memtx->bulk_load_count > 0)
+		fiber_cond_wait(&memtx->bulk_load_cond);
+}
+
 static int
 memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 {
 	(void) is_scheduled;
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 
+	memtx_engine_wait_bulk_load(memtx);
 	assert(memtx->checkpoint == NULL);
 	memtx->checkpoint = checkpoint_new(memtx->snap_dir.dirname,
 					   memtx->snap_io_rate_limit);
@@ -934,6 +1006,8 @@ memtx_engine_backup(struct engine *engine, const struct vclock *vclock,
 struct memtx_join_entry {
 	struct rlist in_ctx;
 	uint32_t space_id;
+	/** Tuples may have compressed fields to decompress. */
+	bool decompress;
 	struct snapshot_iterator *iterator;
 };
 
@@ -963,6 +1037,7 @@ memtx_join_add_space(struct space *space, void *arg)
 		return -1;
 	}
 	entry->space_id = space_id(space);
+	entry->decompress = space->format->is_compressed;
 	entry->iterator = index_create_snapshot_iterator(pk);
 	if (entry->iterator == NULL) {
 		free(entry);
@@ -975,7 +1050,7 @@ memtx_join_add_space(struct space *space, void *arg)
 static int
 memtx_engine_prepare_join(struct engine *engine, void **arg)
 {
-	(void)engine;
+	memtx_engine_wait_bulk_load((struct memtx_engine *)engine);
 	struct memtx_join_ctx *ctx =
 		(struct memtx_join_ctx *)malloc(sizeof(*ctx));
 	if (ctx == NULL) {
@@ -1023,9 +1098,18 @@ memtx_join_f(va_list ap)
 		uint32_t size;
 		const char *data;
 		while ((rc = it->next(it, &data, &size)) == 0 && data != NULL) {
+			struct region *region = &fiber()->gc;
+			size_t region_svp = region_used(region);
+			if (entry->decompress) {
+				data = tuple_decompress(data, data + size,
+							&size);
+				if (data == NULL)
+					return -1;
+			}
 			if (memtx_join_send_tuple(ctx->stream, entry->space_id,
 						  data, size) != 0)
 				return -1;
+			region_truncate(region, region_svp);
 		}
 		if (rc != 0)
 			return -1;
@@ -1153,6 +1237,274 @@ memtx_engine_gc_f(va_list va)
 	return 0;
 }
 
+enum {
+	/** Max number of tuples visited by one defragmentation step. */
+	MEMTX_DEFRAG_BATCH_SIZE = 100,
+};
+
+/**
+ * How often the defragmentation fiber checks the tuple arena
+ * fragmentation when it has nothing to do, in seconds.
+ */
+static const double MEMTX_DEFRAG_CHECK_PERIOD = 1;
+
+/**
+ * Return the fraction of memory allocated for tuples by the small
+ * allocator that isn't used. The system allocator doesn't suffer
+ * from fragmentation we can do anything about, so it isn't counted.
+ */
+static double
+memtx_engine_fragmentation(void)
+{
+	struct allocator_stats stats;
+	memset(&stats, 0, sizeof(stats));
+	allocators_stats(&stats);
+	if (stats.small.total == 0)
+		return 0;
+	return 1 - (double)stats.small.used / stats.small.total;
+}
+
+/** Check if the defragmentation fiber should relocate tuples now. */
+static bool
+memtx_engine_needs_defrag(struct memtx_engine *memtx)
+{
+	/*
+	 * Tuples can't be moved while they may be referenced by
+	 * a read view or by the transaction manager: in the former
+	 * case the old tuple wouldn't be freed anyway, in the latter
+	 * the tuple is referenced by its story. Note that free_mode
+	 * stays MEMTX_ENGINE_COLLECT_GARBAGE after the last read view
+	 * is closed, so check the number of read views instead.
+	 */
+	return memtx->defrag_threshold > 0 && memtx->state == MEMTX_OK &&
+	       memtx->delayed_free_mode == 0 &&
+	       !memtx_tx_manager_use_mvcc_engine &&
+	       memtx_engine_fragmentation() > memtx->defrag_threshold;
+}
+
+/** Argument of memtx_engine_defrag_next_space_cb(). */
+struct memtx_defrag_next_space_arg {
+	struct memtx_engine *memtx;
+	/** Look up a space with the least id greater than this. */
+	uint32_t space_id;
+	/** The space found. */
+	struct space *space;
+};
+
+static int
+memtx_engine_defrag_next_space_cb(struct space *space, void *data)
+{
+	struct memtx_defrag_next_space_arg *arg =
+		(struct memtx_defrag_next_space_arg *)data;
+	if (space->engine != &arg->memtx->base || space_is_system(space) ||
+	    space->index_count == 0 || space_id(space) <= arg->space_id)
+		return 0;
+	if (arg->space == NULL || space_id(space) < space_id(arg->space))
+		arg->space = space;
+	return 0;
+}
+
+/** Finish defragmentation of the current space. */
+static void
+memtx_engine_defrag_next_space(struct memtx_engine *memtx)
+{
+	free(memtx->defrag_key);
+	memtx->defrag_key = NULL;
+}
+
+/**
+ * Move a tuple that is only referenced by its space to a new
+ * memory location, provided the allocator returns a chunk with
+ * a lower address. The small allocator allocates from the slab
+ * with the least address that has free space, so relocating
+ * tuples this way packs them into fewer slabs and lets sparse
+ * slabs be returned to the arena.
+ *
+ * Returns true if the tuple was relocated.
+ */
+static bool
+memtx_space_relocate_tuple(struct memtx_engine *memtx, struct space *space,
+			   struct tuple *old_tuple)
+{
+	struct tuple_format *format = tuple_format(old_tuple);
+	uint32_t bsize;
+	const char *data = tuple_data_range(old_tuple, &bsize);
+	struct tuple *new_tuple =
+		format->vtab.tuple_new(format, data, data + bsize);
+	if (new_tuple == NULL) {
+		diag_clear(diag_get());
+		return false;
+	}
+	if ((uintptr_t)new_tuple > (uintptr_t)old_tuple ||
+	    memtx_index_extent_reserve(memtx,
+				       RESERVE_EXTENTS_BEFORE_REPLACE) != 0) {
+		format->vtab.tuple_delete(format, new_tuple);
+		diag_clear(diag_get());
+		return false;
+	}
+	uint32_t i;
+	for (i = 0; i < space->index_count; i++) {
+		struct tuple *unused;
+		struct index *index = space->index[i];
+		if (index_replace(index, old_tuple, new_tuple,
+				  i == 0 ? DUP_REPLACE : DUP_INSERT,
+				  &unused, &unused) != 0)
+			goto rollback;
+	}
+	memtx->defrag_stat.tuples++;
+	memtx->defrag_stat.bytes += tuple_size(old_tuple);
+	/* Move the reference held by the space. */
+	tuple_ref(new_tuple);
+	tuple_unref(old_tuple);
+	return true;
+rollback:
+	for (; i > 0; i--) {
+		struct tuple *unused;
+		struct index *index = space->index[i - 1];
+		/* Rollback must not fail. */
+		if (index_replace(index, new_tuple, old_tuple,
+				  DUP_INSERT, &unused, &unused) != 0) {
+			diag_log();
+			unreachable();
+			panic("failed to rollback tuple relocation");
+		}
+	}
+	format->vtab.tuple_delete(format, new_tuple);
+	diag_clear(diag_get());
+	return false;
+}
+
+/**
+ * Visit the next batch of tuples in the space being defragmented
+ * and relocate those that aren't referenced by anyone but the
+ * space. Returns the number of visited tuples or -1 if all spaces
+ * have been visited and the next pass should start over.
+ */
+static int
+memtx_engine_defrag_step(struct memtx_engine *memtx)
+{
+	struct space *space = NULL;
+	if (memtx->defrag_key != NULL &&
+	    memtx->defrag_schema_version == schema_version)
+		space = space_by_id(memtx->defrag_space_id);
+	if (space == NULL || space->index_count == 0) {
+		memtx_engine_defrag_next_space(memtx);
+		struct memtx_defrag_next_space_arg arg;
+		arg.memtx = memtx;
+		arg.space_id = memtx->defrag_space_id;
+		arg.space = NULL;
+		space_foreach(memtx_engine_defrag_next_space_cb, &arg);
+		if (arg.space == NULL) {
+			/* The pass is complete, start over. */
+			memtx->defrag_space_id = 0;
+			return -1;
+		}
+		space = arg.space;
+		memtx->defrag_space_id = space_id(space);
+	}
+	if (memtx_space_is_bulk_loading(space)) {
+		/* The loader holds pointers to the space tuples. */
+		memtx_engine_defrag_next_space(memtx);
+		return 0;
+	}
+	if (!rlist_empty(&space->on_replace)) {
+		/*
+		 * Tuples are relocated with raw index replace, which
+		 * bypasses on_replace triggers. Among others, these are
+		 * used to keep an index being built in sync with the
+		 * space, so moving a tuple would leave a dangling
+		 * pointer in it.
+		 */
+		memtx_engine_defrag_next_space(memtx);
+		return 0;
+	}
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (space->index[i]->def->key_def->for_func_index) {
+			/* Functional keys can't be recomputed here. */
+			memtx_engine_defrag_next_space(memtx);
+			return 0;
+		}
+	}
+	struct index *pk = space->index[0];
+	const char *key = memtx->defrag_key;
+	uint32_t part_count = key != NULL ? mp_decode_array(&key) : 0;
+	struct iterator *it = index_create_iterator(
+		pk, key != NULL ? ITER_GT : ITER_ALL, key, part_count);
+	if (it == NULL) {
+		diag_log();
+		memtx_engine_defrag_next_space(memtx);
+		return 0;
+	}
+	/*
+	 * Collect a batch of tuples first: an index can't be
+	 * modified while it is iterated.
+	 */
+	struct tuple *batch[MEMTX_DEFRAG_BATCH_SIZE];
+	int count = 0;
+	struct tuple *tuple;
+	while (count < MEMTX_DEFRAG_BATCH_SIZE &&
+	       iterator_next(it, &tuple) == 0 && tuple != NULL) {
+		tuple_ref(tuple);
+		batch[count++] = tuple;
+	}
+	iterator_delete(it);
+	diag_clear(diag_get());
+	if (count < MEMTX_DEFRAG_BATCH_SIZE) {
+		memtx_engine_defrag_next_space(memtx);
+	} else {
+		struct region *region = &fiber()->gc;
+		size_t region_svp = region_used(region);
+		uint32_t key_size;
+		const char *last_key = tuple_extract_key(
+			batch[count - 1], pk->def->key_def, MULTIKEY_NONE,
+			&key_size);
+		char *buf = last_key != NULL ?
+			    (char *)realloc(memtx->defrag_key, key_size) : NULL;
+		if (buf != NULL) {
+			memcpy(buf, last_key, key_size);
+			memtx->defrag_key = buf;
+			memtx->defrag_schema_version = schema_version;
+		} else {
+			diag_clear(diag_get());
+			memtx_engine_defrag_next_space(memtx);
+		}
+		region_truncate(region, region_svp);
+	}
+	for (int i = 0; i < count; i++) {
+		tuple = batch[i];
+		/* The tuple is referenced by the space and by us. */
+		if (tuple_has_exact_refs(tuple, 2) && !tuple->is_dirty)
+			memtx_space_relocate_tuple(memtx, space, tuple);
+		tuple_unref(tuple);
+	}
+	return count;
+}
+
+/**
+ * Defragmentation fiber. When the tuple arena gets fragmented
+ * (see memtx_engine::defrag_threshold), it walks over memtx spaces
+ * in batches, relocating tuples so that sparse slabs are released.
+ */
+static int
+memtx_engine_defrag_f(va_list va)
+{
+	struct memtx_engine *memtx = va_arg(va, struct memtx_engine *);
+	while (!fiber_is_cancelled()) {
+		if (!memtx_engine_needs_defrag(memtx)) {
+			fiber_sleep(MEMTX_DEFRAG_CHECK_PERIOD);
+			continue;
+		}
+		int count = memtx_engine_defrag_step(memtx);
+		if (count < 0) {
+			fiber_sleep(MEMTX_DEFRAG_CHECK_PERIOD);
+			continue;
+		}
+		/* Throttle relocation to defrag_rate tuples per second. */
+		fiber_sleep(count / memtx->defrag_rate);
+	}
+	return 0;
+}
+
 void
 memtx_set_tuple_format_vtab(const char *allocator_name)
 {
@@ -1172,7 +1524,7 @@ memtx_set_tuple_format_vtab(const char *allocator_name)
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, bool use_hugepages, unsigned granularity,
 		 const char *allocator, float alloc_factor)
 {
 	int64_t snap_signature;
@@ -1222,6 +1574,9 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->gc_fiber = fiber_new("memtx.gc", memtx_engine_gc_f);
 	if (memtx->gc_fiber == NULL)
 		goto fail;
+	memtx->defrag_fiber = fiber_new("memtx.defrag", memtx_engine_defrag_f);
+	if (memtx->defrag_fiber == NULL)
+		goto fail;
 
 	/* Apply lowest allowed objsize bound. */
 	if (objsize_min < OBJSIZE_MIN)
@@ -1241,6 +1596,8 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	quota_init(&memtx->quota, tuple_arena_max_size);
 	tuple_arena_create(&memtx->arena, &memtx->quota, tuple_arena_max_size,
 			   SLAB_SIZE, dontdump, "memtx");
+	memtx->use_hugepages = use_hugepages &&
+			       tuple_arena_use_hugepages(&memtx->arena, "memtx");
 	slab_cache_create(&memtx->slab_cache, &memtx->arena);
 	memtx->free_mode = MEMTX_ENGINE_FREE;
 	float actual_alloc_factor;
@@ -1262,17 +1619,29 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		       MEMTX_ITERATOR_SIZE);
 	memtx->num_reserved_extents = 0;
 	memtx->reserved_extents = NULL;
+	memtx->delayed_formats = mh_i32ptr_new();
 
 	memtx->state = MEMTX_INITIALIZED;
 	memtx->max_tuple_size = MAX_TUPLE_SIZE;
+	tuple_compression_set_max_size(MAX_TUPLE_SIZE);
 	memtx->force_recovery = force_recovery;
 
 	memtx->replica_join_cord = NULL;
 
+	memtx->defrag_threshold = 0;
+	memtx->defrag_rate = 10000;
+	memtx->defrag_space_id = 0;
+	memtx->defrag_key = NULL;
+	memtx->defrag_schema_version = 0;
+	memtx->bulk_load_count = 0;
+	fiber_cond_create(&memtx->bulk_load_cond);
+	memset(&memtx->defrag_stat, 0, sizeof(memtx->defrag_stat));
+
 	memtx->base.vtab = &memtx_engine_vtab;
 	memtx->base.name = "memtx";
 
 	fiber_start(memtx->gc_fiber, memtx);
+	fiber_start(memtx->defrag_fiber, memtx);
 	return memtx;
 fail:
 	xdir_destroy(&memtx->snap_dir);
@@ -1302,6 +1671,10 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size)
 			 "cannot decrease memory size at runtime");
 		return -1;
 	}
+	if (memtx->use_hugepages && size > quota_total(&memtx->quota)) {
+		say_warn("memory added to the memtx arena at runtime "
+			 "isn't backed by huge pages");
+	}
 	quota_set(&memtx->quota, size);
 	return 0;
 }
@@ -1310,6 +1683,22 @@ void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 {
 	memtx->max_tuple_size = max_size;
+	tuple_compression_set_max_size(max_size);
+}
+
+void
+memtx_engine_set_defrag_threshold(struct memtx_engine *memtx,
+				  double threshold)
+{
+	memtx->defrag_threshold = threshold;
+	fiber_wakeup(memtx->defrag_fiber);
+}
+
+void
+memtx_engine_set_defrag_rate(struct memtx_engine *memtx, double rate)
+{
+	memtx->defrag_rate = rate;
+	fiber_wakeup(memtx->defrag_fiber);
 }
 
 void
@@ -1329,6 +1718,13 @@ memtx_leave_delayed_free_mode(struct memtx_engine *memtx)
 	if (--memtx->delayed_free_mode == 0) {
 		memtx->free_mode = MEMTX_ENGINE_COLLECT_GARBAGE;
 		memtx_allocators_set_mode(memtx->free_mode);
+		mh_int_t i;
+		mh_foreach(memtx->delayed_formats, i) {
+			struct tuple_format *format = (struct tuple_format *)
+				mh_i32ptr_node(memtx->delayed_formats, i)->val;
+			tuple_format_unref(format);
+		}
+		mh_i32ptr_clear(memtx->delayed_formats);
 	}
 }
 
@@ -1346,6 +1742,13 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 	uint32_t data_offset, field_map_size;
 	char *raw;
 	bool make_compact;
+	bool has_compressed_fields = false;
+	if (unlikely(format->is_compressed)) {
+		data = tuple_compress(format, data, end, &end,
+				      &has_compressed_fields);
+		if (data == NULL)
+			goto end;
+	}
 	if (tuple_field_map_create(format, data, true, &builder) != 0)
 		goto end;
 	field_map_size = field_map_build_size(&builder);
@@ -1393,6 +1796,7 @@ memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
 	tuple = &memtx_tuple->base;
 	tuple_create(tuple, 0, tuple_format_id(format),
 		     data_offset, tuple_len, make_compact);
+	tuple->has_compressed_fields = has_compressed_fields;
 	memtx_tuple->version = memtx->snapshot_version;
 	tuple_format_ref(format);
 	raw = (char *) tuple + data_offset;
@@ -1419,6 +1823,20 @@ memtx_tuple_delete(struct tuple_format *format, struct tuple *tuple)
 		MemtxAllocator<ALLOC>::free(memtx_tuple);
 	} else {
 		MemtxAllocator<ALLOC>::delayed_free(memtx_tuple);
+		/*
+		 * Pass the tuple reference to the format over to
+		 * memtx_engine::delayed_formats unless it's already
+		 * there.
+		 */
+		uint32_t format_id = tuple_format_id(format);
+		if (mh_i32ptr_find(memtx->delayed_formats, format_id,
+				   NULL) == mh_end(memtx->delayed_formats)) {
+			const struct mh_i32ptr_node_t node = {format_id,
+							      format};
+			mh_i32ptr_put(memtx->delayed_formats, &node,
+				      NULL, NULL);
+			return;
+		}
 	}
 	tuple_format_unref(format);
 }
@@ -1527,6 +1945,19 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (old_def->opts.wide_hint != new_def->opts.wide_hint)
+		return true;
+	if (old_def->opts.inline_key != new_def->opts.inline_key)
+		return true;
+	/*
+	 * Wide hints are computed with the tree comparison key
+	 * definition, which depends on nullability of key parts.
+	 */
+	if ((new_def->opts.wide_hint || new_def->opts.inline_key) &&
+	    old_def->key_def->is_nullable != new_def->key_def->is_nullable)
+		return true;
+	if (old_def->opts.hash_table != new_def->opts.hash_table)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -38,6 +38,7 @@
 #include <small/mempool.h>
 
 #include "engine.h"
+#include "fiber_cond.h"
 #include "xlog.h"
 #include "salad/stailq.h"
 #include "sysalloc.h"
@@ -50,6 +51,7 @@ struct index;
 struct fiber;
 struct tuple;
 struct tuple_format;
+struct mh_i32ptr_t;
 
 /**
  * Free mode, determines a strategy for freeing up memory
@@ -118,7 +120,7 @@ enum memtx_reserve_extents_num {
  * allocated for each iterator (except rtree index iterator that
  * is significantly bigger so has own pool).
  */
-#define MEMTX_ITERATOR_SIZE (176)
+#define MEMTX_ITERATOR_SIZE (200)
 
 struct memtx_engine {
 	struct engine base;
@@ -146,6 +148,12 @@ struct memtx_engine {
 	 * is reflected in box.slab.info(), @sa lua/slab.c.
 	 */
 	struct slab_arena arena;
+	/**
+	 * Set if the arena is backed by transparent huge pages,
+	 * box.cfg.memtx_use_hugepages. Memory added to the arena
+	 * by raising memtx_memory at runtime uses regular pages.
+	 */
+	bool use_hugepages;
 	/** Slab cache for allocating tuples. */
 	struct slab_cache slab_cache;
 	/** Slab cache for allocating index extents. */
@@ -171,6 +179,13 @@ struct memtx_engine {
 	 * memtx_leave_delayed_free_mode() is called.
 	 */
 	uint32_t delayed_free_mode;
+	/**
+	 * Formats of tuples whose freeing was delayed, indexed by
+	 * format id. Such a tuple may still be accessed via a read
+	 * view, so its format is referenced until delayed free mode
+	 * is left.
+	 */
+	struct mh_i32ptr_t *delayed_formats;
 	/** Memory pool for rtree index iterator. */
 	struct mempool rtree_iterator_pool;
 	/**
@@ -193,6 +208,51 @@ struct memtx_engine {
 	 * Free mode, determines a strategy for freeing up memory
 	 */
 	enum memtx_engine_free_mode free_mode;
+	/**
+	 * Tuple arena fragmentation, i.e. the fraction of memory
+	 * allocated for tuples that isn't used, above which tuples
+	 * are relocated by the defragmentation fiber,
+	 * box.cfg.memtx_defrag_threshold. 0 disables defragmentation.
+	 */
+	double defrag_threshold;
+	/**
+	 * Max number of tuples relocated by the defragmentation
+	 * fiber per second, box.cfg.memtx_defrag_rate.
+	 */
+	double defrag_rate;
+	/** Defragmentation fiber, see memtx_engine_defrag_f(). */
+	struct fiber *defrag_fiber;
+	/** Id of the space being defragmented. */
+	uint32_t defrag_space_id;
+	/**
+	 * Primary key of the last tuple visited by the
+	 * defragmentation fiber in the space being defragmented,
+	 * NULL if the space hasn't been started yet.
+	 */
+	char *defrag_key;
+	/**
+	 * Schema version at the time defrag_key was saved. If the
+	 * schema changes, the space may have been altered or dropped
+	 * and recreated with the same id so the key is discarded.
+	 */
+	uint32_t defrag_schema_version;
+	/**
+	 * Number of bulk loads in progress, see
+	 * memtx_space_bulk_load_begin(). Tuples of a bulk load are
+	 * visible in the space before their rows reach WAL, so
+	 * checkpoints and initial joins wait for bulk loads to
+	 * complete on bulk_load_cond.
+	 */
+	int bulk_load_count;
+	/** Signaled when bulk_load_count drops to 0. */
+	struct fiber_cond bulk_load_cond;
+	/** Defragmentation statistics, reported by box.slab.info(). */
+	struct {
+		/** Number of relocated tuples. */
+		uint64_t tuples;
+		/** Total size of relocated tuples. */
+		uint64_t bytes;
+	} defrag_stat;
 };
 
 struct memtx_gc_task;
@@ -227,13 +287,21 @@ memtx_engine_schedule_gc(struct memtx_engine *memtx,
 struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		 bool dontdump, unsigned granularity,
+		 bool dontdump, bool use_hugepages, unsigned granularity,
 		 const char *allocator, float alloc_factor);
 
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock);
 
+/**
+ * Load a snapshot file received from the master on checkpoint
+ * initial join. Rows of replica-local spaces are skipped.
+ */
+int
+memtx_engine_recover_join_snapshot(struct memtx_engine *memtx,
+				   const char *filename);
+
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
@@ -243,6 +311,18 @@ memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+/**
+ * Set the tuple arena fragmentation that triggers defragmentation,
+ * 0 disables it.
+ */
+void
+memtx_engine_set_defrag_threshold(struct memtx_engine *memtx,
+				  double threshold);
+
+/** Set the max number of tuples relocated per second. */
+void
+memtx_engine_set_defrag_rate(struct memtx_engine *memtx, double rate);
+
 /**
  * Enter tuple delayed free mode: tuple allocated before the call
  * won't be freed until memtx_leave_delayed_free_mode() is called.
@@ -331,13 +411,13 @@ memtx_set_tuple_format_vtab(const char *allocator_name);
 static inline struct memtx_engine *
 memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
-		    bool dontdump, unsigned granularity,
+		    bool dontdump, bool use_hugepages, unsigned granularity,
 		    const char *allocator, float alloc_factor)
 {
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size,
-				 objsize_min, dontdump,
+				 objsize_min, dontdump, use_hugepages,
 				 granularity, allocator, alloc_factor);
 	if (memtx == NULL)
 		diag_raise();
@@ -0,0 +1,1092 @@
+/*
+ * Copyright 2010-2016, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "memtx_hash.h"
+#include "say.h"
+#include "fiber.h"
+#include "index.h"
+#include "tuple.h"
+#include "txn.h"
+#include "memtx_tx.h"
+#include "memtx_engine.h"
+#include "space.h"
+#include "schema.h" /* space_by_id(), space_cache_find() */
+#include "errinj.h"
+
+#include <small/mempool.h>
+
+/**
+ * The index is parametrized with HASH_TABLE, which is a value of
+ * enum hash_index_table_type selecting the hash table the index
+ * is built on, see the `hash_table` index option.
+ */
+
+static inline bool
+memtx_hash_equal(struct tuple *tuple_a, struct tuple *tuple_b,
+		 struct key_def *key_def)
+{
+	return tuple_compare(tuple_a, HINT_NONE,
+			     tuple_b, HINT_NONE, key_def) == 0;
+}
+
+static inline bool
+memtx_hash_equal_key(struct tuple *tuple, const char *key,
+		     struct key_def *key_def)
+{
+	return tuple_compare_with_key(tuple, HINT_NONE, key, key_def->part_count,
+				      HINT_NONE, key_def) == 0;
+}
+
+#define LIGHT_NAME _index
+#define LIGHT_DATA_TYPE struct tuple *
+#define LIGHT_KEY_TYPE const char *
+#define LIGHT_CMP_ARG_TYPE struct key_def *
+#define LIGHT_EQUAL(a, b, c) memtx_hash_equal(a, b, c)
+#define LIGHT_EQUAL_KEY(a, b, c) memtx_hash_equal_key(a, b, c)
+
+#include "salad/light.h"
+
+#undef LIGHT_NAME
+#undef LIGHT_DATA_TYPE
+#undef LIGHT_KEY_TYPE
+#undef LIGHT_CMP_ARG_TYPE
+#undef LIGHT_EQUAL
+#undef LIGHT_EQUAL_KEY
+
+#define SWISS_NAME _index
+#define SWISS_DATA_TYPE struct tuple *
+#define SWISS_KEY_TYPE const char *
+#define SWISS_CMP_ARG_TYPE struct key_def *
+#define SWISS_EQUAL(a, b, c) memtx_hash_equal(a, b, c)
+#define SWISS_EQUAL_KEY(a, b, c) memtx_hash_equal_key(a, b, c)
+
+#include "salad/swiss.h"
+
+#undef SWISS_NAME
+#undef SWISS_DATA_TYPE
+#undef SWISS_KEY_TYPE
+#undef SWISS_CMP_ARG_TYPE
+#undef SWISS_EQUAL
+#undef SWISS_EQUAL_KEY
+
+/**
+ * Hash table operations used by the index. Both tables keep the
+ * number of stored tuples in `count` and the key definition in
+ * `arg`, so these are accessed directly.
+ */
+template <int HASH_TABLE>
+struct memtx_hash_table;
+
+template <>
+struct memtx_hash_table<HASH_INDEX_TABLE_LIGHT> {
+	using core = struct light_index_core;
+	using iterator = struct light_index_iterator;
+
+	static void
+	create(core *ht, struct memtx_engine *memtx, struct key_def *key_def)
+	{
+		light_index_create(ht, MEMTX_EXTENT_SIZE,
+				   memtx_index_extent_alloc,
+				   memtx_index_extent_free, memtx, key_def);
+	}
+
+	static void
+	destroy(core *ht)
+	{
+		light_index_destroy(ht);
+	}
+
+	static size_t
+	extent_count(core *ht)
+	{
+		return matras_extent_count(&ht->mtable);
+	}
+
+	static struct tuple *
+	random(core *ht, uint32_t rnd)
+	{
+		if (ht->count == 0)
+			return NULL;
+		rnd %= ht->table_size;
+		while (!light_index_pos_valid(ht, rnd)) {
+			rnd++;
+			rnd %= ht->table_size;
+		}
+		return light_index_get(ht, rnd);
+	}
+
+	static struct tuple *
+	find_key(core *ht, uint32_t hash, const char *key)
+	{
+		uint32_t pos = light_index_find_key(ht, hash, key);
+		return pos != light_index_end ? light_index_get(ht, pos) : NULL;
+	}
+
+	/**
+	 * Insert a tuple or replace the tuple with the same key,
+	 * which is returned in @a replaced. Returns -1 on memory
+	 * error.
+	 */
+	static int
+	replace(core *ht, uint32_t hash, struct tuple *tuple,
+		struct tuple **replaced)
+	{
+		uint32_t pos = light_index_replace(ht, hash, tuple, replaced);
+		if (pos == light_index_end)
+			pos = light_index_insert(ht, hash, tuple);
+		return pos != light_index_end ? 0 : -1;
+	}
+
+	/** Undo replace(). Returns -1 on memory error. */
+	static int
+	rollback(core *ht, uint32_t hash, struct tuple *tuple,
+		 struct tuple *replaced)
+	{
+		if (replaced != NULL) {
+			struct tuple *unused;
+			uint32_t pos = light_index_replace(ht, hash, replaced,
+							   &unused);
+			assert(pos != light_index_end);
+			(void)pos;
+			return 0;
+		}
+		return light_index_delete_value(ht, hash, tuple) < 0 ? -1 : 0;
+	}
+
+	static int
+	delete_value(core *ht, uint32_t hash, struct tuple *tuple)
+	{
+		return light_index_delete_value(ht, hash, tuple);
+	}
+
+	static void
+	iterator_begin(core *ht, iterator *itr)
+	{
+		light_index_iterator_begin(ht, itr);
+	}
+
+	static void
+	iterator_key(core *ht, iterator *itr, uint32_t hash, const char *key)
+	{
+		light_index_iterator_key(ht, itr, hash, key);
+	}
+
+	static bool
+	iterator_is_end(iterator *itr)
+	{
+		return itr->slotpos == light_index_end;
+	}
+
+	static struct tuple **
+	iterator_get_and_next(core *ht, iterator *itr)
+	{
+		return light_index_iterator_get_and_next(ht, itr);
+	}
+
+	static void
+	iterator_freeze(core *ht, iterator *itr)
+	{
+		light_index_iterator_freeze(ht, itr);
+	}
+
+	static void
+	iterator_destroy(core *ht, iterator *itr)
+	{
+		light_index_iterator_destroy(ht, itr);
+	}
+};
+
+template <>
+struct memtx_hash_table<HASH_INDEX_TABLE_SWISS> {
+	using core = struct swiss_index_core;
+	using iterator = struct swiss_index_iterator;
+
+	static void
+	create(core *ht, struct memtx_engine *memtx, struct key_def *key_def)
+	{
+		swiss_index_create(ht, MEMTX_EXTENT_SIZE,
+				   memtx_index_extent_alloc,
+				   memtx_index_extent_free, memtx, key_def);
+	}
+
+	static void
+	destroy(core *ht)
+	{
+		swiss_index_destroy(ht);
+	}
+
+	static size_t
+	extent_count(core *ht)
+	{
+		return swiss_index_extent_count(ht);
+	}
+
+	static struct tuple *
+	random(core *ht, uint32_t rnd)
+	{
+		struct tuple **res = swiss_index_random(ht, rnd);
+		return res != NULL ? *res : NULL;
+	}
+
+	static struct tuple *
+	find_key(core *ht, uint32_t hash, const char *key)
+	{
+		struct tuple **res = swiss_index_find_key(ht, hash, key);
+		return res != NULL ? *res : NULL;
+	}
+
+	static int
+	replace(core *ht, uint32_t hash, struct tuple *tuple,
+		struct tuple **replaced)
+	{
+		int rc = swiss_index_replace(ht, hash, tuple, replaced);
+		if (rc == 0)
+			rc = swiss_index_insert(ht, hash, tuple);
+		return rc < 0 ? -1 : 0;
+	}
+
+	static int
+	rollback(core *ht, uint32_t hash, struct tuple *tuple,
+		 struct tuple *replaced)
+	{
+		/*
+		 * The slot of the new tuple was touched by replace(),
+		 * so putting the old tuple back doesn't allocate.
+		 */
+		if (replaced != NULL) {
+			struct tuple *unused;
+			int rc = swiss_index_replace(ht, hash, replaced,
+						     &unused);
+			assert(rc == 1);
+			(void)rc;
+			return 0;
+		}
+		return swiss_index_delete_value(ht, hash, tuple) < 0 ? -1 : 0;
+	}
+
+	static int
+	delete_value(core *ht, uint32_t hash, struct tuple *tuple)
+	{
+		return swiss_index_delete_value(ht, hash, tuple);
+	}
+
+	static void
+	iterator_begin(core *ht, iterator *itr)
+	{
+		swiss_index_iterator_begin(ht, itr);
+	}
+
+	static void
+	iterator_key(core *ht, iterator *itr, uint32_t hash, const char *key)
+	{
+		swiss_index_iterator_key(ht, itr, hash, key);
+	}
+
+	static bool
+	iterator_is_end(iterator *itr)
+	{
+		return itr->pos == swiss_index_end;
+	}
+
+	static struct tuple **
+	iterator_get_and_next(core *ht, iterator *itr)
+	{
+		return swiss_index_iterator_get_and_next(ht, itr);
+	}
+
+	static void
+	iterator_freeze(core *ht, iterator *itr)
+	{
+		swiss_index_iterator_freeze(ht, itr);
+	}
+
+	static void
+	iterator_destroy(core *ht, iterator *itr)
+	{
+		swiss_index_iterator_destroy(ht, itr);
+	}
+};
+
+template <int HASH_TABLE>
+using memtx_hash_t = typename memtx_hash_table<HASH_TABLE>::core;
+
+template <int HASH_TABLE>
+using memtx_hash_iterator_t = typename memtx_hash_table<HASH_TABLE>::iterator;
+
+template <int HASH_TABLE>
+struct memtx_hash_index {
+	struct index base;
+	memtx_hash_t<HASH_TABLE> hash_table;
+	struct memtx_gc_task gc_task;
+	memtx_hash_iterator_t<HASH_TABLE> gc_iterator;
+};
+
+/* {{{ MemtxHash Iterators ****************************************/
+
+template <int HASH_TABLE>
+struct hash_iterator {
+	struct iterator base; /* Must be the first member. */
+	memtx_hash_iterator_t<HASH_TABLE> iterator;
+	/** Memory pool the iterator was allocated from. */
+	struct mempool *pool;
+};
+
+static_assert(sizeof(struct hash_iterator<HASH_INDEX_TABLE_LIGHT>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct hash_iterator) must be less than or equal "
+	      "to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct hash_iterator<HASH_INDEX_TABLE_SWISS>) <=
+	      MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct hash_iterator) must be less than or equal "
+	      "to MEMTX_ITERATOR_SIZE");
+
+template <int HASH_TABLE>
+static void
+hash_iterator_free(struct iterator *iterator)
+{
+	assert(iterator->free == hash_iterator_free<HASH_TABLE>);
+	struct hash_iterator<HASH_TABLE> *it =
+		(struct hash_iterator<HASH_TABLE> *)iterator;
+	mempool_free(it->pool, it);
+}
+
+template <int HASH_TABLE>
+static int
+hash_iterator_ge_base(struct iterator *ptr, struct tuple **ret)
+{
+	assert(ptr->free == hash_iterator_free<HASH_TABLE>);
+	using table = memtx_hash_table<HASH_TABLE>;
+	struct hash_iterator<HASH_TABLE> *it =
+		(struct hash_iterator<HASH_TABLE> *)ptr;
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)ptr->index;
+	struct tuple **res = table::iterator_get_and_next(&index->hash_table,
+							  &it->iterator);
+	*ret = res != NULL ? *res : NULL;
+	return 0;
+}
+
+template <int HASH_TABLE>
+static int
+hash_iterator_gt_base(struct iterator *ptr, struct tuple **ret)
+{
+	assert(ptr->free == hash_iterator_free<HASH_TABLE>);
+	using table = memtx_hash_table<HASH_TABLE>;
+	ptr->next = hash_iterator_ge_base<HASH_TABLE>;
+	struct hash_iterator<HASH_TABLE> *it =
+		(struct hash_iterator<HASH_TABLE> *)ptr;
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)ptr->index;
+	struct tuple **res = table::iterator_get_and_next(&index->hash_table,
+							  &it->iterator);
+	if (res != NULL)
+		res = table::iterator_get_and_next(&index->hash_table,
+						   &it->iterator);
+	*ret = res != NULL ? *res : NULL;
+	return 0;
+}
+
+#define WRAP_ITERATOR_METHOD(name)						\
+template <int HASH_TABLE>							\
+static int									\
+name(struct iterator *iterator, struct tuple **ret)				\
+{										\
+	struct txn *txn = in_txn();						\
+	struct space *space = space_by_id(iterator->space_id);			\
+	bool is_rw = txn != NULL;						\
+	struct index *idx = iterator->index;					\
+	bool is_first = true;							\
+	do {									\
+		int rc = is_first ? name##_base<HASH_TABLE>(iterator, ret)	\
+				  : hash_iterator_ge_base<HASH_TABLE>(		\
+						iterator, ret);			\
+		if (rc != 0 || *ret == NULL)					\
+			return rc;						\
+		is_first = false;						\
+		*ret = memtx_tx_tuple_clarify(txn, space, *ret, idx, 0, is_rw);	\
+	} while (*ret == NULL);							\
+	return 0;								\
+}										\
+struct forgot_to_add_semicolon
+
+WRAP_ITERATOR_METHOD(hash_iterator_ge);
+WRAP_ITERATOR_METHOD(hash_iterator_gt);
+
+#undef WRAP_ITERATOR_METHOD
+
+static int
+hash_iterator_eq_next(MAYBE_UNUSED struct iterator *it, struct tuple **ret)
+{
+	*ret = NULL;
+	return 0;
+}
+
+template <int HASH_TABLE>
+static int
+hash_iterator_eq(struct iterator *it, struct tuple **ret)
+{
+	it->next = hash_iterator_eq_next;
+	/* always returns zero. */
+	hash_iterator_ge_base<HASH_TABLE>(it, ret);
+	if (*ret == NULL)
+		return 0;
+	struct txn *txn = in_txn();
+	struct space *sp = space_by_id(it->space_id);
+	bool is_rw = txn != NULL;
+	*ret = memtx_tx_tuple_clarify(txn, sp, *ret, it->index, 0, is_rw);
+	return 0;
+}
+
+/* }}} */
+
+/* {{{ MemtxHash -- implementation of all hashes. **********************/
+
+template <int HASH_TABLE>
+static void
+memtx_hash_index_free(struct memtx_hash_index<HASH_TABLE> *index)
+{
+	memtx_hash_table<HASH_TABLE>::destroy(&index->hash_table);
+	free(index);
+}
+
+template <int HASH_TABLE>
+static void
+memtx_hash_index_gc_run(struct memtx_gc_task *task, bool *done)
+{
+	/*
+	 * Yield every 1K tuples to keep latency < 0.1 ms.
+	 * Yield more often in debug mode.
+	 */
+#ifdef NDEBUG
+	enum { YIELD_LOOPS = 1000 };
+#else
+	enum { YIELD_LOOPS = 10 };
+#endif
+
+	using table = memtx_hash_table<HASH_TABLE>;
+	struct memtx_hash_index<HASH_TABLE> *index = container_of(task,
+			struct memtx_hash_index<HASH_TABLE>, gc_task);
+	memtx_hash_t<HASH_TABLE> *hash = &index->hash_table;
+	memtx_hash_iterator_t<HASH_TABLE> *itr = &index->gc_iterator;
+
+	struct tuple **res;
+	unsigned int loops = 0;
+	while ((res = table::iterator_get_and_next(hash, itr)) != NULL) {
+		tuple_unref(*res);
+		if (++loops >= YIELD_LOOPS) {
+			*done = false;
+			return;
+		}
+	}
+	*done = true;
+}
+
+template <int HASH_TABLE>
+static void
+memtx_hash_index_gc_free(struct memtx_gc_task *task)
+{
+	struct memtx_hash_index<HASH_TABLE> *index = container_of(task,
+			struct memtx_hash_index<HASH_TABLE>, gc_task);
+	memtx_hash_index_free(index);
+}
+
+template <int HASH_TABLE>
+static struct memtx_gc_task_vtab *
+get_memtx_hash_index_gc_vtab()
+{
+	static memtx_gc_task_vtab tab =
+	{
+		.run = memtx_hash_index_gc_run<HASH_TABLE>,
+		.free = memtx_hash_index_gc_free<HASH_TABLE>,
+	};
+	return &tab;
+}
+
+template <int HASH_TABLE>
+static void
+memtx_hash_index_destroy(struct index *base)
+{
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	if (base->def->iid == 0) {
+		/*
+		 * Primary index. We need to free all tuples stored
+		 * in the index, which may take a while. Schedule a
+		 * background task in order not to block tx thread.
+		 */
+		index->gc_task.vtab = get_memtx_hash_index_gc_vtab<HASH_TABLE>();
+		memtx_hash_table<HASH_TABLE>::iterator_begin(
+			&index->hash_table, &index->gc_iterator);
+		memtx_engine_schedule_gc(memtx, &index->gc_task);
+	} else {
+		/*
+		 * Secondary index. Destruction is fast, no need to
+		 * hand over to background fiber.
+		 */
+		memtx_hash_index_free(index);
+	}
+}
+
+template <int HASH_TABLE>
+static void
+memtx_hash_index_update_def(struct index *base)
+{
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	index->hash_table.arg = index->base.def->key_def;
+}
+
+template <int HASH_TABLE>
+static ssize_t
+memtx_hash_index_size(struct index *base)
+{
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	struct space *space = space_by_id(base->def->space_id);
+	/* Substract invisible count. */
+	return index->hash_table.count -
+	       memtx_tx_index_invisible_count(in_txn(), space, base);
+}
+
+template <int HASH_TABLE>
+static ssize_t
+memtx_hash_index_bsize(struct index *base)
+{
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	return memtx_hash_table<HASH_TABLE>::extent_count(&index->hash_table) *
+	       MEMTX_EXTENT_SIZE;
+}
+
+template <int HASH_TABLE>
+static int
+memtx_hash_index_random(struct index *base, uint32_t rnd, struct tuple **result)
+{
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	*result = memtx_hash_table<HASH_TABLE>::random(&index->hash_table, rnd);
+	return 0;
+}
+
+template <int HASH_TABLE>
+static ssize_t
+memtx_hash_index_count(struct index *base, enum iterator_type type,
+		       const char *key, uint32_t part_count)
+{
+	if (type == ITER_ALL)
+		return memtx_hash_index_size<HASH_TABLE>(base); /* optimization */
+	return generic_index_count(base, type, key, part_count);
+}
+
+template <int HASH_TABLE>
+static int
+memtx_hash_index_get(struct index *base, const char *key,
+		     uint32_t part_count, struct tuple **result)
+{
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+
+	assert(base->def->opts.is_unique &&
+	       part_count == base->def->key_def->part_count);
+	(void) part_count;
+
+	struct space *space = space_by_id(base->def->space_id);
+	struct txn *txn = in_txn();
+	*result = NULL;
+	uint32_t h = key_hash(key, base->def->key_def);
+	struct tuple *tuple =
+		memtx_hash_table<HASH_TABLE>::find_key(&index->hash_table,
+						       h, key);
+	if (tuple != NULL) {
+		bool is_rw = txn != NULL;
+		*result = memtx_tx_tuple_clarify(txn, space, tuple, base,
+						 0, is_rw);
+	} else {
+		memtx_tx_track_point(txn, space, base, key);
+	}
+	return 0;
+}
+
+template <int HASH_TABLE>
+static int
+memtx_hash_index_replace(struct index *base, struct tuple *old_tuple,
+			 struct tuple *new_tuple, enum dup_replace_mode mode,
+			 struct tuple **result, struct tuple **successor)
+{
+	using table = memtx_hash_table<HASH_TABLE>;
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	memtx_hash_t<HASH_TABLE> *hash_table = &index->hash_table;
+
+	/* HASH index doesn't support ordering. */
+	*successor = NULL;
+
+	if (new_tuple) {
+		uint32_t h = tuple_hash(new_tuple, base->def->key_def);
+		struct tuple *dup_tuple = NULL;
+		int rc = table::replace(hash_table, h, new_tuple, &dup_tuple);
+
+		ERROR_INJECT(ERRINJ_INDEX_ALLOC,
+		{
+			if (rc == 0 &&
+			    table::rollback(hash_table, h, new_tuple,
+					    dup_tuple) != 0) {
+				panic("Failed to allocate memory in "
+				      "recover of int hash_table");
+			}
+			dup_tuple = NULL;
+			rc = -1;
+		});
+
+		if (rc != 0) {
+			diag_set(OutOfMemory, (ssize_t)hash_table->count,
+				 "hash_table", "key");
+			return -1;
+		}
+		uint32_t errcode = replace_check_dup(old_tuple,
+						     dup_tuple, mode);
+		if (errcode) {
+			if (table::rollback(hash_table, h, new_tuple,
+					    dup_tuple) != 0) {
+				panic("Failed to allocate memory in "
+				      "recover of int hash_table");
+			}
+			struct space *sp = space_cache_find(base->def->space_id);
+			if (sp != NULL) {
+				if (errcode == ER_TUPLE_FOUND){
+					diag_set(ClientError, errcode,  base->def->name,
+						 space_name(sp), tuple_str(dup_tuple),
+						 tuple_str(new_tuple));
+				} else {
+					diag_set(ClientError, errcode, base->def->name,
+						 space_name(sp));
+				}
+			}
+			return -1;
+		}
+
+		if (dup_tuple) {
+			*result = dup_tuple;
+			return 0;
+		}
+	}
+
+	if (old_tuple) {
+		uint32_t h = tuple_hash(old_tuple, base->def->key_def);
+		int res = table::delete_value(hash_table, h, old_tuple);
+		assert(res == 0); (void) res;
+	}
+	*result = old_tuple;
+	return 0;
+}
+
+template <int HASH_TABLE>
+static struct iterator *
+memtx_hash_index_create_iterator(struct index *base, enum iterator_type type,
+				 const char *key, uint32_t part_count)
+{
+	using table = memtx_hash_table<HASH_TABLE>;
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+
+	assert(part_count == 0 || key != NULL);
+
+	struct hash_iterator<HASH_TABLE> *it =
+		(struct hash_iterator<HASH_TABLE> *)
+		mempool_alloc(&memtx->iterator_pool);
+	if (it == NULL) {
+		diag_set(OutOfMemory, sizeof(struct hash_iterator<HASH_TABLE>),
+			 "memtx_hash_index", "iterator");
+		return NULL;
+	}
+	iterator_create(&it->base, base);
+	it->pool = &memtx->iterator_pool;
+	it->base.free = hash_iterator_free<HASH_TABLE>;
+	table::iterator_begin(&index->hash_table, &it->iterator);
+
+	switch (type) {
+	case ITER_GT:
+		if (part_count != 0) {
+			table::iterator_key(&index->hash_table, &it->iterator,
+					    key_hash(key, base->def->key_def),
+					    key);
+			it->base.next = hash_iterator_gt<HASH_TABLE>;
+		} else {
+			table::iterator_begin(&index->hash_table,
+					      &it->iterator);
+			it->base.next = hash_iterator_ge<HASH_TABLE>;
+		}
+		/* This iterator needs to be supported as a legacy. */
+		memtx_tx_track_full_scan(in_txn(),
+					 space_by_id(it->base.space_id),
+					 &index->base);
+		break;
+	case ITER_ALL:
+		table::iterator_begin(&index->hash_table, &it->iterator);
+		it->base.next = hash_iterator_ge<HASH_TABLE>;
+		memtx_tx_track_full_scan(in_txn(),
+					 space_by_id(it->base.space_id),
+					 &index->base);
+		break;
+	case ITER_EQ:
+		assert(part_count > 0);
+		table::iterator_key(&index->hash_table, &it->iterator,
+				    key_hash(key, base->def->key_def), key);
+		it->base.next = hash_iterator_eq<HASH_TABLE>;
+		if (table::iterator_is_end(&it->iterator))
+			memtx_tx_track_point(in_txn(),
+					     space_by_id(it->base.space_id),
+					     &index->base, key);
+		break;
+	default:
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		mempool_free(&memtx->iterator_pool, it);
+		return NULL;
+	}
+	return (struct iterator *)it;
+}
+
+template <int HASH_TABLE>
+struct hash_snapshot_iterator {
+	struct snapshot_iterator base;
+	struct memtx_hash_index<HASH_TABLE> *index;
+	memtx_hash_iterator_t<HASH_TABLE> iterator;
+	struct memtx_tx_snapshot_cleaner cleaner;
+};
+
+/**
+ * Destroy read view and free snapshot iterator.
+ * Virtual method of snapshot iterator.
+ * @sa index_vtab::create_snapshot_iterator.
+ */
+template <int HASH_TABLE>
+static void
+hash_snapshot_iterator_free(struct snapshot_iterator *iterator)
+{
+	assert(iterator->free == hash_snapshot_iterator_free<HASH_TABLE>);
+	struct hash_snapshot_iterator<HASH_TABLE> *it =
+		(struct hash_snapshot_iterator<HASH_TABLE> *)iterator;
+	memtx_leave_delayed_free_mode((struct memtx_engine *)
+				      it->index->base.engine);
+	memtx_hash_table<HASH_TABLE>::iterator_destroy(&it->index->hash_table,
+						       &it->iterator);
+	index_unref(&it->index->base);
+	memtx_tx_snapshot_cleaner_destroy(&it->cleaner);
+	free(iterator);
+}
+
+/**
+ * Get next tuple from snapshot iterator.
+ * Virtual method of snapshot iterator.
+ * @sa index_vtab::create_snapshot_iterator.
+ */
+template <int HASH_TABLE>
+static int
+hash_snapshot_iterator_next(struct snapshot_iterator *iterator,
+			    const char **data, uint32_t *size)
+{
+	assert(iterator->free == hash_snapshot_iterator_free<HASH_TABLE>);
+	struct hash_snapshot_iterator<HASH_TABLE> *it =
+		(struct hash_snapshot_iterator<HASH_TABLE> *)iterator;
+	memtx_hash_t<HASH_TABLE> *hash_table = &it->index->hash_table;
+
+	while (true) {
+		struct tuple **res = memtx_hash_table<HASH_TABLE>::
+			iterator_get_and_next(hash_table, &it->iterator);
+		if (res == NULL) {
+			*data = NULL;
+			return 0;
+		}
+
+		struct tuple *tuple = *res;
+		tuple = memtx_tx_snapshot_clarify(&it->cleaner, tuple);
+
+		if (tuple != NULL) {
+			*data = tuple_data_range(*res, size);
+			return 0;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Create an ALL iterator with personal read view so further
+ * index modifications will not affect the iteration results.
+ * Must be destroyed by iterator->free after usage.
+ */
+template <int HASH_TABLE>
+static struct snapshot_iterator *
+memtx_hash_index_create_snapshot_iterator(struct index *base)
+{
+	using table = memtx_hash_table<HASH_TABLE>;
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	struct hash_snapshot_iterator<HASH_TABLE> *it =
+		(struct hash_snapshot_iterator<HASH_TABLE> *)
+		calloc(1, sizeof(*it));
+	if (it == NULL) {
+		diag_set(OutOfMemory, sizeof(*it),
+			 "memtx_hash_index", "iterator");
+		return NULL;
+	}
+
+	it->base.next = hash_snapshot_iterator_next<HASH_TABLE>;
+	it->base.free = hash_snapshot_iterator_free<HASH_TABLE>;
+	it->index = index;
+	index_ref(base);
+	table::iterator_begin(&index->hash_table, &it->iterator);
+	table::iterator_freeze(&index->hash_table, &it->iterator);
+	memtx_enter_delayed_free_mode((struct memtx_engine *)base->engine);
+	return (struct snapshot_iterator *) it;
+}
+
+template <int HASH_TABLE>
+struct hash_read_view {
+	struct index_read_view base;
+	/** The index the read view was created for. */
+	struct memtx_hash_index<HASH_TABLE> *index;
+	/**
+	 * Frozen iterator positioned at the beginning of the hash
+	 * table. Iterators over the read view are copies of it.
+	 */
+	memtx_hash_iterator_t<HASH_TABLE> iterator;
+	/** Used to skip tuples not committed by the time of creation. */
+	struct memtx_tx_snapshot_cleaner cleaner;
+};
+
+template <int HASH_TABLE>
+struct hash_read_view_iterator {
+	struct snapshot_iterator base;
+	struct hash_read_view<HASH_TABLE> *rv;
+	memtx_hash_iterator_t<HASH_TABLE> iterator;
+};
+
+template <int HASH_TABLE>
+static void
+hash_read_view_iterator_free(struct snapshot_iterator *iterator)
+{
+	assert(iterator->free == hash_read_view_iterator_free<HASH_TABLE>);
+	free(iterator);
+}
+
+template <int HASH_TABLE>
+static int
+hash_read_view_iterator_next(struct snapshot_iterator *iterator,
+			     const char **data, uint32_t *size)
+{
+	assert(iterator->free == hash_read_view_iterator_free<HASH_TABLE>);
+	struct hash_read_view_iterator<HASH_TABLE> *it =
+		(struct hash_read_view_iterator<HASH_TABLE> *)iterator;
+	memtx_hash_t<HASH_TABLE> *hash_table = &it->rv->index->hash_table;
+
+	while (true) {
+		struct tuple **res = memtx_hash_table<HASH_TABLE>::
+			iterator_get_and_next(hash_table, &it->iterator);
+		if (res == NULL) {
+			*data = NULL;
+			return 0;
+		}
+		struct tuple *tuple =
+			memtx_tx_snapshot_clarify(&it->rv->cleaner, *res);
+		if (tuple != NULL) {
+			*data = tuple_data_range(tuple, size);
+			return 0;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Create an iterator over a hash index read view. Since the hash
+ * table can't be searched in a read view, only full scans are
+ * supported.
+ */
+template <int HASH_TABLE>
+static struct snapshot_iterator *
+hash_read_view_create_iterator(struct index_read_view *base,
+			       enum iterator_type type,
+			       const char *key, uint32_t part_count)
+{
+	(void)key;
+	struct hash_read_view<HASH_TABLE> *rv =
+		(struct hash_read_view<HASH_TABLE> *)base;
+	if (type != ITER_ALL && part_count > 0) {
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		return NULL;
+	}
+	struct hash_read_view_iterator<HASH_TABLE> *it =
+		(struct hash_read_view_iterator<HASH_TABLE> *)
+		malloc(sizeof(*it));
+	if (it == NULL) {
+		diag_set(OutOfMemory, sizeof(*it), "malloc",
+			 "struct hash_read_view_iterator");
+		return NULL;
+	}
+	it->base.next = hash_read_view_iterator_next<HASH_TABLE>;
+	it->base.free = hash_read_view_iterator_free<HASH_TABLE>;
+	it->rv = rv;
+	it->iterator = rv->iterator;
+	return &it->base;
+}
+
+template <int HASH_TABLE>
+static void
+hash_read_view_free(struct index_read_view *base)
+{
+	struct hash_read_view<HASH_TABLE> *rv =
+		(struct hash_read_view<HASH_TABLE> *)base;
+	struct memtx_hash_index<HASH_TABLE> *index = rv->index;
+	memtx_hash_table<HASH_TABLE>::iterator_destroy(&index->hash_table,
+						       &rv->iterator);
+	memtx_tx_snapshot_cleaner_destroy(&rv->cleaner);
+	memtx_leave_delayed_free_mode((struct memtx_engine *)
+				      index->base.engine);
+	index_unref(&index->base);
+	index_read_view_destroy(base);
+	free(rv);
+}
+
+/**
+ * Create a read view of a hash index. All iterators created
+ * over it see the index as it was at the moment of creation.
+ */
+template <int HASH_TABLE>
+static struct index_read_view *
+memtx_hash_index_create_read_view(struct index *base)
+{
+	static const struct index_read_view_vtab vtab = {
+		/* .free = */ hash_read_view_free<HASH_TABLE>,
+		/* .create_iterator = */
+			hash_read_view_create_iterator<HASH_TABLE>,
+	};
+	using table = memtx_hash_table<HASH_TABLE>;
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)base;
+	struct hash_read_view<HASH_TABLE> *rv =
+		(struct hash_read_view<HASH_TABLE> *)malloc(sizeof(*rv));
+	if (rv == NULL) {
+		diag_set(OutOfMemory, sizeof(*rv), "malloc",
+			 "struct hash_read_view");
+		return NULL;
+	}
+	if (index_read_view_create(&rv->base, &vtab, base->def) != 0) {
+		free(rv);
+		return NULL;
+	}
+	struct space *space = space_cache_find(base->def->space_id);
+	memtx_tx_snapshot_cleaner_create(&rv->cleaner, space, base);
+	rv->index = index;
+	index_ref(base);
+	table::iterator_begin(&index->hash_table, &rv->iterator);
+	table::iterator_freeze(&index->hash_table, &rv->iterator);
+	memtx_enter_delayed_free_mode((struct memtx_engine *)base->engine);
+	return &rv->base;
+}
+
+/* }}} */
+
+template <int HASH_TABLE>
+static const struct index_vtab *
+get_memtx_hash_index_vtab()
+{
+	static const struct index_vtab vtab = {
+		/* .destroy = */ memtx_hash_index_destroy<HASH_TABLE>,
+		/* .commit_create = */ generic_index_commit_create,
+		/* .abort_create = */ generic_index_abort_create,
+		/* .commit_modify = */ generic_index_commit_modify,
+		/* .commit_drop = */ generic_index_commit_drop,
+		/* .update_def = */ memtx_hash_index_update_def<HASH_TABLE>,
+		/* .depends_on_pk = */ generic_index_depends_on_pk,
+		/* .def_change_requires_rebuild = */
+			memtx_index_def_change_requires_rebuild,
+		/* .size = */ memtx_hash_index_size<HASH_TABLE>,
+		/* .bsize = */ memtx_hash_index_bsize<HASH_TABLE>,
+		/* .min = */ generic_index_min,
+		/* .max = */ generic_index_max,
+		/* .random = */ memtx_hash_index_random<HASH_TABLE>,
+		/* .count = */ memtx_hash_index_count<HASH_TABLE>,
+		/* .get = */ memtx_hash_index_get<HASH_TABLE>,
+		/* .replace = */ memtx_hash_index_replace<HASH_TABLE>,
+		/* .create_iterator = */
+			memtx_hash_index_create_iterator<HASH_TABLE>,
+		/* .create_snapshot_iterator = */
+			memtx_hash_index_create_snapshot_iterator<HASH_TABLE>,
+		/* .create_read_view = */
+			memtx_hash_index_create_read_view<HASH_TABLE>,
+		/* .stat = */ generic_index_stat,
+		/* .compact = */ generic_index_compact,
+		/* .reset_stat = */ generic_index_reset_stat,
+		/* .begin_build = */ generic_index_begin_build,
+		/* .reserve = */ generic_index_reserve,
+		/* .build_next = */ generic_index_build_next,
+		/* .end_build = */ generic_index_end_build,
+	};
+	return &vtab;
+}
+
+template <int HASH_TABLE>
+static struct index *
+memtx_hash_index_new_tpl(struct memtx_engine *memtx, struct index_def *def)
+{
+	struct memtx_hash_index<HASH_TABLE> *index =
+		(struct memtx_hash_index<HASH_TABLE> *)
+		calloc(1, sizeof(*index));
+	if (index == NULL) {
+		diag_set(OutOfMemory, sizeof(*index),
+			 "malloc", "struct memtx_hash_index");
+		return NULL;
+	}
+	if (index_create(&index->base, (struct engine *)memtx,
+			 get_memtx_hash_index_vtab<HASH_TABLE>(), def) != 0) {
+		free(index);
+		return NULL;
+	}
+
+	memtx_hash_table<HASH_TABLE>::create(&index->hash_table, memtx,
+					     index->base.def->key_def);
+	return &index->base;
+}
+
+struct index *
+memtx_hash_index_new(struct memtx_engine *memtx, struct index_def *def)
+{
+	switch (def->opts.hash_table) {
+	case HASH_INDEX_TABLE_SWISS:
+		return memtx_hash_index_new_tpl<HASH_INDEX_TABLE_SWISS>(memtx,
+									def);
+	default:
+		return memtx_hash_index_new_tpl<HASH_INDEX_TABLE_LIGHT>(memtx,
+									def);
+	}
+}
@@ -34,6 +34,7 @@
 #include "txn.h"
 #include "memtx_tx.h"
 #include "tuple.h"
+#include "tuple_compression.h"
 #include "xrow_update.h"
 #include "xrow.h"
 #include "memtx_hash.h"
@@ -323,6 +324,190 @@ rollback:
 	return -1;
 }
 
+int
+memtx_space_replace_bulk_load(struct space *space, struct tuple *old_tuple,
+			      struct tuple *new_tuple,
+			      enum dup_replace_mode mode,
+			      struct tuple **result)
+{
+	(void)space;
+	(void)old_tuple;
+	(void)new_tuple;
+	(void)mode;
+	(void)result;
+	diag_set(ClientError, ER_UNSUPPORTED, "memtx",
+		 "writes to a space while it is being bulk loaded");
+	return -1;
+}
+
+/** Remove the given tuples from an index of a space. */
+static void
+memtx_space_bulk_unload_index(struct space *space, struct index *index,
+			      struct tuple **tuples, uint32_t count)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	for (uint32_t i = 0; i < count; i++) {
+		struct tuple *unused;
+		/* Rollback must not fail. */
+		if (memtx_index_extent_reserve(memtx,
+				RESERVE_EXTENTS_BEFORE_DELETE) != 0 ||
+		    index_replace(index, tuples[i], NULL,
+				  DUP_REPLACE_OR_INSERT,
+				  &unused, &unused) != 0) {
+			diag_log();
+			unreachable();
+			panic("failed to rollback bulk load");
+		}
+	}
+}
+
+/**
+ * The bulk build doesn't check the unique constraint, so look for
+ * equal keys among neighbors in a freshly built index.
+ */
+static int
+memtx_space_bulk_check_unique(struct space *space, struct index *index)
+{
+	struct key_def *key_def = index->def->key_def;
+	int rc;
+	struct iterator *it = index_create_iterator(index, ITER_ALL, NULL, 0);
+	if (it == NULL)
+		return -1;
+	struct tuple *prev = NULL;
+	struct tuple *tuple;
+	while ((rc = iterator_next(it, &tuple)) == 0 && tuple != NULL) {
+		if (key_def->is_nullable &&
+		    tuple_key_contains_null(tuple, key_def, MULTIKEY_NONE)) {
+			prev = NULL;
+			continue;
+		}
+		if (prev != NULL && tuple_compare(prev, HINT_NONE, tuple,
+						  HINT_NONE, key_def) == 0) {
+			diag_set(ClientError, ER_TUPLE_FOUND, index->def->name,
+				 space_name(space), tuple_str(prev),
+				 tuple_str(tuple));
+			rc = -1;
+			break;
+		}
+		prev = tuple;
+	}
+	iterator_delete(it);
+	return rc;
+}
+
+/**
+ * Insert tuples into an empty index of a space being bulk loaded.
+ * Non-unique tree indexes and unique tree indexes over plain keys
+ * are built with the bulk build API, which sorts all keys at once
+ * instead of inserting them one by one. For other indexes fall
+ * back on inserting tuples one by one.
+ */
+static int
+memtx_space_bulk_load_index(struct space *space, struct index *index,
+			    struct tuple **tuples, uint32_t count)
+{
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	struct key_def *key_def = index->def->key_def;
+	bool is_unique = index->def->opts.is_unique;
+	if (index->def->type != TREE ||
+	    (is_unique && key_def->is_multikey)) {
+		if (index_reserve(index, count) != 0)
+			return -1;
+		for (uint32_t i = 0; i < count; i++) {
+			struct tuple *unused;
+			if (memtx_index_extent_reserve(memtx,
+					RESERVE_EXTENTS_BEFORE_REPLACE) != 0 ||
+			    index_replace(index, NULL, tuples[i], DUP_INSERT,
+					  &unused, &unused) != 0) {
+				memtx_space_bulk_unload_index(space, index,
+							      tuples, i);
+				return -1;
+			}
+		}
+		return 0;
+	}
+	int rc = 0;
+	index_begin_build(index);
+	if (index_reserve(index, count) != 0)
+		rc = -1;
+	for (uint32_t i = 0; rc == 0 && i < count; i++)
+		rc = index_build_next(index, tuples[i]);
+	index_end_build(index);
+	if (rc == 0 && is_unique)
+		rc = memtx_space_bulk_check_unique(space, index);
+	if (rc != 0) {
+		/* A tree tolerates removal of tuples it doesn't have. */
+		memtx_space_bulk_unload_index(space, index, tuples, count);
+	}
+	return rc;
+}
+
+int
+memtx_space_bulk_load_begin(struct space *space, struct tuple **tuples,
+			    uint32_t count)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	if (memtx_space->replace != memtx_space_replace_all_keys ||
+	    memtx_tx_manager_use_mvcc_engine) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memtx",
+			 memtx_space->replace == memtx_space_replace_bulk_load ?
+			 "concurrent bulk loads into a space" :
+			 "bulk load with MVCC or during recovery");
+		return -1;
+	}
+	struct index *pk = index_find(space, 0);
+	if (pk == NULL)
+		return -1;
+	if (index_size(pk) != 0) {
+		diag_set(ClientError, ER_UNSUPPORTED, "memtx",
+			 "bulk load into a non-empty space");
+		return -1;
+	}
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (space->index[i]->def->key_def->for_func_index) {
+			diag_set(ClientError, ER_UNSUPPORTED, "memtx",
+				 "bulk load into a space with "
+				 "functional indexes");
+			return -1;
+		}
+	}
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		if (memtx_space_bulk_load_index(space, space->index[i],
+						tuples, count) != 0) {
+			while (i-- > 0) {
+				memtx_space_bulk_unload_index(
+					space, space->index[i], tuples, count);
+			}
+			return -1;
+		}
+	}
+	for (uint32_t i = 0; i < count; i++)
+		memtx_space_update_bsize(space, NULL, tuples[i]);
+	memtx_space->replace = memtx_space_replace_bulk_load;
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	memtx->bulk_load_count++;
+	return 0;
+}
+
+void
+memtx_space_bulk_load_end(struct space *space, struct tuple **rollback,
+			  uint32_t rollback_count)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	assert(memtx_space->replace == memtx_space_replace_bulk_load);
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		memtx_space_bulk_unload_index(space, space->index[i],
+					      rollback, rollback_count);
+	}
+	for (uint32_t i = 0; i < rollback_count; i++)
+		memtx_space_update_bsize(space, rollback[i], NULL);
+	memtx_space->replace = memtx_space_replace_all_keys;
+	struct memtx_engine *memtx = (struct memtx_engine *)space->engine;
+	assert(memtx->bulk_load_count > 0);
+	if (--memtx->bulk_load_count == 0)
+		fiber_cond_broadcast(&memtx->bulk_load_cond);
+}
+
 static inline enum dup_replace_mode
 dup_replace_mode(uint16_t op)
 {
@@ -414,7 +599,10 @@ memtx_space_execute_update(struct space *space, struct txn *txn,
 	/* Update the tuple; legacy, request ops are in request->tuple */
 	uint32_t new_size = 0, bsize;
 	struct tuple_format *format = space->format;
-	const char *old_data = tuple_data_range(old_tuple, &bsize);
+	/* Update operations may not be applied to compressed fields. */
+	const char *old_data = tuple_data_decompressed(old_tuple, &bsize);
+	if (old_data == NULL)
+		return -1;
 	const char *new_data =
 		xrow_update_execute(request->tuple, request->tuple_end,
 				    old_data, old_data + bsize, format,
@@ -502,7 +690,10 @@ memtx_space_execute_upsert(struct space *space, struct txn *txn,
 		tuple_ref(stmt->new_tuple);
 	} else {
 		uint32_t new_size = 0, bsize;
-		const char *old_data = tuple_data_range(old_tuple, &bsize);
+		const char *old_data = tuple_data_decompressed(old_tuple,
+							       &bsize);
+		if (old_data == NULL)
+			return -1;
 		/*
 		 * Update the tuple.
 		 * xrow_upsert_execute() fails on totally wrong
@@ -854,6 +1045,18 @@ memtx_space_add_primary_key(struct space *space)
 	return 0;
 }
 
+/**
+ * Check that a tuple stored in the space matches a new format.
+ * Compressed fields are checked decompressed.
+ */
+static inline int
+memtx_tuple_validate(struct tuple_format *format, struct tuple *tuple)
+{
+	if (likely(!tuple->has_compressed_fields))
+		return tuple_validate(format, tuple);
+	return tuple_validate_decompressed(format, tuple);
+}
+
 /*
  * Ongoing index build or format check state used by
  * corrseponding on_replace triggers.
@@ -895,7 +1098,7 @@ memtx_check_on_replace(struct trigger *trigger, void *event)
 			  state->cmp_def) < 0)
 		return 0;
 
-	state->rc = tuple_validate(state->format, stmt->new_tuple);
+	state->rc = memtx_tuple_validate(state->format, stmt->new_tuple);
 	if (state->rc != 0)
 		diag_move(diag_get(), &state->diag);
 	return 0;
@@ -938,7 +1141,7 @@ memtx_space_check_format(struct space *space, struct tuple_format *format)
 		 * Check that the tuple is OK according to the
 		 * new format.
 		 */
-		rc = tuple_validate(format, tuple);
+		rc = memtx_tuple_validate(format, tuple);
 		if (rc != 0)
 			break;
 
@@ -1013,7 +1216,7 @@ memtx_build_on_replace_rollback(struct trigger *trigger, void *event)
 	 */
 	assert(stmt != NULL);
 	assert(stmt->old_tuple == NULL ||
-	       tuple_validate(state->format, stmt->old_tuple) == 0);
+	       memtx_tuple_validate(state->format, stmt->old_tuple) == 0);
 
 	struct tuple *delete = NULL;
 	struct tuple *successor = NULL;
@@ -1070,7 +1273,7 @@ memtx_build_on_replace(struct trigger *trigger, void *event)
 		return 0;
 
 	if (stmt->new_tuple != NULL &&
-	    tuple_validate(state->format, stmt->new_tuple) != 0) {
+	    memtx_tuple_validate(state->format, stmt->new_tuple) != 0) {
 		state->rc = -1;
 		diag_move(diag_get(), &state->diag);
 		return 0;
@@ -1212,7 +1415,7 @@ memtx_space_build_index(struct space *src_space, struct index *new_index,
 		 * Check that the tuple is OK according to the
 		 * new format.
 		 */
-		rc = tuple_validate(new_format, tuple);
+		rc = memtx_tuple_validate(new_format, tuple);
 		if (rc != 0)
 			break;
 		/*
@@ -1285,6 +1488,12 @@ memtx_space_prepare_alter(struct space *old_space, struct space *new_space)
 		return -1;
 	}
 
+	if (old_memtx_space->replace == memtx_space_replace_bulk_load) {
+		diag_set(ClientError, ER_ALTER_SPACE, old_space->def->name,
+			 "space is being bulk loaded");
+		return -1;
+	}
+
 	new_memtx_space->replace = old_memtx_space->replace;
 	new_memtx_space->bsize = old_memtx_space->bsize;
 	return 0;
@@ -1343,6 +1552,13 @@ memtx_space_new(struct memtx_engine *memtx,
 		return NULL;
 	}
 	tuple_format_ref(format);
+	if (!def->opts.is_ephemeral) {
+		format->compression_threshold = def->opts.compression_threshold;
+		format->compression_space_id = def->id;
+		format->is_compressed =
+			def->opts.compression_threshold != 0 ||
+			tuple_compression_stat(def->id) != NULL;
+	}
 
 	if (space_create((struct space *)memtx_space, (struct engine *)memtx,
 			 &memtx_space_vtab, def, key_list, format) != 0) {
@@ -83,6 +83,47 @@ memtx_space_replace_primary_key(struct space *, struct tuple *, struct tuple *,
 int
 memtx_space_replace_all_keys(struct space *, struct tuple *, struct tuple *,
 			     enum dup_replace_mode, struct tuple **);
+/**
+ * Replace function installed while a bulk load is being written
+ * to WAL, see memtx_space_bulk_load_begin(). Fails any request.
+ */
+int
+memtx_space_replace_bulk_load(struct space *, struct tuple *, struct tuple *,
+			      enum dup_replace_mode, struct tuple **);
+
+/**
+ * Fill all indexes of an empty memtx space with the given tuples
+ * at once. Tree indexes are built by sorting all keys instead of
+ * inserting tuples one by one. The caller must hold a reference
+ * to each tuple, which is passed to the space on success.
+ *
+ * Until memtx_space_bulk_load_end() is called, the space rejects
+ * any other writes and DDL.
+ *
+ * @retval  0 success, the tuples are visible in the space.
+ * @retval -1 error, diag is set, the space is left empty.
+ */
+int
+memtx_space_bulk_load_begin(struct space *space, struct tuple **tuples,
+			    uint32_t count);
+
+/**
+ * Finish a bulk load started with memtx_space_bulk_load_begin().
+ * The given tuples, which must be a subset of the loaded ones,
+ * are removed from the space, e.g. because they failed to be
+ * written to WAL. The caller is responsible for unreferencing them.
+ */
+void
+memtx_space_bulk_load_end(struct space *space, struct tuple **rollback,
+			  uint32_t rollback_count);
+
+/** Check if a bulk load into a memtx space is in progress. */
+static inline bool
+memtx_space_is_bulk_loading(struct space *space)
+{
+	struct memtx_space *memtx_space = (struct memtx_space *)space;
+	return memtx_space->replace == memtx_space_replace_bulk_load;
+}
 
 struct space *
 memtx_space_new(struct memtx_engine *memtx,
@@ -43,6 +43,13 @@
 #include <qsort_arg.h>
 #include <small/mempool.h>
 
+/**
+ * Tree elements and keys are parametrized with USE_HINT, which is
+ * 0 if comparison hints aren't used, 1 if tuple_hint() is stored
+ * along with each tuple, 2 if tuple_wide_hint() is stored too, and
+ * 3 if tuple_inline_key_hint() is stored instead of the latter.
+ */
+
 /**
  * Struct that is used as a key in BPS tree definition.
  */
@@ -53,22 +60,38 @@ struct memtx_tree_key_data_common {
 	uint32_t part_count;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_key_data;
 
 template <>
 struct memtx_tree_key_data<false> : memtx_tree_key_data_common {
 	static constexpr hint_t hint = HINT_NONE;
+	static constexpr hint_t wide_hint = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
+	void set_wide_hint(hint_t) { assert(false); }
 };
 
 template <>
 struct memtx_tree_key_data<true> : memtx_tree_key_data_common {
 	/** Comparison hint, see tuple_hint(). */
 	hint_t hint;
+	static constexpr hint_t wide_hint = HINT_NONE;
 	void set_hint(hint_t h) { hint = h; }
+	void set_wide_hint(hint_t) { assert(false); }
+};
+
+template <>
+struct memtx_tree_key_data<2> : memtx_tree_key_data<true> {
+	/** Wide comparison hint, see key_wide_hint(). */
+	hint_t wide_hint;
+	void set_hint(hint_t h) { hint = h; wide_hint = HINT_NONE; }
+	void set_wide_hint(hint_t h) { wide_hint = h; }
 };
 
+/** Inline key hint is stored in wide_hint, see key_inline_key_hint(). */
+template <>
+struct memtx_tree_key_data<3> : memtx_tree_key_data<2> {};
+
 /**
  * Struct that is used as a elem in BPS tree definition.
  */
@@ -77,13 +100,15 @@ struct memtx_tree_data_common {
 	struct tuple *tuple;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_data;
 
 template <>
 struct memtx_tree_data<false> : memtx_tree_data_common {
 	static constexpr hint_t hint = HINT_NONE;
+	static constexpr hint_t wide_hint = HINT_NONE;
 	void set_hint(hint_t) { assert(false); }
+	void set_wide_hint(hint_t) { assert(false); }
 };
 
 template <>
@@ -93,6 +118,39 @@ struct memtx_tree_data<true> :  memtx_tree_data<false> {
 	void set_hint(hint_t h) { hint = h; }
 };
 
+template <>
+struct memtx_tree_data<2> : memtx_tree_data<true> {
+	/** Wide comparison hint, see tuple_wide_hint(). */
+	hint_t wide_hint;
+	void set_hint(hint_t h) { hint = h; wide_hint = HINT_NONE; }
+	void set_wide_hint(hint_t h) { wide_hint = h; }
+};
+
+/** Inline key hint is stored in wide_hint, see tuple_inline_key_hint(). */
+template <>
+struct memtx_tree_data<3> : memtx_tree_data<2> {};
+
+/** Wide hint of a tuple stored in a tree element. */
+template <int USE_HINT>
+static inline hint_t
+memtx_tree_tuple_wide_hint(struct tuple *tuple, struct key_def *cmp_def)
+{
+	if (USE_HINT > 2)
+		return tuple_inline_key_hint(tuple, cmp_def);
+	return tuple_wide_hint(tuple, cmp_def);
+}
+
+/** Wide hint of a key used for searching a tree. */
+template <int USE_HINT>
+static inline hint_t
+memtx_tree_key_wide_hint(const char *key, uint32_t part_count,
+			 struct key_def *cmp_def)
+{
+	if (USE_HINT > 2)
+		return key_inline_key_hint(key, part_count, cmp_def);
+	return key_wide_hint(key, part_count, cmp_def);
+}
+
 /**
  * Test whether BPS tree elements are identical i.e. represent
  * the same tuple at the same position in the tree.
@@ -108,14 +166,83 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 	return a->tuple == b->tuple;
 }
 
+/**
+ * Compare wide hints of tree elements or keys having equal hints.
+ * Returns 0 if the wide hints can't order them.
+ */
+static inline int
+memtx_tree_wide_hint_cmp(hint_t hint_a, hint_t wide_hint_a,
+			 hint_t hint_b, hint_t wide_hint_b)
+{
+	if (hint_a == hint_b && hint_a != HINT_NONE &&
+	    wide_hint_a != wide_hint_b &&
+	    wide_hint_a != HINT_NONE && wide_hint_b != HINT_NONE)
+		return wide_hint_a < wide_hint_b ? -1 : 1;
+	return 0;
+}
+
+/**
+ * Check if tree elements or keys having equal hints and wide hints
+ * are equal, which is the case if the comparison definition has a
+ * single part fully stored in the inline key hint. Only unique
+ * non-nullable single-part indexes are compared by such a
+ * definition: others have primary key parts appended, see
+ * memtx_tree_index_update_def().
+ */
+static inline bool
+memtx_tree_inline_key_is_equal(hint_t hint_a, hint_t wide_hint_a,
+			       hint_t hint_b, hint_t wide_hint_b,
+			       struct key_def *key_def)
+{
+	return key_def->part_count == 1 && hint_a == hint_b &&
+	       hint_a != HINT_NONE && wide_hint_a == wide_hint_b &&
+	       inline_key_hint_is_exact(wide_hint_a);
+}
+
+template <int USE_HINT>
+static inline int
+memtx_tree_compare(const struct memtx_tree_data<USE_HINT> *a,
+		   const struct memtx_tree_data<USE_HINT> *b,
+		   struct key_def *key_def)
+{
+	if (USE_HINT > 1) {
+		int rc = memtx_tree_wide_hint_cmp(a->hint, a->wide_hint,
+						  b->hint, b->wide_hint);
+		if (rc != 0)
+			return rc;
+	}
+	if (USE_HINT > 2 &&
+	    memtx_tree_inline_key_is_equal(a->hint, a->wide_hint,
+					   b->hint, b->wide_hint, key_def))
+		return 0;
+	return tuple_compare(a->tuple, a->hint, b->tuple, b->hint, key_def);
+}
+
+template <int USE_HINT>
+static inline int
+memtx_tree_compare_key(const struct memtx_tree_data<USE_HINT> *a,
+		       const struct memtx_tree_key_data<USE_HINT> *b,
+		       struct key_def *key_def)
+{
+	if (USE_HINT > 1) {
+		int rc = memtx_tree_wide_hint_cmp(a->hint, a->wide_hint,
+						  b->hint, b->wide_hint);
+		if (rc != 0)
+			return rc;
+	}
+	if (USE_HINT > 2 &&
+	    memtx_tree_inline_key_is_equal(a->hint, a->wide_hint,
+					   b->hint, b->wide_hint, key_def))
+		return 0;
+	return tuple_compare_with_key(a->tuple, a->hint, b->key,
+				      b->part_count, b->hint, key_def);
+}
+
 #define BPS_TREE_NAME memtx_tree
 #define BPS_TREE_BLOCK_SIZE (512)
 #define BPS_TREE_EXTENT_SIZE MEMTX_EXTENT_SIZE
-#define BPS_TREE_COMPARE(a, b, arg)\
-	tuple_compare((&a)->tuple, (&a)->hint, (&b)->tuple, (&b)->hint, arg)
-#define BPS_TREE_COMPARE_KEY(a, b, arg)\
-	tuple_compare_with_key((&a)->tuple, (&a)->hint, (b)->key,\
-			       (b)->part_count, (b)->hint, arg)
+#define BPS_TREE_COMPARE(a, b, arg) memtx_tree_compare(&a, &b, arg)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) memtx_tree_compare_key(&a, b, arg)
 #define BPS_TREE_IS_IDENTICAL(a, b) memtx_tree_data_is_equal(&a, &b)
 #define BPS_TREE_NO_DEBUG 1
 #define bps_tree_arg_t struct key_def *
@@ -140,6 +267,26 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef bps_tree_elem_t
 #undef bps_tree_key_t
 
+#define BPS_TREE_NAMESPACE NS_USE_WIDE_HINT
+#define bps_tree_elem_t struct memtx_tree_data<2>
+#define bps_tree_key_t struct memtx_tree_key_data<2> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
+#define BPS_TREE_NAMESPACE NS_USE_INLINE_KEY
+#define bps_tree_elem_t struct memtx_tree_data<3>
+#define bps_tree_key_t struct memtx_tree_key_data<3> *
+
+#include "salad/bps_tree.h"
+
+#undef BPS_TREE_NAMESPACE
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+
 #undef BPS_TREE_NAME
 #undef BPS_TREE_BLOCK_SIZE
 #undef BPS_TREE_EXTENT_SIZE
@@ -151,8 +298,10 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 
 using namespace NS_NO_HINT;
 using namespace NS_USE_HINT;
+using namespace NS_USE_WIDE_HINT;
+using namespace NS_USE_INLINE_KEY;
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_selector;
 
 template <>
@@ -161,10 +310,16 @@ struct memtx_tree_selector<false> : NS_NO_HINT::memtx_tree {};
 template <>
 struct memtx_tree_selector<true> : NS_USE_HINT::memtx_tree {};
 
-template <bool USE_HINT>
+template <>
+struct memtx_tree_selector<2> : NS_USE_WIDE_HINT::memtx_tree {};
+
+template <>
+struct memtx_tree_selector<3> : NS_USE_INLINE_KEY::memtx_tree {};
+
+template <int USE_HINT>
 using memtx_tree_t = struct memtx_tree_selector<USE_HINT>;
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct memtx_tree_iterator_selector;
 
 template <>
@@ -177,9 +332,45 @@ struct memtx_tree_iterator_selector<true> {
 	using type = NS_USE_HINT::memtx_tree_iterator;
 };
 
-template <bool USE_HINT>
+template <>
+struct memtx_tree_iterator_selector<2> {
+	using type = NS_USE_WIDE_HINT::memtx_tree_iterator;
+};
+
+template <>
+struct memtx_tree_iterator_selector<3> {
+	using type = NS_USE_INLINE_KEY::memtx_tree_iterator;
+};
+
+template <int USE_HINT>
 using memtx_tree_iterator_t = typename memtx_tree_iterator_selector<USE_HINT>::type;
 
+template <int USE_HINT>
+struct memtx_tree_view_selector;
+
+template <>
+struct memtx_tree_view_selector<false> {
+	using type = NS_NO_HINT::memtx_tree_view;
+};
+
+template <>
+struct memtx_tree_view_selector<true> {
+	using type = NS_USE_HINT::memtx_tree_view;
+};
+
+template <>
+struct memtx_tree_view_selector<2> {
+	using type = NS_USE_WIDE_HINT::memtx_tree_view;
+};
+
+template <>
+struct memtx_tree_view_selector<3> {
+	using type = NS_USE_INLINE_KEY::memtx_tree_view;
+};
+
+template <int USE_HINT>
+using memtx_tree_view_t = typename memtx_tree_view_selector<USE_HINT>::type;
+
 static void
 invalidate_tree_iterator(NS_NO_HINT::memtx_tree_iterator *itr)
 {
@@ -192,7 +383,19 @@ invalidate_tree_iterator(NS_USE_HINT::memtx_tree_iterator *itr)
 	*itr = NS_USE_HINT::memtx_tree_invalid_iterator();
 }
 
-template <bool USE_HINT>
+static void
+invalidate_tree_iterator(NS_USE_WIDE_HINT::memtx_tree_iterator *itr)
+{
+	*itr = NS_USE_WIDE_HINT::memtx_tree_invalid_iterator();
+}
+
+static void
+invalidate_tree_iterator(NS_USE_INLINE_KEY::memtx_tree_iterator *itr)
+{
+	*itr = NS_USE_INLINE_KEY::memtx_tree_invalid_iterator();
+}
+
+template <int USE_HINT>
 struct memtx_tree_index {
 	struct index base;
 	memtx_tree_t<USE_HINT> tree;
@@ -211,7 +414,7 @@ memtx_tree_cmp_def(TREE *tree)
 	return tree->arg;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_qcompare(const void* a, const void *b, void *c)
 {
@@ -220,12 +423,11 @@ memtx_tree_qcompare(const void* a, const void *b, void *c)
 	const struct memtx_tree_data<USE_HINT> *data_b =
 		(struct memtx_tree_data<USE_HINT> *)b;
 	struct key_def *key_def = (struct key_def *)c;
-	return tuple_compare(data_a->tuple, data_a->hint, data_b->tuple,
-			     data_b->hint, key_def);
+	return memtx_tree_compare(data_a, data_b, key_def);
 }
 
 /* {{{ MemtxTree Iterators ****************************************/
-template <bool USE_HINT>
+template <int USE_HINT>
 struct tree_iterator {
 	struct iterator base;
 
@@ -264,6 +466,12 @@ struct tree_iterator {
 	 */
 	void *current_func_key;
 	char current_func_key_buf[32];
+	/**
+	 * Interval of the index read by the iterator in the current
+	 * transaction, tracked by the MVCC transaction manager. NULL if
+	 * not tracked.
+	 */
+	struct range_item *range;
 	/** Memory pool the iterator was allocated from. */
 	struct mempool *pool;
 };
@@ -274,8 +482,14 @@ static_assert(sizeof(struct tree_iterator<false>) <= MEMTX_ITERATOR_SIZE,
 static_assert(sizeof(struct tree_iterator<true>) <= MEMTX_ITERATOR_SIZE,
 	      "sizeof(struct tree_iterator<true>) must be less than or equal "
 	      "to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<2>) <= MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<2>) must be less than or equal "
+	      "to MEMTX_ITERATOR_SIZE");
+static_assert(sizeof(struct tree_iterator<3>) <= MEMTX_ITERATOR_SIZE,
+	      "sizeof(struct tree_iterator<3>) must be less than or equal "
+	      "to MEMTX_ITERATOR_SIZE");
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static inline void
 tree_iterator_set_current_tuple(struct tree_iterator<USE_HINT> *it,
 				struct tuple *tuple)
@@ -287,7 +501,7 @@ tree_iterator_set_current_tuple(struct tree_iterator<USE_HINT> *it,
 		tuple_ref(tuple);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static inline void
 tree_iterator_set_current_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
 {
@@ -312,7 +526,7 @@ tree_iterator_set_current_hint(struct tree_iterator<USE_HINT> *it, hint_t hint)
 	it->current.set_hint(hint);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static inline void
 tree_iterator_set_current(struct tree_iterator<USE_HINT> *it,
 			  struct memtx_tree_data<USE_HINT> *cur)
@@ -320,17 +534,19 @@ tree_iterator_set_current(struct tree_iterator<USE_HINT> *it,
 	if (cur != NULL) {
 		tree_iterator_set_current_tuple(it, cur->tuple);
 		tree_iterator_set_current_hint(it, cur->hint);
+		if (USE_HINT > 1)
+			it->current.set_wide_hint(cur->wide_hint);
 	} else {
 		tree_iterator_set_current_tuple(it, NULL);
 		tree_iterator_set_current_hint(it, HINT_NONE);
 	}
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 tree_iterator_free(struct iterator *iterator);
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static inline struct tree_iterator<USE_HINT> *
 get_tree_iterator(struct iterator *it)
 {
@@ -338,12 +554,14 @@ get_tree_iterator(struct iterator *it)
 	return (struct tree_iterator<USE_HINT> *) it;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 tree_iterator_free(struct iterator *iterator)
 {
 	struct tree_iterator<USE_HINT> *it = get_tree_iterator<USE_HINT>(iterator);
 	tree_iterator_set_current<USE_HINT>(it, NULL);
+	if (it->range != NULL)
+		memtx_tx_detach_range(it->range);
 	mempool_free(it->pool, it);
 }
 
@@ -355,7 +573,29 @@ tree_iterator_dummie(struct iterator *iterator, struct tuple **ret)
 	return 0;
 }
 
-template <bool USE_HINT>
+/**
+ * Track the gap the iterator has just read: extend the interval read
+ * by the iterator up to @a end (NULL if the iterator is exhausted) or,
+ * if the interval isn't tracked by the current transaction, track the
+ * gap before @a successor described by @a type and @a key.
+ */
+template <int USE_HINT>
+static void
+tree_iterator_track_gap(struct tree_iterator<USE_HINT> *it,
+			struct space *space, struct tuple *end,
+			struct tuple *successor, enum iterator_type type,
+			const char *key, uint32_t part_count)
+{
+	if (!memtx_tx_manager_use_mvcc_engine)
+		return;
+	struct txn *txn = in_txn();
+	if (memtx_tx_extend_range(txn, it->range, end))
+		return;
+	memtx_tx_track_gap(txn, space, it->base.index, successor, type,
+			   key, part_count);
+}
+
+template <int USE_HINT>
 static int
 tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -377,7 +617,6 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	*ret = it->current.tuple;
 	if (*ret == NULL)
 		iterator->next = tree_iterator_dummie;
-	struct index *idx = iterator->index;
 	struct space *space = space_by_id(iterator->space_id);
 
 /********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
@@ -385,13 +624,13 @@ tree_iterator_next_base(struct iterator *iterator, struct tuple **ret)
 	 * Pass no key because any write to the gap between that
 	 * two tuples must lead to conflict.
 	 */
-	memtx_tx_track_gap(in_txn(), space, idx, *ret, ITER_GE, NULL, 0);
+	tree_iterator_track_gap(it, space, *ret, *ret, ITER_GE, NULL, 0);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -414,7 +653,6 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	*ret = it->current.tuple;
 	if (*ret == NULL)
 		iterator->next = tree_iterator_dummie;
-	struct index *idx = iterator->index;
 	struct space *space = space_by_id(iterator->space_id);
 
 /********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
@@ -422,14 +660,14 @@ tree_iterator_prev_base(struct iterator *iterator, struct tuple **ret)
 	 * Pass no key because any write to the gap between that
 	 * two tuples must lead to conflict.
 	 */
-	memtx_tx_track_gap(in_txn(), space, idx, successor, ITER_LE, NULL, 0);
+	tree_iterator_track_gap(it, space, *ret, successor, ITER_LE, NULL, 0);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 
 	tuple_unref(successor);
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -447,7 +685,6 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 	}
 	struct memtx_tree_data<USE_HINT> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
-	struct index *idx = iterator->index;
 	struct space *space = space_by_id(iterator->space_id);
 	/* Use user key def to save a few loops. */
 	if (res == NULL ||
@@ -466,8 +703,9 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 		struct tuple *nearby_tuple = res == NULL ? NULL : res->tuple;
 
 /********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
-		memtx_tx_track_gap(in_txn(), space, idx, nearby_tuple, ITER_EQ,
-				   it->key_data.key, it->key_data.part_count);
+		tree_iterator_track_gap(it, space, NULL, nearby_tuple, ITER_EQ,
+					it->key_data.key,
+					it->key_data.part_count);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	} else {
 		tree_iterator_set_current<USE_HINT>(it, res);
@@ -478,14 +716,15 @@ tree_iterator_next_equal_base(struct iterator *iterator, struct tuple **ret)
 		 * Pass no key because any write to the gap between that
 		 * two tuples must lead to conflict.
 		 */
-		memtx_tx_track_gap(in_txn(), space, idx, *ret, ITER_GE, NULL, 0);
+		tree_iterator_track_gap(it, space, *ret, *ret, ITER_GE,
+					NULL, 0);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	}
 
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 {
@@ -504,7 +743,6 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 	tuple_ref(successor);
 	struct memtx_tree_data<USE_HINT> *res =
 		memtx_tree_iterator_get_elem(&index->tree, &it->tree_iterator);
-	struct index *idx = iterator->index;
 	struct space *space = space_by_id(iterator->space_id);
 	/* Use user key def to save a few loops. */
 	if (res == NULL ||
@@ -522,8 +760,9 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 		 * Got end of key. Store gap from the key boundary to the
 		 * previous tuple in nearby tuple.
 		 */
-		memtx_tx_track_gap(in_txn(), space, idx, successor, ITER_REQ,
-				   it->key_data.key, it->key_data.part_count);
+		tree_iterator_track_gap(it, space, NULL, successor, ITER_REQ,
+					it->key_data.key,
+					it->key_data.part_count);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	} else {
 		tree_iterator_set_current<USE_HINT>(it, res);
@@ -534,8 +773,8 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 		 * Pass no key because any write to the gap between that
 		 * two tuples must lead to conflict.
 		 */
-		memtx_tx_track_gap(in_txn(), space, idx, successor, ITER_LE,
-				   NULL, 0);
+		tree_iterator_track_gap(it, space, *ret, successor, ITER_LE,
+					NULL, 0);
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	}
 	tuple_unref(successor);
@@ -543,7 +782,7 @@ tree_iterator_prev_equal_base(struct iterator *iterator, struct tuple **ret)
 }
 
 #define WRAP_ITERATOR_METHOD(name)						\
-template <bool USE_HINT>							\
+template <int USE_HINT>							\
 static int									\
 name(struct iterator *iterator, struct tuple **ret)				\
 {										\
@@ -583,7 +822,7 @@ WRAP_ITERATOR_METHOD(tree_iterator_prev_equal);
 
 #undef WRAP_ITERATOR_METHOD
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 {
@@ -612,7 +851,7 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 	}
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 {
@@ -702,10 +941,25 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 	    memtx_tx_manager_use_mvcc_engine) {
 		/* it->tree_iterator is positioned on successor of a key! */
 		struct tuple *successor = res == NULL ? NULL : res->tuple;
+		/*
+		 * Keys of multikey and functional indexes can't be compared
+		 * with tuples so track gaps between tuples for them.
+		 */
+		struct key_def *key_def = idx->def->key_def;
+		bool track_range = !key_def->is_multikey &&
+				   !key_def->for_func_index;
 
 /********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND START*********/
-		memtx_tx_track_gap(in_txn(), space, idx, successor, type,
-				   it->key_data.key, it->key_data.part_count);
+		if (track_range) {
+			memtx_tx_track_range(in_txn(), space, idx, type,
+					     it->key_data.key,
+					     it->key_data.part_count,
+					     successor, &it->range);
+		} else {
+			memtx_tx_track_gap(in_txn(), space, idx, successor,
+					   type, it->key_data.key,
+					   it->key_data.part_count);
+		}
 /*********MVCC TRANSACTION MANAGER STORY GARBAGE COLLECTION BOUND END**********/
 	}
 
@@ -726,7 +980,7 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 
 /* {{{ MemtxTree  **********************************************************/
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
 {
@@ -735,7 +989,7 @@ memtx_tree_index_free(struct memtx_tree_index<USE_HINT> *index)
 	free(index);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 {
@@ -768,7 +1022,7 @@ memtx_tree_index_gc_run(struct memtx_gc_task *task, bool *done)
 	*done = true;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_gc_free(struct memtx_gc_task *task)
 {
@@ -777,7 +1031,7 @@ memtx_tree_index_gc_free(struct memtx_gc_task *task)
 	memtx_tree_index_free(index);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct memtx_gc_task_vtab * get_memtx_tree_index_gc_vtab()
 {
 	static memtx_gc_task_vtab tab =
@@ -788,7 +1042,7 @@ static struct memtx_gc_task_vtab * get_memtx_tree_index_gc_vtab()
 	return &tab;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_destroy(struct index *base)
 {
@@ -813,7 +1067,7 @@ memtx_tree_index_destroy(struct index *base)
 	}
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_update_def(struct index *base)
 {
@@ -838,7 +1092,7 @@ memtx_tree_index_depends_on_pk(struct index *base)
 	return !def->opts.is_unique || def->key_def->is_nullable;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static ssize_t
 memtx_tree_index_size(struct index *base)
 {
@@ -850,7 +1104,7 @@ memtx_tree_index_size(struct index *base)
 	       memtx_tx_index_invisible_count(in_txn(), space, base);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static ssize_t
 memtx_tree_index_bsize(struct index *base)
 {
@@ -859,7 +1113,7 @@ memtx_tree_index_bsize(struct index *base)
 	return memtx_tree_mem_used(&index->tree);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 {
@@ -870,7 +1124,7 @@ memtx_tree_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static ssize_t
 memtx_tree_index_count(struct index *base, enum iterator_type type,
 		       const char *key, uint32_t part_count)
@@ -880,7 +1134,7 @@ memtx_tree_index_count(struct index *base, enum iterator_type type,
 	return generic_index_count(base, type, key, part_count);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_get(struct index *base, const char *key,
 		     uint32_t part_count, struct tuple **result)
@@ -897,6 +1151,9 @@ memtx_tree_index_get(struct index *base, const char *key,
 	key_data.part_count = part_count;
 	if (USE_HINT)
 		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	if (USE_HINT > 1)
+		key_data.set_wide_hint(memtx_tree_key_wide_hint<USE_HINT>(
+			key, part_count, cmp_def));
 	struct memtx_tree_data<USE_HINT> *res =
 		memtx_tree_find(&index->tree, &key_data);
 	if (res == NULL) {
@@ -913,7 +1170,7 @@ memtx_tree_index_get(struct index *base, const char *key,
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 			 struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -927,6 +1184,10 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 		new_data.tuple = new_tuple;
 		if (USE_HINT)
 			new_data.set_hint(tuple_hint(new_tuple, cmp_def));
+		if (USE_HINT > 1)
+			new_data.set_wide_hint(
+				memtx_tree_tuple_wide_hint<USE_HINT>(
+					new_tuple, cmp_def));
 		struct memtx_tree_data<USE_HINT> dup_data, suc_data;
 		dup_data.tuple = suc_data.tuple = NULL;
 
@@ -972,6 +1233,10 @@ memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
 		old_data.tuple = old_tuple;
 		if (USE_HINT)
 			old_data.set_hint(tuple_hint(old_tuple, cmp_def));
+		if (USE_HINT > 1)
+			old_data.set_wide_hint(
+				memtx_tree_tuple_wide_hint<USE_HINT>(
+					old_tuple, cmp_def));
 		memtx_tree_delete(&index->tree, old_data);
 	}
 	*result = old_tuple;
@@ -1391,7 +1656,7 @@ end:
 	return rc;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct iterator *
 memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 				 const char *key, uint32_t part_count)
@@ -1433,15 +1698,20 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 	it->key_data.part_count = part_count;
 	if (USE_HINT)
 		it->key_data.set_hint(key_hint(key, part_count, cmp_def));
+	if (USE_HINT > 1)
+		it->key_data.set_wide_hint(
+			memtx_tree_key_wide_hint<USE_HINT>(key, part_count,
+							   cmp_def));
 	invalidate_tree_iterator(&it->tree_iterator);
 	it->current.tuple = NULL;
 	if (USE_HINT)
 		it->current.set_hint(HINT_NONE);
 	it->current_func_key = NULL;
+	it->range = NULL;
 	return (struct iterator *)it;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_begin_build(struct index *base)
 {
@@ -1451,7 +1721,7 @@ memtx_tree_index_begin_build(struct index *base)
 	(void)index;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 {
@@ -1472,7 +1742,7 @@ memtx_tree_index_reserve(struct index *base, uint32_t size_hint)
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 /** Initialize the next element of the index build_array. */
 static int
 memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
@@ -1508,10 +1778,15 @@ memtx_tree_index_build_array_append(struct memtx_tree_index<USE_HINT> *index,
 	elem->tuple = tuple;
 	if (USE_HINT)
 		elem->set_hint(hint);
+	if (USE_HINT > 1) {
+		struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+		elem->set_wide_hint(memtx_tree_tuple_wide_hint<USE_HINT>(
+			tuple, cmp_def));
+	}
 	return 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 memtx_tree_index_build_next(struct index *base, struct tuple *tuple)
 {
@@ -1577,7 +1852,7 @@ error:
  * of equal tuples (in terms of index's cmp_def and have same
  * tuple pointer). The build_array is expected to be sorted.
  */
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *index,
 			void (*destroy)(const char *hint))
@@ -1612,7 +1887,7 @@ memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *inde
 	index->build_array_size = w_idx + 1;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 memtx_tree_index_end_build(struct index *base)
 {
@@ -1644,7 +1919,7 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array_alloc_size = 0;
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 struct tree_snapshot_iterator {
 	struct snapshot_iterator base;
 	struct memtx_tree_index<USE_HINT> *index;
@@ -1652,7 +1927,7 @@ struct tree_snapshot_iterator {
 	struct memtx_tx_snapshot_cleaner cleaner;
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static void
 tree_snapshot_iterator_free(struct snapshot_iterator *iterator)
 {
@@ -1667,7 +1942,7 @@ tree_snapshot_iterator_free(struct snapshot_iterator *iterator)
 	free(iterator);
 }
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static int
 tree_snapshot_iterator_next(struct snapshot_iterator *iterator,
 			    const char **data, uint32_t *size)
@@ -1705,7 +1980,7 @@ tree_snapshot_iterator_next(struct snapshot_iterator *iterator,
  * index modifications will not affect the iteration results.
  * Must be destroyed by iterator->free after usage.
  */
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct snapshot_iterator *
 memtx_tree_index_create_snapshot_iterator(struct index *base)
 {
@@ -1722,7 +1997,7 @@ memtx_tree_index_create_snapshot_iterator(struct index *base)
 	}
 
 	struct space *space = space_cache_find(base->def->space_id);
-	memtx_tx_snapshot_cleaner_create(&it->cleaner, space);
+	memtx_tx_snapshot_cleaner_create(&it->cleaner, space, base);
 
 	it->base.free = tree_snapshot_iterator_free<USE_HINT>;
 	it->base.next = tree_snapshot_iterator_next<USE_HINT>;
@@ -1734,6 +2009,221 @@ memtx_tree_index_create_snapshot_iterator(struct index *base)
 	return (struct snapshot_iterator *) it;
 }
 
+/* {{{ Read view ************************************************/
+
+template <int USE_HINT>
+struct tree_read_view {
+	struct index_read_view base;
+	/** The index the read view was created for. */
+	struct memtx_tree_index<USE_HINT> *index;
+	/** Frozen state of the index tree. */
+	memtx_tree_view_t<USE_HINT> tree_view;
+	/** Used to skip tuples not committed by the time of creation. */
+	struct memtx_tx_snapshot_cleaner cleaner;
+};
+
+template <int USE_HINT>
+struct tree_read_view_iterator {
+	struct snapshot_iterator base;
+	struct tree_read_view<USE_HINT> *rv;
+	enum iterator_type type;
+	/** Search key, copied to the memory following the struct. */
+	struct memtx_tree_key_data<USE_HINT> key_data;
+	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+};
+
+template <int USE_HINT>
+static void
+tree_read_view_iterator_free(struct snapshot_iterator *iterator)
+{
+	assert(iterator->free == &tree_read_view_iterator_free<USE_HINT>);
+	free(iterator);
+}
+
+template <int USE_HINT>
+static int
+tree_read_view_iterator_next(struct snapshot_iterator *iterator,
+			     const char **data, uint32_t *size)
+{
+	assert(iterator->free == &tree_read_view_iterator_free<USE_HINT>);
+	struct tree_read_view_iterator<USE_HINT> *it =
+		(struct tree_read_view_iterator<USE_HINT> *)iterator;
+	struct tree_read_view<USE_HINT> *rv = it->rv;
+	memtx_tree_t<USE_HINT> *tree = &rv->index->tree;
+	struct key_def *key_def = rv->base.def->key_def;
+	bool is_eq = it->type == ITER_EQ || it->type == ITER_REQ;
+
+	while (true) {
+		struct memtx_tree_data<USE_HINT> *res =
+			memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
+		if (res == NULL) {
+			*data = NULL;
+			return 0;
+		}
+		if (is_eq &&
+		    tuple_compare_with_key(res->tuple, res->hint,
+					   it->key_data.key,
+					   it->key_data.part_count,
+					   it->key_data.hint, key_def) != 0) {
+			invalidate_tree_iterator(&it->tree_iterator);
+			*data = NULL;
+			return 0;
+		}
+		if (iterator_type_is_reverse(it->type))
+			memtx_tree_iterator_prev(tree, &it->tree_iterator);
+		else
+			memtx_tree_iterator_next(tree, &it->tree_iterator);
+
+		struct tuple *tuple = res->tuple;
+		tuple = memtx_tx_snapshot_clarify(&rv->cleaner, tuple);
+		if (tuple == NULL)
+			continue;
+		*data = tuple_data_range(tuple, size);
+		return 0;
+	}
+	return 0;
+}
+
+template <int USE_HINT>
+static struct snapshot_iterator *
+tree_read_view_create_iterator(struct index_read_view *base,
+			       enum iterator_type type,
+			       const char *key, uint32_t part_count)
+{
+	struct tree_read_view<USE_HINT> *rv =
+		(struct tree_read_view<USE_HINT> *)base;
+	memtx_tree_t<USE_HINT> *tree = &rv->index->tree;
+	struct key_def *cmp_def = memtx_tree_cmp_def(tree);
+
+	assert(part_count == 0 || key != NULL);
+	if (type > ITER_GT) {
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		return NULL;
+	}
+	if (part_count == 0) {
+		type = iterator_type_is_reverse(type) ? ITER_LE : ITER_GE;
+		key = NULL;
+	}
+	const char *key_end = key;
+	for (uint32_t i = 0; i < part_count; i++)
+		mp_next(&key_end);
+	size_t key_size = key_end - key;
+
+	struct tree_read_view_iterator<USE_HINT> *it;
+	size_t size = sizeof(*it) + key_size;
+	it = (struct tree_read_view_iterator<USE_HINT> *)malloc(size);
+	if (it == NULL) {
+		diag_set(OutOfMemory, size, "malloc",
+			 "struct tree_read_view_iterator");
+		return NULL;
+	}
+	it->base.next = tree_read_view_iterator_next<USE_HINT>;
+	it->base.free = tree_read_view_iterator_free<USE_HINT>;
+	it->rv = rv;
+	it->type = type;
+	if (key != NULL) {
+		char *key_copy = (char *)(it + 1);
+		memcpy(key_copy, key, key_size);
+		key = key_copy;
+	}
+	it->key_data.key = key;
+	it->key_data.part_count = part_count;
+	if (USE_HINT)
+		it->key_data.set_hint(key_hint(key, part_count, cmp_def));
+	if (USE_HINT > 1)
+		it->key_data.set_wide_hint(
+			memtx_tree_key_wide_hint<USE_HINT>(key, part_count,
+							   cmp_def));
+	if (key == NULL) {
+		if (iterator_type_is_reverse(type))
+			it->tree_iterator = memtx_tree_view_last(
+				tree, &rv->tree_view);
+		else
+			it->tree_iterator = memtx_tree_view_first(
+				tree, &rv->tree_view);
+		return &it->base;
+	}
+	bool equals = false;
+	if (type == ITER_ALL || type == ITER_EQ ||
+	    type == ITER_GE || type == ITER_LT) {
+		it->tree_iterator = memtx_tree_view_lower_bound(
+			tree, &rv->tree_view, &it->key_data, &equals);
+	} else { // ITER_GT, ITER_REQ, ITER_LE
+		it->tree_iterator = memtx_tree_view_upper_bound(
+			tree, &rv->tree_view, &it->key_data, &equals);
+	}
+	if (iterator_type_is_reverse(type)) {
+		/*
+		 * See the comment in tree_iterator_start(). Unlike
+		 * a regular iterator, a frozen one doesn't turn to
+		 * the last position on a back step from the invalid
+		 * state, so do it explicitly.
+		 */
+		if (memtx_tree_iterator_is_invalid(&it->tree_iterator))
+			it->tree_iterator = memtx_tree_view_last(
+				tree, &rv->tree_view);
+		else
+			memtx_tree_iterator_prev(tree, &it->tree_iterator);
+	}
+	if (!equals && (type == ITER_EQ || type == ITER_REQ))
+		invalidate_tree_iterator(&it->tree_iterator);
+	return &it->base;
+}
+
+template <int USE_HINT>
+static void
+tree_read_view_free(struct index_read_view *base)
+{
+	struct tree_read_view<USE_HINT> *rv =
+		(struct tree_read_view<USE_HINT> *)base;
+	struct memtx_tree_index<USE_HINT> *index = rv->index;
+	memtx_tree_view_destroy(&index->tree, &rv->tree_view);
+	memtx_tx_snapshot_cleaner_destroy(&rv->cleaner);
+	memtx_leave_delayed_free_mode((struct memtx_engine *)
+				      index->base.engine);
+	index_unref(&index->base);
+	index_read_view_destroy(base);
+	free(rv);
+}
+
+/**
+ * Create a read view of a tree index. All iterators created
+ * over it see the index as it was at the moment of creation.
+ */
+template <int USE_HINT>
+static struct index_read_view *
+memtx_tree_index_create_read_view(struct index *base)
+{
+	static const struct index_read_view_vtab vtab = {
+		/* .free = */ tree_read_view_free<USE_HINT>,
+		/* .create_iterator = */
+			tree_read_view_create_iterator<USE_HINT>,
+	};
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct tree_read_view<USE_HINT> *rv =
+		(struct tree_read_view<USE_HINT> *)malloc(sizeof(*rv));
+	if (rv == NULL) {
+		diag_set(OutOfMemory, sizeof(*rv), "malloc",
+			 "struct tree_read_view");
+		return NULL;
+	}
+	if (index_read_view_create(&rv->base, &vtab, base->def) != 0) {
+		free(rv);
+		return NULL;
+	}
+	struct space *space = space_cache_find(base->def->space_id);
+	memtx_tx_snapshot_cleaner_create(&rv->cleaner, space, base);
+	rv->index = index;
+	index_ref(base);
+	memtx_tree_view_create(&index->tree, &rv->tree_view);
+	memtx_enter_delayed_free_mode((struct memtx_engine *)base->engine);
+	return &rv->base;
+}
+
+/* }}} */
+
 static const struct index_vtab memtx_tree_no_hint_index_vtab = {
 	/* .destroy = */ memtx_tree_index_destroy<false>,
 	/* .commit_create = */ generic_index_commit_create,
@@ -1755,6 +2245,7 @@ static const struct index_vtab memtx_tree_no_hint_index_vtab = {
 	/* .create_iterator = */ memtx_tree_index_create_iterator<false>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<false>,
+	/* .create_read_view = */ memtx_tree_index_create_read_view<false>,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1785,6 +2276,7 @@ static const struct index_vtab memtx_tree_use_hint_index_vtab = {
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<true>,
+	/* .create_read_view = */ memtx_tree_index_create_read_view<true>,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1794,6 +2286,68 @@ static const struct index_vtab memtx_tree_use_hint_index_vtab = {
 	/* .end_build = */ memtx_tree_index_end_build<true>,
 };
 
+static const struct index_vtab memtx_tree_use_wide_hint_index_vtab = {
+	/* .destroy = */ memtx_tree_index_destroy<2>,
+	/* .commit_create = */ generic_index_commit_create,
+	/* .abort_create = */ generic_index_abort_create,
+	/* .commit_modify = */ generic_index_commit_modify,
+	/* .commit_drop = */ generic_index_commit_drop,
+	/* .update_def = */ memtx_tree_index_update_def<2>,
+	/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
+	/* .def_change_requires_rebuild = */
+		memtx_index_def_change_requires_rebuild,
+	/* .size = */ memtx_tree_index_size<2>,
+	/* .bsize = */ memtx_tree_index_bsize<2>,
+	/* .min = */ generic_index_min,
+	/* .max = */ generic_index_max,
+	/* .random = */ memtx_tree_index_random<2>,
+	/* .count = */ memtx_tree_index_count<2>,
+	/* .get = */ memtx_tree_index_get<2>,
+	/* .replace = */ memtx_tree_index_replace<2>,
+	/* .create_iterator = */ memtx_tree_index_create_iterator<2>,
+	/* .create_snapshot_iterator = */
+		memtx_tree_index_create_snapshot_iterator<2>,
+	/* .create_read_view = */ memtx_tree_index_create_read_view<2>,
+	/* .stat = */ generic_index_stat,
+	/* .compact = */ generic_index_compact,
+	/* .reset_stat = */ generic_index_reset_stat,
+	/* .begin_build = */ memtx_tree_index_begin_build<2>,
+	/* .reserve = */ memtx_tree_index_reserve<2>,
+	/* .build_next = */ memtx_tree_index_build_next<2>,
+	/* .end_build = */ memtx_tree_index_end_build<2>,
+};
+
+static const struct index_vtab memtx_tree_use_inline_key_index_vtab = {
+	/* .destroy = */ memtx_tree_index_destroy<3>,
+	/* .commit_create = */ generic_index_commit_create,
+	/* .abort_create = */ generic_index_abort_create,
+	/* .commit_modify = */ generic_index_commit_modify,
+	/* .commit_drop = */ generic_index_commit_drop,
+	/* .update_def = */ memtx_tree_index_update_def<3>,
+	/* .depends_on_pk = */ memtx_tree_index_depends_on_pk,
+	/* .def_change_requires_rebuild = */
+		memtx_index_def_change_requires_rebuild,
+	/* .size = */ memtx_tree_index_size<3>,
+	/* .bsize = */ memtx_tree_index_bsize<3>,
+	/* .min = */ generic_index_min,
+	/* .max = */ generic_index_max,
+	/* .random = */ memtx_tree_index_random<3>,
+	/* .count = */ memtx_tree_index_count<3>,
+	/* .get = */ memtx_tree_index_get<3>,
+	/* .replace = */ memtx_tree_index_replace<3>,
+	/* .create_iterator = */ memtx_tree_index_create_iterator<3>,
+	/* .create_snapshot_iterator = */
+		memtx_tree_index_create_snapshot_iterator<3>,
+	/* .create_read_view = */ memtx_tree_index_create_read_view<3>,
+	/* .stat = */ generic_index_stat,
+	/* .compact = */ generic_index_compact,
+	/* .reset_stat = */ generic_index_reset_stat,
+	/* .begin_build = */ memtx_tree_index_begin_build<3>,
+	/* .reserve = */ memtx_tree_index_reserve<3>,
+	/* .build_next = */ memtx_tree_index_build_next<3>,
+	/* .end_build = */ memtx_tree_index_end_build<3>,
+};
+
 static const struct index_vtab memtx_tree_index_multikey_vtab = {
 	/* .destroy = */ memtx_tree_index_destroy<true>,
 	/* .commit_create = */ generic_index_commit_create,
@@ -1815,6 +2369,7 @@ static const struct index_vtab memtx_tree_index_multikey_vtab = {
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<true>,
+	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1845,6 +2400,7 @@ static const struct index_vtab memtx_tree_func_index_vtab = {
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<true>,
+	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1881,6 +2437,7 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .create_iterator = */ generic_index_create_iterator,
 	/* .create_snapshot_iterator = */
 		generic_index_create_snapshot_iterator,
+	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1890,7 +2447,7 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .end_build = */ generic_index_end_build,
 };
 
-template <bool USE_HINT>
+template <int USE_HINT>
 static struct index *
 memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 			 const struct index_vtab *vtab)
@@ -1930,6 +2487,12 @@ memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 			vtab = &memtx_tree_func_index_vtab;
 	} else if (def->key_def->is_multikey) {
 		vtab = &memtx_tree_index_multikey_vtab;
+	} else if (def->opts.hint && def->opts.inline_key) {
+		vtab = &memtx_tree_use_inline_key_index_vtab;
+		return memtx_tree_index_new_tpl<3>(memtx, def, vtab);
+	} else if (def->opts.hint && def->opts.wide_hint) {
+		vtab = &memtx_tree_use_wide_hint_index_vtab;
+		return memtx_tree_index_new_tpl<2>(memtx, def, vtab);
 	} else if (def->opts.hint) {
 		vtab = &memtx_tree_use_hint_index_vtab;
 	} else {
@@ -34,10 +34,12 @@
 #include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "txn.h"
 #include "schema_def.h"
 #include "small/mempool.h"
+#include "info/info.h"
 
 static uint32_t
 memtx_tx_story_key_hash(const struct tuple *a)
@@ -119,6 +121,71 @@ struct full_scan_item {
 	struct txn *txn;
 };
 
+/**
+ * A bound of an interval of an ordered index: a position right before
+ * or right after all tuples matching a (partial) key.
+ */
+struct range_bound {
+	/**
+	 * Key with MsgPack array header. An empty key is before or after
+	 * all tuples of the index.
+	 */
+	const char *key;
+	/** Set if the bound is after the tuples matching the key. */
+	bool is_after;
+};
+
+/**
+ * An element that stores the fact that some transaction have read
+ * an interval of an ordered index with one iterator. Unlike gap_item,
+ * which covers the gap between two neighbouring tuples, it covers the
+ * whole interval read by the iterator so far and is extended as the
+ * iterator advances, so a scan costs one item regardless of its length.
+ *
+ * When the iterator is destroyed, the interval is converted to a pair
+ * of bounds and merged with the overlapping intervals the transaction
+ * has read from the index, see memtx_tx_detach_range(). So an index has
+ * at most one item per open iterator plus one per disjoint interval
+ * read by a transaction.
+ */
+struct range_item {
+	/** A link in index::read_ranges. */
+	struct rlist in_read_ranges;
+	/** Link in txn->range_list. */
+	struct rlist in_range_list;
+	/** The transaction that read it. */
+	struct txn *txn;
+	/** The index the interval was read from. */
+	struct index *index;
+	/**
+	 * Set if the interval is described with @a lo and @a hi rather
+	 * than with the iterator key, type and end.
+	 */
+	bool has_bounds;
+	/** Lower and upper bounds of the interval in the index order. */
+	struct range_bound lo;
+	struct range_bound hi;
+	/**
+	 * Iterator's reference to this item, reset to NULL when the item
+	 * is deleted. NULL if the iterator is destroyed.
+	 */
+	struct range_item **owner;
+	/**
+	 * The last tuple read by the iterator: tuples beyond it in the
+	 * iteration order aren't in the range. NULL if the iterator is
+	 * exhausted. Referenced.
+	 */
+	struct tuple *end;
+	/** The iterator key. Can be NULL. */
+	const char *key;
+	uint32_t key_len;
+	uint32_t part_count;
+	/** Search mode. */
+	enum iterator_type type;
+	/** Storage for short key. @key may point here. */
+	char short_key[16];
+};
+
 /**
  * Helper structure for searching for point_hole_item in the hash table,
  * @sa point_hole_item_pool.
@@ -191,6 +258,12 @@ struct tx_manager
 	 * so the list is ordered by rv_psn.
 	 */
 	struct rlist read_view_txs;
+	/**
+	 * List of transactions without writes that were sent to a read
+	 * view by a conflict and whose read trackers haven't been
+	 * released yet, see memtx_tx_release_read_sets().
+	 */
+	struct rlist read_set_release_txs;
 	/** Mempools for tx_story objects with different index count. */
 	struct mempool memtx_tx_story_pool[BOX_INDEX_MAX];
 	/** Hash table tuple -> memtx_story of that tuple. */
@@ -205,6 +278,8 @@ struct tx_manager
 	struct mempool gap_item_mempoool;
 	/** Mempool for full_scan_item objects. */
 	struct mempool full_scan_item_mempool;
+	/** Mempool for range_item objects. */
+	struct mempool range_item_mempool;
 	/** List of all memtx_story objects. */
 	struct rlist all_stories;
 	/** Iterator that sequentially traverses all memtx_story objects. */
@@ -213,6 +288,8 @@ struct tx_manager
 	struct rlist all_txs;
 	/** Accumulated number of GC steps that should be done. */
 	size_t must_do_gc_steps;
+	/** Read-only transaction statistics. */
+	struct memtx_tx_statistics stat;
 };
 
 enum {
@@ -234,6 +311,7 @@ void
 memtx_tx_manager_init()
 {
 	rlist_create(&txm.read_view_txs);
+	rlist_create(&txm.read_set_release_txs);
 	for (size_t i = 0; i < BOX_INDEX_MAX; i++) {
 		size_t item_size = sizeof(struct memtx_story) +
 				   i * sizeof(struct memtx_story_link);
@@ -248,6 +326,8 @@ memtx_tx_manager_init()
 		       cord_slab_cache(), sizeof(struct gap_item));
 	mempool_create(&txm.full_scan_item_mempool,
 		       cord_slab_cache(), sizeof(struct full_scan_item));
+	mempool_create(&txm.range_item_mempool,
+		       cord_slab_cache(), sizeof(struct range_item));
 	txm.point_holes_size = 0;
 	rlist_create(&txm.all_stories);
 	rlist_create(&txm.all_txs);
@@ -265,6 +345,36 @@ memtx_tx_manager_free()
 	mh_point_holes_delete(txm.point_holes);
 	mempool_destroy(&txm.gap_item_mempoool);
 	mempool_destroy(&txm.full_scan_item_mempool);
+	mempool_destroy(&txm.range_item_mempool);
+}
+
+void
+memtx_tx_stat(struct info_handler *h)
+{
+	struct memtx_tx_statistics *stat = &txm.stat;
+	info_begin(h);
+	info_table_begin(h, "txn");
+	info_append_int(h, "read_only", stat->read_only_txns);
+	info_append_int(h, "read_view", stat->read_view_txns);
+	info_table_end(h); /* txn */
+	info_table_begin(h, "saved_trackers");
+	info_append_int(h, "read", stat->saved_reads);
+	info_append_int(h, "point", stat->saved_points);
+	info_append_int(h, "gap", stat->saved_gaps);
+	info_append_int(h, "full_scan", stat->saved_full_scans);
+	info_table_end(h); /* saved_trackers */
+	struct mempool_stats mstats;
+	mempool_stats(&txm.range_item_mempool, &mstats);
+	info_table_begin(h, "trackers");
+	info_append_int(h, "range", mstats.objcount);
+	info_table_end(h); /* trackers */
+	info_end(h);
+}
+
+void
+memtx_tx_reset_stat(void)
+{
+	memset(&txm.stat, 0, sizeof(txm.stat));
 }
 
 void
@@ -345,6 +455,23 @@ memtx_tx_cause_conflict(struct txn *breaker, struct txn *victim)
 	return 0;
 }
 
+void
+memtx_tx_send_to_read_view(struct txn *txn)
+{
+	assert(txn_has_flag(txn, TXN_IS_READ_ONLY));
+	txm.stat.read_only_txns++;
+	if (!memtx_tx_manager_use_mvcc_engine)
+		return;
+	assert(txn->status == TXN_INPROGRESS);
+	/*
+	 * The transaction sees everything prepared so far, like any
+	 * other transaction in progress, and nothing prepared later.
+	 */
+	txn->status = TXN_IN_READ_VIEW;
+	txn->rv_psn = txn_last_psn + 1;
+	rlist_add_tail(&txm.read_view_txs, &txn->in_read_view_txs);
+}
+
 void
 memtx_tx_handle_conflict(struct txn *breaker, struct txn *victim)
 {
@@ -358,6 +485,16 @@ memtx_tx_handle_conflict(struct txn *breaker, struct txn *victim)
 		victim->status = TXN_IN_READ_VIEW;
 		victim->rv_psn = breaker->psn;
 		rlist_add_tail(&txm.read_view_txs, &victim->in_read_view_txs);
+		/*
+		 * The victim will never be conflicted, so it stops
+		 * tracking new reads and its existing trackers are
+		 * released on the next garbage collection round. They
+		 * can't be unlinked here because we may be called while
+		 * the story reader lists are being iterated.
+		 */
+		rlist_add_tail(&txm.read_set_release_txs,
+			       &victim->in_read_set_release_txs);
+		txm.stat.read_view_txns++;
 	} else {
 		/* Mark as conflicted. */
 		victim->status = TXN_CONFLICTED;
@@ -910,12 +1047,52 @@ memtx_tx_story_gc_step()
 	memtx_tx_story_delete(story);
 }
 
+/**
+ * Release all read trackers of the transactions that were sent to a read
+ * view by a conflict: they will never be conflicted so they don't need
+ * the trackers anymore.
+ */
+static void
+memtx_tx_release_read_sets(void)
+{
+	while (!rlist_empty(&txm.read_set_release_txs)) {
+		struct txn *txn =
+			rlist_first_entry(&txm.read_set_release_txs,
+					  struct txn, in_read_set_release_txs);
+		assert(txn->status == TXN_IN_READ_VIEW);
+		rlist_del(&txn->in_read_set_release_txs);
+		struct tx_read_tracker *tracker, *tmp;
+		rlist_foreach_entry_safe(tracker, &txn->read_set,
+					 in_read_set, tmp) {
+			rlist_del(&tracker->in_reader_list);
+			rlist_del(&tracker->in_read_set);
+			txm.stat.saved_reads++;
+		}
+		struct point_hole_item *point;
+		rlist_foreach_entry(point, &txn->point_holes_list,
+				    in_point_holes_list)
+			txm.stat.saved_points++;
+		struct gap_item *gap;
+		rlist_foreach_entry(gap, &txn->gap_list, in_gap_list)
+			txm.stat.saved_gaps++;
+		struct full_scan_item *full_scan;
+		rlist_foreach_entry(full_scan, &txn->full_scan_list,
+				    in_full_scan_list)
+			txm.stat.saved_full_scans++;
+		struct range_item *range;
+		rlist_foreach_entry(range, &txn->range_list, in_range_list)
+			txm.stat.saved_gaps++;
+		memtx_tx_clean_txn(txn);
+	}
+}
+
 /**
  * Run several rounds of memtx_tx_story_gc_step()
  */
 static void
 memtx_tx_story_gc()
 {
+	memtx_tx_release_read_sets();
 	for (size_t i = 0; i < txm.must_do_gc_steps; i++)
 		memtx_tx_story_gc_step();
 	txm.must_do_gc_steps = 0;
@@ -1312,6 +1489,99 @@ static int
 memtx_tx_track_read_story(struct txn *txn, struct space *space,
 			  struct memtx_story *story, uint64_t index_mask);
 
+/**
+ * Compare @a tuple with a range bound. Never returns 0 since a bound
+ * lies between tuples.
+ */
+static int
+memtx_tx_range_bound_cmp(const struct range_bound *bound,
+			 struct tuple *tuple, struct key_def *cmp_def)
+{
+	const char *key = bound->key;
+	uint32_t part_count = mp_decode_array(&key);
+	int cmp = 0;
+	if (part_count != 0) {
+		cmp = tuple_compare_with_key(tuple, HINT_NONE, key,
+					     part_count, HINT_NONE, cmp_def);
+	}
+	if (cmp != 0)
+		return cmp;
+	return bound->is_after ? -1 : 1;
+}
+
+/** Compare positions of two range bounds in the index order. */
+static int
+memtx_tx_range_bound_compare(const struct range_bound *a,
+			     const struct range_bound *b,
+			     struct key_def *cmp_def)
+{
+	int cmp = key_compare(a->key, HINT_NONE, b->key, HINT_NONE, cmp_def);
+	if (cmp != 0)
+		return cmp;
+	/* One of the keys is a prefix of the other one. */
+	if (a->is_after != b->is_after)
+		return a->is_after ? 1 : -1;
+	const char *key_a = a->key;
+	const char *key_b = b->key;
+	int part_count_a = mp_decode_array(&key_a);
+	int part_count_b = mp_decode_array(&key_b);
+	/* A shorter key is matched by more tuples. */
+	return a->is_after ? part_count_b - part_count_a :
+			     part_count_a - part_count_b;
+}
+
+/** Check if @a tuple falls into the interval read with @a item. */
+static bool
+memtx_tx_range_contains(struct range_item *item, struct index *index,
+			struct tuple *tuple)
+{
+	if (item->has_bounds) {
+		struct key_def *cmp_def = index->def->cmp_def;
+		return memtx_tx_range_bound_cmp(&item->lo, tuple,
+						cmp_def) > 0 &&
+		       memtx_tx_range_bound_cmp(&item->hi, tuple,
+						cmp_def) < 0;
+	}
+	if (item->part_count != 0) {
+		struct key_def *def = index->def->key_def;
+		int cmp = tuple_compare_with_key(tuple, HINT_NONE, item->key,
+						 item->part_count, HINT_NONE,
+						 def);
+		switch (item->type) {
+		case ITER_EQ:
+		case ITER_REQ:
+			if (cmp != 0)
+				return false;
+			break;
+		case ITER_ALL:
+		case ITER_GE:
+			if (cmp < 0)
+				return false;
+			break;
+		case ITER_GT:
+			if (cmp <= 0)
+				return false;
+			break;
+		case ITER_LE:
+			if (cmp > 0)
+				return false;
+			break;
+		case ITER_LT:
+			if (cmp >= 0)
+				return false;
+			break;
+		default:
+			unreachable();
+		}
+	}
+	if (item->end == NULL)
+		return true;
+	struct key_def *cmp_def = index->def->cmp_def;
+	int cmp = tuple_compare(tuple, HINT_NONE, item->end, HINT_NONE,
+				cmp_def);
+	return cmp * iterator_direction(item->type) < 0;
+}
+
 /**
  * Handle insertion to a new place in index. There can be readers which
  * have read from this gap and thus must be sent to read view or conflicted.
@@ -1328,6 +1598,15 @@ memtx_tx_handle_gap_write(struct txn *txn, struct space *space,
 		if (memtx_tx_cause_conflict(txn, fsc_item->txn) != 0)
 			return -1;
 	}
+	uint64_t index_mask = 1ull << (ind & 63);
+	struct range_item *range;
+	rlist_foreach_entry(range, &index->read_ranges, in_read_ranges) {
+		if (!memtx_tx_range_contains(range, index, tuple))
+			continue;
+		if (memtx_tx_track_read_story(range->txn, space, story,
+					      index_mask) != 0)
+			return -1;
+	}
 	if (successor != NULL && !successor->is_dirty)
 		return 0; /* no gap records */
 
@@ -1339,7 +1618,6 @@ memtx_tx_handle_gap_write(struct txn *txn, struct space *space,
 		list = &succ_story->link[ind].nearby_gaps;
 		assert(list->next != NULL && list->prev != NULL);
 	}
-	uint64_t index_mask = 1ull << (ind & 63);
 	struct gap_item *item, *tmp;
 	rlist_foreach_entry_safe(item, list, in_nearby_gaps, tmp) {
 		bool is_split = false;
@@ -1995,6 +2273,18 @@ memtx_tx_full_scan_item_delete(struct full_scan_item *item)
 	mempool_free(&txm.full_scan_item_mempool, item);
 }
 
+static void
+memtx_tx_range_item_delete(struct range_item *item)
+{
+	rlist_del(&item->in_range_list);
+	rlist_del(&item->in_read_ranges);
+	if (item->owner != NULL)
+		*item->owner = NULL;
+	if (item->end != NULL)
+		tuple_unref(item->end);
+	mempool_free(&txm.range_item_mempool, item);
+}
+
 void
 memtx_tx_on_index_delete(struct index *index)
 {
@@ -2012,6 +2302,13 @@ memtx_tx_on_index_delete(struct index *index)
 					  in_full_scans);
 		memtx_tx_full_scan_item_delete(item);
 	}
+	while (!rlist_empty(&index->read_ranges)) {
+		struct range_item *item =
+			rlist_first_entry(&index->read_ranges,
+					  struct range_item,
+					  in_read_ranges);
+		memtx_tx_range_item_delete(item);
+	}
 }
 
 void
@@ -2039,6 +2336,22 @@ memtx_tx_on_space_delete(struct space *space)
 	}
 }
 
+/**
+ * Read trackers are only needed for detecting conflicts and a
+ * transaction that isn't in progress can't be conflicted anymore.
+ * Returns false if @a txn doesn't need to track its reads. If the
+ * transaction is in a read view, accounts the tracker in @a saved.
+ */
+static inline bool
+memtx_tx_need_tracking(struct txn *txn, int64_t *saved)
+{
+	if (txn->status == TXN_INPROGRESS)
+		return true;
+	if (txn->status == TXN_IN_READ_VIEW)
+		++*saved;
+	return false;
+}
+
 /**
  * Allocate and initialize tx_read_tracker, return NULL in case of error
  * (diag is set). Links in lists are not initialized though.
@@ -2111,6 +2424,10 @@ memtx_tx_track_read_story(struct txn *txn, struct space *space,
 		return 0;
 	if (space->def->opts.is_ephemeral)
 		return 0;
+	if (txn->status == TXN_IN_READ_VIEW) {
+		txm.stat.saved_reads++;
+		return 0;
+	}
 	return memtx_tx_track_read_story_slow(txn, story, index_mask);
 }
 
@@ -2125,6 +2442,10 @@ memtx_tx_track_read(struct txn *txn, struct space *space, struct tuple *tuple)
 		return 0;
 	if (space->def->opts.is_ephemeral)
 		return 0;
+	if (txn->status == TXN_IN_READ_VIEW) {
+		txm.stat.saved_reads++;
+		return 0;
+	}
 
 	if (tuple->is_dirty) {
 		struct memtx_story *story = memtx_tx_story_get(tuple);
@@ -2260,7 +2581,7 @@ point_hole_storage_delete(struct point_hole_item *object)
 int
 memtx_tx_track_point_slow(struct txn *txn, struct index *index, const char *key)
 {
-	if (txn->status != TXN_INPROGRESS)
+	if (!memtx_tx_need_tracking(txn, &txm.stat.saved_points))
 		return 0;
 
 	struct key_def *def = index->def->key_def;
@@ -2321,7 +2642,7 @@ memtx_tx_track_gap_slow(struct txn *txn, struct space *space, struct index *inde
 			struct tuple *successor, enum iterator_type type,
 			const char *key, uint32_t part_count)
 {
-	if (txn->status != TXN_INPROGRESS)
+	if (!memtx_tx_need_tracking(txn, &txm.stat.saved_gaps))
 		return 0;
 
 	struct gap_item *item = memtx_tx_gap_item_new(txn, type, key,
@@ -2375,7 +2696,7 @@ memtx_tx_full_scan_item_new(struct txn *txn)
 int
 memtx_tx_track_full_scan_slow(struct txn *txn, struct index *index)
 {
-	if (txn->status != TXN_INPROGRESS)
+	if (!memtx_tx_need_tracking(txn, &txm.stat.saved_full_scans))
 		return 0;
 
 	struct full_scan_item *item = memtx_tx_full_scan_item_new(txn);
@@ -2387,6 +2708,190 @@ memtx_tx_track_full_scan_slow(struct txn *txn, struct index *index)
 	return 0;
 }
 
+int
+memtx_tx_track_range_slow(struct txn *txn, struct index *index,
+			  enum iterator_type type, const char *key,
+			  uint32_t part_count, struct tuple *end,
+			  struct range_item **range)
+{
+	assert(*range == NULL);
+	if (!memtx_tx_need_tracking(txn, &txm.stat.saved_gaps))
+		return 0;
+
+	struct range_item *item = (struct range_item *)
+		mempool_alloc(&txm.range_item_mempool);
+	if (item == NULL) {
+		diag_set(OutOfMemory, sizeof(*item), "mempool_alloc",
+			 "range_item");
+		return -1;
+	}
+	const char *tmp = key;
+	for (uint32_t i = 0; i < part_count; i++)
+		mp_next(&tmp);
+	item->key_len = tmp - key;
+	if (part_count == 0) {
+		item->key = NULL;
+	} else if (item->key_len <= sizeof(item->short_key)) {
+		item->key = item->short_key;
+	} else {
+		item->key = (char *)region_alloc(&txn->region, item->key_len);
+		if (item->key == NULL) {
+			mempool_free(&txm.range_item_mempool, item);
+			diag_set(OutOfMemory, item->key_len, "tx region",
+				 "range key");
+			return -1;
+		}
+	}
+	memcpy((char *)item->key, key, item->key_len);
+	item->txn = txn;
+	item->index = index;
+	item->has_bounds = false;
+	item->type = type;
+	item->part_count = part_count;
+	item->end = end;
+	if (end != NULL)
+		tuple_ref(end);
+	item->owner = range;
+	*range = item;
+	rlist_add(&txn->range_list, &item->in_range_list);
+	rlist_add(&index->read_ranges, &item->in_read_ranges);
+	return 0;
+}
+
+bool
+memtx_tx_extend_range(struct txn *txn, struct range_item *range,
+		      struct tuple *end)
+{
+	if (range == NULL || range->txn != txn)
+		return false;
+	assert(!range->has_bounds);
+	if (end != NULL)
+		tuple_ref(end);
+	if (range->end != NULL)
+		tuple_unref(range->end);
+	range->end = end;
+	return true;
+}
+
+/** Empty key, which is before or after all tuples of an index. */
+static const char memtx_tx_range_empty_key[] = {(char)0x90};
+
+/**
+ * Describe the interval read with a range item by its bounds so that
+ * it doesn't depend on the iterator key, type and end anymore. The
+ * keys are allocated on the transaction region.
+ */
+static int
+memtx_tx_range_set_bounds(struct range_item *item)
+{
+	struct txn *txn = item->txn;
+	struct key_def *cmp_def = item->index->def->cmp_def;
+	const char *key = memtx_tx_range_empty_key;
+	if (item->part_count != 0) {
+		size_t size = mp_sizeof_array(item->part_count) +
+			      item->key_len;
+		char *buf = (char *)region_alloc(&txn->region, size);
+		if (buf == NULL) {
+			diag_set(OutOfMemory, size, "tx region", "range key");
+			return -1;
+		}
+		char *data = mp_encode_array(buf, item->part_count);
+		memcpy(data, item->key, item->key_len);
+		key = buf;
+	}
+	const char *end_key = NULL;
+	if (item->end != NULL) {
+		size_t region_svp = region_used(&fiber()->gc);
+		uint32_t size;
+		const char *data = tuple_extract_key(item->end, cmp_def,
+						     MULTIKEY_NONE, &size);
+		char *buf = data == NULL ? NULL :
+			    (char *)region_alloc(&txn->region, size);
+		if (buf != NULL)
+			memcpy(buf, data, size);
+		region_truncate(&fiber()->gc, region_svp);
+		if (buf == NULL) {
+			diag_set(OutOfMemory, size, "tx region", "range key");
+			return -1;
+		}
+		end_key = buf;
+	}
+	/*
+	 * The iterator key is the start of the interval and the last
+	 * read tuple is its end, exclusive since the tuple itself is
+	 * tracked as read. An exhausted iterator reads up to the end of
+	 * the key for EQ and REQ and up to the end of the index for the
+	 * other types.
+	 */
+	struct range_bound *start, *stop;
+	if (iterator_direction(item->type) > 0) {
+		start = &item->lo;
+		stop = &item->hi;
+		start->is_after = item->type == ITER_GT;
+	} else {
+		start = &item->hi;
+		stop = &item->lo;
+		start->is_after = item->type != ITER_LT;
+	}
+	start->key = key;
+	if (end_key != NULL) {
+		stop->key = end_key;
+		stop->is_after = stop == &item->lo;
+	} else if (item->type == ITER_EQ || item->type == ITER_REQ) {
+		stop->key = key;
+		stop->is_after = stop == &item->hi;
+	} else {
+		stop->key = memtx_tx_range_empty_key;
+		stop->is_after = stop == &item->hi;
+	}
+	if (item->end != NULL) {
+		tuple_unref(item->end);
+		item->end = NULL;
+	}
+	item->has_bounds = true;
+	return 0;
+}
+
+void
+memtx_tx_detach_range(struct range_item *range)
+{
+	assert(*range->owner == range);
+	range->owner = NULL;
+	if (memtx_tx_range_set_bounds(range) != 0) {
+		/* The item is still valid, it just can't be merged. */
+		diag_clear(diag_get());
+		return;
+	}
+	/*
+	 * Merge the interval with the other intervals the transaction
+	 * has read from the index that overlap or touch it so that
+	 * repeated scans of the same keys don't pile up items until the
+	 * transaction ends. Disjoint intervals are kept apart: merging
+	 * them would make the transaction conflict with writes to the
+	 * keys between them, which it has never read.
+	 */
+	struct key_def *cmp_def = range->index->def->cmp_def;
+	struct range_item *item, *tmp;
+	rlist_foreach_entry_safe(item, &range->txn->range_list,
+				 in_range_list, tmp) {
+		if (item == range || item->index != range->index ||
+		    !item->has_bounds)
+			continue;
+		if (memtx_tx_range_bound_compare(&item->lo, &range->hi,
+						 cmp_def) > 0 ||
+		    memtx_tx_range_bound_compare(&range->lo, &item->hi,
+						 cmp_def) > 0)
+			continue;
+		if (memtx_tx_range_bound_compare(&item->lo, &range->lo,
+						 cmp_def) < 0)
+			range->lo = item->lo;
+		if (memtx_tx_range_bound_compare(&item->hi, &range->hi,
+						 cmp_def) > 0)
+			range->hi = item->hi;
+		memtx_tx_range_item_delete(item);
+	}
+}
+
 /**
  * Clean memtx_tx part of @a txm.
  */
@@ -2414,6 +2919,13 @@ memtx_tx_clean_txn(struct txn *txn)
 					  in_full_scan_list);
 		memtx_tx_full_scan_item_delete(item);
 	}
+	while (!rlist_empty(&txn->range_list)) {
+		struct range_item *item =
+			rlist_first_entry(&txn->range_list,
+					  struct range_item,
+					  in_range_list);
+		memtx_tx_range_item_delete(item);
+	}
 }
 
 static uint32_t
@@ -2445,7 +2957,7 @@ struct memtx_tx_snapshot_cleaner_entry
 
 void
 memtx_tx_snapshot_cleaner_create(struct memtx_tx_snapshot_cleaner *cleaner,
-				 struct space *space)
+				 struct space *space, struct index *index)
 {
 	cleaner->ht = NULL;
 	if (space == NULL || rlist_empty(&space->memtx_stories))
@@ -2453,10 +2965,17 @@ memtx_tx_snapshot_cleaner_create(struct memtx_tx_snapshot_cleaner *cleaner,
 	struct mh_snapshot_cleaner_t *ht = mh_snapshot_cleaner_new();
 	struct memtx_story *story;
 	rlist_foreach_entry(story, &space->memtx_stories, in_space_stories) {
+		/*
+		 * Walk the story chain of the given index: it only
+		 * holds versions stored at the same position of the
+		 * index, so if the visible version of the tuple has
+		 * a different key in this index, the tuple is cleaned
+		 * to NULL here and found at the other position.
+		 */
 		struct tuple *tuple = story->tuple;
 		struct tuple *clean =
 			memtx_tx_tuple_clarify_slow(NULL, space, tuple,
-						    space->index[0], 0, true);
+						    index, 0, true);
 		if (clean == tuple)
 			continue;
 
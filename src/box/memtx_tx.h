@@ -48,6 +48,27 @@ extern "C" {
  */
 extern bool memtx_tx_manager_use_mvcc_engine;
 
+struct info_handler;
+
+/** Statistics of transactions that don't track their reads. */
+struct memtx_tx_statistics {
+	/** Number of transactions started in the read-only mode. */
+	int64_t read_only_txns;
+	/**
+	 * Number of transactions without writes that were sent to
+	 * a read view by a conflict.
+	 */
+	int64_t read_view_txns;
+	/** Number of read trackers not allocated or released early. */
+	int64_t saved_reads;
+	/** Number of point hole trackers not allocated or released early. */
+	int64_t saved_points;
+	/** Number of gap trackers not allocated or released early. */
+	int64_t saved_gaps;
+	/** Number of full scan trackers not allocated or released early. */
+	int64_t saved_full_scans;
+};
+
 /**
  * Record that links two transactions, breaker and victim.
  * See memtx_tx_cause_conflict for details.
@@ -170,6 +191,14 @@ struct memtx_tx_snapshot_cleaner {
 void
 memtx_tx_register_tx(struct txn *tx);
 
+/** Dump transaction manager statistics to an info handler. */
+void
+memtx_tx_stat(struct info_handler *h);
+
+/** Reset transaction manager statistics. */
+void
+memtx_tx_reset_stat(void);
+
 /**
  * Initialize memtx transaction manager.
  */
@@ -216,12 +245,23 @@ memtx_tx_cause_conflict(struct txn *breaker, struct txn *victim);
  * The conflict is happened if @a victim have read something that @a breaker
  * overwrites.
  * If @a victim is read-only or hasn't made any changes, it should be sent
- * to read view, in which is will not see @a breaker.
+ * to read view, in which is will not see @a breaker. Its read trackers
+ * are released on the next garbage collection round then.
  * Otherwise @a victim must be marked as conflicted and aborted on occasion.
  */
 void
 memtx_tx_handle_conflict(struct txn *breaker, struct txn *victim);
 
+/**
+ * Send a transaction that was just made read-only to a read view.
+ * The transaction will see a consistent state of the database at
+ * the current moment without tracking its reads, because it can't
+ * be conflicted by anyone. Does nothing but accounting if the MVCC
+ * engine is disabled.
+ */
+void
+memtx_tx_send_to_read_view(struct txn *txn);
+
 /**
  * @brief Add a statement to transaction manager's history.
  * Until unlinking or releasing the space could internally contain
@@ -355,6 +395,67 @@ memtx_tx_track_gap(struct txn *txn, struct space *space, struct index *index,
 				       type, key, part_count);
 }
 
+struct range_item;
+
+/**
+ * Helper of memtx_tx_track_range.
+ */
+int
+memtx_tx_track_range_slow(struct txn *txn, struct index *index,
+			  enum iterator_type type, const char *key,
+			  uint32_t part_count, struct tuple *end,
+			  struct range_item **range);
+
+/**
+ * Record in TX manager that a transaction @a txn have started reading
+ * @a index of @a space with an iterator of type @a type positioned by
+ * @a key, and the interval read so far ends at @a end (NULL if there's
+ * nothing to read beyond the key). The iterator extends the interval
+ * with memtx_tx_extend_range() as it advances, so the whole scan is
+ * tracked with one item instead of one gap per tuple.
+ * The item is stored to @a range, which is reset to NULL when the item
+ * is deleted, e.g. on transaction end. The iterator must call
+ * memtx_tx_detach_range() on destruction.
+ * This function must be used only for ordered indexes, such as TREE,
+ * with keys comparable to tuples (i.e. not functional ones).
+ * @return 0 on success, -1 on memory error.
+ */
+static inline int
+memtx_tx_track_range(struct txn *txn, struct space *space,
+		     struct index *index, enum iterator_type type,
+		     const char *key, uint32_t part_count,
+		     struct tuple *end, struct range_item **range)
+{
+	if (!memtx_tx_manager_use_mvcc_engine)
+		return 0;
+	if (txn == NULL)
+		return 0;
+	/* Skip ephemeral spaces. */
+	if (space == NULL || space->def->id == 0)
+		return 0;
+	return memtx_tx_track_range_slow(txn, index, type, key, part_count,
+					 end, range);
+}
+
+/**
+ * Extend the interval read with an iterator up to @a end, NULL if the
+ * iterator is exhausted. Returns false if @a range is NULL or isn't
+ * tracked by @a txn: in this case the caller must track the gap it has
+ * just read with memtx_tx_track_gap().
+ */
+bool
+memtx_tx_extend_range(struct txn *txn, struct range_item *range,
+		      struct tuple *end);
+
+/**
+ * Detach a range item from the iterator that is being destroyed. The
+ * interval stays tracked until the transaction ends, merged with the
+ * intervals the transaction has read from the same index that overlap
+ * or touch it.
+ */
+void
+memtx_tx_detach_range(struct range_item *range);
+
 /**
  * Helper of memtx_tx_track_full_scan.
  */
@@ -453,10 +554,13 @@ memtx_tx_on_space_delete(struct space *space);
  * Create a snapshot cleaner.
  * @param cleaner - cleaner to create.
  * @param space - space for which the cleaner must be created.
+ * @param index - index of the space the cleaner is used to iterate
+ *  over: a tuple is cleaned to a version stored at the same position
+ *  of the index or NULL.
  */
 void
 memtx_tx_snapshot_cleaner_create(struct memtx_tx_snapshot_cleaner *cleaner,
-				 struct space *space);
+				 struct space *space, struct index *index);
 
 /** Helper of txm_snapshot_clafify. */
 struct tuple *
@@ -0,0 +1,175 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/read_view.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "box/box.h"
+#include "box/index.h"
+#include "box/schema.h"
+#include "box/space.h"
+#include "box/tuple_format.h"
+#include "diag.h"
+#include "exception.h"
+#include "fiber.h"
+#include "small/rlist.h"
+#include "trivia/util.h"
+
+RLIST_HEAD(read_view_list);
+
+/** Used for generating unique read view ids. */
+static uint64_t read_view_id_max;
+
+void
+read_view_opts_create(struct read_view_opts *opts)
+{
+	opts->name = "unknown";
+	opts->filter_space = NULL;
+	opts->filter_arg = NULL;
+}
+
+static void
+space_read_view_delete(struct space_read_view *space_rv)
+{
+	for (uint32_t i = 0; i <= space_rv->index_id_max; i++) {
+		struct index_read_view *index_rv = space_rv->index_map[i];
+		if (index_rv != NULL)
+			index_read_view_delete(index_rv);
+	}
+	tuple_format_unref(space_rv->format);
+	free(space_rv->name);
+	free(space_rv);
+}
+
+static struct space_read_view *
+space_read_view_new(struct space *space)
+{
+	size_t index_map_size = sizeof(struct index_read_view *) *
+				(space->index_id_max + 1);
+	size_t size = sizeof(struct space_read_view) + index_map_size;
+	struct space_read_view *space_rv = malloc(size);
+	if (space_rv == NULL) {
+		diag_set(OutOfMemory, size, "malloc", "struct space_read_view");
+		return NULL;
+	}
+	space_rv->name = strdup(space_name(space));
+	if (space_rv->name == NULL) {
+		diag_set(OutOfMemory, strlen(space_name(space)) + 1,
+			 "strdup", "space name");
+		free(space_rv);
+		return NULL;
+	}
+	space_rv->id = space_id(space);
+	space_rv->format = space->format;
+	tuple_format_ref(space_rv->format);
+	space_rv->index_id_max = space->index_id_max;
+	space_rv->index_map = (struct index_read_view **)(space_rv + 1);
+	memset(space_rv->index_map, 0, index_map_size);
+	for (uint32_t i = 0; i <= space->index_id_max; i++) {
+		struct index *index = space->index_map[i];
+		if (index == NULL)
+			continue;
+		struct index_read_view *index_rv;
+		index_rv = index_create_read_view(index);
+		if (index_rv != NULL) {
+			space_rv->index_map[i] = index_rv;
+			continue;
+		}
+		/*
+		 * Indexes that don't support read views (e.g. multikey)
+		 * are skipped, but the primary index is mandatory.
+		 */
+		struct error *e = diag_last_error(diag_get());
+		if (i == 0 || type_assignable(&type_OutOfMemory, e->type)) {
+			space_read_view_delete(space_rv);
+			return NULL;
+		}
+		diag_clear(diag_get());
+	}
+	return space_rv;
+}
+
+/** Argument of read_view_add_space_cb(). */
+struct read_view_add_space_arg {
+	struct read_view *rv;
+	const struct read_view_opts *opts;
+};
+
+static int
+read_view_add_space_cb(struct space *space, void *arg_raw)
+{
+	struct read_view_add_space_arg *arg = arg_raw;
+	struct read_view *rv = arg->rv;
+	const struct read_view_opts *opts = arg->opts;
+	/*
+	 * Tuples of temporary spaces are freed immediately even in
+	 * the delayed free mode so they can't be included.
+	 */
+	if (!space_is_memtx(space) || space_is_temporary(space) ||
+	    space_index(space, 0) == NULL)
+		return 0;
+	if (opts->filter_space != NULL &&
+	    !opts->filter_space(space, opts->filter_arg))
+		return 0;
+	struct space_read_view *space_rv = space_read_view_new(space);
+	if (space_rv == NULL)
+		return -1;
+	rlist_add_tail_entry(&rv->spaces, space_rv, link);
+	return 0;
+}
+
+int
+read_view_open(struct read_view *rv, const struct read_view_opts *opts)
+{
+	rv->name = strdup(opts->name);
+	if (rv->name == NULL) {
+		diag_set(OutOfMemory, strlen(opts->name) + 1,
+			 "strdup", "read view name");
+		return -1;
+	}
+	rv->id = ++read_view_id_max;
+	vclock_copy(&rv->vclock, box_vclock);
+	rv->timestamp = fiber_time();
+	rlist_create(&rv->spaces);
+	rlist_create(&rv->in_all);
+	struct read_view_add_space_arg arg = {
+		.rv = rv,
+		.opts = opts,
+	};
+	if (space_foreach(read_view_add_space_cb, &arg) != 0) {
+		read_view_close(rv);
+		return -1;
+	}
+	rlist_add_tail_entry(&read_view_list, rv, in_all);
+	return 0;
+}
+
+void
+read_view_close(struct read_view *rv)
+{
+	struct space_read_view *space_rv, *next;
+	rlist_foreach_entry_safe(space_rv, &rv->spaces, link, next)
+		space_read_view_delete(space_rv);
+	rlist_del_entry(rv, in_all);
+	free(rv->name);
+	TRASH(rv);
+}
+
+struct space_read_view *
+read_view_space_by_id(struct read_view *rv, uint32_t space_id)
+{
+	struct space_read_view *space_rv;
+	rlist_foreach_entry(space_rv, &rv->spaces, link) {
+		if (space_rv->id == space_id)
+			return space_rv;
+	}
+	return NULL;
+}
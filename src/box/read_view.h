@@ -0,0 +1,118 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "small/rlist.h"
+#include "vclock/vclock.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct space;
+struct tuple_format;
+struct index_read_view;
+
+/** Read view of a space. */
+struct space_read_view {
+	/** Link in read_view::spaces. */
+	struct rlist link;
+	/** Space id. */
+	uint32_t id;
+	/** Space name. */
+	char *name;
+	/** Tuple format of the space. Used for creating tuples. */
+	struct tuple_format *format;
+	/**
+	 * Read views of the space indexes, indexed by index id.
+	 * An entry is NULL if the index doesn't support read views.
+	 */
+	struct index_read_view **index_map;
+	/** Max index id, size of the index_map array minus one. */
+	uint32_t index_id_max;
+};
+
+/**
+ * Point-in-time view of the database: further modifications of
+ * the database don't affect the data visible through it.
+ *
+ * Only memtx spaces are included: a read view is built from
+ * frozen memtx indexes so it doesn't hold up garbage collection
+ * of MVCC stories, but the memory freed by tuples deleted after
+ * the read view was opened isn't reused until it's closed.
+ */
+struct read_view {
+	/** Unique read view id. */
+	uint64_t id;
+	/** Read view name, used for introspection. */
+	char *name;
+	/** Vclock of the database at the moment of opening. */
+	struct vclock vclock;
+	/** Wall clock time of opening. */
+	double timestamp;
+	/** List of space_read_view objects, linked by link. */
+	struct rlist spaces;
+	/** Link in the list of all open read views. */
+	struct rlist in_all;
+};
+
+/** Read view options. */
+struct read_view_opts {
+	/** Read view name. */
+	const char *name;
+	/**
+	 * If set, only spaces for which the function returns true
+	 * are included in the read view.
+	 */
+	bool (*filter_space)(struct space *space, void *arg);
+	/** Argument passed to filter_space. */
+	void *filter_arg;
+};
+
+/** Initialize read view options with default values. */
+void
+read_view_opts_create(struct read_view_opts *opts);
+
+/**
+ * Open a read view. Never yields.
+ * Returns -1 and sets diag on error.
+ */
+int
+read_view_open(struct read_view *rv, const struct read_view_opts *opts);
+
+/** Close a read view opened with read_view_open(). */
+void
+read_view_close(struct read_view *rv);
+
+/** Look up a space in a read view by id. Returns NULL if not found. */
+struct space_read_view *
+read_view_space_by_id(struct read_view *rv, uint32_t space_id);
+
+/**
+ * Look up an index in a space read view by id.
+ * Returns NULL if not found.
+ */
+static inline struct index_read_view *
+space_read_view_index(struct space_read_view *space_rv, uint32_t index_id)
+{
+	if (index_id <= space_rv->index_id_max)
+		return space_rv->index_map[index_id];
+	return NULL;
+}
+
+/** Iterate over all open read views. */
+#define read_view_foreach(rv) \
+	rlist_foreach_entry(rv, &read_view_list, in_all)
+
+/** List of all open read views, linked by read_view::in_all. */
+extern struct rlist read_view_list;
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -80,8 +80,8 @@
  * Throws an exception in  case of error.
  */
 struct recovery *
-recovery_new(const char *wal_dirname, bool force_recovery,
-	     const struct vclock *vclock)
+recovery_new(const char *wal_dirname, const char *wal_archive_dirname,
+	     bool force_recovery, const struct vclock *vclock)
 {
 	struct recovery *r = (struct recovery *)
 			calloc(1, sizeof(*r));
@@ -97,6 +97,7 @@ recovery_new(const char *wal_dirname, bool force_recovery,
 
 	xdir_create(&r->wal_dir, wal_dirname, XLOG, &INSTANCE_UUID,
 		    &xlog_opts_default);
+	xdir_set_archive(&r->wal_dir, wal_archive_dirname);
 	r->wal_dir.force_recovery = force_recovery;
 
 	vclock_copy(&r->vclock, vclock);
@@ -58,9 +58,14 @@ struct recovery {
 	struct rlist on_close_log;
 };
 
+/**
+ * Create a recovery object reading WAL files from @wal_dirname.
+ * Files missing there are looked up in @wal_archive_dirname
+ * unless it's NULL.
+ */
 struct recovery *
-recovery_new(const char *wal_dirname, bool force_recovery,
-	     const struct vclock *vclock);
+recovery_new(const char *wal_dirname, const char *wal_archive_dirname,
+	     bool force_recovery, const struct vclock *vclock);
 
 void
 recovery_delete(struct recovery *r);
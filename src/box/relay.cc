@@ -41,12 +41,14 @@
 
 #include "coio.h"
 #include "coio_task.h"
+#include "coio_file.h"
 #include "engine.h"
 #include "gc.h"
 #include "iostream.h"
 #include "iproto_constants.h"
 #include "recovery.h"
 #include "replication.h"
+#include "schema_def.h"
 #include "trigger.h"
 #include "vclock/vclock.h"
 #include "version.h"
@@ -58,6 +60,7 @@
 #include "raft.h"
 
 #include <stdlib.h>
+#include <msgpuck.h>
 
 /**
  * Cbus message to send status updates from relay to tx thread.
@@ -71,6 +74,8 @@ struct relay_status_msg {
 	struct vclock vclock;
 	/** Last replicated transaction timestamp. */
 	double txn_lag;
+	/** Leader timestamp echoed by the replica. */
+	double leader_tm;
 };
 
 /**
@@ -126,6 +131,11 @@ struct relay {
 	struct diag diag;
 	/** Vclock recieved from replica. */
 	struct vclock recv_vclock;
+	/**
+	 * Timestamp of the last row of this instance received by the replica
+	 * while this instance was the Raft leader, as reported in the ACK.
+	 */
+	double recv_leader_tm;
 	/** Replicatoin slave version. */
 	uint32_t version_id;
 	/**
@@ -135,6 +145,29 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * Sorted ids of spaces whose rows should be relayed, passed
+	 * by the replica on subscribe. Rows of other user spaces are
+	 * skipped. Empty means all spaces.
+	 */
+	uint32_t *space_filter;
+	/** Number of ids in the space filter. */
+	uint32_t space_filter_size;
+	/**
+	 * State of the transaction filtered by the space filter,
+	 * reset after its last row.
+	 */
+	struct {
+		/** Id of the instance that originated the transaction. */
+		uint32_t replica_id;
+		/** Original id of the transaction. */
+		int64_t tsn;
+		/**
+		 * Id of the transaction sent to the replica, which is
+		 * the LSN of its first sent row, 0 if none was sent.
+		 */
+		int64_t sent_tsn;
+	} filter_tx;
 	/**
 	 * Local vclock at the moment of subscribe, used to check
 	 * dataset on the other side and send missing data rows if any.
@@ -156,6 +189,13 @@ struct relay {
 	struct stailq pending_gc;
 	/** Time when last row was sent to peer. */
 	double last_row_time;
+	/**
+	 * Time when last heartbeat was sent to peer. Heartbeats
+	 * carry the monotonic time the replica echoes to renew the
+	 * Raft leader lease, so they are sent even if there are
+	 * rows to send.
+	 */
+	double last_heartbeat_time;
 	/**
 	 * A time difference between the moment when we
 	 * wrote a transaction to the local WAL and when
@@ -376,6 +416,9 @@ relay_stop(struct relay *relay)
 	 */
 	relay->txn_lag = 0;
 	relay->tx.txn_lag = 0;
+	free(relay->space_filter);
+	relay->space_filter = NULL;
+	relay->space_filter_size = 0;
 }
 
 void
@@ -477,6 +520,49 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 	engine_join_xc(&ctx, &relay->stream);
 }
 
+/** Size of a checkpoint file chunk sent on checkpoint join. */
+static const size_t RELAY_JOIN_FILE_CHUNK_SIZE = 256 * 1024;
+
+void
+relay_initial_join_checkpoint(struct iostream *io, uint64_t sync,
+			      const struct vclock *vclock,
+			      const char *filename)
+{
+	int fd = coio_file_open(filename, O_RDONLY, 0);
+	if (fd < 0)
+		tnt_raise(SystemError, "failed to open file '%s'", filename);
+	char *buf = (char *)xmalloc(RELAY_JOIN_FILE_CHUNK_SIZE);
+	auto guard = make_scoped_guard([=] {
+		free(buf);
+		coio_file_close(fd);
+	});
+
+	/* Respond to the JOIN request with the checkpoint vclock. */
+	struct xrow_header row;
+	xrow_encode_vclock_xc(&row, vclock);
+	row.sync = sync;
+	coio_write_xrow(io, &row);
+
+	say_info("sending checkpoint `%s'", filename);
+	/*
+	 * The file is read in the coio thread pool and sent in
+	 * chunks, so that the TX thread isn't blocked and errors
+	 * are reported with the usual framing.
+	 */
+	while (true) {
+		ssize_t size = coio_read(fd, buf, RELAY_JOIN_FILE_CHUNK_SIZE);
+		if (size < 0) {
+			tnt_raise(SystemError, "failed to read file '%s'",
+				  filename);
+		}
+		if (size == 0)
+			break;
+		xrow_encode_join_file_xc(&row, buf, size);
+		row.sync = sync;
+		coio_write_xrow(io, &row);
+	}
+}
+
 int
 relay_final_join_f(va_list ap)
 {
@@ -514,7 +600,8 @@ relay_final_join(struct iostream *io, uint64_t sync,
 	 * always be valid.
 	 */
 	vclock_copy(&relay->recv_vclock, start_vclock);
-	relay->r = recovery_new(wal_dir(), false, start_vclock);
+	relay->r = recovery_new(wal_dir(), wal_archive_dir(), false,
+				start_vclock);
 	vclock_copy(&relay->stop_vclock, stop_vclock);
 
 	int rc = cord_costart(&relay->cord, "final_join",
@@ -552,6 +639,11 @@ tx_status_update(struct cmsg *msg)
 	struct relay_status_msg *status = (struct relay_status_msg *)msg;
 	vclock_copy(&status->relay->tx.vclock, &status->vclock);
 	status->relay->tx.txn_lag = status->txn_lag;
+	/* Anonymous replicas don't participate in Raft. */
+	if (status->leader_tm != 0 && !status->relay->replica->anon) {
+		raft_process_lease_ack(box_raft(), status->relay->replica->id,
+				       status->leader_tm);
+	}
 
 	struct replication_ack ack;
 	ack.source = status->relay->replica->id;
@@ -695,7 +787,8 @@ relay_reader_f(va_list ap)
 			struct xrow_header xrow;
 			coio_read_xrow_timeout_xc(relay->io, &ibuf, &xrow,
 					replication_disconnect_timeout());
-			xrow_decode_vclock_xc(&xrow, &relay->recv_vclock);
+			xrow_decode_ack_xc(&xrow, &relay->recv_vclock,
+					   &relay->recv_leader_tm);
 			/*
 			 * Replica send us last replicated transaction
 			 * timestamp which is needed for relay lag
@@ -724,8 +817,10 @@ static void
 relay_send_heartbeat(struct relay *relay)
 {
 	struct xrow_header row;
-	xrow_encode_timestamp(&row, instance_id, ev_now(loop()));
+	relay->last_heartbeat_time = ev_monotonic_now(loop());
 	try {
+		xrow_encode_heartbeat_xc(&row, instance_id, ev_now(loop()),
+					 relay->last_heartbeat_time);
 		relay_send(relay, &row);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
@@ -882,7 +977,9 @@ relay_subscribe_f(va_list ap)
 			timeout = inj->dparam;
 
 		fiber_cond_wait_deadline(&relay->reader_cond,
-					 relay->last_row_time + timeout);
+					 MIN(relay->last_row_time,
+					     relay->last_heartbeat_time) +
+					 timeout);
 
 		/*
 		 * The fiber can be woken by IO cancel, by a timeout of
@@ -891,7 +988,9 @@ relay_subscribe_f(va_list ap)
 		 */
 		cbus_process(&relay->endpoint);
 		/* Check for a heartbeat timeout. */
-		if (ev_monotonic_now(loop()) - relay->last_row_time > timeout)
+		double now = ev_monotonic_now(loop());
+		if (now - relay->last_row_time > timeout ||
+		    now - relay->last_heartbeat_time > timeout)
 			relay_send_heartbeat(relay);
 		/*
 		 * Check that the vclock has been updated and the previous
@@ -909,7 +1008,8 @@ relay_subscribe_f(va_list ap)
 		relay_schedule_pending_gc(relay, send_vclock);
 
 		if (vclock_sum(&relay->status_msg.vclock) ==
-		    vclock_sum(send_vclock))
+		    vclock_sum(send_vclock) &&
+		    relay->status_msg.leader_tm == relay->recv_leader_tm)
 			continue;
 		static const struct cmsg_hop route[] = {
 			{tx_status_update, NULL}
@@ -917,6 +1017,7 @@ relay_subscribe_f(va_list ap)
 		cmsg_init(&relay->status_msg.msg, route);
 		vclock_copy(&relay->status_msg.vclock, send_vclock);
 		relay->status_msg.txn_lag = relay->txn_lag;
+		relay->status_msg.leader_tm = relay->recv_leader_tm;
 		relay->status_msg.relay = relay;
 		cpipe_push(&relay->tx_pipe, &relay->status_msg.msg);
 	}
@@ -955,11 +1056,94 @@ relay_subscribe_f(va_list ap)
 	return -1;
 }
 
+static int
+relay_space_id_cmp(const void *a, const void *b)
+{
+	uint32_t id_a = *(const uint32_t *)a;
+	uint32_t id_b = *(const uint32_t *)b;
+	return id_a < id_b ? -1 : id_a > id_b;
+}
+
+/** Set the space filter from a MsgPack array of space ids. */
+static void
+relay_set_space_filter(struct relay *relay, const char *data)
+{
+	assert(relay->space_filter == NULL);
+	uint32_t size = mp_decode_array(&data);
+	if (size == 0)
+		return;
+	relay->space_filter = (uint32_t *)xcalloc(size, sizeof(uint32_t));
+	for (uint32_t i = 0; i < size; i++)
+		relay->space_filter[i] = mp_decode_uint(&data);
+	qsort(relay->space_filter, size, sizeof(uint32_t),
+	      relay_space_id_cmp);
+	relay->space_filter_size = size;
+	memset(&relay->filter_tx, 0, sizeof(relay->filter_tx));
+}
+
+/** Check if a row modifies a space the replica isn't interested in. */
+static bool
+relay_space_is_filtered(struct relay *relay, struct xrow_header *packet)
+{
+	if (!iproto_type_is_dml(packet->type) || packet->type == IPROTO_NOP)
+		return false;
+	struct request request;
+	if (xrow_decode_dml(packet, &request,
+			    dml_request_key_map(packet->type)) != 0) {
+		/* Let the replica report the broken row. */
+		diag_clear(diag_get());
+		return false;
+	}
+	/* The schema is always replicated. */
+	if (request.space_id <= BOX_SYSTEM_ID_MAX)
+		return false;
+	return bsearch(&request.space_id, relay->space_filter,
+		       relay->space_filter_size, sizeof(uint32_t),
+		       relay_space_id_cmp) == NULL;
+}
+
+/**
+ * Apply the space filter to a row. Returns true if the row should
+ * be skipped. A transaction is never skipped entirely: if all its
+ * rows are filtered out, the last one is sent as a NOP so that the
+ * replica's vclock is still promoted. The first sent row of a
+ * transaction becomes its id.
+ */
+static bool
+relay_filter_row(struct relay *relay, struct xrow_header *packet)
+{
+	if (relay->space_filter_size == 0)
+		return false;
+	/*
+	 * Transaction ids are unique only among transactions of one
+	 * instance, so a row starts a new transaction if it comes from
+	 * another instance even if the ids match.
+	 */
+	if (packet->replica_id != relay->filter_tx.replica_id ||
+	    packet->tsn != relay->filter_tx.tsn) {
+		relay->filter_tx.replica_id = packet->replica_id;
+		relay->filter_tx.tsn = packet->tsn;
+		relay->filter_tx.sent_tsn = 0;
+	}
+	if (relay_space_is_filtered(relay, packet)) {
+		if (!packet->is_commit)
+			return true;
+		packet->type = IPROTO_NOP;
+		packet->bodycnt = 0;
+	}
+	if (relay->filter_tx.sent_tsn == 0)
+		relay->filter_tx.sent_tsn = packet->lsn;
+	packet->tsn = relay->filter_tx.sent_tsn;
+	if (packet->is_commit)
+		memset(&relay->filter_tx, 0, sizeof(relay->filter_tx));
+	return false;
+}
+
 /** Replication acceptor fiber handler. */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter)
+		uint32_t replica_id_filter, const char *space_filter)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -991,11 +1175,16 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	 * always be valid.
 	 */
 	vclock_copy(&relay->recv_vclock, replica_clock);
-	relay->r = recovery_new(wal_dir(), false, replica_clock);
+	relay->recv_leader_tm = 0;
+	relay->last_heartbeat_time = 0;
+	relay->r = recovery_new(wal_dir(), wal_archive_dir(), false,
+				replica_clock);
 	vclock_copy(&relay->tx.vclock, replica_clock);
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
+	if (space_filter != NULL)
+		relay_set_space_filter(relay, space_filter);
 
 	int rc = cord_costart(&relay->cord, "subscribe",
 			      relay_subscribe_f, relay);
@@ -1062,7 +1251,8 @@ relay_restart_recovery(struct relay *relay)
 	struct vclock restart_vclock;
 	vclock_copy(&restart_vclock, &relay->recv_vclock);
 	vclock_reset(&restart_vclock, 0, vclock_get(&relay->r->vclock, 0));
-	struct recovery *r = recovery_new(wal_dir(), false, &restart_vclock);
+	struct recovery *r = recovery_new(wal_dir(), wal_archive_dir(), false,
+					  &restart_vclock);
 	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
 	recovery_delete(relay->r);
 	relay->r = r;
@@ -1177,6 +1367,8 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 			say_warn("injected broken lsn: %lld",
 				 (long long) packet->lsn);
 		}
+		if (relay_filter_row(relay, packet))
+			return;
 		relay_send(relay, packet);
 	}
 }
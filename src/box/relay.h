@@ -123,6 +123,20 @@ void
 relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 		   uint32_t replica_version_id);
 
+/**
+ * Send the master's last checkpoint file to the replica as is
+ * instead of initial JOIN rows.
+ *
+ * @param io        client connection
+ * @param sync      sync from incoming JOIN request
+ * @param vclock    vclock of the checkpoint
+ * @param filename  checkpoint file
+ */
+void
+relay_initial_join_checkpoint(struct iostream *io, uint64_t sync,
+			      const struct vclock *vclock,
+			      const char *filename);
+
 /**
  * Send final JOIN rows to the replica.
  *
@@ -136,11 +150,13 @@ relay_final_join(struct iostream *io, uint64_t sync,
 /**
  * Subscribe a replica to updates.
  *
+ * @param space_filter MsgPack array of ids of spaces whose rows
+ *                     should be sent or NULL to send all rows.
  * @return none.
  */
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter);
+		uint32_t replica_id_filter, const char *space_filter);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -57,6 +57,10 @@ double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 bool replication_anon = false;
 int replication_threads = 1;
+enum replication_join_mode replication_join_mode =
+	REPLICATION_JOIN_MODE_READ_VIEW;
+uint32_t *replication_space_filter = NULL;
+uint32_t replication_space_filter_size = 0;
 
 struct replicaset replicaset;
 
@@ -123,6 +127,7 @@ replication_free(void)
 	trigger_destroy(&replicaset.on_ack);
 
 	applier_free();
+	free(replication_space_filter);
 }
 
 int
@@ -160,6 +160,27 @@ extern bool replication_anon;
 /** How many threads to use for decoding incoming replication stream. */
 extern int replication_threads;
 
+/** How a new replica asks a master to send its data on initial join. */
+enum replication_join_mode {
+	REPLICATION_JOIN_MODE_INVALID = -1,
+	/** The master sends rows from a read view of its current state. */
+	REPLICATION_JOIN_MODE_READ_VIEW = 0,
+	/** The master sends files of its last checkpoint. */
+	REPLICATION_JOIN_MODE_CHECKPOINT = 1,
+};
+
+/** Initial join mode used when this instance bootstraps. */
+extern enum replication_join_mode replication_join_mode;
+
+/**
+ * Ids of user spaces whose rows this instance asks masters
+ * to send on subscribe. Empty means all spaces.
+ */
+extern uint32_t *replication_space_filter;
+
+/** Number of ids in replication_space_filter. */
+extern uint32_t replication_space_filter_size;
+
 /**
  * Wait for the given period of time before trying to reconnect
  * to a master.
@@ -42,6 +42,7 @@
 #include "sequence.h"
 #include "key_def.h"
 #include "tuple.h"
+#include "tuple_compression.h"
 #include "xrow.h"
 #include "iproto_constants.h"
 
@@ -100,7 +101,22 @@ request_create_from_tuple(struct request *request, struct space *space,
 		request->type = IPROTO_DELETE;
 	} else {
 		uint32_t size;
-		const char *data = tuple_data_range(new_tuple, &size);
+		const char *data;
+		if (unlikely(new_tuple->has_compressed_fields)) {
+			/*
+			 * Compressed fields are never written to WAL.
+			 * The decompressed data is allocated on region
+			 * so it doesn't need to be copied.
+			 */
+			data = tuple_data_decompressed(new_tuple, &size);
+			if (data == NULL)
+				return -1;
+			request->tuple = data;
+			request->tuple_end = data + size;
+			request->type = IPROTO_REPLACE;
+			return request_update_header(request, row);
+		}
+		data = tuple_data_range(new_tuple, &size);
 		/*
 		 * We have to copy the tuple data to region, because
 		 * the tuple is allocated on runtime arena and not
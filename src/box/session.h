@@ -109,6 +109,8 @@ struct session {
 	uint8_t sql_default_engine;
 	/** SQL Connection flag for current user session */
 	uint32_t sql_flags;
+	/** True if reads in the session must be linearizable. */
+	bool is_linearizable_read;
 	enum session_type type;
 	/** Session virtual methods. */
 	const struct session_vtab *vtab;
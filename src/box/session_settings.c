@@ -42,6 +42,7 @@ struct session_setting session_settings[SESSION_SETTING_COUNT] = {};
 
 /** Corresponding names of session settings. */
 const char *session_setting_strs[SESSION_SETTING_COUNT] = {
+	"linearizable_read",
 	"sql_default_engine",
 	"sql_defer_foreign_keys",
 	"sql_full_column_names",
@@ -276,6 +277,7 @@ static const struct index_vtab session_settings_index_vtab = {
 	/* .create_iterator = */ session_settings_index_create_iterator,
 	/* .create_snapshot_iterator = */
 		generic_index_create_snapshot_iterator,
+	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -450,11 +452,48 @@ session_setting_find(const char *name) {
 		return -1;
 }
 
+static void
+linearizable_read_get(int id, const char **mp_pair, const char **mp_pair_end)
+{
+	assert(id == SESSION_SETTING_LINEARIZABLE_READ);
+	const char *name = session_setting_strs[id];
+	size_t name_len = strlen(name);
+	bool value = current_session()->is_linearizable_read;
+	size_t size = mp_sizeof_array(2) + mp_sizeof_str(name_len) +
+		      mp_sizeof_bool(value);
+	char *pos = static_alloc(size);
+	assert(pos != NULL);
+	char *pos_end = mp_encode_array(pos, 2);
+	pos_end = mp_encode_str(pos_end, name, name_len);
+	pos_end = mp_encode_bool(pos_end, value);
+	*mp_pair = pos;
+	*mp_pair_end = pos_end;
+}
+
+static int
+linearizable_read_set(int id, const char *mp_value)
+{
+	assert(id == SESSION_SETTING_LINEARIZABLE_READ);
+	if (mp_typeof(*mp_value) != MP_BOOL) {
+		diag_set(ClientError, ER_SESSION_SETTING_INVALID_VALUE,
+			 session_setting_strs[id],
+			 field_type_strs[FIELD_TYPE_BOOLEAN]);
+		return -1;
+	}
+	current_session()->is_linearizable_read = mp_decode_bool(&mp_value);
+	return 0;
+}
+
 extern void
 sql_session_settings_init();
 
 void
 session_settings_init(void)
 {
+	struct session_setting *setting =
+		&session_settings[SESSION_SETTING_LINEARIZABLE_READ];
+	setting->field_type = FIELD_TYPE_BOOLEAN;
+	setting->get = linearizable_read_get;
+	setting->set = linearizable_read_set;
 	sql_session_settings_init();
 }
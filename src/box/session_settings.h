@@ -42,7 +42,10 @@
  * space iterator will not be sorted properly.
  */
 enum {
-	SESSION_SETTING_SQL_BEGIN,
+	SESSION_SETTING_BOX_BEGIN,
+	SESSION_SETTING_LINEARIZABLE_READ = SESSION_SETTING_BOX_BEGIN,
+	SESSION_SETTING_BOX_END,
+	SESSION_SETTING_SQL_BEGIN = SESSION_SETTING_BOX_END,
 	SESSION_SETTING_SQL_DEFAULT_ENGINE = SESSION_SETTING_SQL_BEGIN,
 	SESSION_SETTING_SQL_DEFER_FOREIGN_KEYS,
 	SESSION_SETTING_SQL_FULL_COLUMN_NAMES,
@@ -40,6 +40,7 @@
 #include "txn.h"
 #include "memtx_tx.h"
 #include "tuple.h"
+#include "tuple_compression.h"
 #include "xrow_update.h"
 #include "request.h"
 #include "xrow.h"
@@ -413,7 +414,9 @@ after_old_tuple_lookup:;
 			/* Nothing to update. */
 			return 0;
 		}
-		old_data = tuple_data_range(old_tuple, &old_size);
+		old_data = tuple_data_decompressed(old_tuple, &old_size);
+		if (old_data == NULL)
+			return -1;
 		old_data_end = old_data + old_size;
 		new_data = xrow_update_execute(request->tuple,
 					       request->tuple_end, old_data,
@@ -446,7 +449,9 @@ after_old_tuple_lookup:;
 				return -1;
 			break;
 		}
-		old_data = tuple_data_range(old_tuple, &old_size);
+		old_data = tuple_data_decompressed(old_tuple, &old_size);
+		if (old_data == NULL)
+			return -1;
 		old_data_end = old_data + old_size;
 		new_data = xrow_upsert_execute(request->ops, request->ops_end,
 					       old_data, old_data_end,
@@ -73,6 +73,12 @@ struct space_opts {
 	 * until replicated to a quorum of replicas.
 	 */
 	bool is_sync;
+	/**
+	 * Tuples whose MessagePack is longer than this many bytes
+	 * have their large non-indexed fields compressed, see
+	 * tuple_compression.h. 0 disables compression.
+	 */
+	uint32_t compression_threshold;
 	/** SQL statement that produced this space. */
 	char *sql;
 };
@@ -47,6 +47,7 @@
 #include "space_def.h"
 #include "index_def.h"
 #include "tuple.h"
+#include "tuple_compression.h"
 #include "fiber.h"
 #include "small/region.h"
 #include "session.h"
@@ -146,8 +147,10 @@ const void *tarantoolsqlPayloadFetch(BtCursor *pCur, u32 *pAmt)
 	       pCur->curFlags & BTCF_TEphemCursor);
 	assert(pCur->last_tuple != NULL);
 
-	*pAmt = box_tuple_bsize(pCur->last_tuple);
-	return tuple_data(pCur->last_tuple);
+	uint32_t size;
+	const char *data = tuple_data_decompressed(pCur->last_tuple, &size);
+	*pAmt = size;
+	return data;
 }
 
 /*
@@ -1307,12 +1310,26 @@ vdbe_field_ref_prepare_data(struct vdbe_field_ref *field_ref, const char *data,
 	vdbe_field_ref_create(field_ref, NULL, data, data_sz);
 }
 
-void
+int
 vdbe_field_ref_prepare_tuple(struct vdbe_field_ref *field_ref,
 			     struct tuple *tuple)
 {
+	if (unlikely(tuple->has_compressed_fields)) {
+		/*
+		 * Offset slots of the tuple point to compressed
+		 * data, so fields are looked up in the decompressed
+		 * data as if there were no tuple.
+		 */
+		uint32_t size;
+		const char *data = tuple_data_decompressed(tuple, &size);
+		if (data == NULL)
+			return -1;
+		vdbe_field_ref_create(field_ref, NULL, data, size);
+		return 0;
+	}
 	vdbe_field_ref_create(field_ref, tuple, tuple_data(tuple),
 			      tuple_bsize(tuple));
+	return 0;
 }
 
 ssize_t
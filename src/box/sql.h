@@ -413,11 +413,13 @@ vdbe_field_ref_prepare_data(struct vdbe_field_ref *field_ref, const char *data,
 
 /**
  * Initialize a new vdbe_field_ref instance with given tuple
- * data.
+ * data. Compressed fields of the tuple are decompressed.
  * @param field_ref The vdbe_field_ref instance to initialize.
  * @param tuple The tuple object pointer.
+ * @retval 0 Success.
+ * @retval -1 Error, diag is set.
  */
-void
+int
 vdbe_field_ref_prepare_tuple(struct vdbe_field_ref *field_ref,
 			     struct tuple *tuple);
 
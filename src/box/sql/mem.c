@@ -37,6 +37,7 @@
 #include "tarantoolInt.h"
 #include "box/schema.h"
 #include "box/tuple.h"
+#include "box/tuple_compression.h"
 #include "mpstream/mpstream.h"
 #include "box/port.h"
 #include "lua/utils.h"
@@ -3213,7 +3214,10 @@ port_c_get_vdbemem(struct port *base, uint32_t *size)
 	struct port_c_entry *pe;
 	for (pe = port->first; pe != NULL; pe = pe->next) {
 		if (pe->mp_size == 0) {
-			data = tuple_data(pe->tuple);
+			uint32_t bsize;
+			data = tuple_data_decompressed(pe->tuple, &bsize);
+			if (data == NULL)
+				goto error;
 			if (mp_decode_array(&data) != 1) {
 				diag_set(ClientError, ER_SQL_EXECUTE,
 					 "Unsupported type passed from C");
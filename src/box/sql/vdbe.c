@@ -1932,8 +1932,9 @@ case OP_Column: {
 			assert(sqlCursorIsValid(pCrsr));
 			assert(pCrsr->curFlags & BTCF_TaCursor ||
 			       pCrsr->curFlags & BTCF_TEphemCursor);
-			vdbe_field_ref_prepare_tuple(&pC->field_ref,
-						     pCrsr->last_tuple);
+			if (vdbe_field_ref_prepare_tuple(&pC->field_ref,
+							 pCrsr->last_tuple) != 0)
+				goto abort_due_to_error;
 		}
 		pC->cacheStatus = p->cacheCtr;
 	}
@@ -3071,7 +3072,9 @@ case OP_RowData: {
 	assert(pCrsr->eState == CURSOR_VALID);
 	assert(pCrsr->curFlags & BTCF_TaCursor ||
 	       pCrsr->curFlags & BTCF_TEphemCursor);
-	tarantoolsqlPayloadFetch(pCrsr, &n);
+	const char *data = tarantoolsqlPayloadFetch(pCrsr, &n);
+	if (data == NULL)
+		goto abort_due_to_error;
 	if (n>(u32)db->aLimit[SQL_LIMIT_LENGTH]) {
 		goto too_big;
 	}
@@ -3082,7 +3085,7 @@ case OP_RowData: {
 		diag_set(OutOfMemory, n, "region_alloc", "buf");
 		goto abort_due_to_error;
 	}
-	sqlCursorPayload(pCrsr, 0, n, buf);
+	memcpy(buf, data, n);
 	mem_set_bin_ephemeral(pOut, buf, n);
 	assert(sqlVdbeCheckMemInvariants(pOut));
 	UPDATE_MAX_BLOBSIZE(pOut);
@@ -29,12 +29,15 @@
  * SUCH DAMAGE.
  */
 #include "tuple.h"
+#include "tuple_compression.h"
 
 #include "trivia/util.h"
 #include "memory.h"
 #include "fiber.h"
 #include "small/quota.h"
 #include "small/small.h"
+#include <sys/mman.h>
+#include <inttypes.h>
 #include "xrow_update.h"
 #include "coll_id_cache.h"
 
@@ -359,6 +362,64 @@ tuple_arena_destroy(struct slab_arena *arena)
 	slab_arena_destroy(arena);
 }
 
+bool
+tuple_arena_use_hugepages(struct slab_arena *arena, const char *arena_name)
+{
+#if defined(MADV_HUGEPAGE)
+	if (madvise(arena->arena, arena->prealloc, MADV_HUGEPAGE) == 0) {
+		say_info("using transparent huge pages for %s tuple arena",
+			 arena_name);
+		return true;
+	}
+	say_syserror("madvise");
+#else
+	errno = ENOTSUP;
+#endif
+	say_warn("failed to enable huge pages for %s tuple arena, "
+		 "falling back on regular pages", arena_name);
+	return false;
+}
+
+size_t
+tuple_arena_hugepages_size(struct slab_arena *arena)
+{
+#if defined(__linux__)
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if (f == NULL)
+		return 0;
+	uintptr_t begin = (uintptr_t)arena->arena;
+	uintptr_t end = begin + arena->prealloc;
+	/* Part of the current VMA that belongs to the arena. */
+	size_t overlap = 0;
+	size_t total = 0;
+	char line[256];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		uintptr_t vma_begin, vma_end;
+		size_t size_kb;
+		if (sscanf(line, "AnonHugePages: %zu kB", &size_kb) == 1) {
+			/*
+			 * The arena may be merged with an adjacent
+			 * mapping into one VMA. smaps doesn't tell
+			 * where huge pages are within a VMA, so count
+			 * at most the part overlapping the arena.
+			 */
+			total += MIN(size_kb * 1024, overlap);
+		} else if (sscanf(line, "%" SCNxPTR "-%" SCNxPTR,
+				  &vma_begin, &vma_end) == 2) {
+			vma_begin = MAX(vma_begin, begin);
+			vma_end = MIN(vma_end, end);
+			overlap = vma_begin < vma_end ?
+				  vma_end - vma_begin : 0;
+		}
+	}
+	fclose(f);
+	return total;
+#else
+	(void)arena;
+	return 0;
+#endif
+}
+
 void
 tuple_free(void)
 {
@@ -598,17 +659,26 @@ size_t
 box_tuple_bsize(box_tuple_t *tuple)
 {
 	assert(tuple != NULL);
-	return tuple_bsize(tuple);
+	uint32_t bsize;
+	/* Compressed fields are checked when the tuple is created. */
+	if (tuple_bsize_decompressed(tuple, &bsize) != 0)
+		return tuple_bsize(tuple);
+	return bsize;
 }
 
 ssize_t
 tuple_to_buf(struct tuple *tuple, char *buf, size_t size)
 {
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
 	uint32_t bsize;
-	const char *data = tuple_data_range(tuple, &bsize);
+	const char *data = tuple_data_decompressed(tuple, &bsize);
+	if (data == NULL)
+		return -1;
 	if (likely(bsize <= size)) {
 		memcpy(buf, data, bsize);
 	}
+	region_truncate(region, region_svp);
 	return bsize;
 }
 
@@ -630,7 +700,7 @@ const char *
 box_tuple_field(box_tuple_t *tuple, uint32_t fieldno)
 {
 	assert(tuple != NULL);
-	return tuple_field(tuple, fieldno);
+	return tuple_field_decompressed(tuple, tuple_field(tuple, fieldno));
 }
 
 typedef struct tuple_iterator box_tuple_iterator_t;
@@ -673,22 +743,24 @@ box_tuple_rewind(box_tuple_iterator_t *it)
 const char *
 box_tuple_seek(box_tuple_iterator_t *it, uint32_t fieldno)
 {
-	return tuple_seek(it, fieldno);
+	return tuple_field_decompressed(it->tuple, tuple_seek(it, fieldno));
 }
 
 const char *
 box_tuple_next(box_tuple_iterator_t *it)
 {
-	return tuple_next(it);
+	return tuple_field_decompressed(it->tuple, tuple_next(it));
 }
 
 box_tuple_t *
 box_tuple_update(box_tuple_t *tuple, const char *expr, const char *expr_end)
 {
 	uint32_t new_size = 0, bsize;
-	const char *old_data = tuple_data_range(tuple, &bsize);
 	struct region *region = &fiber()->gc;
 	size_t used = region_used(region);
+	const char *old_data = tuple_data_decompressed(tuple, &bsize);
+	if (old_data == NULL)
+		return NULL;
 	struct tuple_format *format = tuple_format(tuple);
 	const char *new_data =
 		xrow_update_execute(expr, expr_end, old_data, old_data + bsize,
@@ -708,9 +780,11 @@ box_tuple_t *
 box_tuple_upsert(box_tuple_t *tuple, const char *expr, const char *expr_end)
 {
 	uint32_t new_size = 0, bsize;
-	const char *old_data = tuple_data_range(tuple, &bsize);
 	struct region *region = &fiber()->gc;
 	size_t used = region_used(region);
+	const char *old_data = tuple_data_decompressed(tuple, &bsize);
+	if (old_data == NULL)
+		return NULL;
 	struct tuple_format *format = tuple_format(tuple);
 	const char *new_data =
 		xrow_upsert_execute(expr, expr_end, old_data, old_data + bsize,
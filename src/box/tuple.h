@@ -75,6 +75,29 @@ tuple_arena_create(struct slab_arena *arena, struct quota *quota,
 void
 tuple_arena_destroy(struct slab_arena *arena);
 
+/**
+ * Advise the kernel to back tuples arena with transparent huge
+ * pages. This reduces TLB misses on random accesses to tuples
+ * and index extents of a large arena. Only the memory preallocated
+ * on arena creation is covered: slabs the arena maps later when its
+ * quota is raised use regular pages. Failure isn't critical: the
+ * arena keeps using regular pages, a warning is logged.
+ * @param arena Arena created with tuple_arena_create().
+ * @param arena_name Name of @arena for logs.
+ * @retval true if the arena is going to use huge pages.
+ */
+bool
+tuple_arena_use_hugepages(struct slab_arena *arena, const char *arena_name);
+
+/**
+ * Return the amount of arena memory that is currently backed
+ * by huge pages, in bytes, or 0 if it can't be determined.
+ * Parses /proc/self/smaps, which takes a while on a large
+ * process, so don't call it in the tx thread, use coio_call().
+ */
+size_t
+tuple_arena_hugepages_size(struct slab_arena *arena);
+
 /** \cond public */
 
 typedef struct tuple_format box_tuple_format_t;
@@ -131,6 +154,8 @@ box_tuple_field_count(box_tuple_t *tuple);
 
 /**
  * Return the number of bytes used to store internal tuple data (MsgPack Array).
+ * Compressed fields are accounted decompressed, as box_tuple_to_buf()
+ * writes them.
  * \param tuple a tuple
  */
 size_t
@@ -139,7 +164,8 @@ box_tuple_bsize(box_tuple_t *tuple);
 /**
  * Dump raw MsgPack data to the memory byffer \a buf of size \a size.
  *
- * Store tuple fields in the memory buffer.
+ * Store tuple fields in the memory buffer. Compressed fields are
+ * decompressed.
  * \retval -1 on error.
  * \retval number of bytes written on success.
  * Upon successful return, the function returns the number of bytes written.
@@ -161,10 +187,13 @@ box_tuple_format(box_tuple_t *tuple);
  * Return the raw tuple field in MsgPack format.
  *
  * The buffer is valid until next call to box_tuple_* functions.
+ * A compressed field is decompressed to the fiber region, so it is
+ * valid until the end of the current request.
  *
  * \param tuple a tuple
  * \param fieldno zero-based index in MsgPack array.
- * \retval NULL if i >= box_tuple_field_count(tuple)
+ * \retval NULL if i >= box_tuple_field_count(tuple) or a compressed
+ *         field can't be decompressed (check box_error_last())
  * \retval msgpack otherwise
  */
 const char *
@@ -252,6 +281,7 @@ box_tuple_seek(box_tuple_iterator_t *it, uint32_t fieldno);
 /**
  * Return the next tuple field from tuple iterator.
  * The returned buffer is valid until next call to box_tuple_* API.
+ * Compressed fields are decompressed, see box_tuple_field().
  *
  * \param it tuple iterator.
  * \retval NULL if there are no more fields.
@@ -331,6 +361,11 @@ struct PACKED tuple
 	 * be clarified by transaction engine.
 	 */
 	bool is_dirty : 1;
+	/**
+	 * Some top-level fields of the tuple are stored compressed,
+	 * see tuple_compression.h.
+	 */
+	bool has_compressed_fields : 1;
 	/** Format identifier. */
 	uint16_t format_id;
 	/**
@@ -423,6 +458,7 @@ tuple_create(struct tuple *tuple, uint8_t refs, uint16_t format_id,
 	tuple->local_refs = refs;
 	tuple->has_uploaded_refs = false;
 	tuple->is_dirty = false;
+	tuple->has_compressed_fields = false;
 	tuple->format_id = format_id;
 	if (make_compact) {
 		assert(tuple_can_be_compact(data_offset, bsize));
@@ -474,6 +510,19 @@ tuple_is_unreferenced(struct tuple *tuple)
 	return tuple->local_refs == 0;
 }
 
+/**
+ * Check if the tuple is referenced exactly @a refs times, @a refs
+ * must be less than TUPLE_LOCAL_REF_MAX. Used by the memtx
+ * defragmentation to find out whether the tuple is only referenced
+ * by the space and hence can be moved to another memory location.
+ */
+static inline bool
+tuple_has_exact_refs(struct tuple *tuple, uint8_t refs)
+{
+	assert(refs < TUPLE_LOCAL_REF_MAX);
+	return !tuple->has_uploaded_refs && tuple->local_refs == refs;
+}
+
 /** Check that the tuple is in compact mode. */
 static inline bool
 tuple_is_compact(struct tuple *tuple)
@@ -751,7 +800,9 @@ tuple_field_go_to_key(const char **field, const char *key, int len);
  *                         not TUPLE_OFFSET_SLOT_NIL is used to
  *                         access data in a single operation.
  *                         Else it is initialized with offset_slot
- *                         of format field by path.
+ *                         of format field by path. A non-negative
+ *                         value is a static offset of the field,
+ *                         see tuple_field::static_offset.
  * @param multikey_idx The multikey index hint - index of
  *                     multikey item item to retrieve when array
  *                     index placeholder "[*]" is met.
@@ -766,9 +817,12 @@ tuple_field_raw_by_path(struct tuple_format *format, const char *tuple,
 	if (offset_slot_hint != NULL &&
 	    *offset_slot_hint != TUPLE_OFFSET_SLOT_NIL) {
 		offset_slot = *offset_slot_hint;
+		if (offset_slot >= 0)
+			goto static_offset_access;
 		goto offset_slot_access;
 	}
-	if (likely(fieldno < format->index_field_count)) {
+	if (likely(fieldno < format->index_field_count ||
+		   fieldno < format->static_field_count)) {
 		uint32_t offset;
 		struct tuple_field *field;
 		if (path == NULL && fieldno == 0) {
@@ -780,6 +834,15 @@ tuple_field_raw_by_path(struct tuple_format *format, const char *tuple,
 		assert(field != NULL || path != NULL);
 		if (path != NULL && field == NULL)
 			goto parse;
+		if (field->static_offset != TUPLE_OFFSET_SLOT_NIL) {
+			offset_slot = field->static_offset;
+			if (offset_slot_hint != NULL)
+				*offset_slot_hint = offset_slot;
+static_offset_access:
+			/* The field is at the same offset in all tuples. */
+			mp_decode_array(&tuple);
+			return tuple + offset_slot;
+		}
 		offset_slot = field->offset_slot;
 		if (offset_slot == TUPLE_OFFSET_SLOT_NIL)
 			goto parse;
@@ -843,7 +906,8 @@ static inline const char *
 tuple_field_raw(struct tuple_format *format, const char *tuple,
 		const uint32_t *field_map, uint32_t field_no)
 {
-	if (likely(field_no < format->index_field_count)) {
+	if (likely(field_no < format->index_field_count ||
+		   field_no < format->static_field_count)) {
 		int32_t offset_slot;
 		uint32_t offset = 0;
 		struct tuple_field *field;
@@ -853,6 +917,10 @@ tuple_field_raw(struct tuple_format *format, const char *tuple,
 		}
 		struct json_token *token = format->fields.root.children[field_no];
 		field = json_tree_entry(token, struct tuple_field, token);
+		if (field->static_offset != TUPLE_OFFSET_SLOT_NIL) {
+			mp_decode_array(&tuple);
+			return tuple + field->static_offset;
+		}
 		offset_slot = field->offset_slot;
 		if (offset_slot == TUPLE_OFFSET_SLOT_NIL)
 			goto parse;
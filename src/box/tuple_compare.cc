@@ -103,6 +103,7 @@ static enum mp_class mp_ext_classes[] = {
 	/* .MP_UUID		 = */ MP_CLASS_UUID,
 	/* .MP_ERROR		 = */ mp_class_max,
 	/* .MP_DATETIME		 = */ MP_CLASS_DATETIME,
+	/* .MP_COMPRESSION	 = */ mp_class_max,
 };
 
 static enum mp_class
@@ -1459,6 +1460,215 @@ func_index_compare_with_key(struct tuple *tuple, hint_t tuple_hint,
 
 /* }}} tuple_compare_with_key */
 
+/* {{{ typed comparators */
+
+/**
+ * The comparators above are specialized for both field numbers
+ * and field types, so only a few layouts can be pre-compiled.
+ * The comparators below are specialized only for field types and
+ * take field numbers from the key definition. This allows to
+ * pre-compile all combinations of the most common field types for
+ * keys with up to TYPED_COMPARATOR_MAX_PARTS parts, including the
+ * secondary index keys extended with primary key parts.
+ */
+enum { TYPED_COMPARATOR_MAX_PARTS = 3 };
+
+template <int TYPE>
+static inline int
+field_compare_typed(const char *field_a, const char *field_b);
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_UNSIGNED>(const char *field_a,
+					 const char *field_b)
+{
+	return mp_compare_uint(field_a, field_b);
+}
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_STRING>(const char *field_a,
+				       const char *field_b)
+{
+	return mp_compare_str(field_a, field_b);
+}
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_INTEGER>(const char *field_a,
+					const char *field_b)
+{
+	return mp_compare_integer_with_type(field_a, mp_typeof(*field_a),
+					    field_b, mp_typeof(*field_b));
+}
+
+template <>
+inline int
+field_compare_typed<FIELD_TYPE_UUID>(const char *field_a,
+				     const char *field_b)
+{
+	return mp_compare_uuid(field_a, field_b);
+}
+
+namespace /* local symbols */ {
+
+template <int ...TYPES>
+struct FieldCompareTyped {};
+
+template <>
+struct FieldCompareTyped<> {
+	static inline int
+	compare(struct key_part *, struct tuple *, struct tuple_format *,
+		struct tuple *, struct tuple_format *)
+	{
+		return 0;
+	}
+	static inline int
+	compare_with_key(struct key_part *, struct tuple *,
+			 struct tuple_format *, const char *, uint32_t)
+	{
+		return 0;
+	}
+};
+
+template <int TYPE, int ...MORE_TYPES>
+struct FieldCompareTyped<TYPE, MORE_TYPES...> {
+	static inline int
+	compare(struct key_part *part, struct tuple *tuple_a,
+		struct tuple_format *format_a, struct tuple *tuple_b,
+		struct tuple_format *format_b)
+	{
+		const char *field_a, *field_b;
+		field_a = tuple_field_raw(format_a, tuple_data(tuple_a),
+					  tuple_field_map(tuple_a),
+					  part->fieldno);
+		field_b = tuple_field_raw(format_b, tuple_data(tuple_b),
+					  tuple_field_map(tuple_b),
+					  part->fieldno);
+		int rc = field_compare_typed<TYPE>(field_a, field_b);
+		if (rc != 0)
+			return rc;
+		return FieldCompareTyped<MORE_TYPES...>::
+			compare(part + 1, tuple_a, format_a, tuple_b, format_b);
+	}
+	static inline int
+	compare_with_key(struct key_part *part, struct tuple *tuple,
+			 struct tuple_format *format, const char *key,
+			 uint32_t part_count)
+	{
+		const char *field = tuple_field_raw(format, tuple_data(tuple),
+						    tuple_field_map(tuple),
+						    part->fieldno);
+		int rc = field_compare_typed<TYPE>(field, key);
+		if (rc != 0 || part_count == 1)
+			return rc;
+		mp_next(&key);
+		return FieldCompareTyped<MORE_TYPES...>::
+			compare_with_key(part + 1, tuple, format, key,
+					 part_count - 1);
+	}
+};
+
+template <int ...TYPES>
+struct TupleCompareTyped {
+	static int
+	compare(struct tuple *tuple_a, hint_t tuple_a_hint,
+		struct tuple *tuple_b, hint_t tuple_b_hint,
+		struct key_def *key_def)
+	{
+		assert(key_def->part_count == sizeof...(TYPES));
+		int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
+		if (rc != 0)
+			return rc;
+		return FieldCompareTyped<TYPES...>::
+			compare(key_def->parts, tuple_a, tuple_format(tuple_a),
+				tuple_b, tuple_format(tuple_b));
+	}
+	static int
+	compare_with_key(struct tuple *tuple, hint_t tuple_hint,
+			 const char *key, uint32_t part_count,
+			 hint_t key_hint, struct key_def *key_def)
+	{
+		assert(key_def->part_count == sizeof...(TYPES));
+		assert(part_count <= key_def->part_count);
+		/* Part count can be 0 in wildcard searches. */
+		if (part_count == 0)
+			return 0;
+		int rc = hint_cmp(tuple_hint, key_hint);
+		if (rc != 0)
+			return rc;
+		return FieldCompareTyped<TYPES...>::
+			compare_with_key(key_def->parts, tuple,
+					 tuple_format(tuple), key, part_count);
+	}
+};
+
+/**
+ * Walks over key parts and picks the typed comparator matching
+ * their types. DEPTH is the number of parts matched so far.
+ */
+template <uint32_t DEPTH, int ...TYPES>
+struct TypedComparatorSelector {
+	static bool
+	select(struct key_def *def, tuple_compare_t *cmp,
+	       tuple_compare_with_key_t *cmp_wk)
+	{
+		if (def->part_count == DEPTH) {
+			*cmp = TupleCompareTyped<TYPES...>::compare;
+			*cmp_wk = TupleCompareTyped<TYPES...>::compare_with_key;
+			return true;
+		}
+		switch (def->parts[DEPTH].type) {
+		case FIELD_TYPE_UNSIGNED:
+			return TypedComparatorSelector<DEPTH + 1, TYPES...,
+				FIELD_TYPE_UNSIGNED>::select(def, cmp, cmp_wk);
+		case FIELD_TYPE_STRING:
+			return TypedComparatorSelector<DEPTH + 1, TYPES...,
+				FIELD_TYPE_STRING>::select(def, cmp, cmp_wk);
+		case FIELD_TYPE_INTEGER:
+			return TypedComparatorSelector<DEPTH + 1, TYPES...,
+				FIELD_TYPE_INTEGER>::select(def, cmp, cmp_wk);
+		case FIELD_TYPE_UUID:
+			return TypedComparatorSelector<DEPTH + 1, TYPES...,
+				FIELD_TYPE_UUID>::select(def, cmp, cmp_wk);
+		default:
+			return false;
+		}
+	}
+};
+
+template <int ...TYPES>
+struct TypedComparatorSelector<TYPED_COMPARATOR_MAX_PARTS, TYPES...> {
+	static bool
+	select(struct key_def *def, tuple_compare_t *cmp,
+	       tuple_compare_with_key_t *cmp_wk)
+	{
+		if (def->part_count != TYPED_COMPARATOR_MAX_PARTS)
+			return false;
+		*cmp = TupleCompareTyped<TYPES...>::compare;
+		*cmp_wk = TupleCompareTyped<TYPES...>::compare_with_key;
+		return true;
+	}
+};
+
+} /* end of anonymous namespace */
+
+/**
+ * Set typed comparators for a key definition if there are ones
+ * matching its part types. Returns false otherwise.
+ */
+static bool
+key_def_select_typed_compare_func(struct key_def *def,
+				  tuple_compare_t *cmp,
+				  tuple_compare_with_key_t *cmp_wk)
+{
+	if (def->part_count > TYPED_COMPARATOR_MAX_PARTS)
+		return false;
+	return TypedComparatorSelector<0>::select(def, cmp, cmp_wk);
+}
+
+/* }}} typed comparators */
+
 /* {{{ tuple_hint */
 
 /**
@@ -2041,6 +2251,204 @@ key_def_set_hint_func(struct key_def *def)
 	}
 }
 
+/**
+ * Compute the comparison hint of a field without dispatching on
+ * the field type at compile time. Used for wide hints only.
+ */
+static hint_t
+field_hint_generic(const char *field, struct key_part *part)
+{
+	if (field == NULL || mp_typeof(*field) == MP_NIL)
+		return hint_nil();
+	switch (part->type) {
+	case FIELD_TYPE_BOOLEAN:
+		return field_hint_boolean(field);
+	case FIELD_TYPE_UNSIGNED:
+		return field_hint_unsigned(field);
+	case FIELD_TYPE_INTEGER:
+		return field_hint_integer(field);
+	case FIELD_TYPE_NUMBER:
+		return field_hint_number(field);
+	case FIELD_TYPE_DOUBLE:
+		return field_hint_double(field);
+	case FIELD_TYPE_STRING:
+		return field_hint_string(field, part->coll);
+	case FIELD_TYPE_VARBINARY:
+		return field_hint_varbinary(field);
+	case FIELD_TYPE_SCALAR:
+		return field_hint_scalar(field, part->coll);
+	case FIELD_TYPE_DECIMAL:
+		return field_hint_decimal(field);
+	case FIELD_TYPE_UUID:
+		return field_hint_uuid(field);
+	case FIELD_TYPE_DATETIME:
+		return field_hint_datetime(field);
+	default:
+		return HINT_NONE;
+	}
+}
+
+/**
+ * Return true if no other value of the key part can have the same
+ * hint as the given field so that fields with equal hints are equal.
+ * Note, a number field hint isn't unique, because a floating point
+ * number has the same hint as its integral part.
+ */
+static bool
+field_hint_is_unique(const char *field, struct key_part *part)
+{
+	if (field == NULL)
+		return true;
+	switch (mp_typeof(*field)) {
+	case MP_NIL:
+	case MP_BOOL:
+		return true;
+	case MP_UINT:
+		if (part->type != FIELD_TYPE_UNSIGNED &&
+		    part->type != FIELD_TYPE_INTEGER)
+			return false;
+		return mp_decode_uint(&field) < (uint64_t)HINT_VALUE_INT_MAX;
+	case MP_INT:
+		if (part->type != FIELD_TYPE_INTEGER)
+			return false;
+		return mp_decode_int(&field) > HINT_VALUE_INT_MIN;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Wide hint of a string or varbinary field: the bytes following
+ * the ones stored in the field hint. Returns HINT_NONE for other
+ * fields and strings compared with a collation.
+ */
+static hint_t
+field_wide_hint_str(const char *field, struct key_part *part)
+{
+	if (field == NULL)
+		return HINT_NONE;
+	if (part->type != FIELD_TYPE_STRING &&
+	    part->type != FIELD_TYPE_VARBINARY &&
+	    part->type != FIELD_TYPE_SCALAR)
+		return HINT_NONE;
+	enum mp_class c;
+	uint32_t len;
+	switch (mp_typeof(*field)) {
+	case MP_STR:
+		if (part->coll != NULL)
+			return HINT_NONE;
+		c = MP_CLASS_STR;
+		len = mp_decode_strl(&field);
+		break;
+	case MP_BIN:
+		c = MP_CLASS_BIN;
+		len = mp_decode_binl(&field);
+		break;
+	default:
+		return HINT_NONE;
+	}
+	if (len <= HINT_VALUE_BYTES)
+		return hint_create(c, 0);
+	return hint_create(c, hint_str_raw(field + HINT_VALUE_BYTES,
+					   len - HINT_VALUE_BYTES));
+}
+
+hint_t
+tuple_wide_hint(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	struct key_part *part = key_def->parts;
+	const char *field = tuple_field_by_part(tuple, part, MULTIKEY_NONE);
+	hint_t hint = field_wide_hint_str(field, part);
+	if (hint != HINT_NONE)
+		return hint;
+	if (key_def->part_count < 2 || !field_hint_is_unique(field, part))
+		return HINT_NONE;
+	part++;
+	field = tuple_field_by_part(tuple, part, MULTIKEY_NONE);
+	return field_hint_generic(field, part);
+}
+
+hint_t
+key_wide_hint(const char *key, uint32_t part_count, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	if (part_count == 0)
+		return HINT_NONE;
+	struct key_part *part = key_def->parts;
+	hint_t hint = field_wide_hint_str(key, part);
+	if (hint != HINT_NONE)
+		return hint;
+	if (part_count < 2 || !field_hint_is_unique(key, part))
+		return HINT_NONE;
+	mp_next(&key);
+	return field_hint_generic(key, part + 1);
+}
+
+static_assert(2 * HINT_VALUE_BYTES < INLINE_KEY_HINT_LEN_INEXACT,
+	      "inline key length must fit in inline key hint");
+static_assert(HINT_VALUE_BYTES * CHAR_BIT + INLINE_KEY_HINT_LEN_BITS <=
+	      HINT_VALUE_BITS, "inline key must fit in inline key hint");
+
+/**
+ * Inline key hint of a field. The length stored in the low bits
+ * keeps the order of strings sharing the same bytes in the hint
+ * and the inline key hint: a shorter string is less.
+ */
+static hint_t
+field_inline_key_hint(const char *field, struct key_part *part)
+{
+	if (field_hint_is_unique(field, part))
+		return hint_create(MP_CLASS_NIL, 0);
+	if (part->type != FIELD_TYPE_STRING &&
+	    part->type != FIELD_TYPE_VARBINARY &&
+	    part->type != FIELD_TYPE_SCALAR)
+		return HINT_NONE;
+	enum mp_class c;
+	uint32_t len;
+	switch (mp_typeof(*field)) {
+	case MP_STR:
+		if (part->coll != NULL)
+			return HINT_NONE;
+		c = MP_CLASS_STR;
+		len = mp_decode_strl(&field);
+		break;
+	case MP_BIN:
+		c = MP_CLASS_BIN;
+		len = mp_decode_binl(&field);
+		break;
+	default:
+		return HINT_NONE;
+	}
+	uint64_t val = 0;
+	if (len > HINT_VALUE_BYTES) {
+		val = hint_str_raw(field + HINT_VALUE_BYTES,
+				   len - HINT_VALUE_BYTES);
+	}
+	val <<= INLINE_KEY_HINT_LEN_BITS;
+	val |= MIN(len, (uint32_t)INLINE_KEY_HINT_LEN_INEXACT);
+	return hint_create(c, val);
+}
+
+hint_t
+tuple_inline_key_hint(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	struct key_part *part = key_def->parts;
+	const char *field = tuple_field_by_part(tuple, part, MULTIKEY_NONE);
+	return field_inline_key_hint(field, part);
+}
+
+hint_t
+key_inline_key_hint(const char *key, uint32_t part_count,
+		    struct key_def *key_def)
+{
+	assert(!key_def->is_multikey && !key_def->for_func_index);
+	if (part_count == 0)
+		return HINT_NONE;
+	return field_inline_key_hint(key, key_def->parts);
+}
+
 /* }}} tuple_hint */
 
 static void
@@ -2082,6 +2490,21 @@ key_def_set_compare_func_fast(struct key_def *def)
 			break;
 		}
 	}
+	/*
+	 * Then try comparators specialized only for the part types,
+	 * they are still faster than the generic ones, because they
+	 * don't have to dispatch on the field type in runtime.
+	 */
+	tuple_compare_t typed_cmp;
+	tuple_compare_with_key_t typed_cmp_wk;
+	if ((cmp == NULL || cmp_wk == NULL) &&
+	    key_def_select_typed_compare_func(def, &typed_cmp,
+					      &typed_cmp_wk)) {
+		if (cmp == NULL)
+			cmp = typed_cmp;
+		if (cmp_wk == NULL)
+			cmp_wk = typed_cmp_wk;
+	}
 	if (cmp == NULL) {
 		cmp = is_sequential ?
 			tuple_compare_sequential<false, false> :
@@ -37,6 +37,7 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct key_def;
+struct tuple;
 
 /**
  * Hints are now used for two purposes - passing the index of the
@@ -76,6 +77,81 @@ typedef uint64_t hint_t;
 void
 key_def_set_compare_func(struct key_def *def);
 
+/**
+ * Wide comparison hint extends the tuple hint with the next 64
+ * bits of the sort order so that tuples having equal hints can
+ * still be ordered without comparing the tuples themselves:
+ *
+ *   if h(t1) == h(t2) and w(t1) < w(t2) then t1 < t2,
+ *
+ * provided that neither w(t1) nor w(t2) is HINT_NONE.
+ *
+ * For a string or varbinary first key part (without collation),
+ * the wide hint covers the next bytes of the field. If the hint
+ * of the first key part is unique (e.g. a small integer), the
+ * wide hint is the hint of the second key part. Otherwise it is
+ * HINT_NONE.
+ *
+ * Must not be used for multikey and functional indexes.
+ */
+hint_t
+tuple_wide_hint(struct tuple *tuple, struct key_def *key_def);
+
+/**
+ * Get a wide comparison hint of a key.
+ * @sa tuple_wide_hint().
+ */
+hint_t
+key_wide_hint(const char *key, uint32_t part_count, struct key_def *key_def);
+
+/**
+ * Inline key hint is a wide comparison hint (see tuple_wide_hint())
+ * that, in addition to ordering tuples having equal hints, tells
+ * whether they are equal by the first key part:
+ *
+ *   if h(t1) == h(t2) and i(t1) == i(t2) and i(t1) is exact,
+ *   then t1 and t2 have equal first key parts.
+ *
+ * For a string or varbinary first key part (without collation),
+ * it stores the next bytes of the field followed by the field
+ * length, so strings up to 2 * HINT_VALUE_BYTES long are fully
+ * stored in the hint and the inline key hint. For a first key part
+ * with a unique hint (e.g. a small integer), it is a constant exact
+ * value. Otherwise it is HINT_NONE.
+ *
+ * Must not be used for multikey and functional indexes.
+ */
+hint_t
+tuple_inline_key_hint(struct tuple *tuple, struct key_def *key_def);
+
+/**
+ * Get an inline key hint of a key.
+ * @sa tuple_inline_key_hint().
+ */
+hint_t
+key_inline_key_hint(const char *key, uint32_t part_count,
+		    struct key_def *key_def);
+
+enum {
+	/** Number of low bits of an inline key hint storing length. */
+	INLINE_KEY_HINT_LEN_BITS = 4,
+	/** Inline key hint length meaning that the key is longer. */
+	INLINE_KEY_HINT_LEN_INEXACT = (1 << INLINE_KEY_HINT_LEN_BITS) - 1,
+};
+
+/**
+ * Return true if two tuples or keys having equal hints and equal
+ * inline key hints have equal first key parts.
+ * @sa tuple_inline_key_hint().
+ */
+static inline bool
+inline_key_hint_is_exact(hint_t hint)
+{
+	return hint != HINT_NONE &&
+	       (hint & INLINE_KEY_HINT_LEN_INEXACT) !=
+	       INLINE_KEY_HINT_LEN_INEXACT;
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
@@ -0,0 +1,552 @@
+/*
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "tuple_compression.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <zstd.h>
+#include <msgpuck/msgpuck.h>
+#include <small/region.h>
+
+#include "assoc.h"
+#include "clock.h"
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "mp_extension_types.h"
+#include "tt_static.h"
+#include "tuple.h"
+#include "tuple_format.h"
+#include "xrow.h"
+
+/** Compression context, created on demand. */
+static ZSTD_CCtx *tuple_compression_cctx;
+/**
+ * Decompression context of the tx thread, created on demand.
+ * Other threads (snapshot, initial join) decompress without
+ * a context.
+ */
+static ZSTD_DCtx *tuple_compression_dctx;
+/** Space id -> struct tuple_compression_stat. */
+static struct mh_i32ptr_t *tuple_compression_stats;
+/** Maximal size of a decompressed field. */
+static size_t tuple_compression_max_size;
+
+int
+tuple_compression_init(void)
+{
+	tuple_compression_stats = mh_i32ptr_new();
+	return 0;
+}
+
+void
+tuple_compression_free(void)
+{
+	if (tuple_compression_stats == NULL)
+		return;
+	mh_int_t i;
+	mh_foreach(tuple_compression_stats, i)
+		free(mh_i32ptr_node(tuple_compression_stats, i)->val);
+	mh_i32ptr_delete(tuple_compression_stats);
+	tuple_compression_stats = NULL;
+	ZSTD_freeCCtx(tuple_compression_cctx);
+	ZSTD_freeDCtx(tuple_compression_dctx);
+	tuple_compression_cctx = NULL;
+	tuple_compression_dctx = NULL;
+}
+
+void
+tuple_compression_set_max_size(size_t size)
+{
+	if (size > tuple_compression_max_size)
+		tuple_compression_max_size = size;
+}
+
+const struct tuple_compression_stat *
+tuple_compression_stat(uint32_t space_id)
+{
+	mh_int_t i = mh_i32ptr_find(tuple_compression_stats, space_id, NULL);
+	if (i == mh_end(tuple_compression_stats))
+		return NULL;
+	return mh_i32ptr_node(tuple_compression_stats, i)->val;
+}
+
+/** Find or create compression statistics of a space. */
+static struct tuple_compression_stat *
+tuple_compression_stat_get(uint32_t space_id)
+{
+	struct tuple_compression_stat *stat =
+		(struct tuple_compression_stat *)
+		tuple_compression_stat(space_id);
+	if (stat != NULL)
+		return stat;
+	stat = calloc(1, sizeof(*stat));
+	if (stat == NULL) {
+		diag_set(OutOfMemory, sizeof(*stat), "calloc",
+			 "struct tuple_compression_stat");
+		return NULL;
+	}
+	const struct mh_i32ptr_node_t node = { space_id, stat };
+	mh_i32ptr_put(tuple_compression_stats, &node, NULL, NULL);
+	return stat;
+}
+
+/**
+ * Check if a top-level field may be compressed: only fields that
+ * aren't indexed and may store any MessagePack qualify.
+ */
+static inline bool
+tuple_field_is_compressible(struct tuple_format *format, uint32_t fieldno)
+{
+	if (fieldno >= tuple_format_field_count(format))
+		return true;
+	struct tuple_field *field = tuple_format_field(format, fieldno);
+	return field->type == FIELD_TYPE_ANY && !field->is_key_part &&
+	       json_token_is_leaf(&field->token);
+}
+
+/**
+ * Decode the header of a compressed field. On success, the id of
+ * the space the field was compressed for, the size of the field
+ * before compression and the bounds of the zstd frame are
+ * returned. Returns -1 and sets diag if the header is corrupted.
+ */
+static int
+tuple_field_decode_header(const char *field, uint32_t *space_id,
+			  uint32_t *raw_size, const char **frame,
+			  const char **frame_end)
+{
+	int8_t type;
+	uint32_t len = mp_decode_extl(&field, &type);
+	assert(type == MP_COMPRESSION);
+	const char *end = field + len;
+	if (field == end || mp_typeof(*field) != MP_UINT ||
+	    mp_check_uint(field, end) > 0)
+		goto invalid;
+	uint64_t id = mp_decode_uint(&field);
+	if (field == end || mp_typeof(*field) != MP_UINT ||
+	    mp_check_uint(field, end) > 0)
+		goto invalid;
+	uint64_t size = mp_decode_uint(&field);
+	if (id > UINT32_MAX || size == 0 ||
+	    size > tuple_compression_max_size)
+		goto invalid;
+	*space_id = id;
+	*raw_size = size;
+	*frame = field;
+	*frame_end = end;
+	return 0;
+invalid:
+	diag_set(ClientError, ER_INVALID_MSGPACK, "corrupted compressed field");
+	return -1;
+}
+
+/**
+ * Compress a field and write it to @a out as MP_COMPRESSION,
+ * provided it takes less space than the raw field. Returns the
+ * number of bytes written, 0 if compression doesn't pay off,
+ * -1 on error.
+ */
+static ssize_t
+tuple_field_compress(uint32_t space_id, const char *field, size_t size,
+		     char *out)
+{
+	if (tuple_compression_cctx == NULL) {
+		tuple_compression_cctx = ZSTD_createCCtx();
+		if (tuple_compression_cctx == NULL) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 "failed to create context");
+			return -1;
+		}
+	}
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t bound = ZSTD_compressBound(size);
+	char *buf = region_alloc(region, bound);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, bound, "region_alloc", "buf");
+		return -1;
+	}
+	size_t zsize = ZSTD_compressCCtx(tuple_compression_cctx, buf, bound,
+					 field, size,
+					 TUPLE_COMPRESSION_LEVEL);
+	if (ZSTD_isError(zsize)) {
+		region_truncate(region, region_svp);
+		diag_set(ClientError, ER_COMPRESSION,
+			 ZSTD_getErrorName(zsize));
+		return -1;
+	}
+	size_t len = mp_sizeof_uint(space_id) + mp_sizeof_uint(size) + zsize;
+	size_t total = mp_sizeof_ext(len);
+	if (total >= size) {
+		region_truncate(region, region_svp);
+		return 0;
+	}
+	char *pos = mp_encode_extl(out, MP_COMPRESSION, len);
+	pos = mp_encode_uint(pos, space_id);
+	pos = mp_encode_uint(pos, size);
+	memcpy(pos, buf, zsize);
+	assert(pos + zsize == out + total);
+	region_truncate(region, region_svp);
+	return total;
+}
+
+const char *
+tuple_compress(struct tuple_format *format, const char *data,
+	       const char *data_end, const char **new_end,
+	       bool *has_compressed_fields)
+{
+	*new_end = data_end;
+	*has_compressed_fields = false;
+	uint32_t threshold = format->compression_threshold;
+	bool need_compress = threshold != 0 &&
+			     (size_t)(data_end - data) > threshold;
+	/*
+	 * The first pass looks for fields compressed before, e.g.
+	 * by an update of a compressed tuple, and computes the size
+	 * of the result with the fields that can't stay compressed
+	 * in this format decompressed. Compressed fields are never
+	 * larger than raw ones, so it's enough for the result.
+	 */
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	size_t total = pos - data;
+	bool need_decompress = false;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!tuple_field_is_compressed(field)) {
+			total += pos - field;
+			continue;
+		}
+		if (threshold != 0 && tuple_field_is_compressible(format, i)) {
+			*has_compressed_fields = true;
+			total += pos - field;
+			continue;
+		}
+		uint32_t space_id, raw_size;
+		const char *frame, *frame_end;
+		if (tuple_field_decode_header(field, &space_id, &raw_size,
+					      &frame, &frame_end) != 0)
+			return NULL;
+		total += raw_size;
+		need_decompress = true;
+	}
+	assert(pos == data_end);
+	if (!need_compress && !need_decompress)
+		return data;
+	struct region *region = &fiber()->gc;
+	char *buf = region_alloc(region, total);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, total, "region_alloc", "buf");
+		return NULL;
+	}
+	struct tuple_compression_stat *stat = NULL;
+	bool is_changed = need_decompress;
+	pos = data;
+	mp_decode_array(&pos);
+	char *out = mp_encode_array(buf, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		size_t field_size = pos - field;
+		bool is_compressible = threshold != 0 &&
+				       tuple_field_is_compressible(format, i);
+		if (tuple_field_is_compressed(field)) {
+			if (!is_compressible) {
+				size_t region_svp = region_used(region);
+				uint32_t raw_size;
+				const char *raw = tuple_field_decompress(
+					field, &raw_size);
+				if (raw == NULL)
+					return NULL;
+				memcpy(out, raw, raw_size);
+				out += raw_size;
+				region_truncate(region, region_svp);
+				continue;
+			}
+		} else if (need_compress && is_compressible &&
+			   field_size >= TUPLE_COMPRESSION_MIN_FIELD_SIZE) {
+			ssize_t rc = tuple_field_compress(
+				format->compression_space_id, field,
+				field_size, out);
+			if (rc < 0)
+				return NULL;
+			if (rc > 0) {
+				if (stat == NULL) {
+					stat = tuple_compression_stat_get(
+						format->compression_space_id);
+					if (stat == NULL)
+						return NULL;
+				}
+				stat->fields++;
+				stat->raw_size += field_size;
+				stat->compressed_size += rc;
+				out += rc;
+				*has_compressed_fields = true;
+				is_changed = true;
+				continue;
+			}
+		}
+		memcpy(out, field, field_size);
+		out += field_size;
+	}
+	assert(out <= buf + total);
+	if (!is_changed)
+		return data;
+	if (stat != NULL)
+		stat->tuples++;
+	*new_end = out;
+	return buf;
+}
+
+const char *
+tuple_field_decompress(const char *field, uint32_t *size)
+{
+	uint32_t space_id, raw_size;
+	const char *frame, *frame_end;
+	if (tuple_field_decode_header(field, &space_id, &raw_size,
+				      &frame, &frame_end) != 0)
+		return NULL;
+	bool is_main = cord_is_main();
+	if (is_main && tuple_compression_dctx == NULL) {
+		tuple_compression_dctx = ZSTD_createDCtx();
+		if (tuple_compression_dctx == NULL) {
+			diag_set(ClientError, ER_DECOMPRESSION,
+				 "failed to create context");
+			return NULL;
+		}
+	}
+	char *buf = region_alloc(&fiber()->gc, raw_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, raw_size, "region_alloc", "buf");
+		return NULL;
+	}
+	double start = clock_monotonic();
+	size_t rc = is_main ?
+		ZSTD_decompressDCtx(tuple_compression_dctx, buf, raw_size,
+				    frame, frame_end - frame) :
+		ZSTD_decompress(buf, raw_size, frame, frame_end - frame);
+	if (ZSTD_isError(rc) || rc != raw_size)
+		goto invalid;
+	const char *check = buf;
+	if (mp_check(&check, buf + raw_size) != 0 || check != buf + raw_size)
+		goto invalid;
+	/* Statistics are only maintained by the tx thread. */
+	if (is_main) {
+		struct tuple_compression_stat *stat =
+			(struct tuple_compression_stat *)
+			tuple_compression_stat(space_id);
+		if (stat != NULL) {
+			stat->decode_count++;
+			stat->decode_time += clock_monotonic() - start;
+		}
+	}
+	*size = raw_size;
+	return buf;
+invalid:
+	diag_set(ClientError, ER_INVALID_MSGPACK, "corrupted compressed field");
+	return NULL;
+}
+
+/**
+ * Compute the size of MessagePack array [@a data, @a data_end)
+ * with all compressed top-level fields decompressed, using raw
+ * field sizes stored in compressed fields' headers. Returns -1
+ * and sets diag if a header is corrupted.
+ */
+static int
+tuple_decompressed_size(const char *data, const char *data_end,
+			uint32_t *size)
+{
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	size_t total = pos - data;
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!tuple_field_is_compressed(field)) {
+			total += pos - field;
+			continue;
+		}
+		uint32_t space_id, raw_size;
+		const char *frame, *frame_end;
+		if (tuple_field_decode_header(field, &space_id, &raw_size,
+					      &frame, &frame_end) != 0)
+			return -1;
+		total += raw_size;
+	}
+	assert(pos == data_end);
+	(void)data_end;
+	if (total > UINT32_MAX) {
+		diag_set(ClientError, ER_INVALID_MSGPACK,
+			 "corrupted compressed field");
+		return -1;
+	}
+	*size = total;
+	return 0;
+}
+
+const char *
+tuple_decompress(const char *data, const char *data_end, uint32_t *size)
+{
+	uint32_t total;
+	if (tuple_decompressed_size(data, data_end, &total) != 0)
+		return NULL;
+	struct region *region = &fiber()->gc;
+	char *buf = region_alloc(region, total);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, total, "region_alloc", "buf");
+		return NULL;
+	}
+	const char *pos = data;
+	uint32_t field_count = mp_decode_array(&pos);
+	char *out = mp_encode_array(buf, field_count);
+	for (uint32_t i = 0; i < field_count; i++) {
+		const char *field = pos;
+		mp_next(&pos);
+		if (!tuple_field_is_compressed(field)) {
+			memcpy(out, field, pos - field);
+			out += pos - field;
+			continue;
+		}
+		size_t region_svp = region_used(region);
+		uint32_t field_size;
+		const char *raw = tuple_field_decompress(field, &field_size);
+		if (raw == NULL)
+			return NULL;
+		memcpy(out, raw, field_size);
+		out += field_size;
+		region_truncate(region, region_svp);
+	}
+	assert(out == buf + total);
+	*size = total;
+	return buf;
+}
+
+const char *
+tuple_data_decompressed(struct tuple *tuple, uint32_t *size)
+{
+	const char *data = tuple_data_range(tuple, size);
+	if (likely(!tuple->has_compressed_fields))
+		return data;
+	return tuple_decompress(data, data + *size, size);
+}
+
+int
+tuple_bsize_decompressed(struct tuple *tuple, uint32_t *size)
+{
+	const char *data = tuple_data_range(tuple, size);
+	if (likely(!tuple->has_compressed_fields))
+		return 0;
+	return tuple_decompressed_size(data, data + *size, size);
+}
+
+const char *
+tuple_field_decompressed(struct tuple *tuple, const char *field)
+{
+	if (likely(!tuple->has_compressed_fields) || field == NULL ||
+	    !tuple_field_is_compressed(field))
+		return field;
+	uint32_t size;
+	return tuple_field_decompress(field, &size);
+}
+
+int
+tuple_validate_decompressed(struct tuple_format *format, struct tuple *tuple)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t size;
+	const char *data = tuple_data_decompressed(tuple, &size);
+	if (data == NULL)
+		return -1;
+	int rc = tuple_validate_raw(format, data);
+	region_truncate(region, region_svp);
+	if (rc != 0 || !tuple->has_compressed_fields)
+		return rc;
+	const char *pos = tuple_data(tuple);
+	uint32_t field_count = mp_decode_array(&pos);
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (tuple_field_is_compressed(pos) &&
+		    !tuple_field_is_compressible(format, i)) {
+			diag_set(ClientError, ER_COMPRESSION,
+				 tt_sprintf("field %u is stored compressed, "
+					    "replace the tuple with "
+					    "compression disabled first",
+					    i + TUPLE_INDEX_BASE));
+			return -1;
+		}
+		mp_next(&pos);
+	}
+	return 0;
+}
+
+/**
+ * Check that top-level fields of a MessagePack array sent by
+ * a client aren't compressed.
+ */
+static int
+tuple_compression_check_fields(const char *data)
+{
+	if (mp_typeof(*data) != MP_ARRAY)
+		return 0;
+	uint32_t field_count = mp_decode_array(&data);
+	for (uint32_t i = 0; i < field_count; i++) {
+		if (tuple_field_is_compressed(data)) {
+			diag_set(ClientError, ER_ILLEGAL_PARAMS,
+				 "compressed fields can't be sent by clients");
+			return -1;
+		}
+		mp_next(&data);
+	}
+	return 0;
+}
+
+int
+tuple_compression_check_request(const struct request *request)
+{
+	if (request->tuple != NULL &&
+	    tuple_compression_check_fields(request->tuple) != 0)
+		return -1;
+	if (request->ops == NULL || mp_typeof(*request->ops) != MP_ARRAY)
+		return 0;
+	/* Values of update operations may end up as tuple fields. */
+	const char *ops = request->ops;
+	uint32_t op_count = mp_decode_array(&ops);
+	for (uint32_t i = 0; i < op_count; i++) {
+		if (tuple_compression_check_fields(ops) != 0)
+			return -1;
+		mp_next(&ops);
+	}
+	return 0;
+}
@@ -0,0 +1,219 @@
+#ifndef TARANTOOL_BOX_TUPLE_COMPRESSION_H_INCLUDED
+#define TARANTOOL_BOX_TUPLE_COMPRESSION_H_INCLUDED
+/*
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * Transparent compression of large tuple fields.
+ *
+ * A space with non-zero compression_threshold stores top-level
+ * fields that are neither indexed nor typed (i.e. have type 'any')
+ * as MP_EXT of type MP_COMPRESSION, if the tuple is longer than
+ * the threshold and compression actually makes the field smaller.
+ * Indexed fields are never touched, so comparators, hints and
+ * key extraction work on the raw data as before.
+ *
+ * The extension payload is
+ *
+ *   MP_UINT space id | MP_UINT raw field size | zstd frame
+ *
+ * The space id is only used to account decompression in the
+ * space statistics, so it's fine if the space doesn't exist.
+ *
+ * Compressed fields never leave the engine: they are decompressed
+ * when decoded to Lua, when a tuple is sent to a client, written
+ * to a snapshot or to the WAL, or sent to a joining replica. The
+ * same goes for update and upsert operations, SQL and the public
+ * C API (box_tuple_field(), box_tuple_to_buf() and friends).
+ * Clients may not send MP_COMPRESSION fields.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <msgpuck/msgpuck.h>
+
+#include "mp_extension_types.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct tuple;
+struct tuple_format;
+struct request;
+
+enum {
+	/** Fields shorter than this are never compressed. */
+	TUPLE_COMPRESSION_MIN_FIELD_SIZE = 128,
+	/** zstd compression level used for tuple fields. */
+	TUPLE_COMPRESSION_LEVEL = 3,
+};
+
+/** Compression statistics of a space. */
+struct tuple_compression_stat {
+	/** Number of tuples created with compressed fields. */
+	uint64_t tuples;
+	/** Number of fields compressed. */
+	uint64_t fields;
+	/** Total size of compressed fields before compression. */
+	uint64_t raw_size;
+	/** Total size of compressed fields after compression. */
+	uint64_t compressed_size;
+	/** Number of fields decompressed. */
+	uint64_t decode_count;
+	/** Time spent decompressing fields, in seconds. */
+	double decode_time;
+};
+
+/** Initialize the tuple compression subsystem. */
+int
+tuple_compression_init(void);
+
+/** Free the tuple compression subsystem. */
+void
+tuple_compression_free(void);
+
+/**
+ * Set the maximal size of a decompressed field. Compressed fields
+ * claiming to be larger are considered corrupted. The limit only
+ * grows so that fields compressed before the tuple size limit was
+ * lowered can still be read.
+ */
+void
+tuple_compression_set_max_size(size_t size);
+
+/**
+ * Return compression statistics of the space with the given id
+ * or NULL if the space has never compressed a tuple.
+ */
+const struct tuple_compression_stat *
+tuple_compression_stat(uint32_t space_id);
+
+/**
+ * Prepare MessagePack data of a new tuple of the given format for
+ * storing: compress large fields if the format is configured to
+ * do so (see tuple_format::compression_threshold).
+ *
+ * Fields compressed before, e.g. by an update of a compressed
+ * tuple, are kept as is unless the format doesn't allow them to
+ * be compressed, in which case they are decompressed.
+ *
+ * Returns a pointer to the new data allocated on the fiber region,
+ * or @a data itself if nothing was changed. The end of the data
+ * is returned in @a new_end. @a has_compressed_fields is set if
+ * the result contains compressed fields, including those that were
+ * compressed before.
+ *
+ * Returns NULL and sets diag on error.
+ */
+const char *
+tuple_compress(struct tuple_format *format, const char *data,
+	       const char *data_end, const char **new_end,
+	       bool *has_compressed_fields);
+
+/** Check if a MessagePack field is a compressed field. */
+static inline bool
+tuple_field_is_compressed(const char *field)
+{
+	if (mp_typeof(*field) != MP_EXT)
+		return false;
+	int8_t type;
+	mp_decode_extl(&field, &type);
+	return type == MP_COMPRESSION;
+}
+
+/**
+ * Decompress a compressed field (see tuple_field_is_compressed()).
+ * The size of the decompressed field is stored in @a size and the
+ * field, allocated on the fiber region, is returned. Returns NULL
+ * and sets diag on error.
+ */
+const char *
+tuple_field_decompress(const char *field, uint32_t *size);
+
+/**
+ * Decompress all compressed top-level fields of MessagePack array
+ * [@a data, @a data_end). The result is allocated on the fiber
+ * region, its size is returned in @a size. Returns NULL and sets
+ * diag on error.
+ */
+const char *
+tuple_decompress(const char *data, const char *data_end, uint32_t *size);
+
+/**
+ * Return MessagePack data of a tuple with all fields decompressed.
+ * If the tuple has no compressed fields, its data is returned as
+ * is, otherwise the result is allocated on the fiber region.
+ * Returns NULL and sets diag on error.
+ */
+const char *
+tuple_data_decompressed(struct tuple *tuple, uint32_t *size);
+
+/**
+ * Return the size of MessagePack data of a tuple with all fields
+ * decompressed in @a size without decompressing them. Returns -1
+ * and sets diag if a compressed field is corrupted.
+ */
+int
+tuple_bsize_decompressed(struct tuple *tuple, uint32_t *size);
+
+/**
+ * Return a top-level @a field of a tuple decompressed. If the
+ * field isn't compressed, it's returned as is, otherwise the
+ * result is allocated on the fiber region. @a field may be NULL,
+ * in which case NULL is returned. Returns NULL and sets diag on
+ * error.
+ */
+const char *
+tuple_field_decompressed(struct tuple *tuple, const char *field);
+
+/**
+ * Check that a tuple with compressed fields matches a format, see
+ * tuple_validate(). The fields are checked decompressed. Since a
+ * stored tuple can't be rewritten, a field it stores compressed
+ * may not become indexed or typed in the new format.
+ */
+int
+tuple_validate_decompressed(struct tuple_format *format, struct tuple *tuple);
+
+/**
+ * Check that a DML request sent by a client doesn't contain
+ * compressed fields: they may only be created by the engine.
+ */
+int
+tuple_compression_check_request(const struct request *request);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_BOX_TUPLE_COMPRESSION_H_INCLUDED */
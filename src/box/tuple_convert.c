@@ -29,6 +29,7 @@
  * SUCH DAMAGE.
  */
 #include "tuple.h"
+#include "tuple_compression.h"
 #include <msgpuck/msgpuck.h>
 #include <yaml.h>
 #include <base64.h>
@@ -40,13 +41,19 @@
 int
 tuple_to_obuf(struct tuple *tuple, struct obuf *buf)
 {
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
 	uint32_t bsize;
-	const char *data = tuple_data_range(tuple, &bsize);
+	const char *data = tuple_data_decompressed(tuple, &bsize);
+	if (data == NULL)
+		return -1;
+	int rc = 0;
 	if (obuf_dup(buf, data, bsize) != bsize) {
 		diag_set(OutOfMemory, bsize, "tuple_to_obuf", "dup");
-		return -1;
+		rc = -1;
 	}
-	return 0;
+	region_truncate(region, region_svp);
+	return rc;
 }
 
 int
@@ -229,7 +236,11 @@ encode_node(yaml_emitter_t *emitter, const char **data)
 char *
 tuple_to_yaml(struct tuple *tuple)
 {
-	const char *data = tuple_data(tuple);
+	/* Freed by the caller along with the result. */
+	uint32_t bsize;
+	const char *data = tuple_data_decompressed(tuple, &bsize);
+	if (data == NULL)
+		return NULL;
 	yaml_emitter_t emitter;
 	yaml_event_t ev;
 
@@ -152,6 +152,7 @@ tuple_field_new(void)
 	field->token.type = JSON_TOKEN_END;
 	field->type = FIELD_TYPE_ANY;
 	field->offset_slot = TUPLE_OFFSET_SLOT_NIL;
+	field->static_offset = TUPLE_OFFSET_SLOT_NIL;
 	field->coll_id = COLL_NONE;
 	field->nullable_action = ON_CONFLICT_ACTION_NONE;
 	field->multikey_required_fields = NULL;
@@ -428,6 +429,83 @@ tuple_format_use_key_part(struct tuple_format *format, uint32_t field_count,
 	return 0;
 }
 
+/**
+ * Return the size of a MessagePack value of the given field type
+ * if it is the same for all values of the type, 0 otherwise.
+ *
+ * Note, uuid isn't a fixed-size type: field validation only checks
+ * the MP_EXT subtype so a uuid may be encoded as ext8 or ext16 too.
+ */
+static uint32_t
+field_type_fixed_mp_size(enum field_type type)
+{
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+		return mp_sizeof_bool(false);
+	case FIELD_TYPE_DOUBLE:
+		return mp_sizeof_double(0);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Assign static offsets to the leading top-level fields that are
+ * preceded only by mandatory indexed fields of fixed-size types,
+ * e.g. in a space with format {double, boolean, ...}. The
+ * preceding fields must be indexed, because vinyl replaces other
+ * fields with nils in surrogate statements. Offset slots of such
+ * fields are freed and the remaining slots are packed so that the
+ * field map gets smaller.
+ */
+static void
+tuple_format_set_static_offsets(struct tuple_format *format,
+				int *current_slot)
+{
+	uint32_t field_count = MIN(tuple_format_field_count(format),
+				   format->min_field_count);
+	uint32_t offset = 0;
+	uint32_t static_field_count = 0;
+	for (uint32_t i = 0; i < field_count; i++) {
+		struct tuple_field *field = tuple_format_field(format, i);
+		if (!json_token_is_leaf(&field->token))
+			break;
+		field->static_offset = offset;
+		static_field_count = i + 1;
+		uint32_t size = field_type_fixed_mp_size(field->type);
+		if (size == 0 || tuple_field_is_nullable(field) ||
+		    !field->is_key_part)
+			break;
+		offset += size;
+	}
+	format->static_field_count = static_field_count;
+	/* Pack offset slots left after static fields. */
+	int freed_slot_count = 0;
+	struct tuple_field *field;
+	json_tree_foreach_entry_preorder(field, &format->fields.root,
+					 struct tuple_field, token) {
+		if (field->offset_slot == TUPLE_OFFSET_SLOT_NIL ||
+		    field->static_offset != TUPLE_OFFSET_SLOT_NIL)
+			continue;
+		int shift = 0;
+		for (uint32_t i = 0; i < static_field_count; i++) {
+			struct tuple_field *f = tuple_format_field(format, i);
+			if (f->offset_slot != TUPLE_OFFSET_SLOT_NIL &&
+			    f->offset_slot > field->offset_slot)
+				shift++;
+		}
+		field->offset_slot += shift;
+	}
+	for (uint32_t i = 0; i < static_field_count; i++) {
+		struct tuple_field *f = tuple_format_field(format, i);
+		if (f->offset_slot != TUPLE_OFFSET_SLOT_NIL) {
+			f->offset_slot = TUPLE_OFFSET_SLOT_NIL;
+			freed_slot_count++;
+		}
+	}
+	*current_slot += freed_slot_count;
+}
+
 /**
  * Extract all available type info from keys and field
  * definitions.
@@ -491,6 +569,7 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 
 	assert(tuple_format_field(format, 0)->offset_slot == TUPLE_OFFSET_SLOT_NIL
 	       || json_token_is_multikey(&tuple_format_field(format, 0)->token));
+	tuple_format_set_static_offsets(format, &current_slot);
 	size_t field_map_size = -current_slot * sizeof(uint32_t);
 	if (field_map_size > INT16_MAX) {
 		/** tuple->data_offset is 15 bits */
@@ -682,6 +761,10 @@ tuple_format_alloc(struct key_def * const *keys, uint16_t key_count,
 	format->index_field_count = index_field_count;
 	format->exact_field_count = 0;
 	format->min_field_count = 0;
+	format->static_field_count = 0;
+	format->compression_threshold = 0;
+	format->compression_space_id = 0;
+	format->is_compressed = false;
 	format->epoch = 0;
 	return format;
 error:
@@ -110,6 +110,14 @@ struct tuple_field {
 	 * field map is negative.
 	 */
 	int32_t offset_slot;
+	/**
+	 * Offset of the field from the beginning of the first
+	 * tuple field if it is the same in all tuples conforming
+	 * to the format, i.e. all preceding fields are mandatory
+	 * and have fixed-size types. Such a field doesn't need an
+	 * offset slot. Otherwise TUPLE_OFFSET_SLOT_NIL is stored.
+	 */
+	int32_t static_offset;
 	/** True if this field is used by an index. */
 	bool is_key_part;
 	/** True if this field is used by multikey index. */
@@ -204,6 +212,27 @@ struct tuple_format {
 	 * index_field_count <= min_field_count <= field_count.
 	 */
 	uint32_t min_field_count;
+	/**
+	 * The number of leading top-level fields that have a
+	 * static offset, see tuple_field::static_offset.
+	 * static_field_count <= min_field_count.
+	 */
+	uint32_t static_field_count;
+	/**
+	 * Tuples longer than this have their large non-indexed
+	 * fields compressed, see tuple_compression.h. 0 means no
+	 * compression. Set by the engine for space formats.
+	 */
+	uint32_t compression_threshold;
+	/** Id of the space compressed tuples are accounted to. */
+	uint32_t compression_space_id;
+	/**
+	 * Tuples of this format may have compressed fields:
+	 * compression is enabled for the space or was enabled
+	 * before, so fields compressed then may need to be
+	 * decompressed.
+	 */
+	bool is_compressed;
 	/**
 	 * Total number of formatted fields, including JSON
 	 * path fields. See also tuple_format::fields.
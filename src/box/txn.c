@@ -236,9 +236,11 @@ txn_new(void)
 	rlist_create(&txn->point_holes_list);
 	rlist_create(&txn->gap_list);
 	rlist_create(&txn->full_scan_list);
+	rlist_create(&txn->range_list);
 	rlist_create(&txn->conflict_list);
 	rlist_create(&txn->conflicted_by_list);
 	rlist_create(&txn->in_read_view_txs);
+	rlist_create(&txn->in_read_set_release_txs);
 	rlist_create(&txn->in_all_txs);
 	return txn;
 }
@@ -275,6 +277,7 @@ txn_free(struct txn *txn)
 	assert(rlist_empty(&txn->conflicted_by_list));
 
 	rlist_del(&txn->in_read_view_txs);
+	rlist_del(&txn->in_read_set_release_txs);
 	rlist_del(&txn->in_all_txs);
 
 	struct txn_stmt *stmt;
@@ -389,6 +392,11 @@ txn_begin_stmt(struct txn *txn, struct space *space, uint16_t type)
 	if (txn_check_can_continue(txn) != 0)
 		return -1;
 
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY)) {
+		diag_set(ClientError, ER_TRANSACTION_READ_ONLY);
+		return -1;
+	}
+
 	struct txn_stmt *stmt = txn_stmt_new(&txn->region);
 	if (stmt == NULL)
 		return -1;
@@ -830,8 +838,135 @@ txn_limbo_on_rollback(struct trigger *trig, void *event)
 	return 0;
 }
 
+/**
+ * Complete batched transactions written to the journal with the
+ * given result. All of them get the signature of the whole batch.
+ */
+static void
+txn_batch_complete(struct stailq *entries, int64_t res)
+{
+	/* Roll back in the reverse order, like the journal does. */
+	if (res < 0)
+		stailq_reverse(entries);
+	struct journal_entry *entry, *next;
+	stailq_foreach_entry_safe(entry, next, entries, fifo) {
+		entry->res = res;
+		txn_on_journal_write(entry);
+	}
+}
+
+/** Callback invoked when a batch journal write is finished. */
+static void
+txn_batch_on_journal_write(struct journal_entry *entry)
+{
+	/*
+	 * The entry and the list are allocated on the region of a batched
+	 * transaction, which is freed on its completion.
+	 */
+	struct stailq entries = *(struct stailq *)entry->complete_data;
+	txn_batch_complete(&entries, entry->res);
+}
+
+static int
+txn_batch_on_yield(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct txn_batch *batch = (struct txn_batch *)trigger->data;
+	if (txn_batch_flush(batch) != 0)
+		diag_log();
+	return 0;
+}
+
+void
+txn_batch_create(struct txn_batch *batch)
+{
+	stailq_create(&batch->entries);
+	batch->txn_count = 0;
+	batch->n_rows = 0;
+	batch->approx_len = 0;
+	trigger_create(&batch->on_yield, txn_batch_on_yield, batch, NULL);
+	batch->write_count = 0;
+	batch->write_txn_count = 0;
+}
+
+/** Add a prepared transaction journal entry to the batch. */
+static void
+txn_batch_add(struct txn_batch *batch, struct journal_entry *req)
+{
+	if (batch->txn_count == 0)
+		trigger_add(&fiber()->on_yield, &batch->on_yield);
+	stailq_add_tail_entry(&batch->entries, req, fifo);
+	batch->txn_count++;
+	batch->n_rows += req->n_rows;
+	batch->approx_len += req->approx_len;
+}
+
 int
-txn_commit_try_async(struct txn *txn)
+txn_batch_flush(struct txn_batch *batch)
+{
+	if (batch->txn_count == 0)
+		return 0;
+	trigger_clear(&batch->on_yield);
+	struct stailq entries;
+	stailq_create(&entries);
+	stailq_concat(&entries, &batch->entries);
+	int txn_count = batch->txn_count;
+	int n_rows = batch->n_rows;
+	size_t approx_len = batch->approx_len;
+	batch->txn_count = 0;
+	batch->n_rows = 0;
+	batch->approx_len = 0;
+
+	struct journal_entry *req = stailq_first_entry(&entries,
+						       struct journal_entry,
+						       fifo);
+	if (txn_count > 1) {
+		struct region *region =
+			&((struct txn *)req->complete_data)->region;
+		size_t size;
+		struct stailq *list = region_alloc_object(region, typeof(*list),
+							  &size);
+		if (list == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc_object",
+				 "list");
+			goto fail;
+		}
+		req = journal_entry_new(n_rows, region,
+					txn_batch_on_journal_write, list);
+		if (req == NULL)
+			goto fail;
+		req->approx_len = approx_len;
+		struct xrow_header **row = req->rows;
+		struct journal_entry *entry;
+		stailq_foreach_entry(entry, &entries, fifo) {
+			memcpy(row, entry->rows,
+			       entry->n_rows * sizeof(entry->rows[0]));
+			row += entry->n_rows;
+		}
+		assert(row == req->rows + n_rows);
+		*list = entries;
+	}
+	batch->write_count++;
+	batch->write_txn_count += txn_count;
+	journal_queue_on_append(req);
+	if (current_journal->write_async(current_journal, req) != 0)
+		goto fail;
+	return 0;
+fail:
+	diag_log();
+	struct txn *txn = in_txn();
+	fiber_set_txn(fiber(), NULL);
+	txn_batch_complete(&entries, TXN_SIGNATURE_ABORT);
+	fiber_set_txn(fiber(), txn);
+	return -1;
+}
+
+/**
+ * Submit a transaction to the journal or add it to the batch if the
+ * batch isn't NULL and the transaction may be batched.
+ */
+static int
+txn_commit_try_async_impl(struct txn *txn, struct txn_batch *batch)
 {
 	struct journal_entry *req;
 
@@ -852,6 +987,24 @@ txn_commit_try_async(struct txn *txn)
 		goto rollback;
 
 	bool is_sync = txn_has_flag(txn, TXN_WAIT_SYNC);
+	if (batch != NULL) {
+		/*
+		 * Local rows get their LSNs and the commit flag on the last
+		 * row of a journal entry, so transactions having them can't
+		 * share one. Neither can the ones waiting for the limbo.
+		 * Don't grow the batch if there are journal queue waiters,
+		 * they have to be written first.
+		 */
+		if (!is_sync && txn->n_new_rows == 0 && req->flags == 0 &&
+		    !journal_queue_is_full() && !journal_queue_has_waiters()) {
+			fiber_set_txn(fiber(), NULL);
+			txn_batch_add(batch, req);
+			return 0;
+		}
+		if (txn_batch_flush(batch) != 0)
+			goto rollback;
+	}
+
 	struct txn_limbo_entry *limbo_entry;
 	if (is_sync) {
 		/*
@@ -910,6 +1063,18 @@ rollback:
 	return -1;
 }
 
+int
+txn_commit_try_async(struct txn *txn)
+{
+	return txn_commit_try_async_impl(txn, NULL);
+}
+
+int
+txn_commit_try_async_batch(struct txn *txn, struct txn_batch *batch)
+{
+	return txn_commit_try_async_impl(txn, batch);
+}
+
 int
 txn_commit(struct txn *txn)
 {
@@ -1161,6 +1326,35 @@ box_txn_set_timeout(double timeout)
 	return 0;
 }
 
+int
+box_txn_make_read_only(void)
+{
+	struct txn *txn = in_txn();
+	if (txn == NULL) {
+		diag_set(ClientError, ER_NO_TRANSACTION);
+		return -1;
+	}
+	if (txn_has_flag(txn, TXN_IS_READ_ONLY))
+		return 0;
+	/*
+	 * Reads done before switching to the read-only mode could
+	 * be inconsistent with the snapshot the transaction sees.
+	 */
+	if (!stailq_empty(&txn->stmts) || txn->status != TXN_INPROGRESS ||
+	    !rlist_empty(&txn->read_set) ||
+	    !rlist_empty(&txn->point_holes_list) ||
+	    !rlist_empty(&txn->gap_list) ||
+	    !rlist_empty(&txn->full_scan_list) ||
+	    !rlist_empty(&txn->range_list)) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS, "read-only mode must "
+			 "be set before the first statement of a transaction");
+		return -1;
+	}
+	txn_set_flags(txn, TXN_IS_READ_ONLY);
+	memtx_tx_send_to_read_view(txn);
+	return 0;
+}
+
 struct txn_savepoint *
 txn_savepoint_new(struct txn *txn, const char *name)
 {
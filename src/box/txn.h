@@ -101,6 +101,12 @@ enum txn_flag {
 	 * rolled back at commit.
 	 */
 	TXN_IS_ABORTED_BY_TIMEOUT = 0x100,
+	/**
+	 * Transaction was started in the read-only mode: it can't
+	 * modify data and, with the MVCC engine, it reads a fixed
+	 * snapshot of the database without tracking reads.
+	 */
+	TXN_IS_READ_ONLY = 0x200,
 };
 
 enum {
@@ -426,6 +432,12 @@ struct txn {
 	 * Link in tx_manager::read_view_txs.
 	 */
 	struct rlist in_read_view_txs;
+	/**
+	 * Link in tx_manager::read_set_release_txs, not empty if the
+	 * transaction was sent to a read view by a conflict and its
+	 * read trackers are yet to be released.
+	 */
+	struct rlist in_read_set_release_txs;
 	/** List of tx_read_trackers with stories that the TX have read. */
 	struct rlist read_set;
 	/** List of point hole reads. @sa struct point_hole_item. */
@@ -434,6 +446,8 @@ struct txn {
 	struct rlist gap_list;
 	/** List of full scans. @sa struct full_scan_item. */
 	struct rlist full_scan_list;
+	/** List of range reads. @sa struct range_item. */
+	struct rlist range_list;
 	/** Link in tx_manager::all_txs. */
 	struct rlist in_all_txs;
 	/** True in case transaction provides any DDL change. */
@@ -569,6 +583,56 @@ txn_abort(struct txn *txn);
 int
 txn_commit_try_async(struct txn *txn);
 
+/**
+ * A batch of asynchronous transactions submitted to the journal as
+ * a single entry. Used by the applier to coalesce small replicated
+ * transactions, which would otherwise cost a journal entry each.
+ *
+ * Only transactions consisting of remote rows solely and not waiting
+ * for the limbo are batched: such rows keep the transaction id and
+ * the commit flag assigned by their origin, so the transactions are
+ * still recoverable and relayed one by one. The batch is flushed
+ * before the owner fiber yields so that it can't be reordered with
+ * journal writes of other fibers.
+ */
+struct txn_batch {
+	/** Journal entries of the batched transactions. */
+	struct stailq entries;
+	/** Number of the batched transactions. */
+	int txn_count;
+	/** Total number of rows of the batched transactions. */
+	int n_rows;
+	/** Total approximate size of the batched rows. */
+	size_t approx_len;
+	/** Trigger flushing the batch on yield of the owner fiber. */
+	struct trigger on_yield;
+	/** Number of journal writes the batches were flushed with. */
+	int64_t write_count;
+	/** Number of transactions written as a part of a batch. */
+	int64_t write_txn_count;
+};
+
+/** Initialize an empty transaction batch. */
+void
+txn_batch_create(struct txn_batch *batch);
+
+/**
+ * Same as txn_commit_try_async(), but if the transaction can be
+ * batched, add it to the batch instead of submitting to the journal
+ * right away. A transaction which can't be batched is submitted after
+ * the batch is flushed. The batch may not be shared among fibers.
+ */
+int
+txn_commit_try_async_batch(struct txn *txn, struct txn_batch *batch);
+
+/**
+ * Submit all the batched transactions to the journal as one entry.
+ * On failure -1 is returned and the transactions are rolled back.
+ * Never yields.
+ */
+int
+txn_batch_flush(struct txn_batch *batch);
+
 /**
  * Most txns don't have triggers, and txn objects
  * are created on every access to data, so txns
@@ -855,6 +919,19 @@ box_txn_alloc(size_t size);
 API_EXPORT int
 box_txn_set_timeout(double timeout);
 
+/**
+ * Make the current transaction read-only. A read-only transaction
+ * can't modify data. If the MVCC engine is enabled, it sees a
+ * consistent snapshot of the database taken at the moment it was
+ * made read-only, never conflicts and doesn't track its reads.
+ *
+ * @retval 0 if success
+ * @retval -1 if there is no current transaction or it has
+ *            already executed some statements.
+ */
+API_EXPORT int
+box_txn_make_read_only(void);
+
 /** \endcond public */
 
 typedef struct txn_savepoint box_txn_savepoint_t;
@@ -297,7 +297,7 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "level0", lsregion_used(&env->mem_env.allocator));
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
-	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
+	info_append_int(h, "bloom_filter", env->run_env.bloom_memory_used);
 	info_table_end(h); /* memory */
 }
 
@@ -409,7 +409,12 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_table_begin(h, "bloom");
 	info_append_int(h, "hit", stat->disk.iterator.bloom_hit);
 	info_append_int(h, "miss", stat->disk.iterator.bloom_miss);
+	info_append_int(h, "load", stat->disk.iterator.bloom_load);
 	info_table_end(h); /* bloom */
+	info_table_begin(h, "read_ahead");
+	info_append_int(h, "pages", stat->disk.iterator.read_ahead_pages);
+	info_append_int(h, "hit", stat->disk.iterator.read_ahead_hit);
+	info_table_end(h); /* read_ahead */
 	info_table_end(h); /* iterator */
 	info_table_begin(h, "dump");
 	info_append_int(h, "count", stat->disk.dump.count);
@@ -507,7 +512,7 @@ vinyl_engine_memory_stat(struct engine *engine, struct engine_memory_stat *stat)
 	stat->data += lsregion_used(&env->mem_env.allocator) -
 				env->mem_env.tree_extent_size;
 	stat->index += env->mem_env.tree_extent_size;
-	stat->index += env->lsm_env.bloom_size;
+	stat->index += env->run_env.bloom_memory_used;
 	stat->index += env->lsm_env.page_index_size;
 	stat->cache += env->cache_env.mem_used;
 	stat->tx += vy_tx_manager_mem_used(env->xm);
@@ -575,6 +580,21 @@ vy_lsm_find_unique(struct space *space, uint32_t index_id)
 	return lsm;
 }
 
+/**
+ * Return true if the space has a covering secondary index.
+ * Reads from such an index don't check the primary index so
+ * DELETEs must not be deferred in this space.
+ */
+static bool
+vy_space_has_covering_index(struct space *space)
+{
+	for (uint32_t i = 1; i < space->index_count; i++) {
+		if (vy_lsm(space->index[i])->opts.covering)
+			return true;
+	}
+	return false;
+}
+
 static int
 vinyl_engine_check_space_def(struct space_def *def)
 {
@@ -583,6 +603,11 @@ vinyl_engine_check_space_def(struct space_def *def)
 			 def->name, "engine does not support temporary flag");
 		return -1;
 	}
+	if (def->opts.compression_threshold != 0) {
+		diag_set(ClientError, ER_ALTER_SPACE, def->name,
+			 "engine does not support tuple compression");
+		return -1;
+	}
 	return 0;
 }
 
@@ -677,6 +702,26 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "functional index");
 		return -1;
 	}
+	if (index_def->opts.compression_level < 0 ||
+	    index_def->opts.compression_level > XLOG_COMPRESSION_LEVEL_MAX) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 tt_sprintf("compression_level must be between 0 "
+				    "and %d", XLOG_COMPRESSION_LEVEL_MAX));
+		return -1;
+	}
+	if (index_def->opts.covering && index_def->iid == 0) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "primary index can't be covering");
+		return -1;
+	}
+	if (index_def->opts.covering && key_def->is_multikey) {
+		diag_set(ClientError, ER_MODIFY_INDEX,
+			 index_def->name, space_name(space),
+			 "multikey index can't be covering");
+		return -1;
+	}
 	return 0;
 }
 
@@ -934,6 +979,9 @@ vinyl_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.func_id != new_def->opts.func_id)
 		return true;
+	/* Covering indexes store full tuples on disk. */
+	if (old_def->opts.covering != new_def->opts.covering)
+		return true;
 
 	assert(index_depends_on_pk(index));
 	const struct key_def *old_cmp_def = old_def->cmp_def;
@@ -1272,6 +1320,26 @@ vy_get_by_secondary_tuple(struct vy_lsm *lsm, struct vy_tx *tx,
 	int rc = 0;
 	assert(lsm->index_id > 0);
 
+	if (lsm->opts.covering) {
+		/*
+		 * A covering index stores full tuples and DELETEs
+		 * are never deferred in a space that has one, so
+		 * the tuple can be returned without looking up
+		 * the primary index. We still track it in the
+		 * primary index read set, which is cheap, for
+		 * the sake of conflict detection.
+		 */
+		assert(!vy_stmt_is_key(entry.stmt));
+		struct vy_entry pk_entry;
+		pk_entry.stmt = entry.stmt;
+		pk_entry.hint = vy_stmt_hint(entry.stmt, lsm->pk->cmp_def);
+		if (tx != NULL && vy_tx_track_point(tx, lsm->pk, pk_entry) != 0)
+			return -1;
+		tuple_ref(entry.stmt);
+		*result = entry;
+		return 0;
+	}
+
 	/*
 	 * Lookup the full tuple by a secondary statement.
 	 * There are two cases: the secondary statement may be
@@ -1733,13 +1801,16 @@ vy_delete(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 	if (vy_unique_key_validate(lsm, key, part_count))
 		return -1;
 	/*
-	 * There are two cases when need to get the full tuple
+	 * There are three cases when need to get the full tuple
 	 * before deletion.
 	 * - if the space has on_replace triggers and need to pass
 	 *   to them the old tuple.
 	 * - if deletion is done by a secondary index.
+	 * - if the space has a covering index, which must not
+	 *   store deleted tuples.
 	 */
-	if (lsm->index_id > 0 || !rlist_empty(&space->on_replace)) {
+	if (lsm->index_id > 0 || !rlist_empty(&space->on_replace) ||
+	    vy_space_has_covering_index(space)) {
 		if (vy_get_by_raw_key(lsm, tx, vy_tx_read_view(tx),
 				      key, part_count, &stmt->old_tuple) != 0)
 			return -1;
@@ -2270,9 +2341,11 @@ vy_replace(struct vy_env *env, struct vy_tx *tx, struct txn_stmt *stmt,
 	/*
 	 * Get the overwritten tuple from the primary index if
 	 * the space has on_replace triggers, in which case we
-	 * need to pass the old tuple to trigger callbacks.
+	 * need to pass the old tuple to trigger callbacks, or
+	 * a covering index, which must be updated immediately.
 	 */
-	if (!rlist_empty(&space->on_replace)) {
+	if (!rlist_empty(&space->on_replace) ||
+	    vy_space_has_covering_index(space)) {
 		if (vy_get(pk, tx, vy_tx_read_view(tx),
 			   stmt->new_tuple, &stmt->old_tuple) != 0)
 			return -1;
@@ -2724,6 +2797,21 @@ vinyl_engine_set_timeout(struct engine *engine, double timeout)
 	env->timeout = timeout;
 }
 
+void
+vinyl_engine_set_max_subcompactions(struct engine *engine,
+				    int max_subcompactions)
+{
+	struct vy_env *env = vy_env(engine);
+	env->scheduler.max_subcompactions = max_subcompactions;
+}
+
+void
+vinyl_engine_set_bloom_memory(struct engine *engine, size_t limit)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_bloom_memory(&env->run_env, limit);
+}
+
 void
 vinyl_engine_set_too_long_threshold(struct engine *engine,
 				    double too_long_threshold)
@@ -4593,6 +4681,7 @@ static const struct index_vtab vinyl_index_vtab = {
 	/* .create_iterator = */ vinyl_index_create_iterator,
 	/* .create_snapshot_iterator = */
 		vinyl_index_create_snapshot_iterator,
+	/* .create_read_view = */ generic_index_create_read_view,
 	/* .stat = */ vinyl_index_stat,
 	/* .compact = */ vinyl_index_compact,
 	/* .reset_stat = */ vinyl_index_reset_stat,
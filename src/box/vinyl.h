@@ -75,6 +75,20 @@ vinyl_engine_set_max_tuple_size(struct engine *engine, size_t max_size);
 void
 vinyl_engine_set_timeout(struct engine *engine, double timeout);
 
+/**
+ * Update max number of parts a compaction task may be split into.
+ */
+void
+vinyl_engine_set_max_subcompactions(struct engine *engine,
+				    int max_subcompactions);
+
+/**
+ * Update max size of memory used for bloom filters.
+ * 0 means unlimited.
+ */
+void
+vinyl_engine_set_bloom_memory(struct engine *engine, size_t limit);
+
 /**
  * Update too_long_threshold.
  */
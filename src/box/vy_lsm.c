@@ -150,11 +150,12 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 
 	lsm->cmp_def = cmp_def;
 	lsm->key_def = key_def;
-	if (index_def->iid == 0) {
+	if (index_def->iid == 0 || index_def->opts.covering) {
 		/*
 		 * Disk tuples can be returned to an user from a
-		 * primary key. And they must have field
-		 * definitions as well as space->format tuples.
+		 * primary key or a covering secondary key. And
+		 * they must have field definitions as well as
+		 * space->format tuples.
 		 */
 		lsm->disk_format = format;
 	} else {
@@ -166,7 +167,8 @@ vy_lsm_new(struct vy_lsm_env *lsm_env, struct vy_cache_env *cache_env,
 		 * up a full tuple in the primary index.
 		 */
 		lsm->disk_format = lsm_env->key_format;
-
+	}
+	if (index_def->iid > 0) {
 		lsm->pk_in_cmp_def = key_def_find_pk_in_cmp_def(lsm->cmp_def,
 								pk->key_def,
 								&fiber()->gc);
@@ -756,6 +758,7 @@ vy_lsm_add_run(struct vy_lsm *lsm, struct vy_run *run)
 
 	env->bloom_size += bloom_size;
 	env->page_index_size += page_index_size;
+	vy_run_bloom_cache_add(run);
 
 	/* Data size is consistent with space.bsize. */
 	if (lsm->index_id == 0)
@@ -785,6 +788,7 @@ vy_lsm_remove_run(struct vy_lsm *lsm, struct vy_run *run)
 
 	env->bloom_size -= bloom_size;
 	env->page_index_size -= page_index_size;
+	vy_run_bloom_cache_remove(run);
 
 	/* Data size is consistent with space.bsize. */
 	if (lsm->index_id == 0)
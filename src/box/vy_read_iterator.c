@@ -582,7 +582,8 @@ vy_read_iterator_add_disk(struct vy_read_iterator *itr)
 				     &lsm->stat.disk.iterator, slice,
 				     iterator_type, itr->key,
 				     itr->read_view, lsm->cmp_def,
-				     lsm->key_def, lsm->disk_format);
+				     lsm->key_def, lsm->disk_format,
+				     lsm->opts.read_ahead);
 	}
 }
 
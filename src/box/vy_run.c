@@ -74,6 +74,12 @@ const char *vy_file_suffix[] = {
 /* sync run and index files very 16 MB */
 #define VY_RUN_SYNC_INTERVAL (1 << 24)
 
+/**
+ * Number of pages a run iterator must load one after another
+ * before it starts reading ahead.
+ */
+enum { VY_RUN_READ_AHEAD_MIN_SEQ_PAGES = 2 };
+
 /**
  * We read runs in background threads so as not to stall tx.
  * This structure represents such a thread.
@@ -111,6 +117,39 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/**
+ * Cbus message used for reading a page in a reader thread ahead
+ * of a run iterator. Unlike vy_page_read_task, the iterator
+ * doesn't wait for the message to return unless it needs the
+ * page, see vy_run_iterator_read_ahead().
+ */
+struct vy_page_prefetch {
+	/** Cbus message. */
+	struct cmsg base;
+	/** Route: reader thread, then back to tx. */
+	struct cmsg_hop route[2];
+	/** Link in vy_run_iterator::prefetch. */
+	struct rlist in_iterator;
+	/** Run to read the page from. Referenced by the message. */
+	struct vy_run *run;
+	/** Number of the page to read. */
+	uint32_t page_no;
+	/** Page buffer. */
+	struct vy_page *page;
+	/** Set when the message returns to tx. */
+	bool is_done;
+	/** Set by the reader thread if the page was read successfully. */
+	bool is_ok;
+	/**
+	 * Set if the iterator that issued the request doesn't need
+	 * the page anymore. Such a message is freed as soon as it
+	 * returns to tx.
+	 */
+	bool is_orphan;
+	/** Fiber waiting for the message to return, if any. */
+	struct fiber *waiter;
+};
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -183,6 +222,9 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	mempool_create(&env->prefetch_pool, cord_slab_cache(),
+		       sizeof(struct vy_page_prefetch));
+	rlist_create(&env->bloom_lru);
 	env->initial_join = false;
 }
 
@@ -195,6 +237,7 @@ vy_run_env_destroy(struct vy_run_env *env)
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
 	mempool_destroy(&env->read_task_pool);
+	mempool_destroy(&env->prefetch_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
 
@@ -209,6 +252,17 @@ vy_run_env_enable_coio(struct vy_run_env *env)
 	vy_run_env_start_readers(env);
 }
 
+/** Pick a reader thread to process the next read request. */
+static struct vy_run_reader *
+vy_run_env_next_reader(struct vy_run_env *env)
+{
+	assert(env->reader_pool != NULL);
+	struct vy_run_reader *reader;
+	reader = &env->reader_pool[env->next_reader++];
+	env->next_reader %= env->reader_pool_size;
+	return reader;
+}
+
 /**
  * Execute a task on behalf of a reader thread.
  */
@@ -220,10 +274,7 @@ vy_run_env_coio_call(struct vy_run_env *env, struct cbus_call_msg *msg,
 	if (env->reader_pool == NULL)
 		return func(msg);
 
-	/* Pick a reader thread. */
-	struct vy_run_reader *reader;
-	reader = &env->reader_pool[env->next_reader++];
-	env->next_reader %= env->reader_pool_size;
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
 
 	/* Post the task to the reader thread. */
 	bool cancellable = fiber_set_cancellable(false);
@@ -287,6 +338,7 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 	run->refs = 1;
 	rlist_create(&run->in_lsm);
 	rlist_create(&run->in_unused);
+	rlist_create(&run->in_bloom_lru);
 	return run;
 }
 
@@ -302,10 +354,12 @@ vy_run_clear(struct vy_run *run)
 	run->page_info = NULL;
 	run->page_index_size = 0;
 	run->info.page_count = 0;
+	vy_run_bloom_cache_remove(run);
 	if (run->info.bloom != NULL) {
 		tuple_bloom_delete(run->info.bloom);
 		run->info.bloom = NULL;
 	}
+	run->bloom_size = 0;
 	free(run->info.min_key);
 	run->info.min_key = NULL;
 	free(run->info.max_key);
@@ -326,7 +380,70 @@ vy_run_delete(struct vy_run *run)
 size_t
 vy_run_bloom_size(struct vy_run *run)
 {
-	return run->info.bloom == NULL ? 0 : tuple_bloom_size(run->info.bloom);
+	return run->bloom_size;
+}
+
+/**
+ * Drop bloom filters of the least recently used runs from memory
+ * until the memory limit is met. The most recently used bloom
+ * filter is never dropped so that a bloom filter that has just
+ * been loaded can be checked.
+ */
+static void
+vy_run_env_evict_blooms(struct vy_run_env *env)
+{
+	if (env->bloom_memory_limit == 0)
+		return;
+	while (env->bloom_memory_used > env->bloom_memory_limit) {
+		struct vy_run *run = rlist_last_entry(&env->bloom_lru,
+						      struct vy_run,
+						      in_bloom_lru);
+		if (run == rlist_first_entry(&env->bloom_lru, struct vy_run,
+					     in_bloom_lru))
+			break;
+		rlist_del_entry(run, in_bloom_lru);
+		env->bloom_memory_used -= run->bloom_size;
+		tuple_bloom_delete(run->info.bloom);
+		run->info.bloom = NULL;
+	}
+}
+
+void
+vy_run_env_set_bloom_memory(struct vy_run_env *env, size_t limit)
+{
+	env->bloom_memory_limit = limit;
+	vy_run_env_evict_blooms(env);
+}
+
+void
+vy_run_bloom_cache_add(struct vy_run *run)
+{
+	struct vy_run_env *env = run->env;
+	assert(rlist_empty(&run->in_bloom_lru));
+	if (run->info.bloom == NULL)
+		return;
+	rlist_add_entry(&env->bloom_lru, run, in_bloom_lru);
+	env->bloom_memory_used += run->bloom_size;
+	vy_run_env_evict_blooms(env);
+}
+
+void
+vy_run_bloom_cache_remove(struct vy_run *run)
+{
+	struct vy_run_env *env = run->env;
+	if (rlist_empty(&run->in_bloom_lru))
+		return;
+	rlist_del_entry(run, in_bloom_lru);
+	assert(env->bloom_memory_used >= run->bloom_size);
+	env->bloom_memory_used -= run->bloom_size;
+}
+
+/** Mark the bloom filter of a run as recently used. */
+static void
+vy_run_bloom_cache_touch(struct vy_run *run)
+{
+	if (!rlist_empty(&run->in_bloom_lru))
+		rlist_move_entry(&run->env->bloom_lru, run, in_bloom_lru);
 }
 
 /**
@@ -823,6 +940,9 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 	return end;
 }
 
+static void
+vy_run_iterator_discard_prefetch(struct vy_run_iterator *itr);
+
 /**
  * End iteration and free cached data.
  */
@@ -839,6 +959,7 @@ vy_run_iterator_stop(struct vy_run_iterator *itr)
 			vy_page_delete(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
+	vy_run_iterator_discard_prefetch(itr);
 }
 
 static int
@@ -996,15 +1117,301 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+/** Free a page read-ahead message. */
+static void
+vy_page_prefetch_delete(struct vy_page_prefetch *msg)
+{
+	struct vy_run_env *env = msg->run->env;
+	if (msg->page != NULL)
+		vy_page_delete(msg->page);
+	vy_run_unref(msg->run);
+	mempool_free(&env->prefetch_pool, msg);
+}
+
+/** Read a page ahead of an iterator. Called in a reader thread. */
+static void
+vy_page_prefetch_read_f(struct cmsg *base)
+{
+	struct vy_page_prefetch *msg = (struct vy_page_prefetch *)base;
+	struct vy_run *run = msg->run;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(run->env);
+	msg->is_ok = (zdctx != NULL &&
+		      vy_page_read(msg->page, vy_run_page_info(run,
+				   msg->page_no), run, zdctx) == 0);
+	/*
+	 * Read-ahead is best effort: on failure the iterator will
+	 * retry the read synchronously and report the error then.
+	 */
+	if (!msg->is_ok)
+		diag_clear(diag_get());
+}
+
+/** Complete a page read-ahead. Called in tx. */
+static void
+vy_page_prefetch_complete_f(struct cmsg *base)
+{
+	struct vy_page_prefetch *msg = (struct vy_page_prefetch *)base;
+	msg->is_done = true;
+	if (msg->is_orphan)
+		vy_page_prefetch_delete(msg);
+	else if (msg->waiter != NULL)
+		fiber_wakeup(msg->waiter);
+}
+
+/**
+ * Send a request to read the given page in background to
+ * a reader thread. Failures are silently ignored, because
+ * the page will be read synchronously if read-ahead fails.
+ */
+static void
+vy_run_iterator_prefetch_page(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_run_env *env = run->env;
+	struct vy_page_prefetch *msg = mempool_alloc(&env->prefetch_pool);
+	if (msg == NULL)
+		return;
+	msg->page = vy_page_new(vy_run_page_info(run, page_no));
+	if (msg->page == NULL) {
+		diag_clear(diag_get());
+		mempool_free(&env->prefetch_pool, msg);
+		return;
+	}
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
+	msg->route[0].f = vy_page_prefetch_read_f;
+	msg->route[0].pipe = &reader->tx_pipe;
+	msg->route[1].f = vy_page_prefetch_complete_f;
+	msg->route[1].pipe = NULL;
+	cmsg_init(&msg->base, msg->route);
+	vy_run_ref(run);
+	msg->run = run;
+	msg->page_no = page_no;
+	msg->page->page_no = page_no;
+	msg->is_done = false;
+	msg->is_ok = false;
+	msg->is_orphan = false;
+	msg->waiter = NULL;
+	rlist_add_tail_entry(&itr->prefetch, msg, in_iterator);
+	cpipe_push(&reader->reader_pipe, &msg->base);
+	itr->stat->read_ahead_pages++;
+}
+
+/**
+ * Drop all pages read ahead by an iterator. Messages that are
+ * still in progress are freed when they return to tx.
+ */
+static void
+vy_run_iterator_discard_prefetch(struct vy_run_iterator *itr)
+{
+	struct vy_page_prefetch *msg, *tmp;
+	rlist_foreach_entry_safe(msg, &itr->prefetch, in_iterator, tmp) {
+		rlist_del_entry(msg, in_iterator);
+		if (msg->is_done)
+			vy_page_prefetch_delete(msg);
+		else
+			msg->is_orphan = true;
+	}
+}
+
+/**
+ * Take a page read ahead by an iterator, waiting for the read
+ * to complete if necessary. Since pages are read ahead in the
+ * order of iteration, the page, if read ahead at all, must be
+ * the first one in the list.
+ *
+ * On success returns 0 and sets @result to the page or to NULL
+ * if the page wasn't read ahead or the read failed. Returns -1
+ * if the fiber was cancelled while waiting.
+ */
+static NODISCARD int
+vy_run_iterator_take_prefetched(struct vy_run_iterator *itr,
+				uint32_t page_no, struct vy_page **result)
+{
+	*result = NULL;
+	if (rlist_empty(&itr->prefetch))
+		return 0;
+	struct vy_page_prefetch *msg = rlist_first_entry(&itr->prefetch,
+				struct vy_page_prefetch, in_iterator);
+	if (msg->page_no != page_no)
+		return 0;
+	rlist_del_entry(msg, in_iterator);
+	if (!msg->is_done) {
+		bool cancellable = fiber_set_cancellable(false);
+		msg->waiter = fiber();
+		while (!msg->is_done)
+			fiber_yield();
+		msg->waiter = NULL;
+		fiber_set_cancellable(cancellable);
+	}
+	if (msg->is_ok) {
+		*result = msg->page;
+		msg->page = NULL;
+	}
+	vy_page_prefetch_delete(msg);
+	if (fiber_is_cancelled()) {
+		if (*result != NULL)
+			vy_page_delete(*result);
+		*result = NULL;
+		diag_set(FiberIsCancelled);
+		return -1;
+	}
+	return 0;
+}
+
 /**
- * Read a page from disk given its number.
- * The function caches two most recently read pages.
+ * Detect a sequential scan and read pages following the given
+ * one in the iteration direction in background.
+ *
+ * A scan is considered sequential if the iterator has loaded
+ * VY_RUN_READ_AHEAD_MIN_SEQ_PAGES pages one after another. This
+ * filters out short range selects, which would only waste disk
+ * bandwidth on reading ahead.
+ */
+static void
+vy_run_iterator_read_ahead(struct vy_run_iterator *itr, uint32_t page_no)
+{
+	struct vy_slice *slice = itr->slice;
+	int dir = iterator_direction(itr->iterator_type);
+	if (itr->last_page_no != UINT32_MAX &&
+	    (int64_t)page_no == (int64_t)itr->last_page_no + dir)
+		itr->seq_page_count++;
+	else
+		itr->seq_page_count = 0;
+	itr->last_page_no = page_no;
+
+	if (itr->read_ahead == 0 || slice->run->env->reader_pool == NULL ||
+	    itr->seq_page_count < VY_RUN_READ_AHEAD_MIN_SEQ_PAGES)
+		return;
+
+	int64_t next = (int64_t)page_no + dir;
+	if (!rlist_empty(&itr->prefetch)) {
+		struct vy_page_prefetch *last = rlist_last_entry(
+			&itr->prefetch, struct vy_page_prefetch, in_iterator);
+		next = (int64_t)last->page_no + dir;
+	}
+	int64_t end = (int64_t)page_no + dir * (int64_t)itr->read_ahead;
+	if (dir > 0)
+		end = MIN(end, (int64_t)slice->last_page_no);
+	else
+		end = MAX(end, (int64_t)slice->first_page_no);
+	for (; dir * next <= dir * end; next += dir)
+		vy_run_iterator_prefetch_page(itr, next);
+}
+
+/** Cbus task for reloading a bloom filter dropped from memory. */
+struct vy_bloom_read_task {
+	/** parent */
+	struct cbus_call_msg base;
+	/** run to load the bloom filter for */
+	struct vy_run *run;
+	/** [out] loaded bloom filter */
+	struct tuple_bloom *bloom;
+};
+
+/**
+ * Read the bloom filter of a run from its index file.
+ * Returns NULL and sets diag on error.
+ */
+static struct tuple_bloom *
+vy_run_read_bloom(struct vy_run *run)
+{
+	char path[PATH_MAX];
+	vy_run_snprint_path(path, sizeof(path), run->dir, run->space_id,
+			    run->iid, run->id, VY_FILE_INDEX);
+	struct xlog_cursor cursor;
+	if (xlog_cursor_open(&cursor, path) != 0)
+		return NULL;
+
+	struct tuple_bloom *bloom = NULL;
+	struct xrow_header xrow;
+	/* Run info is the first row of the index file. */
+	int rc = xlog_cursor_next_tx(&cursor);
+	if (rc == 0)
+		rc = xlog_cursor_next_row(&cursor, &xrow);
+	if (rc != 0) {
+		if (rc > 0)
+			diag_set(ClientError, ER_INVALID_INDEX_FILE,
+				 path, "Unexpected end of file");
+		goto out;
+	}
+	if (xrow.type != VY_INDEX_RUN_INFO) {
+		diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
+			 tt_sprintf("Wrong xrow type (expected %d, got %u)",
+				    VY_INDEX_RUN_INFO, (unsigned)xrow.type));
+		goto out;
+	}
+	const char *pos = xrow.body->iov_base;
+	uint32_t map_size = mp_decode_map(&pos);
+	for (uint32_t i = 0; i < map_size; i++) {
+		uint32_t key = mp_decode_uint(&pos);
+		switch (key) {
+		case VY_RUN_INFO_BLOOM_LEGACY:
+			bloom = tuple_bloom_decode_legacy(&pos);
+			goto out;
+		case VY_RUN_INFO_BLOOM:
+			bloom = tuple_bloom_decode(&pos);
+			goto out;
+		default:
+			mp_next(&pos);
+			break;
+		}
+	}
+	diag_set(ClientError, ER_INVALID_INDEX_FILE, path,
+		 "Can't find bloom filter");
+out:
+	xlog_cursor_close(&cursor, false);
+	return bloom;
+}
+
+/** Bloom filter read task callback. */
+static int
+vy_bloom_read_cb(struct cbus_call_msg *base)
+{
+	struct vy_bloom_read_task *task = (struct vy_bloom_read_task *)base;
+	task->bloom = vy_run_read_bloom(task->run);
+	return task->bloom == NULL ? -1 : 0;
+}
+
+/**
+ * Load the bloom filter of a run that was dropped from memory
+ * because of the bloom filter memory limit.
+ *
+ * @retval 0 success
+ * @retval -1 read error
+ */
+static NODISCARD int
+vy_run_load_bloom(struct vy_run *run)
+{
+	assert(run->bloom_size > 0);
+	struct vy_bloom_read_task task;
+	task.run = run;
+	task.bloom = NULL;
+	if (vy_run_env_coio_call(run->env, &task.base,
+				 vy_bloom_read_cb) != 0) {
+		if (task.bloom != NULL)
+			tuple_bloom_delete(task.bloom);
+		return -1;
+	}
+	if (run->info.bloom != NULL) {
+		/* Loaded by another fiber while we were waiting. */
+		tuple_bloom_delete(task.bloom);
+		return 0;
+	}
+	run->info.bloom = task.bloom;
+	if (!rlist_empty(&run->in_lsm))
+		vy_run_bloom_cache_add(run);
+	return 0;
+}
+
+/**
+ * Read a page from disk given its number, bypassing the cache.
+ * If @key is set, also look up the key position in the page.
  *
  * @retval 0 success
  * @retval -1 critical error
  */
 static NODISCARD int
-vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
+vy_run_iterator_read_page(struct vy_run_iterator *itr, uint32_t page_no,
 			  struct vy_entry key, enum iterator_type iterator_type,
 			  struct vy_page **result, uint32_t *pos_in_page,
 			  bool *equal_found)
@@ -1012,28 +1419,9 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	struct vy_slice *slice = itr->slice;
 	struct vy_run_env *env = slice->run->env;
 
-	/* Check cache */
-	struct vy_page *page = NULL;
-	if (itr->curr_page != NULL &&
-	    itr->curr_page->page_no == page_no) {
-		page = itr->curr_page;
-	} else if (itr->prev_page != NULL &&
-		   itr->prev_page->page_no == page_no) {
-		SWAP(itr->prev_page, itr->curr_page);
-		page = itr->curr_page;
-	}
-	if (page != NULL) {
-		if (key.stmt != NULL)
-			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
-							itr->format, iterator_type,
-							equal_found);
-		*result = page;
-		return 0;
-	}
-
 	/* Allocate buffers */
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
-	page = vy_page_new(page_info);
+	struct vy_page *page = vy_page_new(page_info);
 	if (page == NULL)
 		return -1;
 
@@ -1065,20 +1453,79 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		vy_page_delete(page);
 		return -1;
 	}
+	page->page_no = page_no;
+	*result = page;
+	return 0;
+}
+
+/**
+ * Read a page from disk given its number.
+ * The function caches two most recently read pages.
+ * Pages are taken from the read-ahead list if possible.
+ *
+ * @retval 0 success
+ * @retval -1 critical error
+ */
+static NODISCARD int
+vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_entry key, enum iterator_type iterator_type,
+			  struct vy_page **result, uint32_t *pos_in_page,
+			  bool *equal_found)
+{
+	struct vy_slice *slice = itr->slice;
+
+	/* Check cache */
+	struct vy_page *page = NULL;
+	if (itr->curr_page != NULL &&
+	    itr->curr_page->page_no == page_no) {
+		page = itr->curr_page;
+	} else if (itr->prev_page != NULL &&
+		   itr->prev_page->page_no == page_no) {
+		SWAP(itr->prev_page, itr->curr_page);
+		page = itr->curr_page;
+	}
+	if (page != NULL) {
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+		*result = page;
+		return 0;
+	}
+
+	/* Check pages read ahead */
+	if (vy_run_iterator_take_prefetched(itr, page_no, &page) != 0)
+		return -1;
+	if (page != NULL) {
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+		itr->stat->read_ahead_hit++;
+	} else {
+		/* Random access: pages read ahead won't be used. */
+		vy_run_iterator_discard_prefetch(itr);
+		if (vy_run_iterator_read_page(itr, page_no, key, iterator_type,
+					      &page, pos_in_page,
+					      equal_found) != 0)
+			return -1;
+	}
 
 	/* Update cache */
 	if (itr->prev_page != NULL)
 		vy_page_delete(itr->prev_page);
 	itr->prev_page = itr->curr_page;
 	itr->curr_page = page;
-	page->page_no = page_no;
 
 	/* Update read statistics. */
+	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
 	itr->stat->read.rows += page_info->row_count;
 	itr->stat->read.bytes += page_info->unpacked_size;
 	itr->stat->read.bytes_compressed += page_info->size;
 	itr->stat->read.pages++;
 
+	vy_run_iterator_read_ahead(itr, page_no);
+
 	*result = page;
 	return 0;
 }
@@ -1342,7 +1789,7 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 {
 	struct key_def *cmp_def = itr->cmp_def;
 	struct vy_slice *slice = itr->slice;
-	struct tuple_bloom *bloom = slice->run->info.bloom;
+	struct vy_run *run = slice->run;
 	struct vy_entry key = itr->key;
 	enum iterator_type iterator_type = itr->iterator_type;
 
@@ -1351,11 +1798,21 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 
 	/* Check the bloom filter on the first iteration. */
 	bool check_bloom = (itr->iterator_type == ITER_EQ &&
-			    itr->curr.stmt == NULL && bloom != NULL);
-	if (check_bloom && !vy_bloom_maybe_has(bloom, itr->key, itr->key_def)) {
-		vy_run_iterator_stop(itr);
-		itr->stat->bloom_hit++;
-		return 0;
+			    itr->curr.stmt == NULL && run->bloom_size > 0);
+	if (check_bloom && run->info.bloom == NULL) {
+		/* The bloom filter was dropped from memory. */
+		if (vy_run_load_bloom(run) != 0)
+			return -1;
+		itr->stat->bloom_load++;
+	}
+	if (check_bloom) {
+		vy_run_bloom_cache_touch(run);
+		if (!vy_bloom_maybe_has(run->info.bloom, itr->key,
+					itr->key_def)) {
+			vy_run_iterator_stop(itr);
+			itr->stat->bloom_hit++;
+			return 0;
+		}
 	}
 
 	/*
@@ -1467,7 +1924,7 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 		     struct vy_slice *slice, enum iterator_type iterator_type,
 		     struct vy_entry key, const struct vy_read_view **rv,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     struct tuple_format *format)
+		     struct tuple_format *format, uint32_t read_ahead)
 {
 	itr->stat = stat;
 	itr->cmp_def = cmp_def;
@@ -1483,6 +1940,10 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_pos.page_no = slice->run->info.page_count;
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
+	itr->read_ahead = read_ahead;
+	itr->last_page_no = UINT32_MAX;
+	itr->seq_page_count = 0;
+	rlist_create(&itr->prefetch);
 	itr->search_started = false;
 
 	/*
@@ -1707,6 +2168,11 @@ vy_run_recover(struct vy_run *run, const char *dir,
 
 	if (vy_run_info_decode(&run->info, &xrow, path) != 0)
 		goto fail_close;
+	if (run->info.bloom != NULL)
+		run->bloom_size = tuple_bloom_size(run->info.bloom);
+	run->dir = dir;
+	run->space_id = space_id;
+	run->iid = iid;
 
 	/* Allocate buffer for page info. */
 	run->page_info = calloc(run->info.page_count,
@@ -1784,14 +2250,18 @@ fail:
 static int
 vy_run_dump_stmt(struct vy_entry entry, struct xlog *data_xlog,
 		 struct vy_page_info *info, struct key_def *key_def,
-		 bool is_primary)
+		 bool is_primary, bool is_covering)
 {
 	struct xrow_header xrow;
-	int rc = (is_primary ?
-		  vy_stmt_encode_primary(entry.stmt, key_def, 0, &xrow) :
-		  vy_stmt_encode_secondary(entry.stmt, key_def,
-					   vy_entry_multikey_idx(entry, key_def),
-					   &xrow));
+	int rc;
+	if (is_primary)
+		rc = vy_stmt_encode_primary(entry.stmt, key_def, 0, &xrow);
+	else if (is_covering)
+		rc = vy_stmt_encode_covering(entry.stmt, key_def, &xrow);
+	else
+		rc = vy_stmt_encode_secondary(entry.stmt, key_def,
+					vy_entry_multikey_idx(entry, key_def),
+					&xrow);
 	if (rc != 0)
 		return -1;
 
@@ -2112,19 +2582,21 @@ fail:
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
-		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression)
+		     bool is_covering, struct key_def *cmp_def,
+		     struct key_def *key_def, uint64_t page_size,
+		     double bloom_fpr, int compression_level)
 {
 	memset(writer, 0, sizeof(*writer));
 	writer->run = run;
 	writer->dirpath = dirpath;
 	writer->space_id = space_id;
 	writer->iid = iid;
+	writer->is_covering = is_covering;
 	writer->cmp_def = cmp_def;
 	writer->key_def = key_def;
 	writer->page_size = page_size;
 	writer->bloom_fpr = bloom_fpr;
-	writer->no_compression = no_compression;
+	writer->compression_level = compression_level;
 	if (bloom_fpr < 1) {
 		writer->bloom = tuple_bloom_builder_new(key_def->part_count);
 		if (writer->bloom == NULL)
@@ -2160,7 +2632,8 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
-	opts.no_compression = writer->no_compression;
+	opts.no_compression = writer->compression_level == 0;
+	opts.compression_level = writer->compression_level;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
 	return 0;
@@ -2232,7 +2705,8 @@ vy_run_writer_write_to_page(struct vy_run_writer *writer, struct vy_entry entry)
 	}
 	*offset = page->unpacked_size;
 	if (vy_run_dump_stmt(entry, &writer->data_xlog, page,
-			     writer->cmp_def, writer->iid == 0) != 0)
+			     writer->cmp_def, writer->iid == 0,
+			     writer->is_covering) != 0)
 		return -1;
 	int64_t lsn = vy_stmt_lsn(entry.stmt);
 	run->info.min_lsn = MIN(run->info.min_lsn, lsn);
@@ -2366,7 +2840,11 @@ vy_run_writer_commit(struct vy_run_writer *writer)
 						  writer->bloom_fpr);
 		if (run->info.bloom == NULL)
 			goto out;
+		run->bloom_size = tuple_bloom_size(run->info.bloom);
 	}
+	run->dir = writer->dirpath;
+	run->space_id = writer->space_id;
+	run->iid = writer->iid;
 	if (vy_run_write_index(run, writer->dirpath,
 			       writer->space_id, writer->iid) != 0)
 		goto out;
@@ -2514,6 +2992,7 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 						  opts->bloom_fpr);
 		if (run->info.bloom == NULL)
 			goto close_err;
+		run->bloom_size = tuple_bloom_size(run->info.bloom);
 		tuple_bloom_builder_delete(bloom_builder);
 		bloom_builder = NULL;
 	}
@@ -2528,6 +3007,9 @@ vy_run_rebuild_index(struct vy_run *run, const char *dir,
 	}
 	if (vy_run_write_index(run, dir, space_id, iid) != 0)
 		goto close_err;
+	run->dir = dir;
+	run->space_id = space_id;
+	run->iid = iid;
 	return 0;
 close_err:
 	vy_run_clear(run);
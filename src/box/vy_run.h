@@ -58,6 +58,8 @@ struct vy_run_env {
 	uint64_t snap_io_rate_limit;
 	/** Mempool for struct vy_page_read_task */
 	struct mempool read_task_pool;
+	/** Mempool for struct vy_page_prefetch */
+	struct mempool prefetch_pool;
 	/** Key for thread-local ZSTD context */
 	pthread_key_t zdctx_key;
 	/** Pool of threads used for reading run files. */
@@ -69,6 +71,22 @@ struct vy_run_env {
 	 * processing the next read request.
 	 */
 	int next_reader;
+	/**
+	 * Max size of memory that may be used for bloom filters
+	 * of runs added to LSM trees, 0 means unlimited. When the
+	 * limit is exceeded, bloom filters of the least recently
+	 * used runs are dropped from memory. They are reloaded
+	 * from index files on demand.
+	 */
+	size_t bloom_memory_limit;
+	/** Size of memory used for bloom filters of LSM tree runs. */
+	size_t bloom_memory_used;
+	/**
+	 * LSM tree runs that have bloom filters loaded in memory,
+	 * linked by vy_run::in_bloom_lru, the most recently used
+	 * run first.
+	 */
+	struct rlist bloom_lru;
 	/**
 	 * We need this flag during compaction in order to determine we can
 	 * unconditionally remove unused runs' files in-place.
@@ -134,6 +152,23 @@ struct vy_run {
 	struct vy_disk_stmt_counter count;
 	/** Size of memory used for storing page index. */
 	size_t page_index_size;
+	/**
+	 * Size of the run bloom filter, whether it's loaded in
+	 * memory or not. 0 if the run doesn't have a bloom filter.
+	 */
+	size_t bloom_size;
+	/**
+	 * Link in vy_run_env::bloom_lru. Empty if the run isn't
+	 * in an LSM tree or its bloom filter isn't loaded.
+	 */
+	struct rlist in_bloom_lru;
+	/**
+	 * Location of the run files, needed for reloading the
+	 * bloom filter. The directory is owned by the environment.
+	 */
+	const char *dir;
+	uint32_t space_id;
+	uint32_t iid;
 	/** Max LSN stored on disk. */
 	int64_t dump_lsn;
 	/**
@@ -284,6 +319,26 @@ struct vy_run_iterator {
 	 */
 	struct vy_page *curr_page;
 	struct vy_page *prev_page;
+	/**
+	 * Max number of pages to read ahead of the current one
+	 * in the iteration direction once a sequential scan is
+	 * detected. Zero disables read-ahead.
+	 */
+	uint32_t read_ahead;
+	/** Number of the last page loaded from disk. */
+	uint32_t last_page_no;
+	/**
+	 * Number of pages loaded one after another in the
+	 * iteration direction, used for detecting sequential
+	 * scans.
+	 */
+	uint32_t seq_page_count;
+	/**
+	 * Pages that are being read ahead in background, linked
+	 * by vy_page_prefetch::in_iterator, in the order in which
+	 * they are going to be requested by the iterator.
+	 */
+	struct rlist prefetch;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
 };
@@ -341,6 +396,30 @@ vy_run_env_enable_coio(struct vy_run_env *env);
 size_t
 vy_run_bloom_size(struct vy_run *run);
 
+/**
+ * Set the max size of memory that may be used for bloom filters
+ * and drop bloom filters of least recently used runs from memory
+ * if the new limit is exceeded. 0 means unlimited.
+ */
+void
+vy_run_env_set_bloom_memory(struct vy_run_env *env, size_t limit);
+
+/**
+ * Account the bloom filter of a run that was added to an LSM
+ * tree to vy_run_env::bloom_memory_used. The bloom filter may
+ * be dropped from memory after this if the limit is exceeded.
+ */
+void
+vy_run_bloom_cache_add(struct vy_run *run);
+
+/**
+ * Stop accounting the bloom filter of a run that was removed
+ * from an LSM tree. The bloom filter stays in memory until the
+ * run is deleted.
+ */
+void
+vy_run_bloom_cache_remove(struct vy_run *run);
+
 static inline struct vy_page_info *
 vy_run_page_info(struct vy_run *run, uint32_t pos)
 {
@@ -518,6 +597,10 @@ vy_slice_cut(struct vy_slice *slice, int64_t id, struct vy_entry begin,
 /**
  * Open an iterator over on-disk run.
  *
+ * @read_ahead is the max number of pages the iterator may read
+ * in background in advance once it detects a sequential scan.
+ * Pass 0 to disable read-ahead, e.g. for point lookups.
+ *
  * Note, it is the caller's responsibility to make sure the slice
  * is not compacted while the iterator is reading it.
  */
@@ -527,7 +610,7 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 		     struct vy_slice *slice, enum iterator_type iterator_type,
 		     struct vy_entry key, const struct vy_read_view **rv,
 		     struct key_def *cmp_def, struct key_def *key_def,
-		     struct tuple_format *format);
+		     struct tuple_format *format, uint32_t read_ahead);
 
 /**
  * Advance a run iterator to the next key.
@@ -600,6 +683,8 @@ struct vy_run_writer {
 	uint32_t space_id;
 	/** Identifier of an index owning the run. */
 	uint32_t iid;
+	/** Set if the run belongs to a covering secondary index. */
+	bool is_covering;
 	/**
 	 * Key definition to extract from tuple and store as page
 	 * min key, run min/max keys, and secondary index
@@ -617,8 +702,11 @@ struct vy_run_writer {
 	 * Current page info capacity. Can grow with page number.
 	 */
 	uint32_t page_info_capacity;
-	/** Don't use compression while writing xlog files. */
-	bool no_compression;
+	/**
+	 * Zstd compression level used for writing the run file.
+	 * 0 disables compression.
+	 */
+	int compression_level;
 	/** Xlog to write data. */
 	struct xlog data_xlog;
 	/** Bloom filter false positive rate. */
@@ -634,12 +722,17 @@ struct vy_run_writer {
 	struct vy_entry last;
 };
 
-/** Create a run writer to fill a run with statements. */
+/**
+ * Create a run writer to fill a run with statements.
+ * Pass 0 for @compression_level to write an uncompressed run.
+ * Set @is_covering to store full tuples in a secondary index run.
+ */
 int
 vy_run_writer_create(struct vy_run_writer *writer, struct vy_run *run,
 		     const char *dirpath, uint32_t space_id, uint32_t iid,
-		     struct key_def *cmp_def, struct key_def *key_def,
-		     uint64_t page_size, double bloom_fpr, bool no_compression);
+		     bool is_covering, struct key_def *cmp_def,
+		     struct key_def *key_def, uint64_t page_size,
+		     double bloom_fpr, int compression_level);
 
 /**
  * Write a specified statement into a run.
@@ -198,6 +198,37 @@ struct vy_task {
 	 * need to remember the slices we are compacting.
 	 */
 	struct vy_slice *first_slice, *last_slice;
+	/**
+	 * Compaction of a big range may be split by key into
+	 * several parts (subcompactions), each of which is executed
+	 * by its own worker thread and writes its own run. Upon
+	 * completion the range is replaced with new ranges, one
+	 * per each part. This array stores all parts of the task,
+	 * starting from the task itself. NULL if the task isn't
+	 * split.
+	 */
+	struct vy_task **parts;
+	/** Number of entries in the @parts array. */
+	int part_count;
+	/**
+	 * Number of parts of this task that haven't been executed
+	 * yet. The task is queued for completion only when all its
+	 * parts are done.
+	 */
+	int parts_in_progress;
+	/** Task this subcompaction part belongs to or NULL. */
+	struct vy_task *parent;
+	/**
+	 * Key interval [part_begin, part_end) compacted by this
+	 * subcompaction part. NULL statement stands for infinity.
+	 */
+	struct vy_entry part_begin, part_end;
+	/**
+	 * Slices of compacted runs cut by the part boundaries,
+	 * linked by vy_slice::in_range. They are passed to the
+	 * write iterator instead of the range slices.
+	 */
+	struct rlist part_slices;
 	/**
 	 * Index options may be modified while a task is in
 	 * progress so we save them here to safely access them
@@ -205,6 +236,7 @@ struct vy_task {
 	 */
 	double bloom_fpr;
 	int64_t page_size;
+	int compression_level;
 	/**
 	 * Deferred DELETE handler passed to the write iterator.
 	 * It sends deferred DELETE statements generated during
@@ -262,6 +294,8 @@ vy_task_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	vy_lsm_ref(lsm);
 	diag_create(&task->diag);
 	task->deferred_delete_handler.iface = &vy_task_deferred_delete_iface;
+	task->parts_in_progress = 1;
+	rlist_create(&task->part_slices);
 	return task;
 }
 
@@ -271,6 +305,14 @@ vy_task_delete(struct vy_task *task)
 {
 	assert(task->deferred_delete_batch == NULL);
 	assert(task->deferred_delete_in_progress == 0);
+	assert(rlist_empty(&task->part_slices));
+	for (int i = 1; i < task->part_count; i++)
+		vy_task_delete(task->parts[i]);
+	free(task->parts);
+	if (task->part_begin.stmt != NULL)
+		tuple_unref(task->part_begin.stmt);
+	if (task->part_end.stmt != NULL)
+		tuple_unref(task->part_end.stmt);
 	key_def_delete(task->cmp_def);
 	key_def_delete(task->key_def);
 	vy_lsm_unref(task->lsm);
@@ -430,6 +472,7 @@ vy_scheduler_create(struct vy_scheduler *scheduler, int write_threads,
 {
 	memset(scheduler, 0, sizeof(*scheduler));
 
+	scheduler->max_subcompactions = 1;
 	scheduler->dump_complete_cb = dump_complete_cb;
 	scheduler->read_views = read_views;
 	scheduler->run_env = run_env;
@@ -1058,7 +1101,7 @@ vy_task_deferred_delete_iface = {
 };
 
 static int
-vy_task_write_run(struct vy_task *task, bool no_compression)
+vy_task_write_run(struct vy_task *task, int compression_level)
 {
 	enum { YIELD_LOOPS = 32 };
 
@@ -1073,9 +1116,10 @@ vy_task_write_run(struct vy_task *task, bool no_compression)
 	struct vy_run_writer writer;
 	if (vy_run_writer_create(&writer, task->new_run, lsm->env->path,
 				 lsm->space_id, lsm->index_id,
+				 lsm->opts.covering,
 				 task->cmp_def, task->key_def,
 				 task->page_size, task->bloom_fpr,
-				 no_compression) != 0)
+				 compression_level) != 0)
 		goto fail;
 
 	if (wi->iface->start(wi) != 0)
@@ -1125,7 +1169,7 @@ vy_task_dump_execute(struct vy_task *task)
 	 * and smallest runs at the same time and so we would gain
 	 * nothing by compressing them.
 	 */
-	return vy_task_write_run(task, true);
+	return vy_task_write_run(task, 0);
 }
 
 static int
@@ -1391,7 +1435,8 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	struct vy_stmt_stream *wi;
 	bool is_last_level = (lsm->run_count == 0);
 	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views, NULL);
+				   lsm->opts.covering, is_last_level,
+				   scheduler->read_views, NULL);
 	if (wi == NULL)
 		goto err_wi;
 	rlist_foreach_entry(mem, &lsm->sealed, in_sealed) {
@@ -1439,11 +1484,286 @@ err:
 	return -1;
 }
 
+/**
+ * Return the number of parts a compaction task consists of.
+ * A task that wasn't split consists of a single part, the
+ * task itself.
+ */
+static inline int
+vy_task_part_count(struct vy_task *task)
+{
+	return task->part_count > 0 ? task->part_count : 1;
+}
+
+/** Return the part of a compaction task with the given number. */
+static inline struct vy_task *
+vy_task_part(struct vy_task *task, int i)
+{
+	assert(i < vy_task_part_count(task));
+	return task->part_count > 0 ? task->parts[i] : task;
+}
+
+/**
+ * Close write iterators of a compaction task and all its parts
+ * and delete slices created for subcompactions. The iterators
+ * have been cleaned up in worker threads.
+ */
+static void
+vy_task_compaction_cleanup(struct vy_task *task)
+{
+	for (int i = 0; i < vy_task_part_count(task); i++) {
+		struct vy_task *part = vy_task_part(task, i);
+		if (part->wi != NULL) {
+			part->wi->iface->close(part->wi);
+			part->wi = NULL;
+		}
+		struct vy_slice *slice, *next_slice;
+		rlist_foreach_entry_safe(slice, &part->part_slices,
+					 in_range, next_slice)
+			vy_slice_delete(slice);
+		rlist_create(&part->part_slices);
+	}
+}
+
 static int
 vy_task_compaction_execute(struct vy_task *task)
 {
 	ERROR_INJECT_SLEEP(ERRINJ_VY_COMPACTION_DELAY);
-	return vy_task_write_run(task, false);
+	return vy_task_write_run(task, task->compression_level);
+}
+
+/**
+ * Complete a compaction task that was split into parts.
+ *
+ * The compacted range is replaced with new ranges, one per each
+ * part. A new range contains the run written by the corresponding
+ * part in place of the compacted slices and slices of the rest of
+ * the runs of the old range cut by the part boundaries.
+ */
+static int
+vy_task_compaction_complete_parts(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	double compaction_time = ev_monotonic_now(loop()) - task->start_time;
+	struct vy_disk_stmt_counter compaction_output;
+	struct vy_disk_stmt_counter compaction_input;
+	struct vy_slice *first_slice = task->first_slice;
+	struct vy_slice *last_slice = task->last_slice;
+	struct vy_slice *slice, *new_slice;
+	struct vy_range *new_range;
+	struct vy_task *part;
+	struct vy_run *run;
+	int i;
+
+	assert(task->part_count > 1);
+
+	/*
+	 * Slices created for the parts reference compacted runs
+	 * so we must delete them before looking for unused runs.
+	 */
+	vy_task_compaction_cleanup(task);
+
+	/* See the comment in vy_task_compaction_complete(). */
+	if (lsm->is_dropped) {
+		for (i = 0; i < task->part_count; i++)
+			vy_run_unref(task->parts[i]->new_run);
+		assert(heap_node_is_stray(&range->heap_node));
+		vy_range_heap_insert(&lsm->range_heap, range);
+		vy_scheduler_update_lsm(scheduler, lsm);
+		return 0;
+	}
+
+	struct vy_range **new_ranges = calloc(task->part_count,
+					      sizeof(*new_ranges));
+	if (new_ranges == NULL) {
+		diag_set(OutOfMemory, task->part_count * sizeof(*new_ranges),
+			 "calloc", "struct vy_range *");
+		return -1;
+	}
+
+	/*
+	 * Allocate new ranges and fill them with slices.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_output);
+	for (i = 0; i < task->part_count; i++) {
+		part = task->parts[i];
+		vy_disk_stmt_counter_add(&compaction_output,
+					 &part->new_run->count);
+		new_range = vy_range_new(vy_log_next_id(), part->part_begin,
+					 part->part_end, lsm->cmp_def);
+		if (new_range == NULL)
+			goto fail;
+		new_ranges[i] = new_range;
+		/*
+		 * vy_range_add_slice() adds a slice to the list head,
+		 * so to preserve the order of the slices list, we have
+		 * to iterate backward.
+		 */
+		bool is_compacted = false;
+		rlist_foreach_entry_reverse(slice, &range->slices, in_range) {
+			if (slice == last_slice)
+				is_compacted = true;
+			if (!is_compacted) {
+				if (vy_slice_cut(slice, vy_log_next_id(),
+						 new_range->begin,
+						 new_range->end, lsm->cmp_def,
+						 &new_slice) != 0)
+					goto fail;
+				if (new_slice != NULL)
+					vy_range_add_slice(new_range,
+							   new_slice);
+				continue;
+			}
+			/*
+			 * Replace compacted slices with the new run
+			 * at the position of the newest of them.
+			 */
+			if (slice != first_slice)
+				continue;
+			is_compacted = false;
+			if (vy_run_is_empty(part->new_run))
+				continue;
+			new_slice = vy_slice_new(vy_log_next_id(),
+						 part->new_run,
+						 vy_entry_none(),
+						 vy_entry_none(),
+						 lsm->cmp_def);
+			if (new_slice == NULL)
+				goto fail;
+			vy_range_add_slice(new_range, new_slice);
+		}
+		new_range->n_compactions = range->n_compactions + 1;
+		vy_range_update_compaction_priority(new_range, &lsm->opts);
+		vy_range_update_dumps_per_compaction(new_range);
+	}
+
+	/*
+	 * Build the list of runs that became unused
+	 * as a result of compaction.
+	 */
+	RLIST_HEAD(unused_runs);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		slice->run->compacted_slice_count++;
+		if (slice == last_slice)
+			break;
+	}
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		run = slice->run;
+		if (run->compacted_slice_count == run->slice_count)
+			rlist_add_entry(&unused_runs, run, in_unused);
+		slice->run->compacted_slice_count = 0;
+		if (slice == last_slice)
+			break;
+	}
+
+	/*
+	 * Log change in metadata.
+	 */
+	vy_log_tx_begin();
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_log_delete_slice(slice->id);
+	vy_log_delete_range(range->id);
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_log_drop_run(run->id, VY_LOG_GC_LSN_CURRENT);
+	for (i = 0; i < task->part_count; i++) {
+		run = task->parts[i]->new_run;
+		if (!vy_run_is_empty(run))
+			vy_log_create_run(lsm->id, run->id, run->dump_lsn,
+					  run->dump_count);
+	}
+	for (i = 0; i < task->part_count; i++) {
+		new_range = new_ranges[i];
+		vy_log_insert_range(lsm->id, new_range->id,
+				    tuple_data_or_null(new_range->begin.stmt),
+				    tuple_data_or_null(new_range->end.stmt));
+		rlist_foreach_entry(slice, &new_range->slices, in_range)
+			vy_log_insert_slice(new_range->id, slice->run->id,
+					    slice->id,
+					    tuple_data_or_null(slice->begin.stmt),
+					    tuple_data_or_null(slice->end.stmt));
+	}
+	if (vy_log_tx_commit() < 0)
+		goto fail;
+
+	/*
+	 * Remove compacted run files that were created after
+	 * the last checkpoint immediately to save disk space,
+	 * see vy_task_compaction_complete().
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused) {
+		if (run->dump_lsn > vy_log_signature() ||
+		    scheduler->run_env->initial_join)
+			vy_run_remove_files(lsm->env->path, lsm->space_id,
+					    lsm->index_id, run->id);
+	}
+
+	/*
+	 * Account new runs that are not empty,
+	 * discard the rest.
+	 */
+	for (i = 0; i < task->part_count; i++) {
+		run = task->parts[i]->new_run;
+		if (!vy_run_is_empty(run)) {
+			vy_lsm_add_run(lsm, run);
+			/* Drop the reference held by the task. */
+			vy_run_unref(run);
+		} else {
+			vy_run_discard(run);
+		}
+	}
+
+	/*
+	 * Replace the compacted range with the new ranges and
+	 * account compaction in LSM tree statistics.
+	 */
+	vy_disk_stmt_counter_reset(&compaction_input);
+	for (slice = first_slice; ; slice = rlist_next_entry(slice, in_range)) {
+		vy_disk_stmt_counter_add(&compaction_input, &slice->count);
+		if (slice == last_slice)
+			break;
+	}
+	vy_lsm_unacct_range(lsm, range);
+	/* The range was removed from the heap when the task was created. */
+	assert(heap_node_is_stray(&range->heap_node));
+	vy_range_heap_insert(&lsm->range_heap, range);
+	vy_lsm_remove_range(lsm, range);
+	for (i = 0; i < task->part_count; i++) {
+		new_range = new_ranges[i];
+		vy_lsm_add_range(lsm, new_range);
+		vy_lsm_acct_range(lsm, new_range);
+	}
+	lsm->range_tree_version++;
+	vy_lsm_acct_compaction(lsm, compaction_time,
+			       &compaction_input, &compaction_output);
+	scheduler->stat.compaction_input += compaction_input.bytes;
+	scheduler->stat.compaction_output += compaction_output.bytes;
+	scheduler->stat.compaction_time += compaction_time;
+	free(new_ranges);
+
+	/*
+	 * Unaccount unused runs and delete the old range
+	 * along with its slices.
+	 */
+	rlist_foreach_entry(run, &unused_runs, in_unused)
+		vy_lsm_remove_run(lsm, run);
+	vy_scheduler_update_lsm(scheduler, lsm);
+
+	say_info("%s: completed compacting range %s in %d parts",
+		 vy_lsm_name(lsm), vy_range_str(range), task->part_count);
+
+	rlist_foreach_entry(slice, &range->slices, in_range)
+		vy_slice_wait_pinned(slice);
+	vy_range_delete(range);
+	return 0;
+fail:
+	for (i = 0; i < task->part_count; i++) {
+		if (new_ranges[i] != NULL)
+			vy_range_delete(new_ranges[i]);
+	}
+	free(new_ranges);
+	return -1;
 }
 
 static int
@@ -1461,6 +1781,9 @@ vy_task_compaction_complete(struct vy_task *task)
 	struct vy_slice *slice, *next_slice, *new_slice = NULL;
 	struct vy_run *run;
 
+	if (task->part_count > 0)
+		return vy_task_compaction_complete_parts(task);
+
 	/*
 	 * The LSM tree could have been dropped while we were writing the new
 	 * run. In this case we should discard the run without committing to
@@ -1601,8 +1924,7 @@ vy_task_compaction_complete(struct vy_task *task)
 		vy_slice_delete(slice);
 	}
 out:
-	/* The iterator has been cleaned up in worker. */
-	task->wi->iface->close(task->wi);
+	vy_task_compaction_cleanup(task);
 
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
@@ -1620,21 +1942,185 @@ vy_task_compaction_abort(struct vy_task *task)
 	struct vy_lsm *lsm = task->lsm;
 	struct vy_range *range = task->range;
 
-	/* The iterator has been cleaned up in worker. */
-	task->wi->iface->close(task->wi);
+	vy_task_compaction_cleanup(task);
 
 	struct error *e = diag_last_error(&task->diag);
 	error_log(e);
 	say_error("%s: failed to compact range %s",
 		  vy_lsm_name(lsm), vy_range_str(range));
 
-	vy_run_discard(task->new_run);
+	for (int i = 0; i < vy_task_part_count(task); i++)
+		vy_run_discard(vy_task_part(task, i)->new_run);
 
 	assert(heap_node_is_stray(&range->heap_node));
 	vy_range_heap_insert(&lsm->range_heap, range);
 	vy_scheduler_update_lsm(scheduler, lsm);
 }
 
+/**
+ * Split a compaction task into parts (subcompactions) that will
+ * be executed by different worker threads in parallel.
+ *
+ * Part boundaries are chosen among min keys of the pages of the
+ * oldest compacted run. Each part is supposed to produce a run
+ * of at least range_size bytes so that the ranges created out of
+ * the parts upon completion aren't coalesced back right away.
+ * The number of parts is also limited by the number of idle
+ * compaction workers and box.cfg.vinyl_max_subcompactions.
+ *
+ * It isn't an error if the task can't be split: in this case
+ * the task is left as is. Returns -1 and sets diag on failure.
+ * Parts allocated by this function are freed with the task.
+ */
+static int
+vy_task_compaction_split(struct vy_task *task)
+{
+	struct vy_scheduler *scheduler = task->scheduler;
+	struct vy_lsm *lsm = task->lsm;
+	struct vy_range *range = task->range;
+	struct vy_slice *last_slice = task->last_slice;
+	struct vy_slice *slice;
+
+	assert(task->part_count == 0);
+	if (scheduler->max_subcompactions <= 1 || last_slice->count.pages == 0)
+		return 0;
+
+	uint64_t input_size = 0;
+	for (slice = task->first_slice; ;
+	     slice = rlist_next_entry(slice, in_range)) {
+		input_size += slice->count.bytes;
+		if (slice == last_slice)
+			break;
+	}
+	uint32_t page_count = last_slice->last_page_no -
+			      last_slice->first_page_no + 1;
+	uint64_t max_part_count = input_size / vy_lsm_range_size(lsm);
+	max_part_count = MIN(max_part_count, page_count);
+	max_part_count = MIN(max_part_count,
+			     (uint64_t)scheduler->max_subcompactions);
+	int part_count = max_part_count;
+	if (part_count <= 1)
+		return 0;
+
+	task->parts = calloc(part_count, sizeof(*task->parts));
+	if (task->parts == NULL) {
+		diag_set(OutOfMemory, part_count * sizeof(*task->parts),
+			 "calloc", "struct vy_task *");
+		return -1;
+	}
+	task->parts[0] = task;
+	task->part_count = 1;
+	task->part_begin = range->begin;
+	if (range->begin.stmt != NULL)
+		tuple_ref(range->begin.stmt);
+
+	struct vy_task *prev = task;
+	for (int i = 1; i < part_count; i++) {
+		uint32_t page_no = last_slice->first_page_no +
+				   (uint64_t)page_count * i / part_count;
+		struct vy_page_info *page = vy_run_page_info(last_slice->run,
+							     page_no);
+		/* Part boundaries must grow and lie within the range. */
+		if (prev->part_begin.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(prev->part_begin,
+						  page->min_key,
+						  page->min_key_hint,
+						  lsm->cmp_def) >= 0)
+			continue;
+		if (range->end.stmt != NULL &&
+		    vy_entry_compare_with_raw_key(range->end, page->min_key,
+						  page->min_key_hint,
+						  lsm->cmp_def) <= 0)
+			break;
+		struct vy_worker *worker;
+		worker = vy_worker_pool_get(&scheduler->compaction_pool);
+		if (worker == NULL)
+			break; /* all workers are busy */
+		struct vy_task *part = vy_task_new(scheduler, worker, lsm,
+						   task->ops);
+		if (part == NULL) {
+			vy_worker_pool_put(worker);
+			return -1;
+		}
+		task->parts[task->part_count++] = part;
+		part->parent = task;
+		part->range = range;
+		part->bloom_fpr = task->bloom_fpr;
+		part->page_size = task->page_size;
+		part->compression_level = task->compression_level;
+		part->part_begin = vy_entry_key_from_msgpack(
+				lsm->env->key_format, lsm->cmp_def,
+				page->min_key);
+		if (part->part_begin.stmt == NULL)
+			return -1;
+		prev->part_end = part->part_begin;
+		tuple_ref(prev->part_end.stmt);
+		part->new_run = vy_run_prepare(scheduler->run_env, lsm);
+		if (part->new_run == NULL)
+			return -1;
+		part->new_run->dump_lsn = task->new_run->dump_lsn;
+		part->new_run->dump_count = task->new_run->dump_count;
+		task->parts_in_progress++;
+		prev = part;
+	}
+	if (task->part_count == 1) {
+		/* No suitable boundary or idle worker, don't split. */
+		free(task->parts);
+		task->parts = NULL;
+		task->part_count = 0;
+		if (task->part_begin.stmt != NULL)
+			tuple_unref(task->part_begin.stmt);
+		task->part_begin = vy_entry_none();
+		return 0;
+	}
+	prev->part_end = range->end;
+	if (range->end.stmt != NULL)
+		tuple_ref(range->end.stmt);
+	return 0;
+}
+
+/**
+ * Create a write iterator for a compaction task part. If the task
+ * was split, compacted slices are cut by the part boundaries.
+ */
+static int
+vy_task_compaction_create_wi(struct vy_task *part, bool is_last_level)
+{
+	struct vy_task *task = part->parent != NULL ? part->parent : part;
+	struct vy_lsm *lsm = part->lsm;
+	struct vy_stmt_stream *wi;
+	wi = vy_write_iterator_new(part->cmp_def, lsm->index_id == 0,
+				   lsm->opts.covering, is_last_level,
+				   part->scheduler->read_views,
+				   lsm->index_id > 0 ? NULL :
+				   &part->deferred_delete_handler);
+	if (wi == NULL)
+		return -1;
+
+	struct vy_slice *slice = task->first_slice;
+	while (true) {
+		struct vy_slice *src = slice;
+		if (task->part_count > 0 &&
+		    vy_slice_cut(slice, vy_log_next_id(), part->part_begin,
+				 part->part_end, lsm->cmp_def, &src) != 0)
+			goto fail;
+		if (src != NULL && src != slice)
+			rlist_add_tail_entry(&part->part_slices, src, in_range);
+		if (src != NULL &&
+		    vy_write_iterator_new_slice(wi, src,
+						lsm->disk_format) != 0)
+			goto fail;
+		if (slice == task->last_slice)
+			break;
+		slice = rlist_next_entry(slice, in_range);
+	}
+	part->wi = wi;
+	return 0;
+fail:
+	wi->iface->close(wi);
+	return -1;
+}
+
 static int
 vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 		       struct vy_lsm *lsm, struct vy_task **p_task)
@@ -1664,22 +2150,10 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	if (new_run == NULL)
 		goto err_run;
 
-	struct vy_stmt_stream *wi;
-	bool is_last_level = (range->compaction_priority == range->slice_count);
-	wi = vy_write_iterator_new(task->cmp_def, lsm->index_id == 0,
-				   is_last_level, scheduler->read_views,
-				   lsm->index_id > 0 ? NULL :
-				   &task->deferred_delete_handler);
-	if (wi == NULL)
-		goto err_wi;
-
 	struct vy_slice *slice;
 	int32_t dump_count = 0;
 	int n = range->compaction_priority;
 	rlist_foreach_entry(slice, &range->slices, in_range) {
-		if (vy_write_iterator_new_slice(wi, slice,
-						lsm->disk_format) != 0)
-			goto err_wi_sub;
 		new_run->dump_lsn = MAX(new_run->dump_lsn,
 					slice->run->dump_lsn);
 		dump_count += slice->run->dump_count;
@@ -1705,13 +2179,23 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	else
 		new_run->dump_count = dump_count;
 
-	range->needs_compaction = false;
-
 	task->range = range;
 	task->new_run = new_run;
-	task->wi = wi;
 	task->bloom_fpr = lsm->opts.bloom_fpr;
 	task->page_size = lsm->opts.page_size;
+	task->compression_level = lsm->opts.compression_level;
+
+	if (vy_task_compaction_split(task) != 0)
+		goto err_wi;
+
+	bool is_last_level = (range->compaction_priority == range->slice_count);
+	for (int i = 0; i < vy_task_part_count(task); i++) {
+		if (vy_task_compaction_create_wi(vy_task_part(task, i),
+						 is_last_level) != 0)
+			goto err_wi;
+	}
+
+	range->needs_compaction = false;
 
 	/*
 	 * Remove the range we are going to compact from the heap
@@ -1723,12 +2207,22 @@ vy_task_compaction_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	say_info("%s: started compacting range %s, runs %d/%d",
 		 vy_lsm_name(lsm), vy_range_str(range),
                  range->compaction_priority, range->slice_count);
+	if (task->part_count > 0) {
+		say_info("%s: split compaction of range %s in %d parts",
+			 vy_lsm_name(lsm), vy_range_str(range),
+			 task->part_count);
+	}
 	*p_task = task;
 	return 0;
 
-err_wi_sub:
-	task->wi->iface->close(wi);
 err_wi:
+	vy_task_compaction_cleanup(task);
+	for (int i = 1; i < task->part_count; i++) {
+		struct vy_task *part = task->parts[i];
+		if (part->new_run != NULL)
+			vy_run_discard(part->new_run);
+		vy_worker_pool_put(part->worker);
+	}
 	vy_run_discard(new_run);
 err_run:
 	vy_task_delete(task);
@@ -1803,6 +2297,15 @@ static void
 vy_task_complete_f(struct cmsg *cmsg)
 {
 	struct vy_task *task = container_of(cmsg, struct vy_task, cmsg);
+	/*
+	 * A task that was split into parts can't be completed
+	 * until all its parts have been executed.
+	 */
+	if (task->parent != NULL)
+		task = task->parent;
+	assert(task->parts_in_progress > 0);
+	if (--task->parts_in_progress > 0)
+		return;
 	stailq_add_tail_entry(&task->scheduler->processed_tasks,
 			      task, in_processed);
 	fiber_cond_signal(&task->scheduler->scheduler_cond);
@@ -1971,6 +2474,15 @@ vy_task_complete(struct vy_task *task)
 	scheduler->stat.tasks_inprogress--;
 
 	struct diag *diag = &task->diag;
+	for (int i = 1; i < task->part_count; i++) {
+		struct vy_task *part = task->parts[i];
+		if (part->is_failed && !task->is_failed) {
+			/* A subcompaction failed, fail the whole task. */
+			assert(!diag_is_empty(&part->diag));
+			diag_move(&part->diag, diag);
+			task->is_failed = true;
+		}
+	}
 	if (task->is_failed) {
 		assert(!diag_is_empty(diag));
 		goto fail; /* ->execute fialed */
@@ -2017,6 +2529,8 @@ vy_scheduler_f(va_list va)
 				tasks_failed++;
 			else
 				tasks_done++;
+			for (int i = 1; i < task->part_count; i++)
+				vy_worker_pool_put(task->parts[i]->worker);
 			vy_worker_pool_put(task->worker);
 			vy_task_delete(task);
 		}
@@ -2052,6 +2566,11 @@ vy_scheduler_f(va_list va)
 		/* Queue the task for execution. */
 		cmsg_init(&task->cmsg, vy_task_execute_route);
 		cpipe_push(&task->worker->worker_pipe, &task->cmsg);
+		for (int i = 1; i < task->part_count; i++) {
+			struct vy_task *part = task->parts[i];
+			cmsg_init(&part->cmsg, vy_task_execute_route);
+			cpipe_push(&part->worker->worker_pipe, &part->cmsg);
+		}
 
 		fiber_reschedule();
 		continue;
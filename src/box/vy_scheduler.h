@@ -78,6 +78,12 @@ struct vy_scheduler {
 	struct vy_worker_pool dump_pool;
 	/** Pool of threads for performing background compactions. */
 	struct vy_worker_pool compaction_pool;
+	/**
+	 * Max number of parts a compaction task may be split into
+	 * so that they are executed by different worker threads in
+	 * parallel (see box.cfg.vinyl_max_subcompactions).
+	 */
+	int max_subcompactions;
 	/** Queue of processed tasks, linked by vy_task::in_processed. */
 	struct stailq processed_tasks;
 	/**
@@ -94,6 +94,20 @@ struct vy_run_iterator_stat {
 	 * prevent a disk read.
 	 */
 	int64_t bloom_miss;
+	/**
+	 * Number of times a bloom filter had to be loaded from
+	 * disk, because it had been dropped from memory due to
+	 * the bloom filter memory limit.
+	 */
+	int64_t bloom_load;
+	/** Number of pages scheduled for reading ahead. */
+	int64_t read_ahead_pages;
+	/**
+	 * Number of times a page requested by the iterator
+	 * had been read ahead and so didn't have to be read
+	 * synchronously.
+	 */
+	int64_t read_ahead_hit;
 	/**
 	 * Number of statements actually read from the disk.
 	 * It may be greater than the number of statements
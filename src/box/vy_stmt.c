@@ -624,9 +624,14 @@ vy_stmt_meta_decode(struct request *request, struct tuple *stmt)
 	}
 }
 
-int
-vy_stmt_encode_primary(struct tuple *value, struct key_def *key_def,
-		       uint32_t space_id, struct xrow_header *xrow)
+/**
+ * Encode a full statement (not just its key) as xrow_header.
+ * Used for primary and covering secondary index runs.
+ */
+static int
+vy_stmt_encode_full(struct tuple *value, struct key_def *key_def,
+		    uint32_t space_id, bool is_primary,
+		    struct xrow_header *xrow)
 {
 	memset(xrow, 0, sizeof(*xrow));
 	enum iproto_type type = vy_stmt_type(value);
@@ -665,7 +670,7 @@ vy_stmt_encode_primary(struct tuple *value, struct key_def *key_def,
 	default:
 		unreachable();
 	}
-	if (vy_stmt_meta_encode(value, &request, true) != 0)
+	if (vy_stmt_meta_encode(value, &request, is_primary) != 0)
 		return -1;
 	xrow->bodycnt = xrow_encode_dml(&request, &fiber()->gc, xrow->body);
 	if (xrow->bodycnt < 0)
@@ -673,6 +678,22 @@ vy_stmt_encode_primary(struct tuple *value, struct key_def *key_def,
 	return 0;
 }
 
+int
+vy_stmt_encode_primary(struct tuple *value, struct key_def *key_def,
+		       uint32_t space_id, struct xrow_header *xrow)
+{
+	return vy_stmt_encode_full(value, key_def, space_id, true, xrow);
+}
+
+int
+vy_stmt_encode_covering(struct tuple *value, struct key_def *cmp_def,
+			struct xrow_header *xrow)
+{
+	/* Secondary indexes never store UPSERTs. */
+	assert(vy_stmt_type(value) != IPROTO_UPSERT);
+	return vy_stmt_encode_full(value, cmp_def, 0, false, xrow);
+}
+
 int
 vy_stmt_encode_secondary(struct tuple *value, struct key_def *cmp_def,
 			 int multikey_idx, struct xrow_header *xrow)
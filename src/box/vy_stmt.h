@@ -676,6 +676,21 @@ int
 vy_stmt_encode_secondary(struct tuple *value, struct key_def *cmp_def,
 			 int multikey_idx, struct xrow_header *xrow);
 
+/**
+ * Encode vy_stmt for a covering secondary key as xrow_header.
+ * Unlike vy_stmt_encode_secondary(), stores full tuples.
+ *
+ * @param value statement to encode
+ * @param cmp_def key definition
+ * @param xrow[out] xrow to fill
+ *
+ * @retval 0 if OK
+ * @retval -1 if error
+ */
+int
+vy_stmt_encode_covering(struct tuple *value, struct key_def *cmp_def,
+			struct xrow_header *xrow);
+
 /**
  * Reconstruct vinyl tuple info and data from xrow
  *
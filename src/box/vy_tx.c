@@ -1111,7 +1111,8 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 	if (old == NULL && vy_stmt_type(entry.stmt) == IPROTO_INSERT)
 		v->is_first_insert = true;
 
-	if (lsm->index_id > 0 && old != NULL && !old->is_nop &&
+	if (lsm->index_id > 0 && !lsm->opts.covering &&
+	    old != NULL && !old->is_nop &&
 	    !vy_lsm_is_being_constructed(lsm)) {
 		/*
 		 * In a secondary index write set, DELETE statement purges
@@ -1134,6 +1135,9 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 		 * vinyl_space_build_index() as featuring bumped lsn).
 		 * Finally, we'll get missing tuple in secondary index after
 		 * it is built.
+		 *
+		 * Covering indexes store full tuples so the optimization
+		 * isn't applicable to them either.
 		 */
 		enum iproto_type type = vy_stmt_type(entry.stmt);
 		enum iproto_type old_type = vy_stmt_type(old->entry.stmt);
@@ -181,6 +181,11 @@ struct vy_write_iterator {
 	 * key and its tuple format is different.
 	 */
 	bool is_primary;
+	/**
+	 * Set if this iterator is for a covering secondary index,
+	 * which stores full tuples.
+	 */
+	bool is_covering;
 	/** Deferred DELETE handler. */
 	struct vy_deferred_delete_handler *deferred_delete_handler;
 	/**
@@ -344,7 +349,8 @@ static const struct vy_stmt_stream_iface vy_slice_stream_iface;
  */
 struct vy_stmt_stream *
 vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
-		      bool is_last_level, struct rlist *read_views,
+		      bool is_covering, bool is_last_level,
+		      struct rlist *read_views,
 		      struct vy_deferred_delete_handler *handler)
 {
 	/*
@@ -387,6 +393,7 @@ vy_write_iterator_new(struct key_def *cmp_def, bool is_primary,
 	rlist_create(&stream->src_list);
 	stream->cmp_def = cmp_def;
 	stream->is_primary = is_primary;
+	stream->is_covering = is_covering;
 	stream->is_last_level = is_last_level;
 	stream->deferred_delete_handler = handler;
 	stream->deferred_delete = vy_entry_none();
@@ -712,12 +719,15 @@ vy_write_iterator_build_history(struct vy_write_iterator *stream,
 	while (true) {
 		*is_first_insert = vy_stmt_type(src->entry.stmt) == IPROTO_INSERT;
 
-		if (!stream->is_primary &&
+		if (!stream->is_primary && !stream->is_covering &&
 		    (vy_stmt_flags(src->entry.stmt) & VY_STMT_UPDATE) != 0) {
 			/*
 			 * If a REPLACE stored in a secondary index was
 			 * generated by an update operation, it can be
-			 * turned into an INSERT.
+			 * turned into an INSERT. This doesn't apply to
+			 * covering indexes, because an update that
+			 * doesn't touch secondary key parts overwrites
+			 * the old tuple there.
 			 */
 			*is_first_insert = true;
 		}
@@ -30,7 +30,10 @@
  */
 #include "wal.h"
 
+#include <sys/stat.h>
+
 #include "fiber.h"
+#include "fiber_cond.h"
 #include "fio.h"
 #include "errinj.h"
 #include "error.h"
@@ -156,6 +159,27 @@ struct wal_writer
 	 * is in progress.
 	 */
 	bool checkpoint_triggered;
+	/**
+	 * WAL retention size: when the total size of WAL files
+	 * stored in the WAL directory exceeds the value of this
+	 * variable, the oldest files that aren't needed to recover
+	 * from the last checkpoint are moved to the archive
+	 * directory, see wal_archive_files(). Zero means no limit.
+	 */
+	int64_t retention_size;
+	/**
+	 * Fiber that moves old WAL files to the archive directory.
+	 * It runs in the WAL thread, but the files are renamed or
+	 * copied in the coio thread pool so as not to stall writes.
+	 */
+	struct fiber *archive_fiber;
+	/** Signaled to wake up the archive fiber. */
+	struct fiber_cond archive_cond;
+	/**
+	 * Set if the archive fiber should check the size of WAL
+	 * files once again, e.g. after a WAL rotation.
+	 */
+	bool archive_requested;
 	/** The current WAL file. */
 	struct xlog current_wal;
 	/**
@@ -210,6 +234,13 @@ wal_dir(void)
 	return wal_writer_singleton.wal_dir.dirname;
 }
 
+const char *
+wal_archive_dir(void)
+{
+	const char *dirname = wal_writer_singleton.wal_dir.archive_dirname;
+	return *dirname != '\0' ? dirname : NULL;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg);
 
@@ -413,7 +444,8 @@ tx_notify_checkpoint(struct cmsg *msg)
  */
 static void
 wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
-		  const char *wal_dirname, int64_t wal_max_size,
+		  const char *wal_dirname, const char *wal_archive_dirname,
+		  int64_t wal_max_size,
 		  const struct tt_uuid *instance_uuid,
 		  wal_on_garbage_collection_f on_garbage_collection,
 		  wal_on_checkpoint_threshold_f on_checkpoint_threshold)
@@ -430,6 +462,7 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	struct xlog_opts opts = xlog_opts_default;
 	opts.sync_is_async = true;
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid, &opts);
+	xdir_set_archive(&writer->wal_dir, wal_archive_dirname);
 	xlog_clear(&writer->current_wal);
 	if (wal_mode == WAL_FSYNC)
 		writer->wal_dir.open_wflags |= O_SYNC;
@@ -440,6 +473,10 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 	writer->checkpoint_wal_size = 0;
 	writer->checkpoint_threshold = INT64_MAX;
 	writer->checkpoint_triggered = false;
+	writer->retention_size = 0;
+	writer->archive_fiber = NULL;
+	fiber_cond_create(&writer->archive_cond);
+	writer->archive_requested = false;
 
 	vclock_create(&writer->vclock);
 	vclock_create(&writer->checkpoint_vclock);
@@ -534,14 +571,15 @@ wal_open(struct wal_writer *writer)
 
 int
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+	 const char *wal_archive_dirname, int64_t wal_max_size,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold)
 {
 	/* Initialize the state. */
 	struct wal_writer *writer = &wal_writer_singleton;
-	wal_writer_create(writer, wal_mode, wal_dirname, wal_max_size,
-			  instance_uuid, on_garbage_collection,
+	wal_writer_create(writer, wal_mode, wal_dirname, wal_archive_dirname,
+			  wal_max_size, instance_uuid, on_garbage_collection,
 			  on_checkpoint_threshold);
 
 	/* Start WAL thread. */
@@ -704,6 +742,104 @@ wal_begin_checkpoint(struct wal_checkpoint *checkpoint)
 	return 0;
 }
 
+/** Move a WAL file to the archive, see xdir_archive_file(). */
+static ssize_t
+wal_archive_file_f(va_list ap)
+{
+	struct xdir *dir = va_arg(ap, struct xdir *);
+	int64_t signature = va_arg(ap, int64_t);
+	return xdir_archive_file(dir, signature);
+}
+
+/**
+ * Move the oldest WAL files to the archive directory until the
+ * total size of WAL files left in the WAL directory fits in the
+ * retention size. Files that are needed to recover from the last
+ * checkpoint and the current WAL file are never moved. Archived
+ * files are still indexed so that they are garbage collected as
+ * usual once all consumers are done with them.
+ *
+ * Files are moved from the coio thread pool. Since the directory
+ * index may change while we are waiting for a file to be moved,
+ * it is looked up anew for each file.
+ */
+static void
+wal_archive_files(struct wal_writer *writer)
+{
+	struct xdir *dir = &writer->wal_dir;
+	while (writer->retention_size > 0 && dir->archive_dirname[0] != '\0') {
+		int64_t checkpoint_lsn = vclock_sum(&writer->checkpoint_vclock);
+		int64_t total_size = 0;
+		int64_t signature = -1;
+		bool is_first = true;
+		struct stat st;
+		struct vclock *vclock;
+		for (vclock = vclockset_first(&dir->index); vclock != NULL;
+		     vclock = vclockset_next(&dir->index, vclock)) {
+			const char *filename = xdir_format_filename(
+				dir, vclock_sum(vclock), NONE);
+			if (stat(filename, &st) != 0) {
+				/* Already archived. */
+				continue;
+			}
+			total_size += st.st_size;
+			if (!is_first)
+				continue;
+			is_first = false;
+			/*
+			 * A file contains rows up to the signature of
+			 * the next file so it's needed for recovery
+			 * unless the next file starts before the
+			 * checkpoint.
+			 */
+			struct vclock *next = vclockset_next(&dir->index,
+							     vclock);
+			if (next != NULL && vclock_sum(next) <= checkpoint_lsn)
+				signature = vclock_sum(vclock);
+		}
+		if (signature < 0 || total_size <= writer->retention_size)
+			break;
+		if (coio_call(wal_archive_file_f, dir, signature) != 0) {
+			diag_log();
+			break;
+		}
+		/*
+		 * The file could have been garbage collected while
+		 * it was being moved, in which case the archived
+		 * copy isn't indexed and must be removed.
+		 */
+		vclock = vclockset_first(&dir->index);
+		if (vclock == NULL || vclock_sum(vclock) > signature) {
+			const char *filename = xdir_find_filename(dir,
+								  signature);
+			eio_unlink(filename, 0, NULL, NULL);
+		}
+	}
+}
+
+/** Wake up the archive fiber, see wal_archive_files(). */
+static void
+wal_schedule_archive(struct wal_writer *writer)
+{
+	writer->archive_requested = true;
+	fiber_cond_signal(&writer->archive_cond);
+}
+
+static int
+wal_archive_f(va_list ap)
+{
+	struct wal_writer *writer = va_arg(ap, struct wal_writer *);
+	while (!fiber_is_cancelled()) {
+		if (!writer->archive_requested) {
+			fiber_cond_wait(&writer->archive_cond);
+			continue;
+		}
+		writer->archive_requested = false;
+		wal_archive_files(writer);
+	}
+	return 0;
+}
+
 static int
 wal_commit_checkpoint_f(struct cbus_call_msg *data)
 {
@@ -723,6 +859,7 @@ wal_commit_checkpoint_f(struct cbus_call_msg *data)
 	assert(writer->checkpoint_wal_size >= msg->wal_size);
 	writer->checkpoint_wal_size -= msg->wal_size;
 	writer->checkpoint_triggered = false;
+	wal_schedule_archive(writer);
 	return 0;
 }
 
@@ -771,6 +908,37 @@ wal_set_checkpoint_threshold(int64_t threshold)
 	fiber_set_cancellable(cancellable);
 }
 
+struct wal_set_retention_size_msg {
+	struct cbus_call_msg base;
+	int64_t retention_size;
+};
+
+static int
+wal_set_retention_size_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_retention_size_msg *msg;
+	msg = (struct wal_set_retention_size_msg *)data;
+	writer->retention_size = msg->retention_size;
+	wal_schedule_archive(writer);
+	return 0;
+}
+
+void
+wal_set_retention_size(int64_t size)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_retention_size_msg msg;
+	msg.retention_size = size;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg.base, wal_set_retention_size_f, NULL,
+		  TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
 void
 wal_set_queue_max_size(int64_t size)
 {
@@ -872,6 +1040,7 @@ wal_opt_rotate(struct wal_writer *writer)
 	xdir_add_vclock(&writer->wal_dir, &writer->vclock);
 
 	wal_notify_watchers(writer, WAL_EVENT_ROTATE);
+	wal_schedule_archive(writer);
 	return 0;
 }
 
@@ -1210,8 +1379,18 @@ wal_writer_f(va_list ap)
 	 */
 	cpipe_create(&writer->tx_prio_pipe, "tx_prio");
 
+	writer->archive_fiber = fiber_new("wal_archive", wal_archive_f);
+	if (writer->archive_fiber == NULL)
+		panic("failed to start WAL archive fiber");
+	fiber_set_joinable(writer->archive_fiber, true);
+	fiber_start(writer->archive_fiber, writer);
+
 	cbus_loop(&endpoint);
 
+	fiber_cancel(writer->archive_fiber);
+	fiber_join(writer->archive_fiber);
+	writer->archive_fiber = NULL;
+
 	/*
 	 * Create a new empty WAL on shutdown so that we don't
 	 * have to rescan the last WAL to find the instance vclock.
@@ -98,10 +98,13 @@ typedef void (*wal_on_checkpoint_threshold_f)(void);
 
 /**
  * Start WAL thread and initialize WAL writer.
+ * @wal_archive_dirname is the directory old WAL files are moved
+ * to when the retention size is exceeded, NULL if none.
  */
 int
 wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+	 const char *wal_archive_dirname, int64_t wal_max_size,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold);
 
@@ -124,6 +127,14 @@ wal_free(void);
 const char *
 wal_dir(void);
 
+/**
+ * Get WAL archive directory path or NULL if WAL archiving is
+ * disabled. Like wal_dir(), never changes after box is configured
+ * first time.
+ */
+const char *
+wal_archive_dir(void);
+
 struct wal_watcher_msg {
 	struct cmsg cmsg;
 	struct wal_watcher *watcher;
@@ -256,6 +267,14 @@ wal_commit_checkpoint(struct wal_checkpoint *checkpoint);
 void
 wal_set_checkpoint_threshold(int64_t threshold);
 
+/**
+ * Set the WAL retention size: once the total size of WAL files
+ * stored in the WAL directory exceeds it, old files are moved to
+ * the WAL archive directory. Zero means no limit.
+ */
+void
+wal_set_retention_size(int64_t size);
+
 /**
  * Set the pending write limit in bytes. Once the limit is reached, new
  * writes are blocked until some previous writes succeed.
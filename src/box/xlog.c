@@ -96,6 +96,7 @@ const struct xlog_opts xlog_opts_default = {
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.compression_level = XLOG_COMPRESSION_LEVEL_DEFAULT,
 };
 
 /* {{{ struct xlog_meta */
@@ -361,6 +362,13 @@ xdir_create(struct xdir *dir, const char *dirname, enum xdir_type type,
 	dir->type = type;
 }
 
+void
+xdir_set_archive(struct xdir *dir, const char *archive_dirname)
+{
+	snprintf(dir->archive_dirname, sizeof(dir->archive_dirname), "%s",
+		 archive_dirname != NULL ? archive_dirname : "");
+}
+
 /**
  * Delete all members from the set of vector clocks.
  */
@@ -439,8 +447,13 @@ int
 xdir_open_cursor(struct xdir *dir, int64_t signature,
 		 struct xlog_cursor *cursor)
 {
-	const char *filename = xdir_format_filename(dir, signature, NONE);
+	const char *filename = xdir_find_filename(dir, signature);
 	int fd = open(filename, O_RDONLY);
+	if (fd < 0 && errno == ENOENT && dir->archive_dirname[0] != '\0') {
+		/* The file may have just been moved to the archive. */
+		filename = xdir_find_filename(dir, signature);
+		fd = open(filename, O_RDONLY);
+	}
 	if (fd < 0) {
 		diag_set(SystemError, "failed to open '%s' file", filename);
 		return -1;
@@ -477,64 +490,27 @@ xdir_open_cursor(struct xdir *dir, int64_t signature,
 }
 
 /**
- * Scan (or rescan) a directory with snapshot or write ahead logs.
- * Read all files matching a pattern from the directory -
- * the filename pattern is \d+.xlog
- * The name of the file is based on its vclock signature,
- * which is the sum of all elements in the vector clock recorded
- * when the file was created. Elements in the vector
- * reflect log sequence numbers of replicas in the asynchronous
- * replication set (see also _cluster system space and vclock.h
- * comments).
- *
- * @param dir - directory to scan
- * @param is_dir_required - flag set if the directory should exist
- *
- * @return:
- *   0 - on success or flag 'is_dir_required' was set to False in
- *   xdir_scan() arguments and opendir() failed with errno ENOENT;
- *   -1 - if opendir() failed, with other than ENOENT errno either
- *   when 'is_dir_required' was set to True in xdir_scan() arguments.
- *
- * This function tries to avoid re-reading a file if
- * it is already in the set of files "known" to the log
- * dir object. This is done to speed up local hot standby and
- * recovery_follow_local(), which periodically rescan the
- * directory to discover newly created logs.
- *
- * On error, this function throws an exception. If
- * dir->force_recovery is true, *some* errors are not
- * propagated up but only logged in the error log file.
- *
- * The list of errors ignored in force_recovery = true mode
- * includes:
- * - a file can not be opened
- * - some of the files have incorrect metadata (such files are
- *   skipped)
- *
- * The goal of force_recovery = true mode is partial recovery
- * from a damaged/incorrect data directory. It doesn't
- * silence conditions such as out of memory or lack of OS
- * resources.
+ * Append signatures of all log files found in a directory to
+ * a dynamic array.
  *
+ * Returns 0 on success, 1 if the directory doesn't exist and
+ * @is_dir_required is unset, -1 on error.
  */
-int
-xdir_scan(struct xdir *dir, bool is_dir_required)
+static int
+xdir_read_signatures(struct xdir *dir, const char *dirname,
+		     bool is_dir_required, int64_t **signatures,
+		     size_t *s_count, size_t *s_capacity)
 {
-	DIR *dh = opendir(dir->dirname);        /* log dir */
-	int64_t *signatures = NULL;             /* log file names */
-	size_t s_count = 0, s_capacity = 0;
-
+	DIR *dh = opendir(dirname);
 	if (dh == NULL) {
 		if (!is_dir_required && errno == ENOENT)
-			return 0;
+			return 1;
 		diag_set(SystemError, "error reading directory '%s'",
-			  dir->dirname);
+			  dirname);
 		return -1;
 	}
 
 	int rc = -1;
-	struct vclock *vclock;
 	struct dirent *dent;
 	/*
 	  A note regarding thread safety, readdir vs. readdir_r:
@@ -575,21 +551,107 @@ xdir_scan(struct xdir *dir, bool is_dir_required)
 			continue;
 		}
 
-		if (s_count == s_capacity) {
-			s_capacity = s_capacity > 0 ? 2 * s_capacity : 16;
-			size_t size = sizeof(*signatures) * s_capacity;
-			signatures = (int64_t *) realloc(signatures, size);
-			if (signatures == NULL) {
+		if (*s_count == *s_capacity) {
+			*s_capacity = *s_capacity > 0 ? 2 * *s_capacity : 16;
+			size_t size = sizeof(**signatures) * *s_capacity;
+			int64_t *new_signatures =
+				(int64_t *) realloc(*signatures, size);
+			if (new_signatures == NULL) {
 				diag_set(OutOfMemory,
 					  size, "realloc", "signatures array");
 				goto exit;
 			}
+			*signatures = new_signatures;
 		}
-		signatures[s_count++] = signature;
+		(*signatures)[(*s_count)++] = signature;
 	}
+	rc = 0;
+exit:
+	closedir(dh);
+	return rc;
+}
+
+/**
+ * Scan (or rescan) a directory with snapshot or write ahead logs.
+ * Read all files matching a pattern from the directory -
+ * the filename pattern is \d+.xlog
+ * The name of the file is based on its vclock signature,
+ * which is the sum of all elements in the vector clock recorded
+ * when the file was created. Elements in the vector
+ * reflect log sequence numbers of replicas in the asynchronous
+ * replication set (see also _cluster system space and vclock.h
+ * comments).
+ *
+ * If the directory has an archive, files stored in the archive
+ * are indexed too.
+ *
+ * @param dir - directory to scan
+ * @param is_dir_required - flag set if the directory should exist
+ *
+ * @return:
+ *   0 - on success or flag 'is_dir_required' was set to False in
+ *   xdir_scan() arguments and opendir() failed with errno ENOENT;
+ *   -1 - if opendir() failed, with other than ENOENT errno either
+ *   when 'is_dir_required' was set to True in xdir_scan() arguments.
+ *
+ * This function tries to avoid re-reading a file if
+ * it is already in the set of files "known" to the log
+ * dir object. This is done to speed up local hot standby and
+ * recovery_follow_local(), which periodically rescan the
+ * directory to discover newly created logs.
+ *
+ * On error, this function throws an exception. If
+ * dir->force_recovery is true, *some* errors are not
+ * propagated up but only logged in the error log file.
+ *
+ * The list of errors ignored in force_recovery = true mode
+ * includes:
+ * - a file can not be opened
+ * - some of the files have incorrect metadata (such files are
+ *   skipped)
+ *
+ * The goal of force_recovery = true mode is partial recovery
+ * from a damaged/incorrect data directory. It doesn't
+ * silence conditions such as out of memory or lack of OS
+ * resources.
+ *
+ */
+int
+xdir_scan(struct xdir *dir, bool is_dir_required)
+{
+	int64_t *signatures = NULL;             /* log file names */
+	size_t s_count = 0, s_capacity = 0;
+	struct vclock *vclock;
+	int rc = xdir_read_signatures(dir, dir->dirname, is_dir_required,
+				      &signatures, &s_count, &s_capacity);
+	if (rc > 0) {
+		/* Missing directory is allowed, nothing to do. */
+		rc = 0;
+		goto exit;
+	}
+	if (rc < 0)
+		goto exit;
+	rc = -1;
+	if (dir->archive_dirname[0] != '\0' &&
+	    xdir_read_signatures(dir, dir->archive_dirname, is_dir_required,
+				 &signatures, &s_count, &s_capacity) < 0)
+		goto exit;
+
 	/** Sort the list of files */
 	if (s_count > 1)
 		qsort(signatures, s_count, sizeof(*signatures), cmp_i64);
+	/*
+	 * A file may be present in both the main directory and
+	 * the archive while it's being moved. Index it only once.
+	 */
+	if (dir->archive_dirname[0] != '\0' && s_count > 1) {
+		size_t n = 1;
+		for (size_t i = 1; i < s_count; i++) {
+			if (signatures[i] != signatures[n - 1])
+				signatures[n++] = signatures[i];
+		}
+		s_count = n;
+	}
 	/**
 	 * Update the log dir index with the current state:
 	 * remove files which no longer exist, add files which
@@ -630,7 +692,6 @@ xdir_scan(struct xdir *dir, bool is_dir_required)
 	rc = 0;
 
 exit:
-	closedir(dh);
 	free(signatures);
 	return rc;
 }
@@ -658,6 +719,106 @@ xdir_format_filename(struct xdir *dir, int64_t signature,
 					      inprogress_suffix : "");
 }
 
+const char *
+xdir_find_filename(struct xdir *dir, int64_t signature)
+{
+	const char *filename = xdir_format_filename(dir, signature, NONE);
+	if (dir->archive_dirname[0] == '\0' || access(filename, F_OK) == 0)
+		return filename;
+	const char *archived = tt_snprintf(PATH_MAX, "%s/%020lld%s",
+					   dir->archive_dirname,
+					   (long long)signature,
+					   dir->filename_ext);
+	if (access(archived, F_OK) == 0)
+		return archived;
+	return filename;
+}
+
+/**
+ * Copy a file. The copy is created with the .inprogress suffix
+ * and renamed once all data is synced to disk so that a partially
+ * written file never shows up in the destination directory.
+ */
+static int
+xdir_copy_file(const char *src, const char *dst)
+{
+	char tmp[PATH_MAX];
+	snprintf(tmp, sizeof(tmp), "%s%s", dst, inprogress_suffix);
+	int src_fd = -1, dst_fd = -1;
+	struct stat st;
+	src_fd = open(src, O_RDONLY);
+	if (src_fd < 0 || fstat(src_fd, &st) < 0) {
+		diag_set(SystemError, "failed to open '%s'", src);
+		goto error;
+	}
+	dst_fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, st.st_mode & 0777);
+	if (dst_fd < 0) {
+		diag_set(SystemError, "failed to create '%s'", tmp);
+		goto error;
+	}
+	for (off_t pos = 0; pos < st.st_size;) {
+		ssize_t rc = eio_sendfile_sync(dst_fd, src_fd, pos,
+					       st.st_size - pos);
+		if (rc <= 0) {
+			diag_set(SystemError, "failed to copy '%s' to '%s'",
+				 src, tmp);
+			goto error;
+		}
+		pos += rc;
+	}
+	if (fsync(dst_fd) < 0) {
+		diag_set(SystemError, "failed to sync '%s'", tmp);
+		goto error;
+	}
+	if (rename(tmp, dst) < 0) {
+		diag_set(SystemError, "failed to rename '%s'", tmp);
+		goto error;
+	}
+	close(dst_fd);
+	close(src_fd);
+	return 0;
+error:
+	if (dst_fd >= 0) {
+		close(dst_fd);
+		unlink(tmp);
+	}
+	if (src_fd >= 0)
+		close(src_fd);
+	return -1;
+}
+
+int
+xdir_archive_file(struct xdir *dir, int64_t signature)
+{
+	assert(dir->archive_dirname[0] != '\0');
+	char src[PATH_MAX], dst[PATH_MAX];
+	strlcpy(src, xdir_format_filename(dir, signature, NONE), sizeof(src));
+	snprintf(dst, sizeof(dst), "%s/%020lld%s", dir->archive_dirname,
+		 (long long)signature, dir->filename_ext);
+	if (rename(src, dst) == 0)
+		goto done;
+	if (errno != EXDEV) {
+		diag_set(SystemError, "failed to move '%s' to '%s'", src, dst);
+		return -1;
+	}
+	/*
+	 * The archive is on another file system. Copy the file
+	 * first and only then delete the original so that the
+	 * file is available in at least one of the directories
+	 * at any moment of time.
+	 */
+	if (xdir_copy_file(src, dst) != 0)
+		return -1;
+	/* The file may have been garbage collected meanwhile. */
+	if (unlink(src) != 0 && errno != ENOENT) {
+		diag_set(SystemError, "failed to remove '%s'", src);
+		return -1;
+	}
+done:
+	say_info("moved %s to %s", src, dst);
+	return 0;
+}
+
 static void
 xdir_say_gc(int result, int errorno, const char *filename)
 {
@@ -683,7 +844,7 @@ xdir_collect_garbage(struct xdir *dir, int64_t signature, unsigned flags)
 	while ((vclock = vclockset_first(&dir->index)) != NULL &&
 	       vclock_sum(vclock) < signature) {
 		const char *filename =
-			xdir_format_filename(dir, vclock_sum(vclock), NONE);
+			xdir_find_filename(dir, vclock_sum(vclock));
 		if (flags & XDIR_GC_ASYNC) {
 			eio_unlink(filename, 0, xdir_complete_gc, NULL);
 		} else {
@@ -704,8 +865,7 @@ xdir_remove_file_by_vclock(struct xdir *dir, struct vclock *to_remove)
 	struct vclock *find = vclockset_match(&dir->index, to_remove);
 	if (vclock_compare(find, to_remove) != 0)
 		return -1;
-	const char *filename =
-		xdir_format_filename(dir, vclock_sum(find), NONE);
+	const char *filename = xdir_find_filename(dir, vclock_sum(find));
 	int rc = unlink(filename);
 	xdir_say_gc(rc, errno, filename);
 	if (rc != 0)
@@ -1138,8 +1298,7 @@ xlog_tx_write_zstd(struct xlog *log)
 
 	uint32_t crc32c = 0;
 	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	ZSTD_compressBegin(log->zctx, log->opts.compression_level);
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -82,6 +82,18 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/**
+	 * Zstd compression level. Ignored if no_compression
+	 * is set.
+	 */
+	int compression_level;
+};
+
+enum {
+	/** Default zstd compression level used for xlog files. */
+	XLOG_COMPRESSION_LEVEL_DEFAULT = 3,
+	/** Max zstd compression level, see ZSTD_maxCLevel(). */
+	XLOG_COMPRESSION_LEVEL_MAX = 22,
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -163,6 +175,14 @@ struct xdir {
 	 * Directory path.
 	 */
 	char dirname[PATH_MAX];
+	/**
+	 * Path to the archive directory or an empty string if
+	 * there's no archive. Files moved to the archive with
+	 * xdir_archive_file() stay in the index and are read
+	 * and garbage collected as if they were stored in the
+	 * main directory.
+	 */
+	char archive_dirname[PATH_MAX];
 	/** Snapshots or xlogs */
 	enum xdir_type type;
 };
@@ -174,6 +194,13 @@ void
 xdir_create(struct xdir *dir, const char *dirname, enum xdir_type type,
 	    const struct tt_uuid *instance_uuid, const struct xlog_opts *opts);
 
+/**
+ * Set the archive directory of a log dir. Pass NULL or an empty
+ * string to disable archiving. Must be called before xdir_scan().
+ */
+void
+xdir_set_archive(struct xdir *dir, const char *archive_dirname);
+
 /**
  * Destroy a log dir object.
  */
@@ -204,6 +231,27 @@ const char *
 xdir_format_filename(struct xdir *dir, int64_t signature,
 		     enum log_suffix suffix);
 
+/**
+ * Return the name of an existing file with the given signature.
+ * Looks up the main directory first, then the archive. If there's
+ * no such file in either of them, the name the file would have
+ * in the main directory is returned.
+ */
+const char *
+xdir_find_filename(struct xdir *dir, int64_t signature);
+
+/**
+ * Move a file with the given signature from the main directory
+ * to the archive. The file is renamed if possible, otherwise it
+ * is copied and then removed, which may take long, so it should
+ * be called from the coio thread pool. Only the directory paths
+ * are accessed, the directory index is left intact.
+ *
+ * Returns 0 on success, -1 on error (diag is set).
+ */
+int
+xdir_archive_file(struct xdir *dir, int64_t signature);
+
 /**
  * Return true if the given directory index has files whose
  * signature is less than specified.
@@ -44,6 +44,7 @@
 #include "scramble.h"
 #include "iproto_constants.h"
 #include "iproto_features.h"
+#include "schema_def.h"
 #include "mpstream/mpstream.h"
 #include "errinj.h"
 
@@ -512,6 +513,33 @@ iproto_reply_vclock(struct obuf *out, const struct vclock *vclock,
 	return 0;
 }
 
+int
+iproto_reply_select_with_vclock(struct obuf *buf, struct obuf_svp *svp,
+				uint64_t sync, uint32_t schema_version,
+				uint32_t count, const struct vclock *vclock)
+{
+	size_t max_size = mp_sizeof_uint(IPROTO_VCLOCK) +
+		mp_sizeof_vclock_ignore0(vclock);
+	char *data = obuf_reserve(buf, max_size);
+	if (data == NULL) {
+		diag_set(OutOfMemory, max_size, "obuf_reserve", "data");
+		return -1;
+	}
+	char *end = mp_encode_uint(data, IPROTO_VCLOCK);
+	end = mp_encode_vclock_ignore0(end, vclock);
+	size_t size = end - data;
+	assert(size <= max_size);
+	char *ptr = obuf_alloc(buf, size);
+	(void) ptr;
+	assert(ptr == data);
+
+	iproto_reply_select(buf, svp, sync, schema_version, count);
+	/* The body has IPROTO_VCLOCK in addition to IPROTO_DATA. */
+	char *body = (char *) obuf_svp_to_ptr(buf, svp) + IPROTO_HEADER_LEN;
+	mp_encode_map(body, 2);
+	return 0;
+}
+
 int
 iproto_reply_vote(struct obuf *out, const struct ballot *ballot,
 		  uint64_t sync, uint32_t schema_version)
@@ -866,6 +894,15 @@ error:
 			request->tuple_meta = value;
 			request->tuple_meta_end = data;
 			break;
+		case IPROTO_VCLOCK:
+			request->wait_vclock = value;
+			break;
+		case IPROTO_TIMEOUT:
+			request->timeout = mp_decode_double(&value);
+			break;
+		case IPROTO_RETURN_VCLOCK:
+			request->return_vclock = mp_decode_bool(&value);
+			break;
 		default:
 			break;
 		}
@@ -1292,6 +1329,21 @@ error:
 			request->args = value;
 			request->args_end = data;
 			break;
+		case IPROTO_VCLOCK:
+			if (mp_typeof(*value) != MP_MAP)
+				goto error;
+			request->wait_vclock = value;
+			break;
+		case IPROTO_TIMEOUT:
+			if (mp_typeof(*value) != MP_DOUBLE)
+				goto error;
+			request->timeout = mp_decode_double(&value);
+			break;
+		case IPROTO_RETURN_VCLOCK:
+			if (mp_typeof(*value) != MP_BOOL)
+				goto error;
+			request->return_vclock = mp_decode_bool(&value);
+			break;
 		default:
 			continue; /* unknown key */
 		}
@@ -1549,6 +1601,71 @@ bad_msgpack:
 	return -1;
 }
 
+int
+xrow_decode_commit(const struct xrow_header *row,
+		   struct commit_request *request)
+{
+	assert(row->type == IPROTO_COMMIT);
+	memset(request, 0, sizeof(*request));
+
+	/** Request without extra options. */
+	if (row->bodycnt == 0)
+		return 0;
+
+	const char *d = row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP)
+		goto bad_msgpack;
+
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; ++i) {
+		if (mp_typeof(*d) != MP_UINT)
+			goto bad_msgpack;
+		uint64_t key = mp_decode_uint(&d);
+		if (key >= IPROTO_KEY_MAX ||
+		    mp_typeof(*d) != iproto_key_type[key])
+			goto bad_msgpack;
+		switch (key) {
+		case IPROTO_RETURN_VCLOCK:
+			request->return_vclock = mp_decode_bool(&d);
+			break;
+		default:
+			mp_next(&d);
+			break;
+		}
+	}
+	return 0;
+
+bad_msgpack:
+	xrow_on_decode_err(row, ER_INVALID_MSGPACK, "request body");
+	return -1;
+}
+
+int
+xrow_decode_vclock_token(const char *data, struct vclock *vclock)
+{
+	vclock_create(vclock);
+	if (mp_typeof(*data) != MP_MAP)
+		goto error;
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t id = mp_decode_uint(&data);
+		if (mp_typeof(*data) != MP_UINT)
+			goto error;
+		uint64_t lsn = mp_decode_uint(&data);
+		if (id >= VCLOCK_MAX || lsn > INT64_MAX)
+			goto error;
+		/* The 0th component is local to each instance. */
+		if (id != 0)
+			vclock_reset(vclock, id, lsn);
+	}
+	return 0;
+error:
+	diag_set(ClientError, ER_INVALID_MSGPACK, "vclock");
+	return -1;
+}
+
 void
 xrow_encode_vote(struct xrow_header *row)
 {
@@ -1679,11 +1796,14 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter)
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_size)
 {
 	memset(row, 0, sizeof(*row));
 	size_t size = XROW_BODY_LEN_MAX +
-		      mp_sizeof_vclock_ignore0(vclock);
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_array(space_filter_size) +
+		      space_filter_size * mp_sizeof_uint(UINT32_MAX);
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
@@ -1691,7 +1811,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	char *data = buf;
 	int filter_size = bit_count_u32(id_filter);
-	data = mp_encode_map(data, filter_size != 0 ? 6 : 5);
+	data = mp_encode_map(data, 5 + (filter_size != 0) +
+				   (space_filter_size != 0));
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -1713,6 +1834,12 @@ xrow_encode_subscribe(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (space_filter_size != 0) {
+		data = mp_encode_uint(data, IPROTO_SPACE_FILTER);
+		data = mp_encode_array(data, space_filter_size);
+		for (uint32_t i = 0; i < space_filter_size; i++)
+			data = mp_encode_uint(data, space_filter[i]);
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1725,7 +1852,8 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter)
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      const char **space_filter, bool *checkpoint_join)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -1750,6 +1878,10 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		*anon = false;
 	if (id_filter != NULL)
 		*id_filter = 0;
+	if (space_filter != NULL)
+		*space_filter = NULL;
+	if (checkpoint_join != NULL)
+		*checkpoint_join = false;
 
 	uint32_t map_size = mp_decode_map(&d);
 	for (uint32_t i = 0; i < map_size; i++) {
@@ -1825,6 +1957,35 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 				*id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_SPACE_FILTER: {
+			if (space_filter == NULL)
+				goto skip;
+			const char *filter = d;
+			if (mp_typeof(*d) != MP_ARRAY) {
+space_filter_decode_err:	xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid SPACE_FILTER");
+				return -1;
+			}
+			uint32_t len = mp_decode_array(&d);
+			for (uint32_t i = 0; i < len; ++i) {
+				if (mp_typeof(*d) != MP_UINT)
+					goto space_filter_decode_err;
+				if (mp_decode_uint(&d) >= BOX_SPACE_MAX)
+					goto space_filter_decode_err;
+			}
+			*space_filter = filter;
+			break;
+		}
+		case IPROTO_CHECKPOINT_JOIN:
+			if (checkpoint_join == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_BOOL) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid CHECKPOINT_JOIN flag");
+				return -1;
+			}
+			*checkpoint_join = mp_decode_bool(&d);
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -1833,7 +1994,8 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 }
 
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 bool checkpoint_join)
 {
 	memset(row, 0, sizeof(*row));
 
@@ -1844,12 +2006,16 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 		return -1;
 	}
 	char *data = buf;
-	data = mp_encode_map(data, 2);
+	data = mp_encode_map(data, checkpoint_join ? 3 : 2);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
 	/* Greet the remote replica with our replica UUID */
 	data = xrow_encode_uuid(data, instance_uuid);
 	data = mp_encode_uint(data, IPROTO_SERVER_VERSION);
 	data = mp_encode_uint(data, tarantool_version_id());
+	if (checkpoint_join) {
+		data = mp_encode_uint(data, IPROTO_CHECKPOINT_JOIN);
+		data = mp_encode_bool(data, true);
+	}
 	assert(data <= buf + size);
 
 	row->body[0].iov_base = buf;
@@ -1859,6 +2025,66 @@ xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid)
 	return 0;
 }
 
+int
+xrow_encode_join_file(struct xrow_header *row, const char *data,
+		      uint32_t size)
+{
+	memset(row, 0, sizeof(*row));
+	size_t len = mp_sizeof_map(1) + mp_sizeof_uint(IPROTO_DATA) +
+		     mp_sizeof_binl(size);
+	char *buf = (char *)region_alloc(&fiber()->gc, len);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, len, "region_alloc", "buf");
+		return -1;
+	}
+	char *d = buf;
+	d = mp_encode_map(d, 1);
+	d = mp_encode_uint(d, IPROTO_DATA);
+	d = mp_encode_binl(d, size);
+	assert(d == buf + len);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = len;
+	row->body[1].iov_base = (void *)data;
+	row->body[1].iov_len = size;
+	row->bodycnt = 2;
+	row->type = IPROTO_JOIN_FILE;
+	return 0;
+}
+
+int
+xrow_decode_join_file(const struct xrow_header *row, const char **data,
+		      uint32_t *size)
+{
+	if (row->bodycnt == 0)
+		goto error;
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP)
+		goto error;
+	*data = NULL;
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_decode_uint(&d) != IPROTO_DATA) {
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_typeof(*d) != MP_BIN)
+			goto error;
+		*data = mp_decode_bin(&d, size);
+	}
+	if (*data == NULL)
+		goto error;
+	return 0;
+error:
+	xrow_on_decode_err(row, ER_INVALID_MSGPACK, "join file chunk");
+	return -1;
+}
+
 int
 xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 {
@@ -1883,6 +2109,74 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock)
 	return 0;
 }
 
+int
+xrow_encode_ack(struct xrow_header *row, const struct vclock *vclock,
+		double leader_tm)
+{
+	if (leader_tm == 0)
+		return xrow_encode_vclock(row, vclock);
+	memset(row, 0, sizeof(*row));
+	size_t size = mp_sizeof_map(2) +
+		      mp_sizeof_uint(IPROTO_VCLOCK) +
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_uint(IPROTO_LEADER_TM) +
+		      mp_sizeof_double(leader_tm);
+	char *buf = (char *)region_alloc(&fiber()->gc, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, 2);
+	data = mp_encode_uint(data, IPROTO_VCLOCK);
+	data = mp_encode_vclock_ignore0(data, vclock);
+	data = mp_encode_uint(data, IPROTO_LEADER_TM);
+	data = mp_encode_double(data, leader_tm);
+	assert(data <= buf + size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = (data - buf);
+	row->bodycnt = 1;
+	row->type = IPROTO_OK;
+	return 0;
+}
+
+/** Decode the IPROTO_LEADER_TM key of a row body if it has one. */
+static int
+xrow_decode_leader_tm(const struct xrow_header *row, const char *d,
+		      double *leader_tm)
+{
+	*leader_tm = 0;
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_decode_uint(&d) != IPROTO_LEADER_TM) {
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_typeof(*d) != MP_DOUBLE) {
+			xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+					   "invalid LEADER_TM");
+			return -1;
+		}
+		*leader_tm = mp_decode_double(&d);
+	}
+	return 0;
+}
+
+int
+xrow_decode_ack(const struct xrow_header *row, struct vclock *vclock,
+		double *leader_tm)
+{
+	if (xrow_decode_vclock(row, vclock) != 0)
+		return -1;
+	return xrow_decode_leader_tm(row, (const char *)row->body[0].iov_base,
+				     leader_tm);
+}
+
 int
 xrow_encode_subscribe_response(struct xrow_header *row,
 			       const struct tt_uuid *replicaset_uuid,
@@ -1922,6 +2216,46 @@ xrow_encode_timestamp(struct xrow_header *row, uint32_t replica_id, double tm)
 	row->tm = tm;
 }
 
+int
+xrow_encode_heartbeat(struct xrow_header *row, uint32_t replica_id,
+		      double tm, double leader_tm)
+{
+	xrow_encode_timestamp(row, replica_id, tm);
+	size_t size = mp_sizeof_map(1) + mp_sizeof_uint(IPROTO_LEADER_TM) +
+		      mp_sizeof_double(leader_tm);
+	char *buf = (char *)region_alloc(&fiber()->gc, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, 1);
+	data = mp_encode_uint(data, IPROTO_LEADER_TM);
+	data = mp_encode_double(data, leader_tm);
+	assert(data == buf + size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = size;
+	row->bodycnt = 1;
+	return 0;
+}
+
+int
+xrow_decode_heartbeat(const struct xrow_header *row, double *leader_tm)
+{
+	*leader_tm = 0;
+	if (row->bodycnt == 0)
+		return 0;
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	const char *end = d + row->body[0].iov_len;
+	if (mp_typeof(*d) != MP_MAP || mp_check(&d, end) != 0) {
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "packet body");
+		return -1;
+	}
+	return xrow_decode_leader_tm(row, (const char *)row->body[0].iov_base,
+				     leader_tm);
+}
+
 void
 xrow_encode_type(struct xrow_header *row, uint16_t type)
 {
@@ -196,6 +196,15 @@ struct request {
 	const char *tuple_meta_end;
 	/** Base field offset for UPDATE/UPSERT, e.g. 0 for C and 1 for Lua. */
 	int index_base;
+	/**
+	 * Vclock the instance must reach before serving a SELECT (a causal
+	 * read token). MessagePack map or NULL.
+	 */
+	const char *wait_vclock;
+	/** Timeout of waiting for @a wait_vclock. 0 means infinity. */
+	double timeout;
+	/** Return the instance vclock in the reply to a write request. */
+	bool return_vclock;
 };
 
 /**
@@ -338,6 +347,15 @@ struct call_request {
 	/** CALL/EVAL parameters. MessagePack Array. */
 	const char *args;
 	const char *args_end;
+	/**
+	 * Vclock the instance must reach before executing the request
+	 * (a causal read token). MessagePack map or NULL.
+	 */
+	const char *wait_vclock;
+	/** Timeout of waiting for @a wait_vclock. 0 means infinity. */
+	double timeout;
+	/** Return the instance vclock in the reply. */
+	bool return_vclock;
 };
 
 /**
@@ -476,6 +494,9 @@ xrow_encode_register(struct xrow_header *row,
  * @param anon Whether it is an anonymous subscribe request or not.
  * @param id_filter A List of replica ids to skip rows from
  *		    when feeding a replica.
+ * @param space_filter Ids of spaces whose rows should be sent
+ *		       to the replica, all spaces if empty.
+ * @param space_filter_size Number of ids in @a space_filter.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -485,7 +506,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter);
+		      uint32_t id_filter, const uint32_t *space_filter,
+		      uint32_t space_filter_size);
 
 /**
  * Decode SUBSCRIBE command.
@@ -497,6 +519,11 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] anon Whether it is an anonymous subscribe.
  * @param[out] id_filter A list of ids to skip rows from when
  *			 feeding a replica.
+ * @param[out] space_filter MsgPack array of ids of spaces whose
+ *			    rows should be sent to the replica or
+ *			    NULL if the replica needs all spaces.
+ * @param[out] checkpoint_join Whether the replica asks to join
+ *			       from the last checkpoint.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -505,36 +532,69 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter);
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      const char **space_filter, bool *checkpoint_join);
 
 /**
  * Encode JOIN command.
  * @param[out] row Row to encode into.
  * @param instance_uuid.
+ * @param checkpoint_join Ask the master to send its last checkpoint
+ *			  files instead of a fresh read view.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
  */
 int
-xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid);
+xrow_encode_join(struct xrow_header *row, const struct tt_uuid *instance_uuid,
+		 bool checkpoint_join);
 
 /**
  * Decode JOIN command.
  * @param row Row to decode.
  * @param[out] instance_uuid.
  * @param[out] version_id.
+ * @param[out] checkpoint_join.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
  */
 static inline int
 xrow_decode_join(const struct xrow_header *row, struct tt_uuid *instance_uuid,
-		 uint32_t *version_id)
+		 uint32_t *version_id, bool *checkpoint_join)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, version_id,
-				     NULL, NULL);
+				     NULL, NULL, NULL, checkpoint_join);
 }
 
+/**
+ * Encode a chunk of a checkpoint file sent on checkpoint join.
+ * The data isn't copied so it must stay valid until the row is
+ * sent.
+ * @param[out] row Row to encode into.
+ * @param data Chunk data.
+ * @param size Chunk size.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_join_file(struct xrow_header *row, const char *data,
+		      uint32_t size);
+
+/**
+ * Decode a chunk of a checkpoint file sent on checkpoint join.
+ * @param row Row to decode.
+ * @param[out] data Chunk data, points to the row body.
+ * @param[out] size Chunk size.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_join_file(const struct xrow_header *row, const char **data,
+		      uint32_t *size);
+
 /**
  * Decode REGISTER request.
  * @param row Row to decode.
@@ -551,7 +611,7 @@ xrow_decode_register(const struct xrow_header *row,
 		     uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock,
-				     version_id, NULL, NULL);
+				     version_id, NULL, NULL, NULL, NULL);
 }
 
 /**
@@ -576,9 +636,38 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL, NULL);
 }
 
+/**
+ * Encode a replica ACK.
+ * @param row[out] Row to encode into.
+ * @param vclock Replica vclock.
+ * @param leader_tm Monotonic time of the Raft leader received in its
+ *        last heartbeat. 0 means the ACK is not for the leader.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_ack(struct xrow_header *row, const struct vclock *vclock,
+		double leader_tm);
+
+/**
+ * Decode a replica ACK. ACKs of old replicas are plain vclocks.
+ * @param row Row to decode.
+ * @param[out] vclock Replica vclock.
+ * @param[out] leader_tm Monotonic time of the Raft leader received in
+ *        its last heartbeat, 0 if not present.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_ack(const struct xrow_header *row, struct vclock *vclock,
+		double *leader_tm);
+
 /**
  * Encode a response to subscribe request.
  * @param row[out] Row to encode into.
@@ -608,7 +697,7 @@ xrow_decode_subscribe_response(const struct xrow_header *row,
 			       struct vclock *vclock)
 {
 	return xrow_decode_subscribe(row, replicaset_uuid, NULL, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, NULL, NULL);
 }
 
 /**
@@ -620,6 +709,35 @@ xrow_decode_subscribe_response(const struct xrow_header *row,
 void
 xrow_encode_timestamp(struct xrow_header *row, uint32_t replica_id, double tm);
 
+/**
+ * Encode a heartbeat message carrying the sender's monotonic time,
+ * which is echoed back by replicas in ACKs to renew the Raft leader
+ * lease, see xrow_encode_ack().
+ * @param row[out] Row to encode into.
+ * @param replica_id Instance id.
+ * @param tm Time stamp.
+ * @param leader_tm Monotonic time of the sender.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_heartbeat(struct xrow_header *row, uint32_t replica_id,
+		      double tm, double leader_tm);
+
+/**
+ * Decode a heartbeat message. Heartbeats of old instances don't
+ * have a body.
+ * @param row Row to decode.
+ * @param[out] leader_tm Monotonic time of the sender, 0 if not
+ *        present.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_heartbeat(const struct xrow_header *row, double *leader_tm);
+
 /**
  * Encode any bodyless message.
  * @param row[out] Row to encode into.
@@ -707,6 +825,19 @@ iproto_reply_ok(struct obuf *out, uint64_t sync, uint32_t schema_version);
 int
 iproto_reply_id(struct obuf *out, uint64_t sync, uint32_t schema_version);
 
+/**
+ * Same as iproto_reply_select(), but also appends the instance
+ * vclock to the reply body as IPROTO_VCLOCK. On failure the caller
+ * must discard the prepared select.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+iproto_reply_select_with_vclock(struct obuf *buf, struct obuf_svp *svp,
+				uint64_t sync, uint32_t schema_version,
+				uint32_t count, const struct vclock *vclock);
+
 /**
  * Encode iproto header with IPROTO_OK response code and vclock
  * in the body.
@@ -908,6 +1039,38 @@ struct begin_request {
 int
 xrow_decode_begin(const struct xrow_header *row, struct begin_request *request);
 
+/**
+ * COMMIT request.
+ */
+struct commit_request {
+	/** Return the instance vclock in the reply. */
+	bool return_vclock;
+};
+
+/**
+ * Parse COMMIT request from a given MessagePack map.
+ * @param row Header.
+ * @param[out] request Request to decode to.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_commit(const struct xrow_header *row,
+		   struct commit_request *request);
+
+/**
+ * Decode a vclock sent by a client as a causal read token
+ * (IPROTO_VCLOCK). The 0th component is ignored.
+ * @param data MessagePack map.
+ * @param[out] vclock Decoded vclock.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_vclock_token(const char *data, struct vclock *vclock);
+
 /**
  * Update vclock with the next LSN value for given replica id.
  * The function will cause panic if the next LSN happens to be
@@ -1042,10 +1205,12 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
 			 const struct vclock *vclock, bool anon,
-			 uint32_t id_filter)
+			 uint32_t id_filter, const uint32_t *space_filter,
+			 uint32_t space_filter_size)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, anon, id_filter) != 0)
+				  vclock, anon, id_filter, space_filter,
+				  space_filter_size) != 0)
 		diag_raise();
 }
 
@@ -1055,29 +1220,49 @@ xrow_decode_subscribe_xc(const struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 			 struct tt_uuid *instance_uuid, struct vclock *vclock,
 			 uint32_t *replica_version_id, bool *anon,
-			 uint32_t *id_filter)
+			 uint32_t *id_filter, const char **space_filter)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
 				  vclock, replica_version_id, anon,
-				  id_filter) != 0)
+				  id_filter, space_filter, NULL) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_encode_join. */
 static inline void
 xrow_encode_join_xc(struct xrow_header *row,
-		    const struct tt_uuid *instance_uuid)
+		    const struct tt_uuid *instance_uuid, bool checkpoint_join)
 {
-	if (xrow_encode_join(row, instance_uuid) != 0)
+	if (xrow_encode_join(row, instance_uuid, checkpoint_join) != 0)
 		diag_raise();
 }
 
 /** @copydoc xrow_decode_join. */
 static inline void
 xrow_decode_join_xc(const struct xrow_header *row,
-		    struct tt_uuid *instance_uuid, uint32_t *version_id)
+		    struct tt_uuid *instance_uuid, uint32_t *version_id,
+		    bool *checkpoint_join)
+{
+	if (xrow_decode_join(row, instance_uuid, version_id,
+			     checkpoint_join) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_join_file. */
+static inline void
+xrow_encode_join_file_xc(struct xrow_header *row, const char *data,
+			 uint32_t size)
 {
-	if (xrow_decode_join(row, instance_uuid, version_id) != 0)
+	if (xrow_encode_join_file(row, data, size) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_decode_join_file. */
+static inline void
+xrow_decode_join_file_xc(const struct xrow_header *row, const char **data,
+			 uint32_t *size)
+{
+	if (xrow_decode_join_file(row, data, size) != 0)
 		diag_raise();
 }
 
@@ -1107,6 +1292,33 @@ xrow_decode_vclock_xc(const struct xrow_header *row, struct vclock *vclock)
 		diag_raise();
 }
 
+/** @copydoc xrow_encode_ack. */
+static inline void
+xrow_encode_ack_xc(struct xrow_header *row, const struct vclock *vclock,
+		   double leader_tm)
+{
+	if (xrow_encode_ack(row, vclock, leader_tm) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_encode_heartbeat. */
+static inline void
+xrow_encode_heartbeat_xc(struct xrow_header *row, uint32_t replica_id,
+			 double tm, double leader_tm)
+{
+	if (xrow_encode_heartbeat(row, replica_id, tm, leader_tm) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_decode_ack. */
+static inline void
+xrow_decode_ack_xc(const struct xrow_header *row, struct vclock *vclock,
+		   double *leader_tm)
+{
+	if (xrow_decode_ack(row, vclock, leader_tm) != 0)
+		diag_raise();
+}
+
 /** @copydoc xrow_encode_subscribe_response. */
 static inline void
 xrow_encode_subscribe_response_xc(struct xrow_header *row,
@@ -367,6 +367,26 @@ raft_process_recovery(struct raft *raft, const struct raft_msg *req)
 	assert(!raft_is_enabled(raft));
 }
 
+/** Lease duration. The leader must not rely on older acks. */
+static inline double
+raft_lease_timeout(const struct raft *raft)
+{
+	return MIN(raft->death_timeout, raft->election_timeout);
+}
+
+/**
+ * Check if this node follows a leader which it has heard from recently enough
+ * to keep the leader's lease valid.
+ */
+static inline bool
+raft_is_leader_alive(const struct raft *raft)
+{
+	return raft->is_lease_enabled && raft->state == RAFT_STATE_FOLLOWER &&
+	       raft->leader != 0 &&
+	       raft_ev_monotonic_now(raft_loop()) - raft->leader_last_seen <
+	       raft->death_timeout;
+}
+
 int
 raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 {
@@ -391,6 +411,17 @@ raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 		return 0;
 	}
 
+	/*
+	 * With leases the leader serves reads relying on followers not going
+	 * to a new term while they hear from it. Otherwise a new leader could
+	 * be elected while the old one still thinks its lease is valid.
+	 */
+	if (req->term > raft->volatile_term && raft_is_leader_alive(raft) &&
+	    req->state != RAFT_STATE_LEADER && source != raft->leader) {
+		say_info("RAFT: the message is ignored - the leader %u is "
+			 "alive", raft->leader);
+		return 0;
+	}
 	/* Term bump. */
 	if (req->term > raft->volatile_term)
 		raft_sm_schedule_new_term(raft, req->term);
@@ -521,6 +552,8 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	 */
 	if (source == 0)
 		return;
+	if (raft->leader == source)
+		raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
 	/*
 	 * When not a candidate - don't wait for anything. Therefore do not care
 	 * about the leader being dead.
@@ -679,6 +712,8 @@ raft_sm_become_leader(struct raft *raft)
 	assert(!raft->is_write_in_progress);
 	raft->state = RAFT_STATE_LEADER;
 	raft->leader = raft->self;
+	raft->leader_since = raft_ev_monotonic_now(raft_loop());
+	memset(raft->lease_acks, 0, sizeof(raft->lease_acks));
 	raft_ev_timer_stop(raft_loop(), &raft->timer);
 	/* State is visible and it is changed - broadcast. */
 	raft_schedule_broadcast(raft);
@@ -692,6 +727,7 @@ raft_sm_follow_leader(struct raft *raft, uint32_t leader)
 	assert(raft->leader == 0);
 	raft->state = RAFT_STATE_FOLLOWER;
 	raft->leader = leader;
+	raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
 	if (!raft->is_write_in_progress && raft->is_candidate) {
 		raft_ev_timer_stop(raft_loop(), &raft->timer);
 		raft_sm_wait_leader_dead(raft);
@@ -1003,6 +1039,41 @@ raft_restore(struct raft *raft)
 	raft_set_candidate(raft, raft->is_cfg_candidate && raft->is_enabled);
 }
 
+void
+raft_process_lease_ack(struct raft *raft, uint32_t source, double sent_time)
+{
+	assert(source > 0 && source < VCLOCK_MAX);
+	if (raft->state != RAFT_STATE_LEADER || source == raft->self)
+		return;
+	/* Sent before this node became the leader - says nothing. */
+	if (sent_time < raft->leader_since)
+		return;
+	if (sent_time > raft->lease_acks[source])
+		raft->lease_acks[source] = sent_time;
+}
+
+bool
+raft_has_lease(const struct raft *raft)
+{
+	if (!raft->is_enabled || !raft->is_lease_enabled ||
+	    raft->state != RAFT_STATE_LEADER)
+		return false;
+	double deadline = raft_ev_monotonic_now(raft_loop()) - raft_lease_timeout(raft);
+	/* The leader itself is a part of the quorum. */
+	int count = 1;
+	for (int i = 0; i < VCLOCK_MAX; i++) {
+		if (i != (int)raft->self && raft->lease_acks[i] > deadline)
+			++count;
+	}
+	return count >= raft->election_quorum;
+}
+
+void
+raft_cfg_is_lease_enabled(struct raft *raft, bool is_lease_enabled)
+{
+	raft->is_lease_enabled = is_lease_enabled;
+}
+
 void
 raft_cfg_election_timeout(struct raft *raft, double timeout)
 {
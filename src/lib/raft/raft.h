@@ -225,6 +225,25 @@ struct raft {
 	double death_timeout;
 	/** Maximal deviation from the election timeout. */
 	double max_shift;
+	/**
+	 * Flag whether leader leases are enabled. A follower which hears from
+	 * a live leader ignores attempts of other nodes to start a new term.
+	 * So the leader, having heard from a quorum recently enough, can be
+	 * sure no other leader is elected and can serve reads locally.
+	 */
+	bool is_lease_enabled;
+	/**
+	 * Time when anything was heard from the current leader last time.
+	 * Lease times are monotonic, see raft_ev_monotonic_now().
+	 */
+	double leader_last_seen;
+	/** Time when this node became the leader of the current term. */
+	double leader_since;
+	/**
+	 * Leader's own timestamps echoed back by the followers. Each one is
+	 * the time when the leader sent something the follower has received.
+	 */
+	double lease_acks[VCLOCK_MAX];
 	/** Number of instances registered in the cluster. */
 	int cluster_size;
 	/** Virtual table to perform application-specific actions. */
@@ -281,6 +300,22 @@ raft_process_async(struct raft *raft);
 void
 raft_process_heartbeat(struct raft *raft, uint32_t source);
 
+/**
+ * Process a lease acknowledgement from an instance with the given ID. The
+ * instance says it has received something the leader sent at @a sent_time
+ * (the leader's monotonic clock).
+ */
+void
+raft_process_lease_ack(struct raft *raft, uint32_t source, double sent_time);
+
+/**
+ * Check if the node is the leader and its lease is valid. It means a quorum
+ * of nodes has heard from the leader recently enough to be sure no other
+ * leader can be elected until the lease expires.
+ */
+bool
+raft_has_lease(const struct raft *raft);
+
 /** Configure whether Raft is enabled. */
 void
 raft_cfg_is_enabled(struct raft *raft, bool is_enabled);
@@ -308,6 +343,10 @@ raft_promote(struct raft *raft);
 void
 raft_restore(struct raft *raft);
 
+/** Configure whether leader leases are enabled. */
+void
+raft_cfg_is_lease_enabled(struct raft *raft, bool is_lease_enabled);
+
 /** Configure Raft leader election timeout. */
 void
 raft_cfg_election_timeout(struct raft *raft, double timeout);
@@ -50,6 +50,13 @@ raft_ev_timer_stop(struct ev_loop *loop, struct ev_timer *watcher);
 struct ev_loop *
 raft_loop(void);
 
+/**
+ * Monotonic time used for leader leases, so that they are not
+ * affected by changes of the system clock.
+ */
+double
+raft_ev_monotonic_now(struct ev_loop *loop);
+
 #define raft_ev_is_active ev_is_active
 
 #define raft_ev_is_pending ev_is_pending
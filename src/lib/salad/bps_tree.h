@@ -163,6 +163,14 @@
  * bool bps_tree_iterator_prev(tree, itr);
  * void bps_tree_iterator_freeze(tree, itr);
  * void bps_tree_iterator_destroy(tree, itr);
+ *
+ * // read views:
+ * void bps_tree_view_create(tree, view);
+ * void bps_tree_view_destroy(tree, view);
+ * struct bps_tree_iterator bps_tree_view_first(tree, view);
+ * struct bps_tree_iterator bps_tree_view_last(tree, view);
+ * struct bps_tree_iterator bps_tree_view_lower_bound(tree, view, key, exact);
+ * struct bps_tree_iterator bps_tree_view_upper_bound(tree, view, key, exact);
  */
 /* }}} */
 
@@ -365,6 +373,7 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_inner _bps(inner)
 #define bps_garbage _bps(garbage)
 #define bps_tree_iterator _api_name(iterator)
+#define bps_tree_view _api_name(view)
 #define bps_inner_path_elem _bps(inner_path_elem)
 #define bps_leaf_path_elem _bps(leaf_path_elem)
 
@@ -394,6 +403,12 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_iterator_prev _api_name(iterator_prev)
 #define bps_tree_iterator_freeze _api_name(iterator_freeze)
 #define bps_tree_iterator_destroy _api_name(iterator_destroy)
+#define bps_tree_view_create _api_name(view_create)
+#define bps_tree_view_destroy _api_name(view_destroy)
+#define bps_tree_view_first _api_name(view_first)
+#define bps_tree_view_last _api_name(view_last)
+#define bps_tree_view_lower_bound _api_name(view_lower_bound)
+#define bps_tree_view_upper_bound _api_name(view_upper_bound)
 #define bps_tree_debug_check _api_name(debug_check)
 #define bps_tree_print _api_name(print)
 #define bps_tree_debug_check_internal_functions \
@@ -417,6 +432,7 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_find_after_ins_point_key _bps_tree(find_after_ins_point_key)
 #define bps_tree_find_after_ins_point_elem _bps_tree(find_after_ins_point_elem)
 #define bps_tree_get_leaf_safe _bps_tree(get_leaf_safe)
+#define bps_tree_view_find_leaf _bps_tree(view_find_leaf)
 #define bps_tree_garbage_push _bps_tree(garbage_push)
 #define bps_tree_garbage_pop _bps_tree(garbage_pop)
 #define bps_tree_create_leaf _bps_tree(create_leaf)
@@ -567,6 +583,26 @@ struct bps_tree_iterator {
 	struct matras_view view;
 };
 
+/**
+ * Tree read view. Keeps the state of a tree at the moment of its
+ * creation, so that it can be searched and iterated regardless of
+ * the following tree modifications. Iterators returned by read view
+ * functions share its version of matras memory and so must not be
+ * used after the read view is destroyed.
+ */
+struct bps_tree_view {
+	/* Version of matras memory for MVCC */
+	struct matras_view view;
+	/* ID of root block. (bps_tree_block_id_t)-1 in empty tree. */
+	bps_tree_block_id_t root_id;
+	/* IDs of first and last block. (-1) in empty tree. */
+	bps_tree_block_id_t first_id, last_id;
+	/* Depth of the tree. Is 0 in empty tree. */
+	bps_tree_block_id_t depth;
+	/* Number of elements in the tree */
+	size_t size;
+};
+
 /**
  * Pointer to function that allocates extent of size BPS_TREE_EXTENT_SIZE
  * BPS-tree properly handles with NULL result but could leak memory
@@ -860,6 +896,59 @@ bps_tree_iterator_freeze(struct bps_tree *tree, struct bps_tree_iterator *itr);
 static inline void
 bps_tree_iterator_destroy(struct bps_tree *tree, struct bps_tree_iterator *itr);
 
+/**
+ * @brief Create a read view of the tree. It must be destroyed with
+ * a bps_tree_view_destroy call after usage.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view to create
+ */
+static inline void
+bps_tree_view_create(struct bps_tree *tree, struct bps_tree_view *view);
+
+/**
+ * @brief Destroy a read view of the tree.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view
+ */
+static inline void
+bps_tree_view_destroy(struct bps_tree *tree, struct bps_tree_view *view);
+
+/**
+ * @brief Get an iterator to the first element of a tree read view.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view
+ * @return - First iterator. Could be invalid if the tree was empty.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_first(const struct bps_tree *tree,
+		    const struct bps_tree_view *view);
+
+/**
+ * @brief Get an iterator to the last element of a tree read view.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view
+ * @return - Last iterator. Could be invalid if the tree was empty.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_last(const struct bps_tree *tree,
+		   const struct bps_tree_view *view);
+
+/**
+ * @brief Same as bps_tree_lower_bound, but searches a tree read view.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_lower_bound(const struct bps_tree *tree,
+			  const struct bps_tree_view *view,
+			  bps_tree_key_t key, bool *exact);
+
+/**
+ * @brief Same as bps_tree_upper_bound, but searches a tree read view.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_upper_bound(const struct bps_tree *tree,
+			  const struct bps_tree_view *view,
+			  bps_tree_key_t key, bool *exact);
+
 #ifndef BPS_TREE_NO_DEBUG
 
 /**
@@ -2080,6 +2169,183 @@ bps_tree_iterator_destroy(struct bps_tree *tree, struct bps_tree_iterator *itr)
 	matras_destroy_read_view(&tree->matras, &itr->view);
 }
 
+/**
+ * @brief Create a read view of the tree. It must be destroyed with
+ * a bps_tree_view_destroy call after usage.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view to create
+ */
+static inline void
+bps_tree_view_create(struct bps_tree *tree, struct bps_tree_view *view)
+{
+	matras_create_read_view(&tree->matras, &view->view);
+	view->root_id = tree->root_id;
+	view->first_id = tree->first_id;
+	view->last_id = tree->last_id;
+	view->depth = tree->depth;
+	view->size = tree->size;
+}
+
+/**
+ * @brief Destroy a read view of the tree.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view
+ */
+static inline void
+bps_tree_view_destroy(struct bps_tree *tree, struct bps_tree_view *view)
+{
+	matras_destroy_read_view(&tree->matras, &view->view);
+}
+
+/**
+ * @brief Get an iterator to the first element of a tree read view.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view
+ * @return - First iterator. Could be invalid if the tree was empty.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_first(const struct bps_tree *tree,
+		    const struct bps_tree_view *view)
+{
+	(void)tree;
+	struct bps_tree_iterator itr;
+	itr.block_id = view->first_id;
+	itr.pos = 0;
+	itr.view = view->view;
+	return itr;
+}
+
+/**
+ * @brief Get an iterator to the last element of a tree read view.
+ * @param tree - pointer to a tree
+ * @param view - pointer to a read view
+ * @return - Last iterator. Could be invalid if the tree was empty.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_last(const struct bps_tree *tree,
+		   const struct bps_tree_view *view)
+{
+	(void)tree;
+	struct bps_tree_iterator itr;
+	itr.block_id = view->last_id;
+	itr.pos = (bps_tree_pos_t)(-1);
+	itr.view = view->view;
+	return itr;
+}
+
+/**
+ * @brief Find the leaf block containing the insertion point of
+ * the key in a tree read view.
+ * @return - ID of the leaf block or (-1) if the tree was empty.
+ */
+static inline bps_tree_block_id_t
+bps_tree_view_find_leaf(const struct bps_tree *tree,
+			const struct bps_tree_view *view,
+			bps_tree_key_t key, bool after, bool *exact)
+{
+	if (view->root_id == (bps_tree_block_id_t)(-1))
+		return (bps_tree_block_id_t)(-1);
+	struct matras_view *v = (struct matras_view *)&view->view;
+	bps_tree_block_id_t block_id = view->root_id;
+	struct bps_block *block = bps_tree_restore_block_ver(tree, block_id, v);
+	for (bps_tree_block_id_t i = 0; i < view->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bool exact_test = false;
+		bps_tree_pos_t pos;
+		if (after)
+			pos = bps_tree_find_after_ins_point_key(tree,
+						inner->elems,
+						inner->header.size - 1,
+						key, &exact_test);
+		else
+			pos = bps_tree_find_ins_point_key(tree, inner->elems,
+						inner->header.size - 1,
+						key, &exact_test);
+		if (exact_test)
+			*exact = true;
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block_ver(tree, block_id, v);
+	}
+	return block_id;
+}
+
+/**
+ * @brief Same as bps_tree_lower_bound, but searches a tree read view.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_lower_bound(const struct bps_tree *tree,
+			  const struct bps_tree_view *view,
+			  bps_tree_key_t key, bool *exact)
+{
+	struct bps_tree_iterator res;
+	res.view = view->view;
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	bool unused = false;
+	bps_tree_block_id_t block_id =
+		bps_tree_view_find_leaf(tree, view, key, false, &unused);
+	if (block_id == (bps_tree_block_id_t)(-1)) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_leaf *leaf = (struct bps_leaf *)
+		bps_tree_restore_block_ver(tree, block_id, &res.view);
+	bps_tree_pos_t pos;
+	pos = bps_tree_find_ins_point_key(tree, leaf->elems, leaf->header.size,
+					  key, exact);
+	if (pos >= leaf->header.size) {
+		res.block_id = leaf->next_id;
+		res.pos = 0;
+	} else {
+		res.block_id = block_id;
+		res.pos = pos;
+	}
+	return res;
+}
+
+/**
+ * @brief Same as bps_tree_upper_bound, but searches a tree read view.
+ */
+static inline struct bps_tree_iterator
+bps_tree_view_upper_bound(const struct bps_tree *tree,
+			  const struct bps_tree_view *view,
+			  bps_tree_key_t key, bool *exact)
+{
+	struct bps_tree_iterator res;
+	res.view = view->view;
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	bps_tree_block_id_t block_id =
+		bps_tree_view_find_leaf(tree, view, key, true, exact);
+	if (block_id == (bps_tree_block_id_t)(-1)) {
+		res.block_id = (bps_tree_block_id_t)(-1);
+		res.pos = 0;
+		return res;
+	}
+	struct bps_leaf *leaf = (struct bps_leaf *)
+		bps_tree_restore_block_ver(tree, block_id, &res.view);
+	bool exact_test;
+	bps_tree_pos_t pos;
+	pos = bps_tree_find_after_ins_point_key(tree, leaf->elems,
+						leaf->header.size,
+						key, &exact_test);
+	if (exact_test)
+		*exact = true;
+	if (pos >= leaf->header.size) {
+		res.block_id = leaf->next_id;
+		res.pos = 0;
+	} else {
+		res.block_id = block_id;
+		res.pos = pos;
+	}
+	return res;
+}
+
 /**
  * @brief Find the first element that is equal to the key (comparator returns 0)
  * @param tree - pointer to a tree
@@ -6101,6 +6367,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_inner
 #undef bps_garbage
 #undef bps_tree_iterator
+#undef bps_tree_view
 #undef bps_inner_path_elem
 #undef bps_leaf_path_elem
 
@@ -6129,6 +6396,12 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_iterator_prev
 #undef bps_tree_iterator_freeze
 #undef bps_tree_iterator_destroy
+#undef bps_tree_view_create
+#undef bps_tree_view_destroy
+#undef bps_tree_view_first
+#undef bps_tree_view_last
+#undef bps_tree_view_lower_bound
+#undef bps_tree_view_upper_bound
 #undef bps_tree_debug_check
 #undef bps_tree_print
 #undef bps_tree_debug_check_internal_functions
@@ -6151,6 +6424,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_find_after_ins_point_key
 #undef bps_tree_find_after_ins_point_elem
 #undef bps_tree_get_leaf_safe
+#undef bps_tree_view_find_leaf
 #undef bps_tree_garbage_push
 #undef bps_tree_garbage_pop
 #undef bps_tree_create_leaf
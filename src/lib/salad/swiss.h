@@ -0,0 +1,1046 @@
+/*
+ * *No header guard*: the header is allowed to be included twice
+ * with different sets of defines.
+ */
+/*
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "small/matras.h"
+
+/**
+ * Open addressing hash table with SIMD group probing.
+ *
+ * Slots are split in groups of SWISS_GROUP_SIZE. Every slot has
+ * a control byte, which is either EMPTY, DELETED, or holds 7 bits
+ * of the value hash (tag). A lookup loads control bytes of a whole
+ * group and compares them with the tag of the looked up hash in
+ * one SSE2 (or NEON) instruction so that values are compared only
+ * if their tags match. Groups are probed quadratically until a
+ * group with an EMPTY slot is found.
+ *
+ * Groups are stored in a matras so that the table can be frozen
+ * for iteration, just like light. To avoid latency spikes, the
+ * table is resized incrementally: first, groups of the new table
+ * are allocated a few at a time on insertions into the old table,
+ * then values are moved from the old table to the new one a few
+ * groups at a time, while lookups check both tables.
+ */
+
+/**
+ * Additional user defined name that appended to prefix 'swiss'
+ * for all names of structs and functions in this header file.
+ * All names use pattern: swiss<SWISS_NAME>_<name of func/struct>
+ * May be empty, but still have to be defined (just #define SWISS_NAME)
+ */
+#ifndef SWISS_NAME
+#error "SWISS_NAME must be defined"
+#endif
+
+/**
+ * Data type that hash table holds.
+ */
+#ifndef SWISS_DATA_TYPE
+#error "SWISS_DATA_TYPE must be defined"
+#endif
+
+/**
+ * Data type that used to for finding values.
+ */
+#ifndef SWISS_KEY_TYPE
+#error "SWISS_KEY_TYPE must be defined"
+#endif
+
+/**
+ * Type of optional third parameter of comparing function.
+ * If not needed, simply use #define SWISS_CMP_ARG_TYPE int
+ */
+#ifndef SWISS_CMP_ARG_TYPE
+#error "SWISS_CMP_ARG_TYPE must be defined"
+#endif
+
+/**
+ * Data comparing function. Takes 3 parameters - value1, value2 and
+ * optional value that stored in hash table struct.
+ */
+#ifndef SWISS_EQUAL
+#error "SWISS_EQUAL must be defined"
+#endif
+
+/**
+ * Data comparing function. Takes 3 parameters - value, key and
+ * optional value that stored in hash table struct.
+ */
+#ifndef SWISS_EQUAL_KEY
+#error "SWISS_EQUAL_KEY must be defined"
+#endif
+
+#ifndef SWISS_COMMON_DEFINED
+#define SWISS_COMMON_DEFINED
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SWISS_USE_NEON
+#include <arm_neon.h>
+#endif
+
+enum {
+	/** Number of slots probed at once. */
+	SWISS_GROUP_SIZE = 16,
+	/** Control byte of a never used slot. */
+	SWISS_CTRL_EMPTY = -128,
+	/** Control byte of a slot whose value was deleted. */
+	SWISS_CTRL_DELETED = -2,
+	/**
+	 * Number of groups allocated or moved to the new table
+	 * on each insertion while the table is being resized.
+	 */
+	SWISS_RESIZE_STEP = 4,
+	/** Max number of slots in a table. */
+	SWISS_MAX_CAPACITY = 1U << 30,
+};
+
+/**
+ * Bit mask of slots of a group that matched a probe.
+ * With NEON, each slot is represented by 4 bits.
+ */
+typedef uint64_t swiss_mask_t;
+
+#if defined(SWISS_USE_NEON)
+enum { SWISS_MASK_SHIFT = 2 };
+
+static inline swiss_mask_t
+swiss_neon_mask(uint8x16_t eq)
+{
+	uint8x8_t res = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+	return vget_lane_u64(vreinterpret_u64_u8(res), 0) &
+	       0x8888888888888888ULL;
+}
+#else
+enum { SWISS_MASK_SHIFT = 0 };
+#endif
+
+/** Return the mask of slots whose control byte equals @a ctrl. */
+static inline swiss_mask_t
+swiss_group_match(const int8_t *group_ctrl, int8_t ctrl)
+{
+#if defined(__SSE2__)
+	__m128i c = _mm_loadu_si128((const __m128i *)group_ctrl);
+	return (uint16_t)_mm_movemask_epi8(
+		_mm_cmpeq_epi8(_mm_set1_epi8(ctrl), c));
+#elif defined(SWISS_USE_NEON)
+	int8x16_t c = vld1q_s8(group_ctrl);
+	return swiss_neon_mask(vceqq_s8(c, vdupq_n_s8(ctrl)));
+#else
+	swiss_mask_t mask = 0;
+	for (int i = 0; i < SWISS_GROUP_SIZE; i++) {
+		if (group_ctrl[i] == ctrl)
+			mask |= (swiss_mask_t)1 << i;
+	}
+	return mask;
+#endif
+}
+
+/** Return the mask of EMPTY or DELETED slots. */
+static inline swiss_mask_t
+swiss_group_match_free(const int8_t *group_ctrl)
+{
+#if defined(__SSE2__)
+	__m128i c = _mm_loadu_si128((const __m128i *)group_ctrl);
+	return (uint16_t)_mm_movemask_epi8(c);
+#elif defined(SWISS_USE_NEON)
+	int8x16_t c = vld1q_s8(group_ctrl);
+	return swiss_neon_mask(vcltzq_s8(c));
+#else
+	swiss_mask_t mask = 0;
+	for (int i = 0; i < SWISS_GROUP_SIZE; i++) {
+		if (group_ctrl[i] < 0)
+			mask |= (swiss_mask_t)1 << i;
+	}
+	return mask;
+#endif
+}
+
+/** Return the number of the first slot in a non-empty mask. */
+static inline int
+swiss_mask_first(swiss_mask_t mask)
+{
+	assert(mask != 0);
+	return __builtin_ctzll(mask) >> SWISS_MASK_SHIFT;
+}
+
+/** Remove the first slot from a non-empty mask. */
+static inline swiss_mask_t
+swiss_mask_next(swiss_mask_t mask)
+{
+	return mask & (mask - 1);
+}
+
+/** Tag stored in the control byte of a slot holding @a hash. */
+static inline int8_t
+swiss_tag(uint32_t hash)
+{
+	return (int8_t)(hash >> 25);
+}
+
+/** Size of a matras block holding a group. */
+static inline uint32_t
+swiss_block_size(size_t group_size)
+{
+	return 1U << (32 - __builtin_clz((uint32_t)group_size - 1));
+}
+
+#endif /* SWISS_COMMON_DEFINED */
+
+/**
+ * Tools for name substitution:
+ */
+#ifndef CONCAT4
+#define CONCAT4_R(a, b, c, d) a##b##c##d
+#define CONCAT4(a, b, c, d) CONCAT4_R(a, b, c, d)
+#endif
+
+#ifdef _
+#error '_' must be undefinded!
+#endif
+#define SWISS(name) CONCAT4(swiss, SWISS_NAME, _, name)
+
+/**
+ * Group of slots. Hashes are stored along with values so that
+ * values don't have to be rehashed when the table is resized.
+ */
+struct SWISS(group) {
+	int8_t ctrl[SWISS_GROUP_SIZE];
+	uint32_t hash[SWISS_GROUP_SIZE];
+	SWISS_DATA_TYPE value[SWISS_GROUP_SIZE];
+};
+
+/**
+ * Array of groups.
+ */
+struct SWISS(table) {
+	/* storage for groups */
+	struct matras mtable;
+	/* number of groups, power of two */
+	uint32_t group_count;
+	/* number of groups allocated so far */
+	uint32_t alloc_count;
+	/* number of values stored in the table */
+	uint32_t count;
+	/* number of slots that aren't EMPTY */
+	uint32_t used;
+	/* number of frozen iterators using the table */
+	uint32_t view_count;
+	/* link in the list of retired tables */
+	struct SWISS(table) *next_retired;
+};
+
+/**
+ * Type of functions for memory allocation and deallocation
+ */
+typedef void *(*SWISS(extent_alloc_t))(void *ctx);
+typedef void (*SWISS(extent_free_t))(void *ctx, void *extent);
+
+/**
+ * Main struct for holding hash table
+ */
+struct SWISS(core) {
+	/* count of values in hash table */
+	uint32_t count;
+	/* table new values are inserted to */
+	struct SWISS(table) *table;
+	/* table values are being moved from, or NULL */
+	struct SWISS(table) *old;
+	/* next group of the old table to move */
+	uint32_t move_pos;
+	/* table being allocated for resize, or NULL */
+	struct SWISS(table) *next;
+	/*
+	 * Tables that were replaced while frozen iterators
+	 * were using them. Freed with the last iterator.
+	 */
+	struct SWISS(table) *retired;
+	/* additional parameter for data comparison */
+	SWISS_CMP_ARG_TYPE arg;
+	/* parameters of table storage */
+	size_t extent_size;
+	SWISS(extent_alloc_t) extent_alloc;
+	SWISS(extent_free_t) extent_free;
+	void *alloc_ctx;
+};
+
+/**
+ * Iterator, for iterating all values in hash table.
+ * Slots of the old table (if any) go first.
+ */
+struct SWISS(iterator) {
+	/* current position */
+	uint32_t pos;
+	/* set if the iterator was frozen */
+	bool is_frozen;
+	/* old and new tables captured by a frozen iterator */
+	struct SWISS(table) *tables[2];
+	/* versions of matras memory for MVCC */
+	struct matras_view views[2];
+};
+
+/**
+ * Special iterator position meaning that nothing was found
+ */
+static const uint32_t SWISS(end) = 0xFFFFFFFF;
+
+/* Functions definition */
+
+/**
+ * @brief Hash table construction.
+ * @param ht - pointer to a hash table struct
+ * @param extent_size - size of allocating memory blocks
+ * @param extent_alloc_func - memory blocks allocation function
+ * @param extent_free_func - memory blocks allocation function
+ * @param alloc_ctx - argument passed to memory block allocator
+ * @param arg - optional parameter to save for comparing function
+ */
+static inline void
+SWISS(create)(struct SWISS(core) *ht, size_t extent_size,
+	      SWISS(extent_alloc_t) extent_alloc_func,
+	      SWISS(extent_free_t) extent_free_func,
+	      void *alloc_ctx, SWISS_CMP_ARG_TYPE arg)
+{
+	memset(ht, 0, sizeof(*ht));
+	ht->arg = arg;
+	ht->extent_size = extent_size;
+	ht->extent_alloc = extent_alloc_func;
+	ht->extent_free = extent_free_func;
+	ht->alloc_ctx = alloc_ctx;
+}
+
+/**
+ * Allocate a table with the given number of groups. Groups
+ * themselves are allocated by SWISS(table_alloc_groups).
+ */
+static inline struct SWISS(table) *
+SWISS(table_new)(struct SWISS(core) *ht, uint32_t group_count)
+{
+	assert((group_count & (group_count - 1)) == 0);
+	struct SWISS(table) *t =
+		(struct SWISS(table) *)calloc(1, sizeof(*t));
+	if (t == NULL)
+		return NULL;
+	t->group_count = group_count;
+	matras_create(&t->mtable, ht->extent_size,
+		      swiss_block_size(sizeof(struct SWISS(group))),
+		      ht->extent_alloc, ht->extent_free, ht->alloc_ctx);
+	return t;
+}
+
+static inline void
+SWISS(table_delete)(struct SWISS(table) *t)
+{
+	matras_destroy(&t->mtable);
+	free(t);
+}
+
+/**
+ * Allocate up to @a count more groups of a table.
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+SWISS(table_alloc_groups)(struct SWISS(table) *t, uint32_t count)
+{
+	for (; count > 0 && t->alloc_count < t->group_count; count--) {
+		uint32_t id;
+		struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_alloc(&t->mtable, &id);
+		if (group == NULL)
+			return -1;
+		assert(id == t->alloc_count);
+		memset(group->ctrl, SWISS_CTRL_EMPTY, sizeof(group->ctrl));
+		t->alloc_count++;
+	}
+	return 0;
+}
+
+static inline uint32_t
+SWISS(table_capacity)(const struct SWISS(table) *t)
+{
+	return t->group_count * SWISS_GROUP_SIZE;
+}
+
+/**
+ * @brief Hash table destruction. Frees all allocated memory
+ * @param ht - pointer to a hash table struct
+ */
+static inline void
+SWISS(destroy)(struct SWISS(core) *ht)
+{
+	if (ht->table != NULL)
+		SWISS(table_delete)(ht->table);
+	if (ht->old != NULL)
+		SWISS(table_delete)(ht->old);
+	if (ht->next != NULL)
+		SWISS(table_delete)(ht->next);
+	while (ht->retired != NULL) {
+		struct SWISS(table) *t = ht->retired;
+		ht->retired = t->next_retired;
+		SWISS(table_delete)(t);
+	}
+}
+
+/**
+ * Find a value by key in a table.
+ * @return slot number or SWISS(end) if not found
+ */
+static inline uint32_t
+SWISS(table_find_key)(const struct SWISS(core) *ht,
+		      const struct SWISS(table) *t,
+		      uint32_t hash, SWISS_KEY_TYPE key)
+{
+	if (t == NULL || t->count == 0)
+		return SWISS(end);
+	uint32_t mask = t->group_count - 1;
+	uint32_t g = hash & mask;
+	int8_t tag = swiss_tag(hash);
+	for (uint32_t i = 1; ; i++) {
+		const struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_get(&t->mtable, g);
+		swiss_mask_t m = swiss_group_match(group->ctrl, tag);
+		for (; m != 0; m = swiss_mask_next(m)) {
+			int s = swiss_mask_first(m);
+			if (group->hash[s] == hash &&
+			    SWISS_EQUAL_KEY((group->value[s]), (key), (ht->arg)))
+				return g * SWISS_GROUP_SIZE + s;
+		}
+		if (swiss_group_match(group->ctrl, SWISS_CTRL_EMPTY) != 0 ||
+		    i > mask)
+			return SWISS(end);
+		/* Triangular numbers visit every group. */
+		g = (g + i) & mask;
+	}
+}
+
+/**
+ * Find a value in a table.
+ * @return slot number or SWISS(end) if not found
+ */
+static inline uint32_t
+SWISS(table_find)(const struct SWISS(core) *ht,
+		  const struct SWISS(table) *t,
+		  uint32_t hash, SWISS_DATA_TYPE value)
+{
+	if (t == NULL || t->count == 0)
+		return SWISS(end);
+	uint32_t mask = t->group_count - 1;
+	uint32_t g = hash & mask;
+	int8_t tag = swiss_tag(hash);
+	for (uint32_t i = 1; ; i++) {
+		const struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_get(&t->mtable, g);
+		swiss_mask_t m = swiss_group_match(group->ctrl, tag);
+		for (; m != 0; m = swiss_mask_next(m)) {
+			int s = swiss_mask_first(m);
+			if (group->hash[s] == hash &&
+			    SWISS_EQUAL((group->value[s]), (value), (ht->arg)))
+				return g * SWISS_GROUP_SIZE + s;
+		}
+		if (swiss_group_match(group->ctrl, SWISS_CTRL_EMPTY) != 0 ||
+		    i > mask)
+			return SWISS(end);
+		g = (g + i) & mask;
+	}
+}
+
+/**
+ * Insert a value into a table. The value must not be there.
+ * @return 0 on success, -1 on memory error or if the table is full
+ */
+static inline int
+SWISS(table_insert)(struct SWISS(table) *t, uint32_t hash,
+		    SWISS_DATA_TYPE value)
+{
+	assert(t->alloc_count == t->group_count);
+	uint32_t mask = t->group_count - 1;
+	uint32_t g = hash & mask;
+	for (uint32_t i = 1; ; i++) {
+		const struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_get(&t->mtable, g);
+		swiss_mask_t m = swiss_group_match_free(group->ctrl);
+		if (m != 0) {
+			struct SWISS(group) *wgroup = (struct SWISS(group) *)
+				matras_touch(&t->mtable, g);
+			if (wgroup == NULL)
+				return -1;
+			int s = swiss_mask_first(m);
+			if (wgroup->ctrl[s] == SWISS_CTRL_EMPTY)
+				t->used++;
+			wgroup->ctrl[s] = swiss_tag(hash);
+			wgroup->hash[s] = hash;
+			wgroup->value[s] = value;
+			t->count++;
+			return 0;
+		}
+		if (i > mask)
+			return -1;
+		g = (g + i) & mask;
+	}
+}
+
+/**
+ * Delete the value stored in the given slot of a table.
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+SWISS(table_delete_slot)(struct SWISS(table) *t, uint32_t slot)
+{
+	uint32_t g = slot / SWISS_GROUP_SIZE;
+	int s = slot % SWISS_GROUP_SIZE;
+	struct SWISS(group) *group = (struct SWISS(group) *)
+		matras_touch(&t->mtable, g);
+	if (group == NULL)
+		return -1;
+	assert(group->ctrl[s] >= 0);
+	/*
+	 * If the group has an EMPTY slot, no probe continues past
+	 * it so the slot can be made EMPTY rather than DELETED.
+	 */
+	if (swiss_group_match(group->ctrl, SWISS_CTRL_EMPTY) != 0) {
+		group->ctrl[s] = SWISS_CTRL_EMPTY;
+		t->used--;
+	} else {
+		group->ctrl[s] = SWISS_CTRL_DELETED;
+	}
+	t->count--;
+	return 0;
+}
+
+/**
+ * Retire a table that isn't used by the hash table anymore.
+ * It is freed right away unless frozen iterators use it.
+ */
+static inline void
+SWISS(table_retire)(struct SWISS(core) *ht, struct SWISS(table) *t)
+{
+	if (t->view_count == 0) {
+		SWISS(table_delete)(t);
+		return;
+	}
+	t->next_retired = ht->retired;
+	ht->retired = t;
+}
+
+/**
+ * Move values of one group of the old table to the new table.
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+SWISS(move_group)(struct SWISS(core) *ht)
+{
+	struct SWISS(table) *old = ht->old;
+	assert(old != NULL && ht->move_pos < old->group_count);
+	const struct SWISS(group) *group = (struct SWISS(group) *)
+		matras_get(&old->mtable, ht->move_pos);
+	/*
+	 * Values are marked DELETED in the old table as they are
+	 * moved so that probes of values that haven't been moved
+	 * yet go on past this group.
+	 */
+	struct SWISS(group) *wgroup = NULL;
+	for (int s = 0; s < SWISS_GROUP_SIZE; s++) {
+		if (group->ctrl[s] < 0)
+			continue;
+		if (wgroup == NULL) {
+			wgroup = (struct SWISS(group) *)
+				matras_touch(&old->mtable, ht->move_pos);
+			if (wgroup == NULL)
+				return -1;
+			group = wgroup;
+		}
+		if (SWISS(table_insert)(ht->table, wgroup->hash[s],
+					wgroup->value[s]) != 0)
+			return -1;
+		wgroup->ctrl[s] = SWISS_CTRL_DELETED;
+		old->count--;
+	}
+	ht->move_pos++;
+	if (ht->move_pos == old->group_count) {
+		assert(old->count == 0);
+		ht->old = NULL;
+		SWISS(table_retire)(ht, old);
+	}
+	return 0;
+}
+
+/**
+ * Do a step of incremental resize of the hash table. If @a force
+ * is set, finish the current resize phase at once.
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+SWISS(resize_step)(struct SWISS(core) *ht, bool force)
+{
+	if (ht->next != NULL) {
+		/* Allocating groups of the new table. */
+		struct SWISS(table) *next = ht->next;
+		uint32_t step = force ? next->group_count : SWISS_RESIZE_STEP;
+		if (SWISS(table_alloc_groups)(next, step) != 0)
+			return -1;
+		if (next->alloc_count < next->group_count)
+			return 0;
+		assert(ht->old == NULL);
+		ht->old = ht->table;
+		ht->table = next;
+		ht->next = NULL;
+		ht->move_pos = 0;
+		return 0;
+	}
+	if (ht->old != NULL) {
+		/* Moving values to the new table. */
+		uint32_t step = force ? ht->old->group_count :
+				SWISS_RESIZE_STEP;
+		for (uint32_t i = 0; i < step && ht->old != NULL; i++) {
+			if (SWISS(move_group)(ht) != 0)
+				return -1;
+		}
+		return 0;
+	}
+	struct SWISS(table) *t = ht->table;
+	uint32_t capacity = SWISS(table_capacity)(t);
+	if (t->used < capacity / 4 * 3)
+		return 0;
+	/*
+	 * If the table is mostly filled with DELETED slots,
+	 * rehash it without growing.
+	 */
+	uint32_t group_count = t->group_count;
+	if (t->count >= capacity / 2) {
+		if (capacity >= SWISS_MAX_CAPACITY)
+			return 0;
+		group_count *= 2;
+	}
+	ht->next = SWISS(table_new)(ht, group_count);
+	if (ht->next == NULL)
+		return -1;
+	return SWISS(resize_step)(ht, force);
+}
+
+/**
+ * Make progress on resizing the hash table before an insertion.
+ * If the current table is almost full, the resize is completed
+ * synchronously. Errors are ignored: an insertion fails only if
+ * there's no room for the new value.
+ */
+static inline void
+SWISS(prepare_insert)(struct SWISS(core) *ht)
+{
+	struct SWISS(table) *t = ht->table;
+	bool force = t->used >= SWISS(table_capacity)(t) / 8 * 7;
+	if (SWISS(resize_step)(ht, force) == 0 && force &&
+	    (ht->next != NULL || ht->old != NULL)) {
+		/* Finish the next phase too. */
+		(void)SWISS(resize_step)(ht, true);
+	}
+}
+
+/**
+ * @brief Find a record with given hash and value
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash to find
+ * @param value - value to find
+ * @return pointer to the found value or NULL if not found
+ */
+static inline SWISS_DATA_TYPE *
+SWISS(find)(const struct SWISS(core) *ht, uint32_t hash,
+	    SWISS_DATA_TYPE value)
+{
+	const struct SWISS(table) *tables[2] = {ht->table, ht->old};
+	for (int i = 0; i < 2; i++) {
+		const struct SWISS(table) *t = tables[i];
+		uint32_t slot = SWISS(table_find)(ht, t, hash, value);
+		if (slot == SWISS(end))
+			continue;
+		struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_get(&t->mtable, slot / SWISS_GROUP_SIZE);
+		return &group->value[slot % SWISS_GROUP_SIZE];
+	}
+	return NULL;
+}
+
+/**
+ * @brief Find a record with given hash and key
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash to find
+ * @param key - key to find
+ * @return pointer to the found value or NULL if not found
+ */
+static inline SWISS_DATA_TYPE *
+SWISS(find_key)(const struct SWISS(core) *ht, uint32_t hash,
+		SWISS_KEY_TYPE key)
+{
+	const struct SWISS(table) *tables[2] = {ht->table, ht->old};
+	for (int i = 0; i < 2; i++) {
+		const struct SWISS(table) *t = tables[i];
+		uint32_t slot = SWISS(table_find_key)(ht, t, hash, key);
+		if (slot == SWISS(end))
+			continue;
+		struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_get(&t->mtable, slot / SWISS_GROUP_SIZE);
+		return &group->value[slot % SWISS_GROUP_SIZE];
+	}
+	return NULL;
+}
+
+/**
+ * @brief Insert a record with given hash and value. The value
+ * must not be present in the hash table.
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash of the value
+ * @param value - value to insert
+ * @return 0 on success, -1 on memory error
+ */
+static inline int
+SWISS(insert)(struct SWISS(core) *ht, uint32_t hash, SWISS_DATA_TYPE value)
+{
+	if (ht->table == NULL) {
+		struct SWISS(table) *t = SWISS(table_new)(ht, 1);
+		if (t == NULL)
+			return -1;
+		if (SWISS(table_alloc_groups)(t, 1) != 0) {
+			SWISS(table_delete)(t);
+			return -1;
+		}
+		ht->table = t;
+	}
+	SWISS(prepare_insert)(ht);
+	if (SWISS(table_insert)(ht->table, hash, value) != 0)
+		return -1;
+	ht->count++;
+	return 0;
+}
+
+/**
+ * @brief Replace a record with given hash and value
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash of the value
+ * @param value - new value
+ * @param replaced - pointer to a value that was stored in table
+ *  before replacement, not touched if nothing was replaced
+ * @return 1 if a value was replaced, 0 if not found,
+ *  -1 on memory error
+ */
+static inline int
+SWISS(replace)(struct SWISS(core) *ht, uint32_t hash,
+	       SWISS_DATA_TYPE value, SWISS_DATA_TYPE *replaced)
+{
+	struct SWISS(table) *tables[2] = {ht->table, ht->old};
+	for (int i = 0; i < 2; i++) {
+		struct SWISS(table) *t = tables[i];
+		uint32_t slot = SWISS(table_find)(ht, t, hash, value);
+		if (slot == SWISS(end))
+			continue;
+		struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_touch(&t->mtable, slot / SWISS_GROUP_SIZE);
+		if (group == NULL)
+			return -1;
+		*replaced = group->value[slot % SWISS_GROUP_SIZE];
+		group->value[slot % SWISS_GROUP_SIZE] = value;
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Delete a record with given hash and value
+ * @param ht - pointer to a hash table struct
+ * @param hash - hash of the value
+ * @param value - value to delete
+ * @return 0 on success, 1 if not found, -1 on memory error
+ */
+static inline int
+SWISS(delete_value)(struct SWISS(core) *ht, uint32_t hash,
+		    SWISS_DATA_TYPE value)
+{
+	struct SWISS(table) *tables[2] = {ht->table, ht->old};
+	for (int i = 0; i < 2; i++) {
+		struct SWISS(table) *t = tables[i];
+		uint32_t slot = SWISS(table_find)(ht, t, hash, value);
+		if (slot == SWISS(end))
+			continue;
+		if (SWISS(table_delete_slot)(t, slot) != 0)
+			return -1;
+		ht->count--;
+		/* Don't let a resize stall if there are no inserts. */
+		if (ht->old != NULL)
+			(void)SWISS(resize_step)(ht, false);
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Get a random value from the hash table
+ * @param ht - pointer to a hash table struct
+ * @param rnd - random number
+ * @return pointer to a value or NULL if the hash table is empty
+ */
+static inline SWISS_DATA_TYPE *
+SWISS(random)(const struct SWISS(core) *ht, uint32_t rnd)
+{
+	if (ht->count == 0)
+		return NULL;
+	const struct SWISS(table) *t = ht->table;
+	if (ht->old != NULL && ht->old->count > rnd % ht->count)
+		t = ht->old;
+	uint32_t capacity = SWISS(table_capacity)(t);
+	for (uint32_t i = 0; i < capacity; i++) {
+		uint32_t slot = (rnd + i) % capacity;
+		struct SWISS(group) *group = (struct SWISS(group) *)
+			matras_get(&t->mtable, slot / SWISS_GROUP_SIZE);
+		if (group->ctrl[slot % SWISS_GROUP_SIZE] >= 0)
+			return &group->value[slot % SWISS_GROUP_SIZE];
+	}
+	/* unreachable */
+	assert(false);
+	return NULL;
+}
+
+/**
+ * @brief Number of memory extents used by the hash table
+ * @param ht - pointer to a hash table struct
+ */
+static inline size_t
+SWISS(extent_count)(const struct SWISS(core) *ht)
+{
+	size_t count = 0;
+	const struct SWISS(table) *tables[3] = {ht->table, ht->old, ht->next};
+	for (int i = 0; i < 3; i++) {
+		if (tables[i] != NULL)
+			count += matras_extent_count(&tables[i]->mtable);
+	}
+	for (const struct SWISS(table) *t = ht->retired; t != NULL;
+	     t = t->next_retired)
+		count += matras_extent_count(&t->mtable);
+	return count;
+}
+
+/**
+ * @brief Set iterator to the beginning of the hash table
+ * @param ht - pointer to a hash table struct
+ * @param itr - iterator to set
+ */
+static inline void
+SWISS(iterator_begin)(const struct SWISS(core) *ht,
+		      struct SWISS(iterator) *itr)
+{
+	(void)ht;
+	itr->pos = 0;
+	itr->is_frozen = false;
+}
+
+/**
+ * @brief Set iterator to position determined by key
+ * @param ht - pointer to a hash table struct
+ * @param itr - iterator to set
+ * @param hash - hash to find
+ * @param key - key to find
+ */
+static inline void
+SWISS(iterator_key)(const struct SWISS(core) *ht,
+		    struct SWISS(iterator) *itr,
+		    uint32_t hash, SWISS_KEY_TYPE key)
+{
+	itr->is_frozen = false;
+	uint32_t old_capacity = ht->old != NULL ?
+				SWISS(table_capacity)(ht->old) : 0;
+	itr->pos = SWISS(table_find_key)(ht, ht->old, hash, key);
+	if (itr->pos != SWISS(end))
+		return;
+	itr->pos = SWISS(table_find_key)(ht, ht->table, hash, key);
+	if (itr->pos != SWISS(end))
+		itr->pos += old_capacity;
+}
+
+/**
+ * @brief Get the value that iterator currently points to
+ * and advance the iterator. Values of the old table go first.
+ * @param ht - pointer to a hash table struct
+ * @param itr - iterator to use
+ * @return pointer to the value or NULL if iteration is complete
+ */
+static inline SWISS_DATA_TYPE *
+SWISS(iterator_get_and_next)(const struct SWISS(core) *ht,
+			     struct SWISS(iterator) *itr)
+{
+	const struct SWISS(table) *tables[2];
+	const struct matras_view *views[2];
+	if (itr->is_frozen) {
+		for (int i = 0; i < 2; i++) {
+			tables[i] = itr->tables[i];
+			views[i] = &itr->views[i];
+		}
+	} else {
+		tables[0] = ht->old;
+		tables[1] = ht->table;
+		for (int i = 0; i < 2; i++) {
+			views[i] = tables[i] != NULL ?
+				   &tables[i]->mtable.head : NULL;
+		}
+	}
+	uint32_t base = 0;
+	for (int i = 0; i < 2; i++) {
+		const struct SWISS(table) *t = tables[i];
+		if (t == NULL)
+			continue;
+		uint32_t capacity = SWISS(table_capacity)(t);
+		while (itr->pos != SWISS(end) &&
+		       itr->pos - base < capacity) {
+			uint32_t slot = itr->pos - base;
+			struct SWISS(group) *group = (struct SWISS(group) *)
+				matras_view_get(&t->mtable, views[i],
+						slot / SWISS_GROUP_SIZE);
+			itr->pos++;
+			if (group->ctrl[slot % SWISS_GROUP_SIZE] >= 0)
+				return &group->value[slot % SWISS_GROUP_SIZE];
+		}
+		base += capacity;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Freezes state for given iterator. All following hash
+ * table modification will not apply to that iterator iteration.
+ * That iterator should be destroyed with a swiss_iterator_destroy
+ * call after usage.
+ * @param ht - pointer to a hash table struct
+ * @param itr - iterator to freeze
+ */
+static inline void
+SWISS(iterator_freeze)(struct SWISS(core) *ht, struct SWISS(iterator) *itr)
+{
+	assert(!itr->is_frozen);
+	itr->tables[0] = ht->old;
+	itr->tables[1] = ht->table;
+	for (int i = 0; i < 2; i++) {
+		struct SWISS(table) *t = itr->tables[i];
+		if (t == NULL)
+			continue;
+		matras_create_read_view(&t->mtable, &itr->views[i]);
+		t->view_count++;
+	}
+	itr->is_frozen = true;
+}
+
+/**
+ * @brief Destroy an iterator that was frozen before. Useless
+ * for not frozen iterators.
+ * @param ht - pointer to a hash table struct
+ * @param itr - iterator to destroy
+ */
+static inline void
+SWISS(iterator_destroy)(struct SWISS(core) *ht, struct SWISS(iterator) *itr)
+{
+	if (!itr->is_frozen)
+		return;
+	for (int i = 0; i < 2; i++) {
+		struct SWISS(table) *t = itr->tables[i];
+		if (t == NULL)
+			continue;
+		matras_destroy_read_view(&t->mtable, &itr->views[i]);
+		assert(t->view_count > 0);
+		t->view_count--;
+	}
+	/* Free retired tables that aren't used anymore. */
+	struct SWISS(table) **link = &ht->retired;
+	while (*link != NULL) {
+		struct SWISS(table) *t = *link;
+		if (t->view_count == 0) {
+			*link = t->next_retired;
+			SWISS(table_delete)(t);
+		} else {
+			link = &t->next_retired;
+		}
+	}
+	itr->is_frozen = false;
+}
+
+/*
+ * Selfcheck of the internal state of hash table. Used only for debugging.
+ * That means that you should not use this function.
+ * If return not zero, something went terribly wrong.
+ */
+static inline int
+SWISS(selfcheck)(const struct SWISS(core) *ht)
+{
+	int res = 0;
+	uint32_t total = 0;
+	const struct SWISS(table) *tables[2] = {ht->table, ht->old};
+	for (int i = 0; i < 2; i++) {
+		const struct SWISS(table) *t = tables[i];
+		if (t == NULL)
+			continue;
+		if (t->alloc_count != t->group_count)
+			res |= 1;
+		uint32_t count = 0, used = 0;
+		for (uint32_t g = 0; g < t->group_count; g++) {
+			const struct SWISS(group) *group =
+				(struct SWISS(group) *)
+				matras_get(&t->mtable, g);
+			for (int s = 0; s < SWISS_GROUP_SIZE; s++) {
+				int8_t ctrl = group->ctrl[s];
+				if (ctrl != SWISS_CTRL_EMPTY)
+					used++;
+				if (ctrl < 0)
+					continue;
+				count++;
+				if (ctrl != swiss_tag(group->hash[s]))
+					res |= 2;
+				if (SWISS(table_find)(ht, t, group->hash[s],
+						      group->value[s]) !=
+				    g * SWISS_GROUP_SIZE + (uint32_t)s)
+					res |= 4;
+			}
+		}
+		if (count != t->count)
+			res |= 8;
+		if (used != t->used)
+			res |= 16;
+		total += count;
+	}
+	if (total != ht->count)
+		res |= 32;
+	if (ht->next != NULL && ht->old != NULL)
+		res |= 64;
+	return res;
+}
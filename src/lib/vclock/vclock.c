@@ -51,6 +51,35 @@ vclock_follow(struct vclock *vclock, uint32_t replica_id, int64_t lsn)
 	return prev_lsn;
 }
 
+int64_t
+vclock_nth_element(const struct vclock *vclock, int n)
+{
+	assert(n >= 0);
+	int64_t lsns[VCLOCK_MAX];
+	int count = 0;
+	struct vclock_iterator it;
+	vclock_iterator_init(&it, vclock);
+	vclock_foreach(&it, replica)
+		lsns[count++] = replica.lsn;
+	if (n >= count)
+		return 0;
+	/*
+	 * Partial selection sort: there are at most VCLOCK_MAX
+	 * components, so it's cheaper than anything smarter.
+	 */
+	for (int i = 0; i <= n; i++) {
+		int max = i;
+		for (int j = i + 1; j < count; j++) {
+			if (lsns[j] > lsns[max])
+				max = j;
+		}
+		int64_t tmp = lsns[i];
+		lsns[i] = lsns[max];
+		lsns[max] = tmp;
+	}
+	return lsns[n];
+}
+
 static int
 vclock_snprint(char *buf, int size, const struct vclock *vclock)
 {
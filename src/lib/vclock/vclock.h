@@ -256,6 +256,19 @@ vclock_sum(const struct vclock *vclock)
 int64_t
 vclock_follow(struct vclock *vclock, uint32_t replica_id, int64_t lsn);
 
+/**
+ * Get the n-th (zero-based) largest LSN among the vclock
+ * components. Components that are not set count as zeros. In other
+ * words, it is the greatest LSN reached by at least n + 1 replicas.
+ *
+ * @param vclock Vector clock.
+ * @param n Zero-based position in the descending order of LSNs.
+ * @return the n-th largest LSN or 0 if there are not enough
+ *         components.
+ */
+int64_t
+vclock_nth_element(const struct vclock *vclock, int n);
+
 /**
  * Merge all diff changes into the destination
  * vclock and after reset the diff.
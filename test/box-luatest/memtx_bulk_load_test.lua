@@ -0,0 +1,170 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        for _, name in ipairs({'test', 'test2'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_bulk_load = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}}, unique = false})
+        s:create_index('hash', {type = 'hash', parts = {{3, 'unsigned'}}})
+        s:create_index('nullable', {parts = {{4, 'unsigned',
+                                             is_nullable = true}}})
+        local tuples = {}
+        for i = 1, 5000 do
+            local key = (i * 7919) % 5003
+            table.insert(tuples, {key, 'name' .. i % 100, i,
+                                  i % 2 == 0 and i or box.NULL})
+        end
+        local lsn = box.info.lsn
+        s:bulk_load(tuples)
+        t.assert_equals(box.info.lsn, lsn + #tuples)
+        t.assert_equals(s:len(), #tuples)
+        t.assert_equals(s.index.sk:count(), #tuples)
+        t.assert_equals(s.index.hash:count(), #tuples)
+        t.assert_equals(s.index.nullable:count(), #tuples)
+        t.assert_equals(s.index.sk:count({'name42'}), 50)
+        t.assert_equals(s.index.hash:get{100}[1], (100 * 7919) % 5003)
+        t.assert_equals(s.index.nullable:get{100}[3], 100)
+        local bsize = s:bsize()
+        t.assert_gt(bsize, 0)
+        -- Compare with a space filled with regular inserts.
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        for _, tuple in ipairs(tuples) do
+            s2:insert(tuple)
+        end
+        t.assert_equals(s:select(), s2:select())
+        t.assert_equals(bsize, s2:bsize())
+        -- The space accepts regular writes afterwards.
+        s:insert{6000, 'name', 6000}
+        s:delete{6000}
+    end)
+    -- Check that the data is recovered from WAL.
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:len(), 5000)
+        t.assert_equals(s.index.sk:count({'name42'}), 50)
+        t.assert_equals(s.index.hash:get{100}[1], (100 * 7919) % 5003)
+        t.assert_equals(s:select(), box.space.test2:select())
+    end)
+end
+
+g.test_bulk_load_checkpoint = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local tuples = {}
+        for i = 1, 5000 do
+            table.insert(tuples, {i})
+        end
+        local f = fiber.new(s.bulk_load, s, tuples)
+        f:set_joinable(true)
+        -- Let the load start writing WAL.
+        fiber.yield()
+        t.assert_equals(s:len(), 5000)
+        -- The checkpoint waits for the load to complete.
+        box.snapshot()
+        t.assert_equals(f:status(), 'dead')
+        t.assert_equals({f:join()}, {true})
+    end)
+    -- The checkpoint must not contain rows that are also in WAL
+    -- after the checkpoint vclock.
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:len(), 5000)
+    end)
+end
+
+g.test_bulk_load_iterator = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {temporary = true})
+        s:create_index('pk')
+        local s2 = box.schema.space.create('test2')
+        s2:create_index('pk')
+        for i = 1, 100 do
+            s2:insert{i, i * i}
+        end
+        local lsn = box.info.lsn
+        s:bulk_load(s2:pairs())
+        -- Temporary spaces aren't written to WAL.
+        t.assert_equals(box.info.lsn, lsn)
+        t.assert_equals(s:select(), s2:select())
+    end)
+end
+
+g.test_bulk_load_duplicate = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}}})
+        t.assert_error_msg_contains(
+            'Duplicate key exists in unique index "pk" in space "test"',
+            s.bulk_load, s, {{1, 1}, {2, 2}, {2, 3}})
+        t.assert_error_msg_contains(
+            'Duplicate key exists in unique index "sk" in space "test"',
+            s.bulk_load, s, {{1, 1}, {2, 2}, {3, 1}})
+        t.assert_error_msg_contains(
+            'expected unsigned, got string',
+            s.bulk_load, s, {{1, 1}, {2, 'x'}})
+        t.assert_equals(s:len(), 0)
+        t.assert_equals(s.index.sk:len(), 0)
+        t.assert_equals(s:bsize(), 0)
+        s:bulk_load({{1, 1}, {2, 2}, {3, 3}})
+        t.assert_equals(s:select(), {{1, 1}, {2, 2}, {3, 3}})
+    end)
+end
+
+g.test_bulk_load_errors = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert{1}
+        t.assert_error_msg_content_equals(
+            'memtx does not support bulk load into a non-empty space',
+            s.bulk_load, s, {{2}})
+        s:truncate()
+        box.begin()
+        t.assert_error_msg_content_equals(
+            'Operation is not permitted when there is an active ' ..
+            'transaction ', s.bulk_load, s, {{2}})
+        box.rollback()
+        s:before_replace(function() end)
+        t.assert_error_msg_contains(
+            'memtx does not support bulk load into a system or ' ..
+            'synchronous space', s.bulk_load, s, {{2}})
+        s:drop()
+        s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            'vinyl does not support bulk load', s.bulk_load, s, {{2}})
+    end)
+end
@@ -0,0 +1,121 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        box.cfg{memtx_defrag_threshold = 0, memtx_defrag_rate = 10000}
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_defrag_threshold, 0)
+        t.assert_equals(box.cfg.memtx_defrag_rate, 10000)
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'memtx_defrag_threshold': " ..
+            "must be greater than or equal to 0 and less than 1",
+            box.cfg, {memtx_defrag_threshold = 1})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'memtx_defrag_rate': " ..
+            "must be greater than 0",
+            box.cfg, {memtx_defrag_rate = 0})
+        box.cfg{memtx_defrag_threshold = 0.5, memtx_defrag_rate = 100}
+        t.assert_equals(box.cfg.memtx_defrag_threshold, 0.5)
+        t.assert_equals(box.cfg.memtx_defrag_rate, 100)
+    end)
+end
+
+-- Tuples are moved out of sparse slabs while the data stays intact.
+g.test_defrag = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}}})
+        local data = string.rep('x', 100)
+        box.begin()
+        for i = 1, 20000 do
+            s:insert{i, data .. i}
+        end
+        box.commit()
+        box.begin()
+        for i = 1, 20000 do
+            if i % 10 ~= 0 then
+                s:delete{i}
+            end
+        end
+        box.commit()
+        collectgarbage()
+        local info = box.slab.info()
+        t.assert_equals(info.defrag_tuples_relocated, 0)
+        local quota_used = info.quota_used
+
+        box.cfg{memtx_defrag_threshold = 0.1}
+        t.helpers.retrying({timeout = 30}, function()
+            t.assert_ge(box.slab.info().defrag_tuples_relocated, 1000)
+        end)
+        box.cfg{memtx_defrag_threshold = 0}
+        info = box.slab.info()
+        t.assert_gt(info.defrag_bytes_relocated, 0)
+        t.assert_le(info.quota_used, quota_used)
+
+        t.assert_equals(s:count(), 2000)
+        t.assert_equals(s.index.sk:count(), 2000)
+        for i = 10, 20000, 10 do
+            t.assert_equals(s:get{i}, {i, data .. i})
+            t.assert_equals(s.index.sk:get{data .. i}, {i, data .. i})
+        end
+    end)
+end
+
+-- A checkpoint leaves the engine in the garbage collection mode,
+-- which must not stop defragmentation once the checkpoint is over.
+g.test_defrag_after_snapshot = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local data = string.rep('x', 100)
+        box.begin()
+        for i = 1, 20000 do
+            s:insert{i, data .. i}
+        end
+        box.commit()
+        box.snapshot()
+        box.begin()
+        for i = 1, 20000 do
+            if i % 10 ~= 0 then
+                s:delete{i}
+            end
+        end
+        box.commit()
+        collectgarbage()
+        local relocated = box.slab.info().defrag_tuples_relocated
+
+        box.cfg{memtx_defrag_threshold = 0.1}
+        t.helpers.retrying({timeout = 30}, function()
+            t.assert_ge(box.slab.info().defrag_tuples_relocated,
+                        relocated + 1000)
+        end)
+        box.cfg{memtx_defrag_threshold = 0}
+
+        t.assert_equals(s:count(), 2000)
+        for i = 10, 20000, 10 do
+            t.assert_equals(s:get{i}, {i, data .. i})
+        end
+    end)
+end
@@ -0,0 +1,41 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_hugepages = true},
+    })
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+-- The option can't be changed at runtime and huge pages are
+-- reported by box.slab.hugepages_size(). Whether the kernel
+-- actually backs the arena with huge pages depends on the system
+-- settings, so only check that the instance works fine.
+g.test_hugepages = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_use_hugepages, true)
+        t.assert_error_msg_content_equals(
+            "Can't set option 'memtx_use_hugepages' dynamically",
+            box.cfg, {memtx_use_hugepages = false})
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 10000 do
+            s:insert{i, string.rep('x', 100)}
+        end
+        local info = box.slab.info()
+        t.assert_equals(info.arena_hugepages_size, nil)
+        local size = box.slab.hugepages_size()
+        t.assert_ge(size, 0)
+        t.assert_le(size, info.quota_size)
+        t.assert_equals(s:count(), 10000)
+        s:drop()
+    end)
+end
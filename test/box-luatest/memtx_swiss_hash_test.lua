@@ -0,0 +1,111 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_swiss_hash = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash', hash_table = 'swiss'})
+        s:create_index('sk', {type = 'hash', parts = {2, 'string'},
+                              hash_table = 'swiss'})
+        t.assert_equals(s.index.pk.hash_table, 'swiss')
+        t.assert_equals(s.index.sk.hash_table, 'swiss')
+        -- Insert enough tuples to make the table resize a few times.
+        box.begin()
+        for i = 1, 100000 do
+            s:insert{i, tostring(i)}
+        end
+        box.commit()
+        t.assert_equals(s:len(), 100000)
+        t.assert_equals(s.index.sk:len(), 100000)
+        t.assert_equals(s:get{500}, {500, '500'})
+        t.assert_equals(s.index.sk:get{'777'}, {777, '777'})
+        t.assert_equals(s:get{100001}, nil)
+        t.assert_error_msg_content_equals(
+            'Duplicate key exists in unique index "sk" in space "test" ' ..
+            'with old tuple - [1, "1"] and new tuple - [0, "1"]',
+            s.insert, s, {0, '1'})
+        t.assert_equals(s:get{0}, nil)
+        s:replace{1, 'one'}
+        t.assert_equals(s.index.sk:get{'1'}, nil)
+        t.assert_equals(s.index.sk:get{'one'}, {1, 'one'})
+        for i = 1, 100000, 2 do
+            s:delete{i}
+        end
+        t.assert_equals(s:len(), 50000)
+        t.assert_equals(s:get{3}, nil)
+        t.assert_equals(s:get{4}, {4, '4'})
+        t.assert_equals(#s:select({}, {iterator = 'all'}), 50000)
+        t.assert_equals(s:select({4}, {iterator = 'eq'}), {{4, '4'}})
+        t.assert_not_equals(s.index.pk:random(1), nil)
+        t.assert_gt(s.index.pk:bsize(), 0)
+    end)
+    -- Check that the index is recovered from a snapshot.
+    g.server:exec(function() box.snapshot() end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.pk.hash_table, 'swiss')
+        t.assert_equals(s:len(), 50000)
+        t.assert_equals(s.index.sk:get{'4'}, {4, '4'})
+    end)
+end
+
+g.test_swiss_hash_alter = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        t.assert_equals(s.index.pk.hash_table, nil)
+        for i = 1, 1000 do
+            s:insert{i}
+        end
+        s.index.pk:alter({hash_table = 'swiss'})
+        t.assert_equals(s.index.pk.hash_table, 'swiss')
+        t.assert_equals(s:len(), 1000)
+        t.assert_equals(s:get{10}, {10})
+        s.index.pk:alter({hash_table = 'light'})
+        t.assert_equals(s.index.pk.hash_table, nil)
+        t.assert_equals(s:get{10}, {10})
+    end)
+end
+
+g.test_swiss_hash_errors = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "hash_table is only reasonable with memtx hash index",
+            s.create_index, s, 'pk', {type = 'tree', hash_table = 'swiss'})
+        t.assert_error_msg_content_equals(
+            "Wrong index options (field 4): " ..
+            "hash_table must be either 'light' or 'swiss'",
+            s.create_index, s, 'pk', {type = 'hash', hash_table = 'foo'})
+        s:drop()
+        s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "hash_table is only reasonable with memtx hash index",
+            s.create_index, s, 'pk', {type = 'tree', hash_table = 'swiss'})
+    end)
+end
@@ -0,0 +1,126 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_inline_key = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {inline_key = true})
+        s:create_index('name', {parts = {{2, 'string'}}, inline_key = true})
+        t.assert_equals(s.index.pk.inline_key, true)
+        t.assert_equals(s.index.name.inline_key, true)
+        -- Strings that are stored inline as a whole, strings that
+        -- differ only in trailing zero bytes and long strings.
+        local names = {'', 'a', 'a\0', 'a\0\0', 'ab', 'abcdefg', 'abcdefg\0',
+                       'abcdefgh', 'abcdefghijklmn', 'abcdefghijklmn\0',
+                       'abcdefghijklmno', 'abcdefghijklmnp', 'b'}
+        for i, name in ipairs(names) do
+            s:insert{i, name}
+        end
+        for i, name in ipairs(names) do
+            t.assert_equals(s.index.name:get{name}[1], i)
+            t.assert_equals(s:get{i}[2], name)
+        end
+        t.assert_equals(s.index.name:get{'abcdefghijklm'}, nil)
+        t.assert_equals(s.index.name:get{'a\0\0\0'}, nil)
+        local res = {}
+        for _, tuple in s.index.name:pairs() do
+            table.insert(res, tuple[1])
+        end
+        t.assert_equals(res, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {100, 'a\0'})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.insert, s, {13, 'c'})
+        s:replace{3, 'c'}
+        t.assert_equals(s.index.name:get{'a\0'}, nil)
+        t.assert_equals(s.index.name:get{'c'}[1], 3)
+        box.snapshot()
+    end)
+    -- Check that the index is recovered from a snapshot.
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.name.inline_key, true)
+        t.assert_equals(s.index.name:get{'abcdefghijklmn\0'}[1], 10)
+        local res = s.index.name:select({'abcdefghijklmn'},
+                                        {iterator = 'gt', limit = 2})
+        t.assert_equals(#res, 2)
+        t.assert_equals(res[1][1], 10)
+        t.assert_equals(res[2][1], 11)
+    end)
+end
+
+-- Integer keys and keys of different kinds in a scalar index are
+-- ordered the same way as without inline keys.
+g.test_inline_key_order = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {parts = {{1, 'integer'}}, inline_key = true})
+        s:create_index('sc', {parts = {{2, 'scalar'}}, unique = false,
+                              inline_key = true})
+        s:create_index('sc2', {parts = {{2, 'scalar'}}, unique = false})
+        local values = {true, 1, -1, 2^60, -2^60, 1.5, 'x', 'xxxxxxxxxx',
+                        'xxxxxxxxxxxxxxxxxxxxxx'}
+        for i = -2000, 2000 do
+            s:insert{i * 1000000007, values[i % #values + 1]}
+        end
+        t.assert_equals(s.index.pk:get{-7 * 1000000007},
+                        {-7 * 1000000007, values[-7 % #values + 1]})
+        t.assert_equals(s.index.sc:select(), s.index.sc2:select())
+        t.assert_equals(s.index.sc:count{'xxxxxxxxxx'},
+                        s.index.sc2:count{'xxxxxxxxxx'})
+        t.assert_equals(s.index.sc:count{1}, s.index.sc2:count{1})
+        t.assert_equals(s:count({0}, {iterator = 'ge'}), 2001)
+    end)
+end
+
+g.test_inline_key_options = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "inline_key is only reasonable with memtx tree index",
+            s.create_index, s, 'pk', {type = 'hash', inline_key = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "inline_key can't be used without hint",
+            s.create_index, s, 'pk', {hint = false, inline_key = true})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "multikey and functional indexes can't use inline keys",
+            s.create_index, s, 'sk', {parts = {{'[2][*]', 'unsigned'}},
+                                      inline_key = true})
+        for i = 1, 100 do
+            s:insert{i}
+        end
+        s.index.pk:alter({inline_key = true})
+        t.assert_equals(s.index.pk.inline_key, true)
+        t.assert_equals(s:get{42}, {42})
+        s.index.pk:alter({inline_key = false})
+        t.assert_equals(s.index.pk.inline_key, nil)
+        t.assert_equals(s:count(), 100)
+    end)
+end
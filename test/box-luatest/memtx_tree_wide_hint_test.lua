@@ -0,0 +1,123 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_wide_hint = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {wide_hint = true})
+        s:create_index('tenant', {parts = {{2, 'unsigned'}, {3, 'unsigned'}},
+                                  wide_hint = true})
+        s:create_index('path', {parts = {{4, 'string'}}, unique = false,
+                                wide_hint = true})
+        t.assert_equals(s.index.pk.wide_hint, true)
+        t.assert_equals(s.index.tenant.wide_hint, true)
+        -- Long common string prefixes and few distinct tenants.
+        local prefix = '/tenants/common/prefix/'
+        box.begin()
+        for i = 1, 10000 do
+            s:insert{i, i % 4, 10000 - i, prefix .. string.format('%05d', i)}
+        end
+        box.commit()
+        t.assert_equals(s:len(), 10000)
+        t.assert_equals(s.index.tenant:get{1, 9999}, {1, 1, 9999,
+                                                      prefix .. '00001'})
+        t.assert_equals(s.index.tenant:get{1, 9998}, nil)
+        t.assert_equals(s.index.path:select(prefix .. '00042'),
+                        {{42, 2, 9958, prefix .. '00042'}})
+        local res = s.index.tenant:select({2}, {iterator = 'ge', limit = 3})
+        t.assert_equals(res, {{9998, 2, 2, prefix .. '09998'},
+                              {9994, 2, 6, prefix .. '09994'},
+                              {9990, 2, 10, prefix .. '09990'}})
+        res = s.index.path:select({prefix .. '00100'},
+                                  {iterator = 'lt', limit = 2})
+        t.assert_equals(res, {{99, 3, 9901, prefix .. '00099'},
+                              {98, 2, 9902, prefix .. '00098'}})
+        t.assert_equals(#s.index.tenant:select({3}), 2500)
+        -- Make sure the ordering matches the index without wide hints.
+        s:create_index('tenant2', {parts = {{2, 'unsigned'},
+                                            {3, 'unsigned'}}})
+        t.assert_equals(s.index.tenant:select(), s.index.tenant2:select())
+        for i = 1, 10000, 2 do
+            s:delete{i}
+        end
+        t.assert_equals(s.index.tenant:count(), 5000)
+        t.assert_equals(s.index.tenant:get{1, 9999}, nil)
+        t.assert_equals(s.index.tenant:select(), s.index.tenant2:select())
+        box.snapshot()
+    end)
+    -- Check that the index is recovered from a snapshot.
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.tenant.wide_hint, true)
+        t.assert_equals(s.index.tenant:select(), s.index.tenant2:select())
+        t.assert_equals(s.index.tenant:get{2, 9998}, {2, 2, 9998,
+                        '/tenants/common/prefix/00002'})
+    end)
+end
+
+g.test_wide_hint_alter = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'string'}}})
+        t.assert_equals(s.index.sk.wide_hint, nil)
+        for i = 1, 1000 do
+            s:insert{i, string.rep('x', 20) .. i}
+        end
+        s.index.sk:alter({wide_hint = true})
+        t.assert_equals(s.index.sk.wide_hint, true)
+        t.assert_equals(s.index.sk:get{string.rep('x', 20) .. 10}[1], 10)
+        s.index.sk:alter({wide_hint = false})
+        t.assert_equals(s.index.sk.wide_hint, nil)
+        t.assert_equals(s.index.sk:get{string.rep('x', 20) .. 10}[1], 10)
+    end)
+end
+
+g.test_wide_hint_errors = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "wide_hint is only reasonable with memtx tree index",
+            s.create_index, s, 'pk', {type = 'hash', wide_hint = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "wide_hint can't be used without hint",
+            s.create_index, s, 'pk', {hint = false, wide_hint = true})
+        s:create_index('pk')
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'test': " ..
+            "multikey and functional indexes can't use wide hints",
+            s.create_index, s, 'sk', {parts = {{'[2][*]', 'unsigned'}},
+                                      wide_hint = true})
+        s:drop()
+        s = box.schema.space.create('test', {engine = 'vinyl'})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "wide_hint is only reasonable with memtx tree index",
+            s.create_index, s, 'pk', {wide_hint = true})
+    end)
+end
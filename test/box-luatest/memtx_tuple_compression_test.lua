@@ -0,0 +1,200 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_options = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        t.assert_equals(s.compression_threshold, 0)
+        s:alter({compression_threshold = 512})
+        t.assert_equals(s.compression_threshold, 512)
+        t.assert_equals(s:stat().compression.threshold, 512)
+        t.assert_error_msg_content_equals(
+            "Can't modify space 'test_vinyl': " ..
+            "engine does not support tuple compression",
+            box.schema.space.create, 'test_vinyl',
+            {engine = 'vinyl', compression_threshold = 512})
+    end)
+end
+
+-- Large fields are compressed transparently, indexed and typed
+-- fields are stored as is.
+g.test_compression = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {
+            compression_threshold = 256,
+            format = {{'id', 'unsigned'}, {'name', 'string'}, {'doc'}},
+        })
+        s:create_index('pk')
+        s:create_index('name', {parts = {'name'}})
+        local doc = {}
+        for i = 1, 100 do
+            doc['key' .. i] = string.rep('value', 5)
+        end
+        local name = string.rep('n', 300)
+        for i = 1, 10 do
+            s:insert{i, name .. i, doc, string.rep('x', 1000)}
+        end
+        s:insert{11, 'short', 'short'}
+
+        local stat = s:stat().compression
+        t.assert_equals(stat.tuples, 10)
+        t.assert_equals(stat.fields, 20)
+        t.assert_gt(stat.ratio, 5)
+        t.assert_lt(s:bsize(), stat.raw_size)
+
+        local tuple = s:get{5}
+        t.assert_equals(tuple.doc, doc)
+        t.assert_equals(tuple[4], string.rep('x', 1000))
+        t.assert_equals(tuple:totable(), {5, name .. 5, doc,
+                                          string.rep('x', 1000)})
+        t.assert_equals(tuple:tomap().doc, doc)
+        t.assert_equals(s.index.name:get{name .. 7}.id, 7)
+        t.assert_equals(s:get{11}:totable(), {11, 'short', 'short'})
+        t.assert_gt(s:stat().compression.decode_count, 0)
+
+        s:update({5}, {{'=', 'doc', 'replaced'}})
+        t.assert_equals(s:get{5}.doc, 'replaced')
+        t.assert_equals(s:get{5}[4], string.rep('x', 1000))
+    end)
+end
+
+-- Compressed tuples are sent to clients decompressed and survive
+-- recovery from a snapshot.
+g.test_net_box_and_recovery = function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {
+            compression_threshold = 128,
+        })
+        s:create_index('pk')
+        for i = 1, 10 do
+            s:insert{i, string.rep('x', 1000)}
+        end
+        box.snapshot()
+    end)
+    local data = string.rep('x', 1000)
+    g.server:connect_net_box()
+    t.assert_equals(g.server.net_box.space.test:get{3}, {3, data})
+    t.assert_equals(g.server.net_box:eval('return box.space.test:get{4}'),
+                    {4, data})
+    g.server:restart()
+    g.server:exec(function(data)
+        local t = require('luatest')
+        t.assert_equals(box.space.test:get{7}:totable(), {7, data})
+        -- The snapshot stores raw data, which is compressed again
+        -- on recovery.
+        t.assert_equals(box.space.test:stat().compression.tuples, 10)
+        box.space.test:replace{7, data}
+        t.assert_equals(box.space.test:stat().compression.tuples, 11)
+    end, {data})
+    g.server:connect_net_box()
+    t.assert_equals(g.server.net_box.space.test:select{}[10], {10, data})
+end
+
+-- Compressed fields never get to snapshots and can't be sent by
+-- clients.
+g.test_snapshot_and_input = function()
+    g.server:exec(function()
+        local fio = require('fio')
+        local msgpack = require('msgpack')
+        local t = require('luatest')
+        local xlog = require('xlog')
+        local s = box.schema.space.create('test', {
+            compression_threshold = 128,
+        })
+        s:create_index('pk')
+        local data = string.rep('x', 1000)
+        s:insert{1, data}
+        t.assert_equals(s:stat().compression.tuples, 1)
+        box.snapshot()
+        local snaps = fio.glob(fio.pathjoin(box.cfg.memtx_dir, '*.snap'))
+        table.sort(snaps)
+        local found = false
+        for _, row in xlog.pairs(snaps[#snaps]) do
+            if row.BODY.space_id == s.id then
+                t.assert_equals(row.BODY.tuple, {1, data})
+                found = true
+            end
+        end
+        t.assert(found)
+
+        local raw = msgpack.object_from_raw('\xd4\x05\x00')
+        local msg = "Illegal parameters, " ..
+                    "compressed fields can't be sent by clients"
+        t.assert_error_msg_content_equals(msg, s.insert, s, {2, raw})
+        t.assert_error_msg_content_equals(msg, s.update, s, {1},
+                                          {{'=', 2, raw}})
+        t.assert_error_msg_contains('Unsupported MsgPack extension type',
+                                    msgpack.decode, '\xd4\x05\x00')
+    end)
+end
+
+-- A field stored compressed can't become indexed until the tuple
+-- is rewritten with compression disabled.
+g.test_alter = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {
+            compression_threshold = 128,
+        })
+        s:create_index('pk')
+        local data = string.rep('x', 1000)
+        s:insert{1, data}
+        t.assert_error_msg_content_equals(
+            "Compression error: field 2 is stored compressed, " ..
+            "replace the tuple with compression disabled first",
+            s.create_index, s, 'sk', {parts = {2, 'string'}})
+        s:alter({compression_threshold = 0})
+        s:update({1}, {{'!', 3, 'y'}})
+        s:create_index('sk', {parts = {2, 'string'}})
+        t.assert_equals(s.index.sk:get{data}, {1, data, 'y'})
+    end)
+end
+
+-- Update and upsert operations and SQL see compressed fields
+-- decompressed.
+g.test_update_upsert_sql = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {
+            compression_threshold = 128,
+            format = {{'id', 'unsigned'}, {'data'}, {'doc'}},
+        })
+        s:create_index('pk')
+        local data = string.rep('x', 1000)
+        local doc = {count = 1, text = string.rep('y', 1000)}
+        s:insert{1, data, doc}
+        t.assert_equals(s:stat().compression.fields, 2)
+
+        s:update({1}, {{':', 'data', 1, 1, 'z'}, {'+', 'doc.count', 1}})
+        t.assert_equals(s:get{1}.data, 'z' .. string.rep('x', 999))
+        t.assert_equals(s:get{1}.doc.count, 2)
+        s:upsert({1, 'new', {}}, {{'+', 'doc.count', 10}})
+        t.assert_equals(s:get{1}.doc.count, 12)
+        t.assert_equals(s:get{1}.doc.text, doc.text)
+
+        local res = box.execute([[SELECT "data" FROM "test";]])
+        t.assert_equals(res.rows, {{'z' .. string.rep('x', 999)}})
+        res = box.execute([[SELECT * FROM "test" WHERE "id" = 1;]])
+        t.assert_equals(res.rows, {s:get{1}:totable()})
+    end)
+end
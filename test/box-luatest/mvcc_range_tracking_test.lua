@@ -0,0 +1,138 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new{
+        alias   = 'default',
+        box_cfg = {memtx_use_mvcc_engine = true}
+    }
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        -- Runs a reader transaction that calls read(), lets a writer
+        -- insert a tuple, then writes something itself and commits.
+        -- Returns true if the reader committed without conflict.
+        rawset(_G, 'reader_commits', function(read, tuple)
+            local fiber = require('fiber')
+            local ch1 = fiber.channel(1)
+            local ch2 = fiber.channel(1)
+            local f = fiber.new(function()
+                box.begin()
+                read()
+                ch1:put(true)
+                ch2:get()
+                box.space.test:replace{1000, 1000}
+                return pcall(box.commit)
+            end)
+            f:set_joinable(true)
+            ch1:get()
+            box.space.test:insert(tuple)
+            ch2:put(true)
+            local _, ok = f:join()
+            box.space.test:delete{tuple[1]}
+            box.space.test:delete{1000}
+            return ok
+        end)
+    end)
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.before_each(function()
+    g.server:exec(function()
+        box.space.test:truncate()
+        for i = 10, 100, 10 do
+            box.space.test:insert{i, i % 30}
+        end
+    end)
+end)
+
+g.test_forward_range = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local function read()
+            s:select({25}, {iterator = 'GE', limit = 3})
+        end
+        -- The range read is [25, 50].
+        t.assert_not(_G.reader_commits(read, {35, 0}))
+        t.assert_not(_G.reader_commits(read, {25, 0}))
+        t.assert(_G.reader_commits(read, {20, 0}))
+        t.assert(_G.reader_commits(read, {55, 0}))
+        -- Exhausted iterator reads to the end of the index.
+        local function read_all()
+            s:select({95}, {iterator = 'GT'})
+        end
+        t.assert_not(_G.reader_commits(read_all, {200, 0}))
+        t.assert(_G.reader_commits(read_all, {95, 0}))
+    end)
+end
+
+g.test_reverse_range = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local function read()
+            s:select({75}, {iterator = 'LT', limit = 2})
+        end
+        -- The range read is [60, 75).
+        t.assert_not(_G.reader_commits(read, {65, 0}))
+        t.assert(_G.reader_commits(read, {75, 0}))
+        t.assert(_G.reader_commits(read, {55, 0}))
+        local function read_all()
+            s:select({15}, {iterator = 'LE'})
+        end
+        t.assert_not(_G.reader_commits(read_all, {1, 0}))
+        t.assert(_G.reader_commits(read_all, {16, 0}))
+    end)
+end
+
+g.test_equal_range = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local function read()
+            s.index.sk:select({10})
+        end
+        t.assert_not(_G.reader_commits(read, {5, 10}))
+        t.assert_not(_G.reader_commits(read, {200, 10}))
+        t.assert(_G.reader_commits(read, {15, 0}))
+        t.assert(_G.reader_commits(read, {15, 20}))
+        local function read_reverse()
+            s.index.sk:select({20}, {iterator = 'REQ'})
+        end
+        t.assert_not(_G.reader_commits(read_reverse, {85, 20}))
+        t.assert(_G.reader_commits(read_reverse, {85, 10}))
+    end)
+end
+
+g.test_merged_ranges = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        -- Overlapping and adjacent ranges of destroyed iterators are
+        -- merged, disjoint ones are kept apart.
+        local ranges
+        local function read()
+            s:select({25}, {iterator = 'GE', limit = 1})
+            s:select({25}, {iterator = 'GE', limit = 2})
+            s:select({40}, {iterator = 'GE', limit = 1})
+            s:select({75}, {iterator = 'LE', limit = 1})
+            ranges = box.stat.memtx.tx().trackers.range
+        end
+        -- The ranges read are [25, 30), [25, 40), [40, 40) and (70, 75].
+        t.assert_not(_G.reader_commits(read, {27, 0}))
+        t.assert_equals(ranges, 2)
+        t.assert_not(_G.reader_commits(read, {73, 0}))
+        t.assert(_G.reader_commits(read, {20, 0}))
+        t.assert(_G.reader_commits(read, {50, 0}))
+        t.assert(_G.reader_commits(read, {80, 0}))
+        t.assert_equals(box.stat.memtx.tx().trackers.range, 0)
+    end)
+end
@@ -0,0 +1,111 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new{
+        alias   = 'default',
+        box_cfg = {memtx_use_mvcc_engine = true}
+    }
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {type = 'hash', parts = {2, 'string'}})
+    end)
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.before_each(function()
+    g.server:exec(function()
+        box.space.test:truncate()
+        box.space.test:insert{1, 'a'}
+        box.space.test:insert{2, 'b'}
+        box.stat.reset()
+    end)
+end)
+
+g.test_read_only_txn = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.space.test
+        local ch1 = fiber.channel(1)
+        local ch2 = fiber.channel(1)
+        local f = fiber.new(function()
+            box.begin({read_only = true})
+            local before = {s:get{1}, s:select{}, s.index.sk:select{}}
+            ch1:put(true)
+            ch2:get()
+            local after = {s:get{1}, s:select{}, s.index.sk:select{}}
+            local ok, err = pcall(s.replace, s, {3, 'c'})
+            box.commit()
+            return before, after, ok, err
+        end)
+        f:set_joinable(true)
+        ch1:get()
+        s:replace{1, 'x'}
+        s:delete{2}
+        ch2:put(true)
+        local _, before, after, ok, err = f:join()
+        t.assert_equals(after, before)
+        t.assert_equals(before[1], {1, 'a'})
+        t.assert_not(ok)
+        t.assert_equals(err.code, box.error.TRANSACTION_READ_ONLY)
+        t.assert_equals(s:select{}, {{1, 'x'}})
+
+        local stat = box.stat.memtx.tx()
+        t.assert_equals(stat.txn.read_only, 1)
+        t.assert_equals(stat.txn.read_view, 0)
+        t.assert_ge(stat.saved_trackers.read, 2)
+        t.assert_ge(stat.saved_trackers.full_scan, 1)
+
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, read_only must be a boolean",
+            box.begin, {read_only = 1})
+    end)
+end
+
+g.test_auto_read_view = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.space.test
+        local ch1 = fiber.channel(1)
+        local ch2 = fiber.channel(1)
+        local f = fiber.new(function()
+            box.begin()
+            s:get{1}
+            s:select{}
+            ch1:put(true)
+            ch2:get()
+            local result = s:select{}
+            box.commit()
+            return result
+        end)
+        f:set_joinable(true)
+        ch1:get()
+        s:replace{1, 'x'}
+        -- The trackers of the transaction sent to a read view are
+        -- released by the next garbage collection round, which is
+        -- run on a read tracked by another transaction.
+        box.begin()
+        s:get{2}
+        box.commit()
+        local stat = box.stat.memtx.tx()
+        t.assert_equals(stat.txn.read_view, 1)
+        t.assert_ge(stat.saved_trackers.read, 2)
+        ch2:put(true)
+        local _, result = f:join()
+        t.assert_equals(result, {{1, 'a'}, {2, 'b'}})
+
+        stat = box.stat.memtx.tx()
+        t.assert_equals(stat.txn.read_only, 0)
+        t.assert_equals(stat.txn.read_view, 1)
+        t.assert_ge(stat.saved_trackers.read, 2)
+    end)
+end
@@ -0,0 +1,154 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        local h = box.schema.space.create('test_hash')
+        h:create_index('pk', {type = 'hash'})
+        for i = 1, 10 do
+            s:insert{i, i % 3}
+            h:insert{i}
+        end
+    end)
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.test_isolation = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local rv = box.read_view.open({name = 'isolation'})
+        t.assert_equals(rv.name, 'isolation')
+        t.assert_equals(rv.status, 'open')
+        t.assert_equals(rv.vclock, box.info.vclock)
+        s:replace{1, 100}
+        s:delete{2}
+        s:insert{11, 0}
+        local rs = rv.space.test
+        t.assert_equals(rs:get{1}, {1, 1})
+        t.assert_equals(rs:get{2}, {2, 2})
+        t.assert_equals(rs:get{11}, nil)
+        t.assert_equals(#rs:select(), 10)
+        t.assert_equals(rv.space[s.id], rs)
+        rv:close()
+        t.assert_equals(rv.status, 'closed')
+        t.assert_error_msg_equals('Read view is closed', rs.select, rs)
+        -- Restore the original contents.
+        s:replace{1, 1}
+        s:insert{2, 2}
+        s:delete{11}
+    end)
+end
+
+g.test_range = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local rv = box.read_view.open()
+        local rs = rv.space.test
+        t.assert_equals(rs:select({8}, {iterator = 'GE'}),
+                        {{8, 2}, {9, 0}, {10, 1}})
+        t.assert_equals(rs:select({3}, {iterator = 'LT'}), {{2, 2}, {1, 1}})
+        t.assert_equals(rs:select({5}, {iterator = 'GT', limit = 2,
+                                        offset = 1}), {{7, 1}, {8, 2}})
+        t.assert_equals(rs.index.sk:select({0}), {{3, 0}, {6, 0}, {9, 0}})
+        t.assert_equals(rs.index[1]:select({2}, {iterator = 'REQ'}),
+                        {{8, 2}, {5, 2}, {2, 2}})
+        local keys = {}
+        for _, tuple in rs.index.sk:pairs({1}, {iterator = 'GT'}) do
+            table.insert(keys, tuple[1])
+        end
+        t.assert_equals(keys, {2, 5, 8})
+        rv:close()
+    end)
+end
+
+g.test_hash = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local rv = box.read_view.open({spaces = {'test_hash'}})
+        t.assert_equals(rv.space.test, nil)
+        local rs = rv.space.test_hash
+        box.space.test_hash:delete{5}
+        t.assert_equals(#rs:select(), 10)
+        t.assert_error_msg_contains('does not support read view',
+                                    rs.select, rs, {1})
+        rv:close()
+        box.space.test_hash:insert{5}
+    end)
+end
+
+g.test_list = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local rv1 = box.read_view.open({name = 'one'})
+        local rv2 = box.read_view.open({name = 'two'})
+        local list = box.read_view.list()
+        t.assert_equals(#list, 2)
+        t.assert_equals(list[1].id, rv1.id)
+        t.assert_equals(list[1].name, 'one')
+        t.assert_equals(list[2].name, 'two')
+        t.assert_equals(list[2].status, 'open')
+        rv1:close()
+        t.assert_equals(#box.read_view.list(), 1)
+        rv2:close()
+        t.assert_equals(box.read_view.list(), {})
+    end)
+end
+
+local g_mvcc = t.group('read_view_mvcc')
+
+g_mvcc.before_all = function()
+    g_mvcc.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    g_mvcc.server:start()
+end
+
+g_mvcc.after_all = function()
+    g_mvcc.server:drop()
+end
+
+-- A tuple whose secondary key is changed by an uncommitted
+-- transaction is only seen at its committed position.
+g_mvcc.test_uncommitted_secondary_key = function()
+    g_mvcc.server:exec(function()
+        local fiber = require('fiber')
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        s:insert{1, 10}
+        s:insert{2, 20}
+        local cond = fiber.cond()
+        local f = fiber.new(function()
+            box.begin()
+            s:update({1}, {{'=', 2, 30}})
+            cond:wait()
+            box.rollback()
+        end)
+        f:set_joinable(true)
+        fiber.yield()
+        local rv = box.read_view.open()
+        local rs = rv.space.test
+        t.assert_equals(rs:select(), {{1, 10}, {2, 20}})
+        t.assert_equals(rs.index.sk:select(), {{1, 10}, {2, 20}})
+        t.assert_equals(rs.index.sk:select({30}), {})
+        t.assert_equals(rs.index.sk:select({10}), {{1, 10}})
+        t.assert_equals(rs.index.sk:select({15}, {iterator = 'GE'}),
+                        {{2, 20}})
+        rv:close()
+        cond:signal()
+        f:join()
+        s:drop()
+    end)
+end
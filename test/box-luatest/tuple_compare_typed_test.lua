@@ -0,0 +1,77 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks comparators specialized for key part types on keys that
+-- don't start from the first field.
+local function check_typed_compare(engine)
+    g.server:exec(function(engine)
+        local t = require('luatest')
+        local uuid = require('uuid')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {parts = {{3, 'integer'}, {2, 'uuid'}}})
+        s:create_index('sk', {parts = {{4, 'string'}, {1, 'unsigned'}},
+                              unique = false})
+        local uuids = {}
+        for i = 1, 4 do
+            uuids[i] = uuid.fromstr(string.format(
+                '%08x-0000-0000-0000-000000000000', i))
+        end
+        local expected = {}
+        for i = 1, 200 do
+            local tuple = {i, uuids[i % 4 + 1], i % 13 - 6, tostring(i % 5)}
+            if s:get{tuple[3], tuple[2]} == nil then
+                s:insert(tuple)
+                table.insert(expected, {tuple[3], tostring(tuple[2])})
+            end
+        end
+        table.sort(expected, function(a, b)
+            if a[1] ~= b[1] then
+                return a[1] < b[1]
+            end
+            return a[2] < b[2]
+        end)
+        local actual = {}
+        for _, tuple in s.index.pk:pairs() do
+            table.insert(actual, {tuple[3], tostring(tuple[2])})
+        end
+        t.assert_equals(actual, expected)
+        t.assert_equals(s.index.pk:get({-6, uuids[3]}),
+                        {26, uuids[3], -6, '1'})
+        t.assert_equals(#s.index.pk:select({-6}), 4)
+        t.assert_equals(s.index.pk:select({0, uuids[2]}, {iterator = 'gt',
+                                                           limit = 1}),
+                        {{6, uuids[3], 0, '1'}})
+        local res = s.index.sk:select({'3', 20}, {iterator = 'le'})
+        t.assert_equals(#res, 4)
+        for i, tuple in ipairs(res) do
+            t.assert_equals(tuple[4], '3')
+            t.assert_equals(tuple[1], 23 - 5 * i)
+        end
+    end, {engine})
+end
+
+g.test_typed_compare_memtx = function()
+    check_typed_compare('memtx')
+end
+
+g.test_typed_compare_vinyl = function()
+    check_typed_compare('vinyl')
+end
@@ -0,0 +1,67 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+local g = t.group()
+
+g.before_all = function()
+    g.server = server:new({alias = 'master'})
+    g.server:start()
+end
+
+g.after_all = function()
+    g.server:drop()
+end
+
+g.after_each(function()
+    g.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Fields preceded only by mandatory fields of fixed-size types are
+-- accessed by static offsets instead of field map offsets.
+local function check_static_offset(engine)
+    g.server:exec(function(engine)
+        local t = require('luatest')
+        local uuid = require('uuid')
+        local s = box.schema.space.create('test', {engine = engine, format = {
+            {'price', 'double'}, {'flag', 'boolean'}, {'id', 'uuid'},
+            {'count', 'unsigned'}, {'name', 'string'},
+            {'opt', 'double', is_nullable = true}, {'tail', 'unsigned'},
+        }})
+        s:create_index('pk', {parts = {'id'}})
+        s:create_index('price', {parts = {'price', 'id'}})
+        s:create_index('flag', {parts = {'flag', 'count'}, unique = false})
+        s:create_index('name', {parts = {'name'}})
+        s:create_index('tail', {parts = {'tail'}})
+        local ids = {}
+        for i = 1, 100 do
+            ids[i] = uuid.new()
+            local opt = i % 2 == 0 and box.NULL or i / 4
+            s:insert{i + 0.5, i % 3 == 0, ids[i], i, 'name' .. i, opt, i * 10}
+        end
+        t.assert_equals(s:get{ids[7]}:totable(),
+                        {7.5, false, ids[7], 7, 'name7', 1.75, 70})
+        t.assert_equals(s.index.price:get{10.5, ids[10]}[4], 10)
+        t.assert_equals(s.index.flag:count({true}), 33)
+        t.assert_equals(s.index.flag:select({true, 9})[1][5], 'name9')
+        t.assert_equals(s.index.name:get{'name42'}.price, 42.5)
+        t.assert_equals(s.index.tail:get{420}.count, 42)
+        t.assert_equals(s.index.tail:get{430}.opt, 10.75)
+        s:update({ids[5]}, {{'=', 'count', 500}, {'=', 'price', 0.25}})
+        t.assert_equals(s.index.price:min()[4], 500)
+        t.assert_equals(s.index.flag:select({false, 500})[1].id, ids[5])
+        s:delete{ids[5]}
+        t.assert_equals(s.index.flag:select({false, 500}), {})
+        t.assert_equals(s:len(), 99)
+    end, {engine})
+end
+
+g.test_static_offset_memtx = function()
+    check_static_offset('memtx')
+end
+
+g.test_static_offset_vinyl = function()
+    check_static_offset('vinyl')
+end
@@ -0,0 +1,86 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('applier_wal_batch', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_each(function(cg)
+    local engine = cg.params.engine
+
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication_timeout = 1,
+    }
+
+    cg.master = cg.cluster:build_server({alias = 'master', engine = engine, box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            server.build_instance_uri('master'),
+        },
+        replication_timeout = 1,
+        read_only           = true
+    }
+
+    cg.replica = cg.cluster:build_server({alias = 'replica', engine = engine, box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_replica(cg)
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+end
+
+g.test_applier_wal_batch = function(cg)
+    cg.master:exec(function(engine)
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        -- Many concurrent small transactions, so that the replica receives
+        -- a lot of them at once.
+        local fibers = {}
+        for i = 1, 100 do
+            local f = fiber.new(function()
+                for j = 1, 10 do
+                    s:insert{i * 100 + j}
+                end
+            end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            f:join()
+        end
+    end, {cg.params.engine})
+    wait_replica(cg)
+
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 1000)
+        local upstream = box.info.replication[1].upstream
+        t.assert_equals(upstream.status, 'follow')
+        t.assert_gt(upstream.wal_batch.count, 0)
+        t.assert_ge(upstream.wal_batch.txns, 1000)
+        t.assert_le(upstream.wal_batch.count, upstream.wal_batch.txns)
+    end)
+
+    -- Transaction boundaries are preserved in the replica's WAL.
+    cg.replica:stop()
+    cg.replica:start()
+    wait_replica(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 1000)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
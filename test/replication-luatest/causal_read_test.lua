@@ -0,0 +1,175 @@
+local fiber = require('fiber')
+local msgpack = require('msgpack')
+local socket = require('socket')
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local IPROTO_REQUEST_TYPE = 0x00
+local IPROTO_SYNC = 0x01
+local IPROTO_STREAM_ID = 0x0a
+local IPROTO_SPACE_ID = 0x10
+local IPROTO_KEY = 0x20
+local IPROTO_TUPLE = 0x21
+local IPROTO_FUNCTION_NAME = 0x22
+local IPROTO_VCLOCK = 0x26
+local IPROTO_DATA = 0x30
+local IPROTO_ERROR_24 = 0x31
+local IPROTO_TIMEOUT = 0x56
+local IPROTO_RETURN_VCLOCK = 0x5c
+
+local IPROTO_SELECT = 1
+local IPROTO_INSERT = 2
+local IPROTO_CALL = 10
+local IPROTO_BEGIN = 14
+local IPROTO_COMMIT = 15
+
+local g = t.group('causal-read')
+
+g.before_all(function()
+    g.cluster = cluster:new({})
+    g.master = g.cluster:build_server({alias = 'master'})
+    g.replica = g.cluster:build_server({alias = 'replica', box_cfg = {
+        replication = server.build_instance_uri('master'),
+        read_only = true,
+    }})
+    g.cluster:add_server(g.master)
+    g.cluster:add_server(g.replica)
+    g.cluster:start()
+    g.space_id = g.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        return s.id
+    end)
+    g.replica:wait_vclock(g.master:get_vclock())
+end)
+
+g.after_all(function()
+    g.cluster:drop()
+end)
+
+local function map(tbl)
+    return setmetatable(tbl, {__serialize = 'map'})
+end
+
+local function connect(server)
+    local sock = socket.tcp_connect('unix/', server.net_box_uri)
+    t.assert(sock)
+    -- Skip the greeting.
+    t.assert_equals(#sock:read(128), 128)
+    return {sock = sock, sync = 0}
+end
+
+-- Sends a raw iproto request and returns the response header and body.
+local function request(conn, header, body)
+    conn.sync = conn.sync + 1
+    header[IPROTO_SYNC] = conn.sync
+    local data = msgpack.encode(map(header)) .. msgpack.encode(map(body))
+    conn.sock:write(msgpack.encode(#data) .. data)
+    local size = msgpack.decode(conn.sock:read(5))
+    data = conn.sock:read(size)
+    local resp_header, pos = msgpack.decode(data)
+    return resp_header, msgpack.decode(data, pos)
+end
+
+local function stop_replication()
+    g.replica:exec(function()
+        box.cfg{replication = {}}
+    end)
+end
+
+local function start_replication()
+    g.replica:exec(function(uri)
+        box.cfg{replication = uri}
+    end, {server.build_instance_uri('master')})
+end
+
+g.test_read_your_writes = function(g)
+    stop_replication()
+    local master = connect(g.master)
+    local replica = connect(g.replica)
+
+    local _, body = request(master, {[IPROTO_REQUEST_TYPE] = IPROTO_INSERT}, {
+        [IPROTO_SPACE_ID] = g.space_id,
+        [IPROTO_TUPLE] = {1},
+        [IPROTO_RETURN_VCLOCK] = true,
+    })
+    t.assert_equals(body[IPROTO_DATA], {{1}})
+    local token = body[IPROTO_VCLOCK]
+    t.assert_equals(token[1], g.master:get_vclock()[1])
+
+    -- The replica doesn't have the write yet.
+    local select = {
+        [IPROTO_SPACE_ID] = g.space_id,
+        [IPROTO_KEY] = {1},
+        [IPROTO_VCLOCK] = map(token),
+        [IPROTO_TIMEOUT] = 0.01,
+    }
+    local header
+    header, body = request(replica, {[IPROTO_REQUEST_TYPE] = IPROTO_SELECT},
+                           select)
+    t.assert_not_equals(header[IPROTO_REQUEST_TYPE], 0)
+    t.assert_equals(body[IPROTO_ERROR_24], 'Timeout exceeded')
+
+    -- The read waits until the replica catches up.
+    select[IPROTO_TIMEOUT] = nil
+    local f = fiber.new(request, replica,
+                        {[IPROTO_REQUEST_TYPE] = IPROTO_SELECT}, select)
+    f:set_joinable(true)
+    start_replication()
+    local ok
+    ok, header, body = f:join()
+    t.assert(ok)
+    t.assert_equals(header[IPROTO_REQUEST_TYPE], 0)
+    t.assert_equals(body[IPROTO_DATA], {{1}})
+
+    master.sock:close()
+    replica.sock:close()
+end
+
+g.test_commit_token = function(g)
+    stop_replication()
+    local master = connect(g.master)
+    local replica = connect(g.replica)
+
+    request(master, {[IPROTO_REQUEST_TYPE] = IPROTO_BEGIN,
+                     [IPROTO_STREAM_ID] = 1}, {})
+    request(master, {[IPROTO_REQUEST_TYPE] = IPROTO_INSERT,
+                     [IPROTO_STREAM_ID] = 1},
+            {[IPROTO_SPACE_ID] = g.space_id, [IPROTO_TUPLE] = {2}})
+    local header, body = request(master, {
+        [IPROTO_REQUEST_TYPE] = IPROTO_COMMIT,
+        [IPROTO_STREAM_ID] = 1,
+    }, {[IPROTO_RETURN_VCLOCK] = true})
+    t.assert_equals(header[IPROTO_REQUEST_TYPE], 0)
+    local token = body[IPROTO_VCLOCK]
+    t.assert_equals(token[1], g.master:get_vclock()[1])
+
+    local f = fiber.new(request, replica, {[IPROTO_REQUEST_TYPE] = IPROTO_CALL}, {
+        [IPROTO_FUNCTION_NAME] = 'box.space.test:get',
+        [IPROTO_TUPLE] = {2},
+        [IPROTO_VCLOCK] = map(token),
+    })
+    f:set_joinable(true)
+    start_replication()
+    local ok
+    ok, header, body = f:join()
+    t.assert(ok)
+    t.assert_equals(header[IPROTO_REQUEST_TYPE], 0)
+    t.assert_equals(body[IPROTO_DATA], {{2}})
+
+    master.sock:close()
+    replica.sock:close()
+end
+
+g.test_invalid_token = function(g)
+    local replica = connect(g.replica)
+    local header, body = request(replica,
+                                 {[IPROTO_REQUEST_TYPE] = IPROTO_SELECT}, {
+        [IPROTO_SPACE_ID] = g.space_id,
+        [IPROTO_VCLOCK] = map({[100] = 1}),
+    })
+    t.assert_not_equals(header[IPROTO_REQUEST_TYPE], 0)
+    t.assert_str_contains(body[IPROTO_ERROR_24], 'Invalid MsgPack')
+    replica.sock:close()
+end
@@ -0,0 +1,109 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('checkpoint_join')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_and_add_server({alias = 'master'})
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function start_replica(cg)
+    local box_cfg = {
+        replication = {
+            server.build_instance_uri('master'),
+        },
+        replication_join_mode = 'checkpoint',
+        read_only = true,
+    }
+    cg.replica = cg.cluster:build_and_add_server({alias = 'replica',
+                                                  box_cfg = box_cfg})
+    cg.replica:start()
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+end
+
+g.test_checkpoint_join = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local loc = box.schema.space.create('loc', {is_local = true})
+        loc:create_index('pk')
+        for i = 1, 1000 do
+            s:insert{i, string.rep('x', 100)}
+            loc:insert{i}
+        end
+        box.snapshot()
+        -- Changes made after the checkpoint come from WAL.
+        for i = 1001, 1100 do
+            s:insert{i}
+        end
+        s:delete{1}
+    end)
+    start_replica(cg)
+    t.assert(cg.master:grep_log('sending checkpoint'))
+    t.assert(cg.replica:grep_log('loading the master checkpoint'))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 1099)
+        t.assert_equals(box.space.test:get{1}, nil)
+        t.assert_equals(box.space.test:get{2}[1], 2)
+        t.assert_equals(box.space.test:get{1100}, {1100})
+        t.assert_equals(box.space.loc:count(), 0)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+        t.assert_equals(box.space._cluster:count(), 2)
+    end)
+    cg.master:exec(function()
+        box.space.test:insert{2000}
+    end)
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:get{2000}, {2000})
+    end)
+    -- The replica recovers from its own checkpoint and WAL.
+    cg.replica:restart()
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 1100)
+    end)
+end
+
+g.test_checkpoint_join_vinyl = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert{i}
+        end
+        box.snapshot()
+    end)
+    start_replica(cg)
+    -- Vinyl files aren't sent, so the master uses a read view.
+    t.assert_not(cg.master:grep_log('sending checkpoint'))
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 100)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+end
+
+g.test_replication_join_mode_cfg = function(cg)
+    cg.master:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.replication_join_mode, 'read_view')
+        t.assert_error_msg_content_equals(
+            "Can't set option 'replication_join_mode' dynamically",
+            box.cfg, {replication_join_mode = 'checkpoint'})
+    end)
+end
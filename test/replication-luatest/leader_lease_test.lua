@@ -0,0 +1,168 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+local wait_timeout = 120
+
+local g = t.group('leader-lease')
+
+g.before_all(function()
+    g.cluster = cluster:new({})
+    local master_uri = server.build_instance_uri('master')
+    local replica_uri = server.build_instance_uri('replica')
+    local replication = {master_uri, replica_uri}
+    local box_cfg = {
+        listen = master_uri,
+        replication = replication,
+        replication_timeout = 0.1,
+        replication_synchro_quorum = 2,
+        election_leader_lease = true,
+    }
+    g.master = g.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    box_cfg.listen = replica_uri
+    g.replica = g.cluster:build_server({alias = 'replica', box_cfg = box_cfg})
+
+    g.cluster:add_server(g.master)
+    g.cluster:add_server(g.replica)
+    g.cluster:start()
+
+    g.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert{1}
+        local tmp = box.schema.space.create('tmp', {temporary = true})
+        tmp:create_index('pk')
+    end)
+    g.replica:wait_vclock(g.master:get_vclock())
+    g.replica:exec(function()
+        box.space.tmp:insert{1}
+        box.cfg{election_mode = 'voter'}
+    end)
+    g.master:exec(function()
+        box.cfg{election_mode = 'candidate'}
+    end)
+    g.master:wait_election_leader()
+end)
+
+g.after_all(function()
+    g.cluster:drop()
+end)
+
+g.test_leader_lease = function(g)
+    g.master:exec(function(wait_timeout)
+        local t = require('luatest')
+        box.session.settings.linearizable_read = true
+        t.helpers.retrying({timeout = wait_timeout}, function()
+            t.assert_equals(box.space.test:select(), {{1}})
+        end)
+        t.assert_equals(box.space.test:get{1}, {1})
+        t.assert_equals(box.space.test.index.pk:count(), 1)
+        t.assert_equals(box.space.tmp:select(), {})
+        box.session.settings.linearizable_read = false
+    end, {wait_timeout})
+
+    g.replica:exec(function()
+        local t = require('luatest')
+        box.session.settings.linearizable_read = true
+        t.assert_error_msg_contains('The instance is not a leader',
+                                    box.space.test.select, box.space.test)
+        t.assert_error_msg_contains('The instance is not a leader',
+                                    box.space.test.get, box.space.test, {1})
+        -- Spaces which aren't replicated can be read anywhere.
+        t.assert_equals(box.space.tmp:select(), {{1}})
+        box.session.settings.linearizable_read = false
+        t.assert_equals(box.space.test:select(), {{1}})
+    end)
+end
+
+g.test_leader_lease_expired = function(g)
+    g.replica:stop()
+    g.master:exec(function(wait_timeout)
+        local t = require('luatest')
+        box.session.settings.linearizable_read = true
+        t.helpers.retrying({timeout = wait_timeout}, function()
+            t.assert_error_msg_content_equals(
+                "The leader doesn't hold a lease to serve linearizable reads",
+                box.space.test.select, box.space.test)
+        end)
+        t.assert_equals(box.info.election.state, 'leader')
+        box.session.settings.linearizable_read = false
+        t.assert_equals(box.space.test:select(), {{1}})
+    end, {wait_timeout})
+    g.replica:start()
+    g.master:exec(function(wait_timeout)
+        local t = require('luatest')
+        box.session.settings.linearizable_read = true
+        t.helpers.retrying({timeout = wait_timeout}, function()
+            t.assert_equals(box.space.test:select(), {{1}})
+        end)
+        box.session.settings.linearizable_read = false
+    end, {wait_timeout})
+end
+
+g.test_leader_lease_disabled = function(g)
+    g.master:exec(function(wait_timeout)
+        local t = require('luatest')
+        box.session.settings.linearizable_read = true
+        t.helpers.retrying({timeout = wait_timeout}, function()
+            t.assert_equals(box.space.test:select(), {{1}})
+        end)
+        box.cfg{election_leader_lease = false}
+        t.assert_error_msg_content_equals(
+            "The leader doesn't hold a lease to serve linearizable reads",
+            box.space.test.select, box.space.test)
+        box.cfg{election_leader_lease = true}
+        box.session.settings.linearizable_read = false
+    end, {wait_timeout})
+end
+
+-- A follower which doesn't honour leases itself doesn't help the leader
+-- to hold one.
+g.test_leader_lease_disabled_on_replica = function(g)
+    g.replica:exec(function()
+        box.cfg{election_leader_lease = false}
+    end)
+    g.master:exec(function(wait_timeout)
+        local t = require('luatest')
+        box.session.settings.linearizable_read = true
+        t.helpers.retrying({timeout = wait_timeout}, function()
+            t.assert_error_msg_content_equals(
+                "The leader doesn't hold a lease to serve linearizable reads",
+                box.space.test.select, box.space.test)
+        end)
+        box.session.settings.linearizable_read = false
+    end, {wait_timeout})
+    g.replica:exec(function()
+        box.cfg{election_leader_lease = true}
+    end)
+    g.master:exec(function(wait_timeout)
+        local t = require('luatest')
+        box.session.settings.linearizable_read = true
+        t.helpers.retrying({timeout = wait_timeout}, function()
+            t.assert_equals(box.space.test:select(), {{1}})
+        end)
+        box.session.settings.linearizable_read = false
+    end, {wait_timeout})
+end
+
+-- A linearizable read waits until the synchronous transactions written
+-- before it are confirmed.
+g.test_leader_lease_waits_for_limbo = function(g)
+    g.master:exec(function(wait_timeout)
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.schema.space.create('sync', {is_sync = true})
+        s:create_index('pk')
+        box.session.settings.linearizable_read = true
+        t.helpers.retrying({timeout = wait_timeout}, function()
+            t.assert_equals(box.space.test:select(), {{1}})
+        end)
+        fiber.create(function() s:insert{1} end)
+        t.assert_not_equals(box.info.synchro.queue.len, 0)
+        t.assert_equals(box.space.test:select(), {{1}})
+        t.assert_equals(box.info.synchro.queue.len, 0)
+        t.assert_equals(s:select(), {{1}})
+        box.session.settings.linearizable_read = false
+        s:drop()
+    end, {wait_timeout})
+end
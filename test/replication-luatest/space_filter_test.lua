@@ -0,0 +1,111 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('space_filter')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_and_add_server({alias = 'master'})
+    cg.cluster:start()
+    cg.master:exec(function()
+        for _, def in ipairs({{'a', 600}, {'b', 601}}) do
+            local s = box.schema.space.create(def[1], {id = def[2]})
+            s:create_index('pk')
+            s:insert{0}
+        end
+    end)
+    local box_cfg = {
+        replication = {
+            server.build_instance_uri('master'),
+        },
+        replication_space_filter = {600},
+        replication_anon = true,
+        read_only = true,
+    }
+    cg.replica = cg.cluster:build_and_add_server({alias = 'replica',
+                                                  box_cfg = box_cfg})
+    cg.replica:start()
+end)
+
+g.after_all(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_replica(cg)
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+end
+
+g.test_space_filter = function(cg)
+    cg.master:exec(function()
+        local a = box.space.a
+        local b = box.space.b
+        for i = 1, 10 do
+            a:insert{i}
+            b:insert{i}
+        end
+        -- A transaction having only filtered rows.
+        box.begin()
+        for i = 11, 20 do
+            b:insert{i}
+        end
+        box.commit()
+        -- A transaction starting and ending with filtered rows.
+        box.begin()
+        b:insert{21}
+        a:insert{21}
+        a:insert{22}
+        b:insert{22}
+        box.commit()
+        -- Schema changes are always sent.
+        a:create_index('sk', {parts = {{1, 'unsigned'}}})
+    end)
+    wait_replica(cg)
+    local function check()
+        cg.replica:exec(function()
+            local t = require('luatest')
+            -- The data sent on join isn't filtered.
+            t.assert_equals(box.space.b:select(), {{0}})
+            t.assert_equals(box.space.a:count(), 13)
+            t.assert_equals(box.space.a:get{22}, {22})
+            t.assert_not_equals(box.space.a.index.sk, nil)
+            t.assert_equals(box.info.replication[1].upstream.status,
+                            'follow')
+        end)
+    end
+    check()
+    -- The replica recovers the filtered stream from its WAL and
+    -- resubscribes from the right position.
+    cg.replica:restart()
+    wait_replica(cg)
+    check()
+    cg.master:exec(function()
+        box.space.a:insert{100}
+        box.space.b:insert{100}
+    end)
+    wait_replica(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.a:get{100}, {100})
+        t.assert_equals(box.space.b:get{100}, nil)
+    end)
+end
+
+g.test_space_filter_cfg = function(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.replication_space_filter, {600})
+        t.assert_error_msg_content_equals(
+            "Can't set option 'replication_space_filter' dynamically",
+            box.cfg, {replication_space_filter = {601}})
+        -- Only anonymous replicas may filter rows.
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'replication_anon': the value " ..
+            "may be set to false only when replication_space_filter " ..
+            "is empty",
+            box.cfg, {replication_anon = false})
+    end)
+end
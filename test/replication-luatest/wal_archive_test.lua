@@ -0,0 +1,112 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local server = require('test.luatest_helpers.server')
+
+local g = t.group('wal_archive')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    cg.master = cg.cluster:build_and_add_server({
+        alias = 'master',
+        box_cfg = {
+            wal_max_size = 1024,
+            wal_archive_dir = 'archive',
+            wal_retention_size = 4096,
+            wal_cleanup_delay = 0,
+            checkpoint_count = 1,
+        },
+    })
+    cg.replica = cg.cluster:build_and_add_server({
+        alias = 'replica',
+        box_cfg = {
+            replication = {
+                server.build_instance_uri('master'),
+            },
+            read_only = true,
+        },
+    })
+    cg.cluster:start()
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_replica(cg)
+    local vclock = cg.master:get_vclock()
+    vclock[0] = nil
+    cg.replica:wait_vclock(vclock)
+end
+
+g.test_archive = function(cg)
+    wait_replica(cg)
+    cg.replica:stop()
+    cg.master:exec(function()
+        local fio = require('fio')
+        local t = require('luatest')
+        for i = 1, 5 do
+            for j = 1, 50 do
+                box.space.test:insert{i * 100 + j, string.rep('x', 100)}
+            end
+            box.snapshot()
+        end
+        -- The stopped replica pins WAL files, which are moved to
+        -- the archive in background once their total size exceeds
+        -- the limit.
+        t.helpers.retrying({}, function()
+            local size = 0
+            for _, path in ipairs(fio.glob('*.xlog')) do
+                size = size + fio.stat(path).size
+            end
+            t.assert_le(size,
+                        box.cfg.wal_retention_size + box.cfg.wal_max_size)
+        end)
+        local archived = fio.glob('archive/*.xlog')
+        t.assert_not_equals(#archived, 0)
+        t.assert_equals(fio.glob('archive/*.inprogress'), {})
+        -- The oldest files are archived first.
+        local first = fio.basename(fio.glob('*.xlog')[1])
+        t.assert_lt(fio.basename(archived[#archived]), first)
+    end)
+    -- The replica is fed from the archive.
+    cg.replica:start()
+    wait_replica(cg)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 250)
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+    end)
+    -- Archived files are garbage collected once the replica is
+    -- done with them.
+    cg.master:exec(function()
+        local fio = require('fio')
+        local t = require('luatest')
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(fio.glob('archive/*.xlog'), {})
+        end)
+    end)
+end
+
+g.test_cfg = function(cg)
+    cg.master:exec(function()
+        local fio = require('fio')
+        local t = require('luatest')
+        -- The archive directory is created on startup.
+        t.assert(fio.path.is_dir('archive'))
+        t.assert_error_msg_content_equals(
+            "Can't set option 'wal_archive_dir' dynamically",
+            box.cfg, {wal_archive_dir = 'other'})
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'wal_retention_size': " ..
+            "value must be >= 0",
+            box.cfg, {wal_retention_size = -1})
+        box.cfg{wal_retention_size = 0}
+        t.assert_equals(box.cfg.wal_retention_size, 0)
+    end)
+end
@@ -542,6 +542,101 @@ iterator_freeze_check()
 	footer();
 }
 
+static void
+view_check()
+{
+	header();
+
+	const int test_data_size = 1000;
+	const int test_data_mod = 2000;
+	srand(0);
+	struct test tree;
+	test_create(&tree, 0, extent_alloc, extent_free,
+		    &total_extents_allocated);
+
+	/* Read view of an empty tree. */
+	struct test_view view;
+	test_view_create(&tree, &view);
+	struct test_iterator itr = test_view_first(&tree, &view);
+	fail_unless(test_iterator_get_elem(&tree, &itr) == NULL);
+	itr = test_view_lower_bound(&tree, &view, 0, NULL);
+	fail_unless(test_iterator_get_elem(&tree, &itr) == NULL);
+	test_view_destroy(&tree, &view);
+
+	for (int j = 0; j < test_data_size; j++) {
+		elem_t e;
+		e.first = rand() % test_data_mod;
+		e.second = j;
+		test_insert(&tree, e, 0, 0);
+	}
+	elem_t comp_buf[test_data_size];
+	int comp_buf_size = 0;
+	itr = test_iterator_first(&tree);
+	elem_t *e;
+	while ((e = test_iterator_get_elem(&tree, &itr))) {
+		comp_buf[comp_buf_size++] = *e;
+		test_iterator_next(&tree, &itr);
+	}
+
+	test_view_create(&tree, &view);
+	/* Modify the tree after the read view is created. */
+	for (int j = 0; j < test_data_size; j++) {
+		elem_t e;
+		e.first = rand() % test_data_mod;
+		e.second = test_data_size + j;
+		test_insert(&tree, e, 0, 0);
+		e = comp_buf[rand() % comp_buf_size];
+		test_delete(&tree, e);
+		int check = test_debug_check(&tree);
+		fail_if(check);
+		assert(check == 0);
+	}
+
+	/* Full scan in both directions. */
+	int tested_count = 0;
+	itr = test_view_first(&tree, &view);
+	while ((e = test_iterator_get_elem(&tree, &itr))) {
+		fail_unless(tested_count < comp_buf_size);
+		fail_unless(equal(*e, comp_buf[tested_count]));
+		tested_count++;
+		test_iterator_next(&tree, &itr);
+	}
+	fail_unless(tested_count == comp_buf_size);
+	itr = test_view_last(&tree, &view);
+	while ((e = test_iterator_get_elem(&tree, &itr))) {
+		fail_unless(tested_count > 0);
+		tested_count--;
+		fail_unless(equal(*e, comp_buf[tested_count]));
+		test_iterator_prev(&tree, &itr);
+	}
+	fail_unless(tested_count == 0);
+
+	/* Range lookups match the tree state at the moment of creation. */
+	for (long key = -1; key <= test_data_mod; key++) {
+		int lower = 0;
+		while (lower < comp_buf_size && comp_buf[lower].first < key)
+			lower++;
+		int upper = lower;
+		while (upper < comp_buf_size && comp_buf[upper].first == key)
+			upper++;
+		bool exact;
+		itr = test_view_lower_bound(&tree, &view, key, &exact);
+		fail_unless(exact == (lower != upper));
+		e = test_iterator_get_elem(&tree, &itr);
+		fail_unless(lower == comp_buf_size ? e == NULL :
+			    e != NULL && equal(*e, comp_buf[lower]));
+		itr = test_view_upper_bound(&tree, &view, key, &exact);
+		fail_unless(exact == (lower != upper));
+		e = test_iterator_get_elem(&tree, &itr);
+		fail_unless(upper == comp_buf_size ? e == NULL :
+			    e != NULL && equal(*e, comp_buf[upper]));
+	}
+	test_view_destroy(&tree, &view);
+	test_destroy(&tree);
+
+	footer();
+}
+
 
 int
 main(void)
@@ -550,6 +645,7 @@ main(void)
 	iterator_check();
 	iterator_invalidate_check();
 	iterator_freeze_check();
+	view_check();
 	if (total_extents_allocated) {
 		fail("memory leak", "true");
 	}
@@ -1893,10 +1893,133 @@ raft_test_split_vote(void)
 	raft_finish_test();
 }
 
+static void
+raft_test_leader_lease(void)
+{
+	raft_start_test(18);
+	struct raft_node node;
+	raft_node_create(&node);
+	raft_node_cfg_is_candidate(&node, false);
+	raft_node_cfg_is_lease_enabled(&node, true);
+
+	/* A follower doesn't go to a new term while the leader is alive. */
+
+	is(raft_node_send_leader(&node,
+		2 /* Term. */,
+		2 /* Source. */
+	), 0, "leader notification");
+
+	double death_timeout = node.cfg_death_timeout;
+	raft_run_for(death_timeout / 2);
+	is(raft_node_send_vote_request(&node,
+		3 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		2 /* Leader. */,
+		2 /* Term. */,
+		0 /* Vote. */,
+		2 /* Volatile term. */,
+		0 /* Volatile vote. */,
+		"{0: 1}" /* Vclock. */
+	), "new term is ignored while the leader is alive");
+
+	raft_node_send_heartbeat(&node, 2);
+	raft_run_for(death_timeout * 3 / 4);
+	is(raft_node_send_vote_request(&node,
+		3 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		2 /* Leader. */,
+		2 /* Term. */,
+		0 /* Vote. */,
+		2 /* Volatile term. */,
+		0 /* Volatile vote. */,
+		"{0: 1}" /* Vclock. */
+	), "heartbeat prolongs the leader's life");
+
+	raft_run_for(death_timeout / 2);
+	is(raft_node_send_vote_request(&node,
+		3 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(raft_node_check_full_state(&node,
+		RAFT_STATE_FOLLOWER /* State. */,
+		0 /* Leader. */,
+		3 /* Term. */,
+		3 /* Vote. */,
+		3 /* Volatile term. */,
+		3 /* Volatile vote. */,
+		"{0: 2}" /* Vclock. */
+	), "voted for 3 when the leader is dead");
+
+	raft_node_destroy(&node);
+
+	/* The leader has the lease while a quorum acks its messages. */
+
+	raft_node_create(&node);
+	raft_node_cfg_is_lease_enabled(&node, true);
+
+	raft_run_next_event();
+	raft_node_send_vote_response(&node,
+		2 /* Term. */,
+		1 /* Vote. */,
+		2 /* Source. */
+	);
+	raft_node_send_vote_response(&node,
+		2 /* Term. */,
+		1 /* Vote. */,
+		3 /* Source. */
+	);
+	is(node.raft.state, RAFT_STATE_LEADER, "became leader");
+	ok(!raft_has_lease(&node.raft), "no lease without acks");
+
+	double ts = raft_time();
+	raft_process_lease_ack(&node.raft, 2, ts - 1);
+	raft_process_lease_ack(&node.raft, 3, ts - 1);
+	ok(!raft_has_lease(&node.raft), "acks sent before the election are "
+	   "ignored");
+
+	raft_process_lease_ack(&node.raft, 2, ts);
+	ok(!raft_has_lease(&node.raft), "not enough acks");
+	raft_process_lease_ack(&node.raft, 3, ts);
+	ok(raft_has_lease(&node.raft), "got the lease");
+
+	double election_timeout = node.cfg_election_timeout;
+	raft_run_for(election_timeout / 2);
+	ok(raft_has_lease(&node.raft), "the lease is still valid");
+	raft_run_for(election_timeout / 2);
+	ok(!raft_has_lease(&node.raft), "the lease is expired");
+
+	ts = raft_time();
+	raft_process_lease_ack(&node.raft, 2, ts);
+	raft_process_lease_ack(&node.raft, 3, ts);
+	ok(raft_has_lease(&node.raft), "the lease is renewed");
+
+	raft_node_cfg_is_lease_enabled(&node, false);
+	ok(!raft_has_lease(&node.raft), "no lease when disabled");
+	raft_node_cfg_is_lease_enabled(&node, true);
+
+	is(raft_node_send_follower(&node,
+		3 /* Term. */,
+		2 /* Source. */
+	), 0, "message with a new term");
+	ok(!raft_has_lease(&node.raft), "no lease after the term bump");
+
+	raft_node_destroy(&node);
+	raft_finish_test();
+}
+
 static int
 main_f(va_list ap)
 {
-	raft_start_test(16);
+	raft_start_test(17);
 
 	(void) ap;
 	fakeev_init();
@@ -1917,6 +2040,7 @@ main_f(va_list ap)
 	raft_test_promote_restore();
 	raft_test_bump_term_before_cfg();
 	raft_test_split_vote();
+	raft_test_leader_lease();
 
 	fakeev_free();
 
@@ -59,6 +59,13 @@ raft_loop(void)
 	return fakeev_loop();
 }
 
+double
+raft_ev_monotonic_now(struct ev_loop *loop)
+{
+	(void)loop;
+	return fakeev_time();
+}
+
 static void
 raft_node_broadcast_f(struct raft *raft, const struct raft_msg *msg);
 
@@ -386,6 +393,7 @@ raft_node_cfg(struct raft_node *node)
 	raft_cfg_election_quorum(&node->raft, node->cfg_election_quorum);
 	raft_cfg_death_timeout(&node->raft, node->cfg_death_timeout);
 	raft_cfg_max_shift(&node->raft, node->cfg_max_shift);
+	raft_cfg_is_lease_enabled(&node->raft, node->cfg_is_lease_enabled);
 	raft_cfg_instance_id(&node->raft, node->cfg_instance_id);
 	raft_cfg_cluster_size(&node->raft, node->cfg_cluster_size);
 	raft_cfg_vclock(&node->raft, node->cfg_vclock);
@@ -496,6 +504,16 @@ raft_node_cfg_max_shift(struct raft_node *node, double value)
 	}
 }
 
+void
+raft_node_cfg_is_lease_enabled(struct raft_node *node, bool value)
+{
+	node->cfg_is_lease_enabled = value;
+	if (raft_node_is_started(node)) {
+		raft_cfg_is_lease_enabled(&node->raft, value);
+		raft_run_async_work();
+	}
+}
+
 bool
 raft_msg_check(const struct raft_msg *msg, enum raft_state state, uint64_t term,
 	       uint32_t vote, const char *vclock)
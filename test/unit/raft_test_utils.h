@@ -106,6 +106,7 @@ struct raft_node {
 	int cfg_election_quorum;
 	double cfg_death_timeout;
 	double cfg_max_shift;
+	bool cfg_is_lease_enabled;
 	uint32_t cfg_instance_id;
 	int cfg_cluster_size;
 	struct vclock *cfg_vclock;
@@ -253,6 +254,9 @@ raft_node_cfg_death_timeout(struct raft_node *node, double value);
 void
 raft_node_cfg_max_shift(struct raft_node *node, double value);
 
+void
+raft_node_cfg_is_lease_enabled(struct raft_node *node, bool value);
+
 /** Check that @a msg message matches the given arguments. */
 bool
 raft_msg_check(const struct raft_msg *msg, enum raft_state state, uint64_t term,
@@ -296,6 +296,48 @@ test_tostring()
 
 #undef test
 
+static inline int
+test_nth_element_one(uint32_t count, const int64_t *lsns, int n, int64_t res)
+{
+	struct vclock vclock;
+	vclock_create(&vclock);
+	for (uint32_t node_id = 0; node_id < count; node_id++) {
+		if (lsns[node_id] > 0)
+			vclock_follow(&vclock, node_id, lsns[node_id]);
+	}
+	int64_t result = vclock_nth_element(&vclock, n);
+	if (result != res)
+		diag("\n!!!new result!!! %lld\n", (long long)result);
+	return result == res;
+}
+
+#define test(xa, n, res) ({\
+	const int64_t a[] = {xa};					\
+	ok(test_nth_element_one(sizeof(a) / sizeof(*a), a, n, res),	\
+		"nth_element %s, %d => %lld", str((xa)), n,		\
+		(long long)res); })
+int
+test_nth_element()
+{
+	plan(9);
+	header();
+
+	test(arg(), 0, 0);
+	test(arg(10), 0, 10);
+	test(arg(10), 1, 0);
+	test(arg(10, 20, 30), 0, 30);
+	test(arg(10, 20, 30), 1, 20);
+	test(arg(10, 20, 30), 2, 10);
+	test(arg(30, -1, 10, 20, 20), 1, 20);
+	test(arg(30, -1, 10, 20, 20), 2, 20);
+	test(arg(30, -1, 10, 20, 20), 4, 0);
+
+	footer();
+	return check_plan();
+}
+
+#undef test
+
 static inline int
 test_fromstring_one(const char *str, uint32_t count, const int64_t *lsns)
 {
@@ -405,11 +447,12 @@ test_fromstring_invalid()
 int
 main(void)
 {
-	plan(5);
+	plan(6);
 
 	test_compare();
 	test_isearch();
 	test_tostring();
+	test_nth_element();
 	test_fromstring();
 	test_fromstring_invalid();
 
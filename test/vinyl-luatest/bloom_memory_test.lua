@@ -0,0 +1,89 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    box_cfg.vinyl_cache = 0
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 100})
+        -- Create 5 runs so that there are 5 bloom filters.
+        for run = 1, 5 do
+            for i = 1, 100 do
+                s:replace{run * 1000 + i}
+            end
+            box.snapshot()
+        end
+    end)
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        box.cfg{vinyl_bloom_memory = 0}
+    end)
+end)
+
+g.test_bloom_memory = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local stat = s.index.pk:stat()
+        local total = stat.disk.bloom_size
+        t.assert_equals(stat.run_count, 5)
+        t.assert_gt(total, 0)
+        t.assert_equals(box.stat.vinyl().memory.bloom_filter, total)
+
+        -- Only the most recently used bloom filter is kept.
+        box.cfg{vinyl_bloom_memory = 1}
+        local used = box.stat.vinyl().memory.bloom_filter
+        t.assert_gt(used, 0)
+        t.assert_lt(used, total)
+        -- Dropped bloom filters are still accounted in index stats.
+        t.assert_equals(s.index.pk:stat().disk.bloom_size, total)
+
+        -- Lookups of missing keys check all bloom filters, so
+        -- the dropped ones are reloaded.
+        box.stat.reset()
+        for i = 1, 10 do
+            t.assert_equals(s:get{i}, nil)
+        end
+        stat = s.index.pk:stat().disk.iterator.bloom
+        t.assert_gt(stat.load, 0)
+        t.assert_gt(stat.hit, 0)
+        t.assert_lt(box.stat.vinyl().memory.bloom_filter, total)
+        t.assert_equals(s:get{3050}, {3050})
+
+        -- Raising the limit lets bloom filters stay in memory.
+        box.cfg{vinyl_bloom_memory = 0}
+        for i = 1, 10 do
+            t.assert_equals(s:get{i}, nil)
+        end
+        t.assert_equals(box.stat.vinyl().memory.bloom_filter, total)
+        box.stat.reset()
+        for i = 1, 10 do
+            t.assert_equals(s:get{i}, nil)
+        end
+        t.assert_equals(s.index.pk:stat().disk.iterator.bloom.load, 0)
+    end)
+end
+
+g.test_bloom_memory_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_bloom_memory': " ..
+            "must be greater than or equal to 0",
+            box.cfg, {vinyl_bloom_memory = -1})
+        t.assert_equals(box.cfg.vinyl_bloom_memory, 0)
+    end)
+end
@@ -0,0 +1,100 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    g.server = server:new({alias = 'master',
+                           box_cfg = common.default_box_cfg()})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        for _, name in ipairs({'none', 'fast', 'best'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_compression_level = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local digest = require('digest')
+        local levels = {none = 0, fast = 1, best = 19}
+        for name, level in pairs(levels) do
+            local s = box.schema.space.create(name, {engine = 'vinyl'})
+            s:create_index('pk', {range_size = 16 * 1024 * 1024,
+                                  compression_level = level})
+            t.assert_equals(s.index.pk.options.compression_level, level)
+        end
+        -- Fill the spaces with the same compressible data and
+        -- compact them so that runs are written with the index
+        -- compression level (dumped runs are never compressed).
+        for i = 1, 1000 do
+            local str = digest.base64_encode(digest.urandom(20))
+            local pad = string.rep(str, 10)
+            for name in pairs(levels) do
+                box.space[name]:replace{i, pad}
+            end
+        end
+        box.snapshot()
+        for name in pairs(levels) do
+            box.space[name].index.pk:compact()
+        end
+        t.helpers.retrying({}, function()
+            for name in pairs(levels) do
+                local stat = box.space[name].index.pk:stat()
+                t.assert_equals(stat.disk.compaction.count, 1)
+            end
+        end)
+        local size = {}
+        for name in pairs(levels) do
+            local stat = box.space[name].index.pk:stat()
+            t.assert_equals(stat.run_count, 1)
+            size[name] = stat.disk.bytes_compressed
+        end
+        t.assert_lt(size.fast, size.none)
+        t.assert_le(size.best, size.fast)
+        for name in pairs(levels) do
+            t.assert_equals(box.space[name]:count(), 1000)
+        end
+    end)
+    -- Make sure runs can be read after restart.
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        for _, name in ipairs({'none', 'fast', 'best'}) do
+            local s = box.space[name]
+            t.assert_equals(s:count(), 1000)
+            t.assert_equals(s:get(500)[1], 500)
+        end
+    end)
+end
+
+g.test_compression_level_alter = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('none', {engine = 'vinyl'})
+        s:create_index('pk')
+        t.assert_equals(s.index.pk.options.compression_level, nil)
+        s.index.pk:alter({compression_level = 0})
+        t.assert_equals(s.index.pk.options.compression_level, 0)
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'none': " ..
+            "compression_level must be between 0 and 22",
+            s.index.pk.alter, s.index.pk, {compression_level = 23})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'sk' in space 'none': " ..
+            "compression_level must be between 0 and 22",
+            s.create_index, s, 'sk', {compression_level = -1})
+    end)
+end
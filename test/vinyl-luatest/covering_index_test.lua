@@ -0,0 +1,138 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Make sure all reads go to disk.
+    box_cfg.vinyl_cache = 0
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.before_each(function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false,
+                              covering = true})
+        s:create_index('sk2', {parts = {2, 'unsigned'}, unique = false})
+    end)
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_covering_index = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.sk.options.covering, true)
+        t.assert_equals(s.index.sk2.options.covering, nil)
+        for i = 1, 100 do
+            s:replace{i, i % 10, 'x'}
+        end
+        box.snapshot()
+        -- Overwrite non-indexed fields with all kinds of requests.
+        for i = 1, 100, 4 do
+            s:replace{i, i % 10, 'y'}
+            s:update(i + 1, {{'=', 3, 'y'}})
+            s:upsert({i + 2, (i + 2) % 10, 'x'}, {{'=', 3, 'y'}})
+            s:delete(i + 3)
+        end
+        box.snapshot()
+        local expected = s.index.sk2:select({5})
+        t.assert_equals(#expected, 10)
+        box.stat.reset()
+        t.assert_equals(s.index.sk:select({5}), expected)
+        t.assert_equals(#s.index.sk:select(), 75)
+        for _, tuple in s.index.sk:pairs() do
+            t.assert_equals(tuple[3], 'y')
+        end
+        t.assert_equals(s.index.pk:stat().lookup, 0)
+        t.assert_equals(s.index.pk:stat().disk.iterator.read.rows, 0)
+        -- Unlike the covering index, a non-covering index
+        -- looks up the primary index.
+        t.assert_equals(s.index.sk2:select({5}, {iterator = 'LE'}),
+                        s.index.sk:select({5}, {iterator = 'LE'}))
+        t.assert_gt(s.index.pk:stat().lookup, 0)
+        -- Compaction preserves the latest versions.
+        s.index.sk:compact()
+        t.helpers.retrying({}, function()
+            t.assert_equals(s.index.sk:stat().run_count, 1)
+        end)
+        t.assert_equals(s.index.sk:stat().disk.rows, 75)
+        t.assert_equals(s.index.sk:select({5}), expected)
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.sk:select(), s.index.sk2:select())
+        t.assert_equals(#s.index.sk:select({3}), 10)
+        t.assert_equals(s.index.sk:select({3})[1], {3, 3, 'y'})
+    end)
+end
+
+g.test_covering_index_tx = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.space.test
+        s:replace{1, 1, 'x'}
+        box.begin()
+        t.assert_equals(s.index.sk:select({1}), {{1, 1, 'x'}})
+        local f = fiber.new(function()
+            s:replace{1, 1, 'y'}
+        end)
+        f:set_joinable(true)
+        t.assert_equals({f:join()}, {true})
+        local ok = pcall(function()
+            s:replace{2, 2, 'z'}
+            box.commit()
+        end)
+        t.assert_not(ok)
+        box.rollback()
+        t.assert_equals(s.index.sk:select(), {{1, 1, 'y'}})
+    end)
+end
+
+g.test_covering_index_alter = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        for i = 1, 10 do
+            s:replace{i, i, 'x'}
+        end
+        box.snapshot()
+        s.index.sk2:alter({covering = true})
+        t.assert_equals(s.index.sk2.options.covering, true)
+        box.stat.reset()
+        t.assert_equals(#s.index.sk2:select(), 10)
+        t.assert_equals(s.index.pk:stat().lookup, 0)
+        s.index.sk:alter({covering = false})
+        t.assert_equals(s.index.sk.options.covering, nil)
+        box.stat.reset()
+        t.assert_equals(#s.index.sk:select(), 10)
+        t.assert_equals(s.index.pk:stat().lookup, 10)
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'pk' in space 'test': " ..
+            "primary index can't be covering",
+            s.index.pk.alter, s.index.pk, {covering = true})
+        t.assert_error_msg_content_equals(
+            "Can't create or modify index 'mk' in space 'test': " ..
+            "multikey index can't be covering",
+            s.create_index, s, 'mk', {parts = {{4, 'unsigned', path = '[*]'}},
+                                      unique = false, covering = true})
+    end)
+end
@@ -0,0 +1,92 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    -- Make sure all reads go to disk.
+    box_cfg.vinyl_cache = 0
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+end)
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.before_each(function()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024, range_size = 16 * 1024 * 1024,
+                              run_count_per_level = 100, read_ahead = 4})
+        local pad = string.rep('x', 100)
+        for i = 1, 1000 do
+            s:replace{i, pad}
+        end
+        box.snapshot()
+        box.stat.reset()
+    end)
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_read_ahead = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local page_count = s.index.pk:stat().disk.pages
+        t.assert_gt(page_count, 10)
+        for _, dir in ipairs({'GE', 'LE'}) do
+            box.stat.reset()
+            t.assert_equals(#s:select({}, {iterator = dir}), 1000)
+            local stat = s.index.pk:stat().disk.iterator
+            -- Every page is read exactly once.
+            t.assert_equals(stat.read.pages, page_count)
+            t.assert_gt(stat.read_ahead.pages, 0)
+            t.assert_le(stat.read_ahead.pages, page_count)
+            t.assert_gt(stat.read_ahead.hit, 0)
+            t.assert_le(stat.read_ahead.hit, stat.read_ahead.pages)
+        end
+        -- Short range selects don't trigger read-ahead.
+        box.stat.reset()
+        for i = 1, 1000, 10 do
+            t.assert_equals(#s:select({i}, {limit = 2}), 2)
+        end
+        t.assert_equals(s.index.pk:stat().disk.iterator.read_ahead.pages, 0)
+    end)
+end
+
+g.test_read_ahead_disabled = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        s.index.pk:alter({read_ahead = 0})
+        t.assert_equals(#s:select(), 1000)
+        local stat = s.index.pk:stat().disk.iterator
+        t.assert_gt(stat.read.pages, 0)
+        t.assert_equals(stat.read_ahead, {pages = 0, hit = 0})
+        t.assert_equals(s.index.pk.options.read_ahead, nil)
+        s.index.pk:alter({read_ahead = 8})
+        t.assert_equals(s.index.pk.options.read_ahead, 8)
+        t.assert_equals(#s:select(), 1000)
+        t.assert_gt(s.index.pk:stat().disk.iterator.read_ahead.hit, 0)
+    end)
+end
+
+g.test_read_ahead_invalid = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Wrong index options (field 4): " ..
+            "read_ahead must be greater than or equal to 0",
+            box.space.test.create_index, box.space.test, 'sk',
+            {read_ahead = -1})
+    end)
+end
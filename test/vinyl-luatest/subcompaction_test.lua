@@ -0,0 +1,109 @@
+local t = require('luatest')
+
+local server = require('test.luatest_helpers.server')
+local common = require('test.vinyl-luatest.common')
+
+local g = t.group()
+
+g.before_all(function()
+    local box_cfg = common.default_box_cfg()
+    box_cfg.vinyl_write_threads = 4
+    box_cfg.vinyl_max_subcompactions = 3
+    g.server = server:new({alias = 'master', box_cfg = box_cfg})
+    g.server:start()
+end)
+
+local function define_helpers()
+    g.server:exec(function()
+        -- Writes two overlapping runs of about 200 KB each
+        -- and compacts them.
+        rawset(_G, 'fill_and_compact', function()
+            local t = require('luatest')
+            local s = box.space.test
+            local pad = string.rep('x', 200)
+            for i = 1, 1000 do
+                s:replace{i, 1, pad}
+            end
+            box.snapshot()
+            for i = 1, 1000 do
+                s:replace{i, 2, pad}
+            end
+            box.snapshot()
+            t.assert_equals(s.index.pk:stat().range_count, 1)
+            t.assert_equals(s.index.pk:stat().run_count, 2)
+            s.index.pk:compact()
+            t.helpers.retrying({}, function()
+                t.assert_equals(s.index.pk:stat().disk.compaction.count, 1)
+            end)
+        end)
+    end)
+end
+
+g.after_all(function()
+    g.server:drop()
+end)
+
+g.before_each(function()
+    define_helpers()
+    g.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 100})
+    end)
+end)
+
+g.after_each(function()
+    g.server:exec(function()
+        box.cfg{vinyl_max_subcompactions = 3}
+        box.space.test:drop()
+    end)
+end)
+
+g.test_subcompaction = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        _G.fill_and_compact()
+        -- There are 3 compaction threads so the task is split
+        -- in 3 parts, each of which produces its own range.
+        local stat = s.index.pk:stat()
+        t.assert_equals(stat.range_count, 3)
+        t.assert_equals(stat.run_count, 3)
+        t.assert_equals(stat.disk.rows, 1000)
+        t.assert_equals(s:count(), 1000)
+        for _, tuple in s:pairs() do
+            t.assert_equals(tuple[2], 2)
+        end
+        t.assert_equals(s:get(1)[2], 2)
+        t.assert_equals(s:get(1000)[2], 2)
+    end)
+    g.server:restart()
+    g.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.pk:stat().range_count, 3)
+        t.assert_equals(s:count(), 1000)
+    end)
+end
+
+g.test_subcompaction_disabled = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        box.cfg{vinyl_max_subcompactions = 1}
+        _G.fill_and_compact()
+        local stat = box.space.test.index.pk:stat()
+        t.assert_equals(stat.range_count, 1)
+        t.assert_equals(stat.run_count, 1)
+        t.assert_equals(box.space.test:count(), 1000)
+    end)
+end
+
+g.test_cfg = function()
+    g.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_content_equals(
+            "Incorrect value for option 'vinyl_max_subcompactions': " ..
+            "must be greater than or equal to 1",
+            box.cfg, {vinyl_max_subcompactions = 0})
+        t.assert_equals(box.cfg.vinyl_max_subcompactions, 3)
+    end)
+end